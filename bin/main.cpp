@@ -33,6 +33,7 @@ int main(int argc, char *argv[])
       else if (mode == "train_rom")    TrainROM(MPI_COMM_WORLD);
       else if (mode == "train_eqp")    TrainEQP(MPI_COMM_WORLD);
       else if (mode == "single_run")   double dump = SingleRun(MPI_COMM_WORLD, output_file);
+      else if (mode == "serve")        ServeROM(MPI_COMM_WORLD);
       else
       {
          if (rank == 0) printf("Unknown mode %s!\n", mode.c_str());
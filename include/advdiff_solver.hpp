@@ -7,6 +7,8 @@
 
 #include "poisson_solver.hpp"
 #include "stokes_solver.hpp"
+#include <deque>
+#include <mutex>
 
 // By convention we only use mfem namespace as default, not CAROM.
 using namespace mfem;
@@ -31,6 +33,27 @@ protected:
    bool save_flow = false;
    std::string flow_file = "";
 
+   /*
+      Library of flow fields solved so far, keyed by the flow parameters and the topology.
+      It is shared by all AdvDiffSolver instances, so that a parameter sweep
+      solves each distinct flow field only once.
+      At most flow_library_size flow fields are kept in memory, and the oldest one is evicted first.
+      When flow_library_file is given, the library is also persisted in a hdf5 file,
+      one group per flow field named by the escaped key (see GetFlowGroupName).
+   */
+   static std::map<std::string, Vector> flow_library;
+   // insertion order of flow_library, for the eviction.
+   static std::deque<std::string> flow_library_order;
+   // guards flow_library and the library file.
+   static std::mutex flow_library_mutex;
+   bool use_flow_library = false;
+   int flow_library_size = 4;
+   std::string flow_library_file = "";
+   // whether the current flow field is copied from the library.
+   bool flow_from_library = false;
+   // obtain the flow field from the flow ROM, if use_rom is also set.
+   bool rom_flow = false;
+
    /* grid functions for visualizaing flow field */
    /* NOTE(kevin): this will be set up at SaveVisualization. */
    Array<FiniteElementSpace *> flow_fes;
@@ -54,13 +77,31 @@ public:
 
    void SetParameterizedProblem(ParameterizedProblem *problem) override;
 
+   // advection operator depends on the flow field of the parameterized problem.
+   bool IsOperatorParamIndependent() override { return false; }
+
    void SaveVisualization() override;
 
+   const bool IsFlowFromLibrary() const { return flow_from_library; }
+   // number of flow fields in the in-memory library.
+   static const int GetFlowLibrarySize();
+   // clear the in-memory library. the library file is kept.
+   static void ClearFlowLibrary();
+
 protected:
    void SetMUMPSSolver() override;
 
 private:
    void GetFlowField(ParameterizedProblem *flow_problem);
+
+   void InitFlowSolver();
+   void SolveFlowField(ParameterizedProblem *flow_problem);
+   const std::string GetFlowKey(ParameterizedProblem *flow_problem);
+   // returns false if the flow field is not found in the library.
+   bool FindFlowInLibrary(const std::string &key, Vector &flow);
+   void AddFlowToLibrary(const std::string &key, const Vector &flow);
+   // hdf5 group name of the key. '/' and '%' are percent-escaped, so that the name is deterministic.
+   static const std::string GetFlowGroupName(const std::string &key);
 };
 
 #endif
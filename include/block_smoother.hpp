@@ -6,6 +6,7 @@
 #define BLOCK_SMOOTHER_HPP
 
 #include "mfem.hpp"
+#include <set>
 
 using namespace mfem;
 
@@ -78,6 +79,62 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/*
+   Direct solver for block-sparse matrices with dense blocks, such as ROM systems.
+   The blocks are stored as dense tiles and factorized with a block LU factorization,
+   where each tile operation is a dense LAPACK/BLAS kernel.
+   Fill-in is determined symbolically on the block sparsity pattern.
+   Blocks with a zero diagonal tile, such as the pressure blocks of a saddle-point system,
+   are symmetrically reordered to be eliminated last, where their pivots are the Schur complements
+   filled in by the other blocks.
+*/
+class BlockDenseLUSolver : public Solver
+{
+protected:
+   int num_blocks = -1;
+   Array<int> offsets;
+   /* elimination order: order[k] is the block eliminated at step k. */
+   Array<int> order;
+
+   /*
+      Dense tiles in the elimination order, overwritten with the block LU factors.
+      Lower tiles (i > j) store L_ij, with unit diagonal blocks.
+      Upper tiles (i < j) store U_ij. Diagonal pivot blocks are stored as inverses in diag_inv.
+   */
+   Array2D<DenseMatrix *> tiles;
+   Array<DenseMatrix *> diag_inv;
+   /* nonzero tile pattern after fill-in, for each block row/column. */
+   std::vector<std::set<int>> row_pattern, col_pattern;
+
+   mutable Vector tmp;
+
+public:
+   BlockDenseLUSolver(const Array<int> &offsets_);
+   BlockDenseLUSolver(const BlockMatrix &mat);
+
+   virtual ~BlockDenseLUSolver();
+
+   /*
+      Accepts a BlockMatrix with the same block offsets,
+      or a SparseMatrix/serial HypreParMatrix partitioned with the block offsets.
+   */
+   virtual void SetOperator(const Operator &op) override;
+
+   virtual void Mult(const Vector &x, Vector &y) const override;
+   // Multiple right-hand sides, one per column. Substitutions are done with tile-by-block gemms.
+   void Mult(const DenseMatrix &X, DenseMatrix &Y) const;
+
+private:
+   void ClearTiles();
+   void AddTile(const int i, const int j);
+   int TileSize(const int k) const { return offsets[order[k]+1] - offsets[order[k]]; }
+   // eliminate the blocks with zero diagonal tiles last, keeping the natural order otherwise.
+   void SetOrder(const Array<bool> &zero_diag);
+   void SetTiles(const BlockMatrix &mat);
+   void SetTiles(const SparseMatrix &mat);
+   void Factorize();
+};
+
 }
 
 #endif
@@ -17,17 +17,32 @@ namespace mesh_config
 static double trans[3], rotate[3];
 typedef void TransformFunction(const Vector &, Vector &);
 
-static void Transform2D(const Vector &x, Vector &y)
+/* rigid transformation with the given configuration, independent of the global configuration above. */
+static void RigidTransform2D(const double *trans_, const double *rotate_, const Vector &x, Vector &y)
 {
    assert(x.Size() == 2);
    y.SetSize(2);
-   double sint = sin(mesh_config::rotate[0]);
-   double cost = cos(mesh_config::rotate[0]);
+   double sint = sin(rotate_[0]);
+   double cost = cos(rotate_[0]);
    y[0] = cost * x[0] - sint * x[1];
    y[1] = sint * x[0] + cost * x[1];
 
-   y[0] += mesh_config::trans[0];
-   y[1] += mesh_config::trans[1];
+   y[0] += trans_[0];
+   y[1] += trans_[1];
+}
+
+static void RigidTransform3D(const double *trans_, const double *rotate_, const Vector &x, Vector &y)
+{
+   assert(x.Size() == 3);
+   y.SetSize(3);
+
+   for (int d = 0; d < 3; d++)
+      y(d) = x(d) + trans_[d];
+}
+
+static void Transform2D(const Vector &x, Vector &y)
+{
+   RigidTransform2D(mesh_config::trans, mesh_config::rotate, x, y);
 }
 
 static void InverseTransform2D(const Vector &x, Vector &y)
@@ -45,11 +60,7 @@ static void InverseTransform2D(const Vector &x, Vector &y)
 
 static void Transform3D(const Vector &x, Vector &y)
 {
-   assert(x.Size() == 3);
-   y.SetSize(3);
-
-   for (int d = 0; d < 3; d++)
-      y(d) = x(d) + mesh_config::trans[d];
+   RigidTransform3D(mesh_config::trans, mesh_config::rotate, x, y);
 }
 
 static void InverseTransform3D(const Vector &x, Vector &y)
@@ -74,6 +85,15 @@ public:
    using Mesh::GetQuadOrientation;
 };
 
+/*
+   Match each point (column) of x1 to a point of x2 whose coordinates all differ by less than threshold.
+   Points of x2 are hashed into cells no smaller than threshold, so that only the neighboring cells are searched.
+   Among the candidates, the first point of x2 that is not matched yet is taken,
+   which is the same pairing as the exhaustive search over x2 in order.
+   match1to2[i] is the matched column of x2 for the column i of x1, or -1 if none is found.
+*/
+void MatchPortVertices(const DenseMatrix &x1, const DenseMatrix &x2, const double threshold, Array<int> &match1to2);
+
 class ComponentTopologyHandler : public TopologyHandler
 {
 public:
@@ -112,7 +132,15 @@ protected:
    mesh_config::TransformFunction *tf_ptr = NULL;
    mesh_config::TransformFunction *inv_tf_ptr = NULL;
 
-   // Meshes for global configuration.
+   /*
+      Meshes for global configuration.
+      Subdomains only refer to the reference component (mesh_types) and its rigid transformation (mesh_configs).
+      A subdomain mesh is copied from the component and transformed only when it is requested
+      by GetMesh or ExportInfo, and stays NULL otherwise.
+      NOTE: MultiBlockSolver calls ExportInfo and builds a finite element space on every subdomain,
+      so any solver run (including ROM-only runs) still holds all subdomain meshes.
+      Only topology-only users (ports, interfaces) stay bound by the number of components.
+   */
    Array<Mesh*> meshes;
 
    // Reference ports between components.
@@ -136,9 +164,12 @@ public:
    virtual ~ComponentTopologyHandler();
 
    // access
-   virtual Mesh* GetMesh(const int k) { return &(*meshes[k]); }
+   // materializes the subdomain mesh, if not yet.
+   virtual Mesh* GetMesh(const int k);
    virtual Mesh* GetGlobalMesh()
    { mfem_error("ComponenetTopologyHandler does not support a global mesh!\n"); return NULL; }
+   // number of subdomain meshes materialized so far.
+   const int GetNumMaterializedMeshes() const;
    virtual const int GetNumRefPorts() { return num_ref_ports; }
    virtual const int GetPortType(const int &port_idx) { return port_types[port_idx]; }
    virtual PortData* GetPortData(const int r) { return ref_ports[r]; }
@@ -150,13 +181,23 @@ public:
    virtual void GetComponentPair(const int &ref_port_idx, int &comp1, int &comp2);
    virtual void GetRefPortInfo(const int &ref_port_idx, int &comp1, int &comp2, int &attr1, int &attr2);
 
-   // Export mesh pointers and interface info.
+   /*
+      Export mesh pointers and interface info. All subdomain meshes are materialized.
+      Only the solvers call this, for their subdomain spaces.
+      Component-level ROM assembly needs only the components, ports and GetMeshType/TransformToSubdomain,
+      and does not build any subdomain mesh (see LazyMeshes_test).
+   */
    virtual void ExportInfo(Array<Mesh*> &mesh_ptrs, TopologyData &topol_data);
 
+   // Rigid transformation from the reference component to the subdomain m, without materializing the mesh.
+   void TransformToSubdomain(const int m, const Vector &x, Vector &y) const;
+
    virtual void TransferToGlobal(Array<GridFunction*> &us, Array<GridFunction*> &global_u, const int &num_var)
    { mfem_error("ComponentTopologyHandler does not yet support global grid function/mesh!\n"); }
 
 protected:
+   virtual Mesh* GetBuiltMesh(const int k) { return meshes[k]; }
+
    // Get vertex orientation of face2 (from mesh2) with respect to face1 (mesh1).
    int GetOrientation(BlockMesh *comp1, const Element::Type &be_type, const Array<int> &vtx1, const Array<int> &vtx2);
 
@@ -177,6 +218,8 @@ protected:
    void SetupComponents();
    void SetupReferencePorts();
    void SetupMeshes();
+   // Copy the reference component mesh, transform it and set the global boundary attributes.
+   Mesh* BuildSubdomainMesh(const int m);
    void SetupBdrAttributes();
    void SetupReferenceInterfaces();
    void SetupPorts();
@@ -247,6 +247,29 @@ void WriteDataset(hid_t &source, std::string dataset, const Vector &value);
 void ReadDataset(hid_t &source, std::string dataset, DenseMatrix &value);
 void WriteDataset(hid_t &source, std::string dataset, const DenseMatrix &value);
 
+/*
+   Extendible DenseMatrix dataset, appended one column at a time.
+   It has the same (transposed) layout as WriteDataset(DenseMatrix) and is chunked by one column,
+   so that only one column needs to be in memory while writing.
+   Returns the dataset id, which must be closed by the caller.
+*/
+hid_t CreateExtendibleDataset(hid_t &source, std::string dataset, const int nrow);
+// Append one column of size nrow. ncol is the current number of columns, incremented after appending.
+void AppendColumn(hid_t &dset_id, const int nrow, int &ncol, const double *data);
+// Size of a DenseMatrix dataset.
+void GetMatrixDatasetSize(hid_t &source, std::string dataset, int &nrow, int &ncol);
+// Read the block of a DenseMatrix dataset starting at (row_begin, col_begin), with the size of value.
+void ReadDatasetBlock(hid_t &source, std::string dataset, const int row_begin, const int col_begin, DenseMatrix &value);
+
+/*
+   Memory-map a 1D double dataset directly from the file, without reading it.
+   Only contiguous, uncompressed datasets aligned to double can be mapped.
+   Returns the pointer to the data, or NULL if the dataset cannot be mapped.
+   map_addr and map_length must be released with UnmapDataset.
+*/
+double* MapDataset(hid_t &source, std::string dataset, int &size, void* &map_addr, size_t &map_length);
+void UnmapDataset(void *map_addr, const size_t map_length);
+
 void ReadDataset(hid_t &source, std::string dataset, DenseTensor &value);
 void WriteDataset(hid_t &source, std::string dataset, const DenseTensor &value);
 
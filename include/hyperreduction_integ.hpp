@@ -14,23 +14,19 @@ namespace mfem
 
 struct EQPSample {
    SampleInfo info;
-   /* shape and gradient of shape function on element 1 */
-   DenseMatrix *shape1 = NULL;
-   Array<DenseMatrix *> dshape1;
-   /* shape and gradient of shape function on element 2 */
-   DenseMatrix *shape2 = NULL;
-   Array<DenseMatrix *> dshape2;
+   /*
+      Precomputed coefficients of the sample, all views into the packed buffer of EQPElement.
+      weight: quadrature weight, multiplied by the jacobian determinant for domain samples.
+      shape1/shape2: shape function on element 1/2, projected on the basis (dim x nbasis).
+      dshape1/dshape2: gradient of shape function on element 1/2, projected on the basis.
+         one dim x dim matrix per basis, stored contiguously in column-major order.
+   */
+   double *weight = NULL;
+   DenseMatrix shape1, shape2;
+   double *dshape1 = NULL, *dshape2 = NULL;
 
    EQPSample(const SampleInfo &info_)
-      : info(info_), shape1(NULL), shape2(NULL), dshape1(0), dshape2(0) {}
-
-   ~EQPSample()
-   {
-      delete shape1;
-      delete shape2;
-      DeletePointers(dshape1);
-      DeletePointers(dshape2);
-   }
+      : info(info_), weight(NULL), dshape1(NULL), dshape2(NULL) {}
 };
 
 class EQPElement
@@ -38,6 +34,25 @@ class EQPElement
 public:
    Array<EQPSample *> samples;
 
+   /*
+      Precomputed coefficients of all samples, packed in one buffer in the sample order.
+      Each sample stores its weight, shape1, dshape1, shape2 and dshape2 contiguously,
+      so that the fast assembly sweeps the buffer linearly.
+   */
+   Vector coeffs;
+   int dim = -1;
+   int nbasis1 = 0, nbasis2 = 0;
+   bool has_dshape = false;
+   // BasisFingerprint of the basis the coefficients are computed with. empty if unknown.
+   std::string basis_fingerprint = "";
+
+private:
+   // true if coeffs are loaded from the file, instead of computed.
+   bool coeffs_loaded = false;
+   // memory-mapped file region, if coeffs are a view of it.
+   void *coeffs_map = NULL;
+   size_t coeffs_map_length = 0;
+
 public:
    EQPElement() : samples(0) {}
 
@@ -51,6 +66,7 @@ public:
    ~EQPElement()
    {
       DeletePointers(samples);
+      hdf5_utils::UnmapDataset(coeffs_map, coeffs_map_length);
    }
 
    const int Size() { return samples.Size(); }
@@ -61,15 +77,74 @@ public:
       return samples[s];
    }
 
+   void GetSampleInfos(Array<SampleInfo> &infos) const
+   {
+      infos.SetSize(samples.Size());
+      for (int s = 0; s < samples.Size(); s++)
+         infos[s] = samples[s]->info;
+   }
+
+   /*
+      Allocate the packed coefficient buffer and set the sample views into it.
+      nbasis2 = 0 if the samples do not have the second element.
+   */
+   void AllocateCoefficients(const int dim_, const int nbasis1_, const int nbasis2_, const bool has_dshape_,
+                             const std::string &basis_fingerprint_ = "");
+   const int GetCoefficientSize() const
+   { return 1 + (dim + ((has_dshape) ? dim * dim : 0)) * (nbasis1 + nbasis2); }
+
+   /*
+      true if the coefficients are loaded from the file with the given layout,
+      and precomputed with the basis of the given fingerprint.
+      Coefficients of a retrained basis, or without a fingerprint, must be computed again.
+   */
+   const bool HasLoadedCoefficients(const int dim_, const int nbasis1_, const int nbasis2_, const bool has_dshape_,
+                                    const std::string &basis_fingerprint_) const
+   {
+      return coeffs_loaded && (dim == dim_) && (nbasis1 == nbasis1_)
+             && (nbasis2 == nbasis2_) && (has_dshape == has_dshape_)
+             && (basis_fingerprint != "") && (basis_fingerprint == basis_fingerprint_);
+   }
+
+   /* precomputed coefficients are saved as well, if allocated. */
    void Save(hid_t file_id, const std::string &dsetname, const IntegratorType type);
+   /* precomputed coefficients are memory-mapped from the file if possible, or read otherwise. */
    void Load(hid_t file_id, const std::string &dsetname, const IntegratorType type);
+
+private:
+   void ReleaseCoefficients();
+   void SetSampleViews();
 };
 
+/*
+   Range [e_begin, e_end) of the EQP system elements on this process.
+   If distributed, the elements are split over all processes in MPI_COMM_WORLD.
+   Otherwise this process takes all elements, without any communication.
+*/
+void GetEQPElementRange(const int ne_global, const bool distributed, int &e_begin, int &e_end);
+
+/* Broadcast EQP samples from the root process. samples on the other processes are overwritten. */
+void BroadcastSampleInfos(Array<SampleInfo> &samples, const int root, MPI_Comm comm = MPI_COMM_WORLD);
+
 class HyperReductionIntegrator : virtual public NonlinearFormIntegrator
 {
 protected:
    HyperReductionIntegrator(const IntegrationRule *ir = NULL)
-      : NonlinearFormIntegrator(ir) {}
+      : NonlinearFormIntegrator(ir), fast_scratch(1) {}
+
+   /*
+      Work space of the fast EQP kernels, one per thread,
+      so that the kernels do not allocate per sample and stay reentrant in threaded EQP.
+   */
+   struct FastScratch
+   {
+      Vector vec1, vec2, vec3;
+      DenseMatrix mat1, mat2;
+   };
+   std::vector<FastScratch> fast_scratch;
+
+   // work space of the calling thread.
+   FastScratch& GetFastScratch();
 
    // removed const qualifier for basis in order to use its column view vector.
    void GetBasisElement(DenseMatrix &basis, const int col,
@@ -92,6 +167,33 @@ public:
                                           const Vector &eltest,
                                           Vector &elquad);
 
+   /*
+      Quadrature vectors of all columns of eltests at once, stored in the columns of elquads.
+      By default this calls AssembleQuadratureVector column by column.
+      Overriding integrators evaluate the geometry and shape functions only once for all columns.
+   */
+   virtual void AssembleQuadratureVectors(const FiniteElement &el,
+                                          ElementTransformation &T,
+                                          const IntegrationPoint &ip,
+                                          const double &iw,
+                                          const DenseMatrix &eltests,
+                                          DenseMatrix &elquads);
+
+   virtual void AssembleQuadratureVectors(const FiniteElement &el1,
+                                          const FiniteElement &el2,
+                                          FaceElementTransformations &T,
+                                          const IntegrationPoint &ip,
+                                          const double &iw,
+                                          const DenseMatrix &eltests,
+                                          DenseMatrix &elquads);
+
+   /*
+      true if AssembleQuadratureVectors for element uses only local work space.
+      It is thread-safe only if mfem is built with MFEM_THREAD_SAFE,
+      since the finite elements keep their own scratch for CalcShape/CalcPhysDShape.
+   */
+   virtual const bool ThreadSafeQuadratureVectors() { return false; }
+
    virtual void AssembleQuadratureGrad(const FiniteElement &el,
                                        ElementTransformation &T,
                                        const IntegrationPoint &ip,
@@ -117,6 +219,9 @@ public:
                                              DenseMatrix &basis,
                                              const SampleInfo &sample);
 
+   // work space for num_threads threads. must be called outside of the parallel region.
+   void ReserveFastScratch(const int num_threads);
+
    virtual void AddAssembleVector_Fast(const EQPSample &eqp_sample,
                                        ElementTransformation &T, const Vector &x, Vector &y);
    virtual void AddAssembleVector_Fast(const EQPSample &eqp_sample,
@@ -160,6 +265,15 @@ public:
                                           const Vector &eltest,
                                           Vector &elquad) override;
 
+   virtual void AssembleQuadratureVectors(const FiniteElement &el,
+                                          ElementTransformation &T,
+                                          const IntegrationPoint &ip,
+                                          const double &iw,
+                                          const DenseMatrix &eltests,
+                                          DenseMatrix &elquads) override;
+
+   const bool ThreadSafeQuadratureVectors() override { return true; }
+
    virtual void AssembleElementGrad(const FiniteElement &el,
                                     ElementTransformation &trans,
                                     const Vector &elfun,
@@ -216,6 +330,15 @@ public:
                                  const Vector &eltest,
                                  Vector &elquad) override;
 
+   void AssembleQuadratureVectors(const FiniteElement &el,
+                                  ElementTransformation &T,
+                                  const IntegrationPoint &ip,
+                                  const double &iw,
+                                  const DenseMatrix &eltests,
+                                  DenseMatrix &elquads) override;
+
+   const bool ThreadSafeQuadratureVectors() override { return true; }
+
    void AssembleQuadratureGrad(const FiniteElement &el,
                               ElementTransformation &trans,
                               const IntegrationPoint &ip,
@@ -87,11 +87,17 @@ protected:
 
    int rank;   // MPI rank
 
-public:
+   /*
+      Stamp of the current options, unique over all InputParser instances.
+      It is renewed whenever the options can be changed through this class,
+      so that OptionSnapshot can tell whether its compiled values are stale.
+   */
+   long revision = 0;
+
    YAML::Node dict_;
 
 public:
-   InputParser() {};
+   InputParser() { UpdateRevision(); };
 
    InputParser(const std::string &input_file, const std::string forced_input="");
 
@@ -129,16 +135,40 @@ public:
    { return GetOptionFromDict<T>(keys, fallback, dict_); }
 
    YAML::Node FindNode(const std::string &keys, bool create=false)
-   { return FindNodeFromDict(keys, dict_, create); }
+   {
+      if (create) UpdateRevision();
+      return FindNodeFromDict(keys, dict_, create);
+   }
 
    template<class T>
    void SetOptionInDict(const std::string &keys, const T &value, YAML::Node input_dict)
    {
       YAML::Node node = FindNodeFromDict(keys, input_dict, true);
       node = value;
+      UpdateRevision();
       return;
    }
 
+   // replace the entire options.
+   void SetDict(const YAML::Node &dict)
+   {
+      dict_ = dict;
+      UpdateRevision();
+   }
+
+   const long GetRevision() const { return revision; }
+
+   /*
+      The options themselves, for direct modification.
+      The returned node shares its data with the options,
+      thus the revision is renewed at every call.
+   */
+   YAML::Node GetDict()
+   {
+      UpdateRevision();
+      return dict_;
+   }
+
    template<class T>
    void SetOption(const std::string &keys, const T &value)
    { SetOptionInDict<T>(keys, value, dict_); }
@@ -186,8 +216,103 @@ public:
 private:
    void OverwriteOption(const std::string &forced_input);
 
+   void UpdateRevision();
+
 };
 
 extern InputParser config;
 
+/*
+   Typed snapshot of input options.
+   A derived snapshot resolves all of its keys at once in Compile, into plain members,
+   so that missing required options and ill-typed values are reported before any solve starts.
+   Hot paths (Solve, Newton loops, per-sample setup) read the members instead of
+   splitting the keys and traversing the yaml nodes at every call.
+   Update compiles again only if the options were changed since (e.g. by sample parameters),
+   which is otherwise a single comparison.
+   The members must be treated as read-only outside Compile.
+*/
+class OptionSnapshot
+{
+protected:
+   long revision = -1;
+
+   virtual void Compile(InputParser &parser) = 0;
+
+public:
+   virtual ~OptionSnapshot() {}
+
+   void Update(InputParser &parser = config)
+   {
+      if (revision == parser.GetRevision()) return;
+
+      Compile(parser);
+      revision = parser.GetRevision();
+   }
+
+   const bool IsCurrent(const InputParser &parser = config) const
+   { return (revision == parser.GetRevision()); }
+};
+
+/*
+   Options of an iterative solver under the key prefix, e.g. "solver" or "solver/jacobian".
+   Defaults are given at construction, since they differ between linear and nonlinear solvers.
+*/
+class IterativeSolverOptions : public OptionSnapshot
+{
+protected:
+   const std::string prefix;
+   const int max_iter_default;
+   const double rtol_default, atol_default;
+   const int print_level_default;
+
+   void Compile(InputParser &parser) override;
+
+public:
+   int max_iter = -1;
+   double rtol = -1.0;
+   double atol = -1.0;
+   int print_level = -1;
+
+   IterativeSolverOptions(const std::string &prefix_, const int max_iter_, const double rtol_,
+                          const double atol_, const int print_level_)
+      : prefix(prefix_), max_iter_default(max_iter_), rtol_default(rtol_),
+        atol_default(atol_), print_level_default(print_level_) {}
+};
+
+/*
+   Options of the linear solve of MultiBlockSolver,
+   with the block-diagonal preconditioner switch under the same prefix.
+*/
+class LinearSolverOptions : public IterativeSolverOptions
+{
+protected:
+   void Compile(InputParser &parser) override;
+
+public:
+   bool block_diag_prec = true;
+
+   LinearSolverOptions(const std::string &prefix_, const int max_iter_, const double rtol_,
+                       const double atol_, const int print_level_)
+      : IterativeSolverOptions(prefix_, max_iter_, rtol_, atol_, print_level_) {}
+};
+
+/*
+   Options of a nonlinear (Newton-type) solve.
+   The outer iteration reads "solver", the linearized systems read "solver/jacobian".
+*/
+class NonlinearSolverOptions : public OptionSnapshot
+{
+protected:
+   void Compile(InputParser &parser) override;
+
+public:
+   IterativeSolverOptions newton = IterativeSolverOptions("solver", 100, 1.e-10, 1.e-10, 0);
+   IterativeSolverOptions jacobian = IterativeSolverOptions("solver/jacobian", 10000, 1.e-10, 1.e-10, -1);
+
+   bool use_lbfgs = false;
+   bool use_restart = false;
+   std::string restart_file = "";   // required if use_restart.
+};
+
 #endif
@@ -55,6 +55,12 @@ public:
    const Array<InterfaceNonlinearFormIntegrator*> &GetIntefaceIntegrators() const
    { return fnfi; }
 
+   /*
+      NULL blocks of mats are skipped, and so are the ports with only NULL blocks.
+      Ports are assembled serially, unlike the subdomain forms:
+      ports sharing a subdomain m all add into mats(m, m),
+      and the interface integrators keep their scratch as members.
+   */
    void AssembleInterfaceMatrices(Array2D<SparseMatrix *> &mats) const;
 
    void AssembleInterfaceMatrixAtPort(const int p, Array<FiniteElementSpace *> &fes_comp, Array2D<SparseMatrix *> &mats_p) const;
@@ -68,11 +74,12 @@ public:
       TODO(kevin): bring it back to protected.
    */
    // NonlinearForm interface operator.
+   // If the port index p is given, uses the cached interface transformations of topol_handler.
    void AssembleInterfaceVector(Mesh *mesh1, Mesh *mesh2,
       FiniteElementSpace *fes1, FiniteElementSpace *fes2,
       Array<InterfaceInfo> *interface_infos,
       const Vector &x1, const Vector &x2,
-      Vector &y1, Vector &y2) const;
+      Vector &y1, Vector &y2, const int p = -1) const;
 
 protected:
 
@@ -84,7 +91,8 @@ protected:
    void AssembleInterfaceGrad(Mesh *mesh1, Mesh *mesh2,
       FiniteElementSpace *fes1, FiniteElementSpace *fes2,
       Array<InterfaceInfo> *interface_infos,
-      const Vector &x1, const Vector &x2, Array2D<SparseMatrix*> &mats) const;
+      const Vector &x1, const Vector &x2, Array2D<SparseMatrix*> &mats,
+      const int p = -1) const;
 
 };
 
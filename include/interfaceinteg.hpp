@@ -62,6 +62,19 @@ public:
                                           const Vector &eltest1, const Vector &eltest2,
                                           Vector &elquad1, Vector &elquad2);
 
+   /*
+      Quadrature vectors of all column pairs of eltests1/2 at once, stored in the columns of elquads1/2.
+      By default this calls AssembleQuadratureVector column by column.
+   */
+   virtual void AssembleQuadratureVectors(const FiniteElement &el1,
+                                          const FiniteElement &el2,
+                                          FaceElementTransformations &Tr1,
+                                          FaceElementTransformations &Tr2,
+                                          const IntegrationPoint &ip,
+                                          const double &iw,
+                                          const DenseMatrix &eltests1, const DenseMatrix &eltests2,
+                                          DenseMatrix &elquads1, DenseMatrix &elquads2);
+
    virtual void AssembleQuadratureGrad(const FiniteElement &el1,
                                           const FiniteElement &el2,
                                           FaceElementTransformations &Tr1,
@@ -322,6 +335,15 @@ public:
                                  const Vector &eltest,
                                  Vector &elquad) override;
 
+   // face geometry, shape functions and coefficients are evaluated once for all columns.
+   void AssembleQuadratureVectors(const FiniteElement &el1,
+                                  const FiniteElement &el2,
+                                  FaceElementTransformations &T,
+                                  const IntegrationPoint &ip,
+                                  const double &iw,
+                                  const DenseMatrix &eltests,
+                                  DenseMatrix &elquads) override;
+
    void AssembleQuadratureGrad(const FiniteElement &el1,
                               const FiniteElement &el2,
                               FaceElementTransformations &T,
@@ -360,6 +382,15 @@ public:
                                  const Vector &eltest1, const Vector &eltest2,
                                  Vector &elquad1, Vector &elquad2) override;
 
+   void AssembleQuadratureVectors(const FiniteElement &el1,
+                                  const FiniteElement &el2,
+                                  FaceElementTransformations &Tr1,
+                                  FaceElementTransformations &Tr2,
+                                  const IntegrationPoint &ip,
+                                  const double &iw,
+                                  const DenseMatrix &eltests1, const DenseMatrix &eltests2,
+                                  DenseMatrix &elquads1, DenseMatrix &elquads2) override;
+
    void AssembleQuadratureGrad(const FiniteElement &el1,
                                  const FiniteElement &el2,
                                  FaceElementTransformations &Tr1,
@@ -121,10 +121,56 @@ void AddToBlockMatrix(const Array<int> &ridx, const Array<int> &cidx, const Matr
 
 void modifiedGramSchmidt(DenseMatrix& mat);
 
-/* Orthonormalize mat over mat1 and itself. */
+/*
+   Orthonormalize the columns of mat by CholQR2, i.e. two passes of
+   mat = mat * R^{-1} with the Cholesky factor R of mat^T * mat, all in matrix-matrix products.
+   If the Cholesky factorization breaks down or the result is not orthonormal,
+   it falls back to modified Gram-Schmidt with reorthogonalization.
+*/
+void BlockOrthonormalize(DenseMatrix& mat);
+
+/*
+   Orthonormalize mat over mat1 and itself.
+   mat1 is assumed to have orthogonal, not necessarily normalized, columns.
+   mat is projected out of mat1 twice in matrix-matrix products (block classical Gram-Schmidt),
+   then orthonormalized by BlockOrthonormalize.
+*/
 void Orthonormalize(DenseMatrix& mat1, DenseMatrix& mat);
 
+/*
+   Serial Lawson-Hanson active-set NNLS for the EQP system.
+   Finds a sparse sol >= 0 with G * sol within the bounds [rhs_lb, rhs_ub],
+   adding one column of G at a time to the passive set, whose least-squares problem
+   toward the center of the bounds is solved by an incrementally updated QR factorization.
+   Unlike CAROM::NNLSSolver, this does not communicate at all,
+   so independent NNLS problems can be solved on different processes simultaneously.
+   The termination follows the criterion of CAROM::NNLSSolver:
+      L2: || G * sol - center ||_2 <= || half gap of the bounds ||_2
+      LINF: every entry of G * sol is within the bounds.
+   Differences from CAROM::NNLSSolver: the constraints are not normalized,
+   there is no limit on the number of nonzeros, and no stall detection
+   beyond reconsidering the excluded columns after every update.
+   Returns true if the criterion is met within max_iter iterations.
+*/
+bool SolveBoundedNNLS(const DenseMatrix &G, const Vector &rhs_lb, const Vector &rhs_ub, Vector &sol,
+                      const CAROM::NNLS_termination criterion = CAROM::NNLS_termination::LINF,
+                      const int max_iter = 100000);
+
+// Compute AP = A * P for all columns of P at once.
+// For a finalized SparseMatrix A, this is a multi-vector SpMM over column blocks.
+void MultDenseBlock(const Operator& A,
+                    const DenseMatrix& P,
+                    DenseMatrix& AP);
+
+// Compute AtP = A^T * P for all columns of P at once, for a finalized SparseMatrix A.
+void MultTransposeDenseBlock(const SparseMatrix& A,
+                             const DenseMatrix& P,
+                             DenseMatrix& AtP);
+
 // Compute Rt * A * P
+// AP is formed once with MultDenseBlock, then Rt * (AP) is a single gemm.
+// If R and P are the same matrix and A is a symmetric SparseMatrix,
+// only the upper triangle is computed.
 void RtAP(DenseMatrix& R,
         const Operator& A,
         DenseMatrix& P,
@@ -182,6 +228,9 @@ void AddSubMatrixRtAP(const DenseMatrix& R, const Array<int> &Rrows,
 void TensorContract(const DenseTensor &tensor, const Vector &xi, const Vector &xj, Vector &yk);
 // y_k += w * T_{ijk} * x_i * x_j
 void TensorAddScaledContract(const DenseTensor &tensor, const double w, const Vector &xi, const Vector &xj, Vector &yk);
+// Batched contraction over the columns b of Xi, Xj and Y, streaming the tensor once for the whole batch.
+// Y_{kb} += w * T_{ijk} * Xi_{ib} * Xj_{jb}
+void TensorAddScaledContract(const DenseTensor &tensor, const double w, const DenseMatrix &Xi, const DenseMatrix &Xj, DenseMatrix &Y);
 // Contracts along the last axis.
 // M_{ij} = T_{ijk} * x_k
 void TensorMult(const DenseTensor &tensor, const Vector &x, DenseMatrix &M);
@@ -196,6 +245,10 @@ void TensorAddMultTranspose(const DenseTensor &tensor, const Vector &x, const in
 // axis 0: M_{kj} += w * T_{ijk} * x_i
 // axis 1: M_{ki} += w * T_{ijk} * x_j
 void TensorAddScaledMultTranspose(const DenseTensor &tensor, const double w, const Vector &x, const int axis, DenseMatrix &M);
+// Fused axis 0 and axis 1 contractions of TensorAddMultTranspose, reading the tensor once.
+// Requires SizeI == SizeJ.
+// M_{ki} += T_{jik} * x_j + T_{ijk} * x_j
+void TensorAddFusedMultTranspose(const DenseTensor &tensor, const Vector &x, DenseMatrix &M);
 
 class CGOptimizer : public OptimizationSolver
 {
@@ -233,9 +286,52 @@ private:
    double Brent(const Vector &rhs, const Vector &xi, Vector &sol, double b0 = 1e-1, double lin_tol = 1e-2) const;
 };
 
+/*
+   Direct solver with a dense LU factorization (LAPACK-backed if mfem is built with LAPACK).
+   For small reduced systems, this is faster than sparse direct solvers.
+   Accepts DenseMatrix, SparseMatrix or a serial HypreParMatrix.
+*/
+class DenseLUSolver : public Solver
+{
+protected:
+   DenseMatrix mat;
+   DenseMatrixInverse inv;
+
+public:
+   DenseLUSolver() : Solver() {}
+   virtual ~DenseLUSolver() {}
+
+   virtual void SetOperator(const Operator &op) override;
+
+   virtual void Mult(const Vector &rhs, Vector &sol) const override
+   { inv.Mult(rhs, sol); }
+};
+
 void GetBasisElement(const DenseMatrix &basis, const int col, const Array<int> vdofs,
                      Vector &basis_el, DofTransformation *dof_trans=NULL);
 
+/*
+   Element restriction of all basis columns at once: basis_el(a, j) = basis(offset + vdofs[a], j),
+   with the sign of negative vdofs as in Vector::GetSubVector.
+*/
+void GetBasisElementBlock(const DenseMatrix &basis, const Array<int> &vdofs,
+                          DenseMatrix &basis_el, const int offset=0);
+
+/*
+   Element restriction of the snapshot columns cols of a non-distributed libROM matrix:
+   snap_el(a, i) = snapshots(vdofs[a], cols[i]), or all columns in order if cols is NULL.
+   libROM matrices are row-major, so each row of vdofs is read contiguously
+   and all snapshots are transposed into one column-major block in a single sweep.
+*/
+void GetSnapshotElementBlock(const CAROM::Matrix &snapshots, const Array<int> &vdofs,
+                             DenseMatrix &snap_el, const Array<int> *cols=NULL);
+
+/*
+   64-bit FNV-1a hash of the basis size and its entries, as a hexadecimal string.
+   Used to check whether data precomputed with a basis is still valid for the current basis.
+*/
+std::string BasisFingerprint(const DenseMatrix &basis);
+
 }
 
 #endif
@@ -31,5 +31,13 @@ void TrainEQP(MPI_Comm comm);
 void FindSnapshotFilesForBasis(const BasisTag &basis_tag, const std::string &default_filename, std::vector<std::string> &file_list);
 // return relative error if comparing solution.
 double SingleRun(MPI_Comm comm, const std::string output_file = "");
+/*
+   Long-lived online ROM mode. Loads the reduced basis/elements and assembles the ROM operator once,
+   then answers parameter queries read from stdin, re-assembling only the RHS
+   as long as the boundary condition types do not change.
+   Solvers whose operator depends on the parameters (all but poisson) re-assemble the ROM operator per query,
+   which includes the FOM operator with model_reduction/save_operator/level: none.
+*/
+void ServeROM(MPI_Comm comm);
 
 #endif
@@ -74,6 +74,23 @@ protected:
    // MFEM solver options
    bool use_amg;
    bool direct_solve = false;
+   // number of threads for the concurrent assembly of subdomain forms.
+   int num_threads = 1;
+   // options of the iterative linear solve in Solve, compiled again when the input changes.
+   LinearSolverOptions solver_opts = LinearSolverOptions("solver", 10000, 1.e-15, 1.e-15, 0);
+
+   /*
+      Distributed linear solve over MPI_COMM_WORLD (solver/distributed).
+      Subdomains are owned by ranks contiguously in their index, [sub_begin, sub_end),
+      and the system rows are partitioned accordingly.
+      Each rank assembles only the subdomain forms, interface couplings and RHS of its own rows,
+      and the solution is gathered back on all ranks.
+      Meshes and FE spaces are still built for every subdomain on every rank.
+      Only for FOM runs of poisson/adv-diff (see ParseInputs).
+      Solution/visualization files are written by rank 0 only.
+   */
+   bool distributed_solve = false;
+   int sub_begin = 0, sub_end = 0;
 
    // Saving solution in single run
    bool save_sol = false;
@@ -131,6 +148,8 @@ public:
    Mesh* GetMesh(const int k) { return &(*meshes[k]); }
    GridFunction* GetGridFunction(const int k) { return us[k]; }
    const int GetDiscretizationOrder() const { return order; }
+   // 1 unless built with OpenMP and mfem with MFEM_THREAD_SAFE.
+   const int GetNumThreads() const { return num_threads; }
    const bool IsNonlinear() const { return nonlinear_mode; }
    const bool UseRom() const { return use_rom; }
    ROMHandlerBase* GetROMHandler() const { return rom_handler; }
@@ -139,9 +158,12 @@ public:
    const std::string GetSolutionFilePrefix() const { return sol_prefix; }
    const std::string GetVisualizationPrefix() const { return visual.prefix; }
    const TopologyHandlerMode GetTopologyMode() const { return topol_mode; }
+   // With distributed solve, the gathered solution is identical on all ranks and only rank 0 writes files.
+   const bool IsOutputRank() const { return (!distributed_solve) || (rank == 0); }
    ParaViewDataCollection* GetParaViewColl(const int &k) { return paraviewColls[k]; }
    BlockVector* GetSolution() { return U; }
    BlockVector* GetSolutionCopy() { return new BlockVector(*U); }
+   BlockVector* GetRHS() { return RHS; }
 
    void SetSolutionSaveMode(const bool save_sol_);
 
@@ -251,17 +273,95 @@ public:
    virtual void ProjectOperatorOnReducedBasis() = 0;
    virtual void ProjectRHSOnReducedBasis();
    virtual void SolveROM();
+   /*
+      Multi-RHS ROM solve for a fixed linear ROM operator.
+      Each column of RHS_cols is a global RHS vector (as assembled by AssembleRHS),
+      and the same column of U_cols is the corresponding lifted ROM solution.
+   */
+   void SolveROM(const DenseMatrix &RHS_cols, DenseMatrix &U_cols);
    virtual void SaveBasisVisualization()
    { rom_handler->SaveBasisVisualization(fes, var_names); }
 
    virtual void SetParameterizedProblem(ParameterizedProblem *problem);
 
+   /*
+      Whether the domain operators are independent of the parameterized problem,
+      as long as the boundary condition types stay the same.
+      Only then the solver can be reused over multiple samples with UpdateParameterizedProblem.
+      By default, all operators are considered parameter-dependent.
+   */
+   virtual bool IsOperatorParamIndependent() { return false; }
+
+   /*
+      Set a new parameterized problem on an already assembled solver,
+      re-assembling only the parameter-dependent RHS/BC operators.
+      The problem is set in any case.
+      Returns false if the domain operators also need to be rebuilt,
+      in which case the caller must re-assemble the operators or re-initialize the solver.
+   */
+   bool UpdateParameterizedProblem(ParameterizedProblem *problem);
+
    void ComputeSubdomainErrorAndNorm(GridFunction *fom_sol, GridFunction *rom_sol, double &error, double &norm);
    void ComputeRelativeError(Array<GridFunction *> fom_sols, Array<GridFunction *> rom_sols, Vector &error);
    void CompareSolution(BlockVector &test_U, Vector &error);
 
 protected:
    virtual void AssembleROMMat(BlockMatrix &romMat);
+
+   /*
+      Create the HypreParMatrix of the monolithic system on MPI_COMM_SELF, without distributed_solve.
+      row_starts are set as the entire row range, which should persist with the returned matrix.
+   */
+   HypreParMatrix* CreateSystemMatrix(SparseMatrix *mono, HYPRE_BigInt &glob_size, HYPRE_BigInt *row_starts) const;
+   /*
+      Create the HypreParMatrix on MPI_COMM_WORLD from the row blocks of the subdomains owned by this rank,
+      with block offsets over subdomains. Blocks of the other rows are not used, and NULL blocks are zero.
+      row_starts are set as the local row range, which should persist with the returned matrix.
+   */
+   HypreParMatrix* CreateSystemMatrix(const Array2D<SparseMatrix *> &blocks, const Array<int> &offsets,
+                                      HYPRE_BigInt &glob_size, HYPRE_BigInt *row_starts) const;
+   // Gather the locally-owned rows [row_starts[0], row_starts[1]) of x from all ranks.
+   void GatherDistributedVector(const HYPRE_BigInt *row_starts, Vector &x) const;
+
+   /*
+      Assemble the subdomain forms, concurrently over subdomains if num_threads > 1.
+      Each form only writes into its own subdomain matrix, thus no synchronization is needed.
+      One subdomain per mesh type is assembled alone first, in order to populate
+      the lazily-built global integration rules (IntRules), which are not thread-safe.
+      Only the subdomains in [begin, end) are assembled, if given (e.g. the owned ones for distributed_solve).
+   */
+   template <class FormType>
+   void AssembleSubdomainForms(Array<FormType *> &forms, const int begin = 0, int end = -1)
+   {
+      assert(forms.Size() == numSub);
+      if (end < 0) end = numSub;
+      assert((begin >= 0) && (begin <= end) && (end <= numSub));
+      Array<bool> assembled(numSub);
+      assembled = false;
+
+      if (num_threads > 1)
+      {
+         Array<int> mesh_types(0);
+         for (int m = begin; m < end; m++)
+         {
+            const int type = topol_handler->GetMeshType(m);
+            if (mesh_types.Find(type) >= 0) continue;
+
+            mesh_types.Append(type);
+            assert(forms[m]);
+            forms[m]->Assemble();
+            assembled[m] = true;
+         }
+      }
+
+      #pragma omp parallel for schedule(dynamic) num_threads(num_threads) if (num_threads > 1)
+      for (int m = begin; m < end; m++)
+      {
+         if (assembled[m]) continue;
+         assert(forms[m]);
+         forms[m]->Assemble();
+      }
+   }
 };
 
 #endif
@@ -18,176 +18,230 @@ namespace function_factory
    Time-constant functions won't use the time input in calculation.
    For time-varying systems, corresponding FunctionCoefficient
    must execuate SetTime to reflect the time.
+
+   The parameters of each function are passed in explicitly as a Params struct.
+   ParameterizedProblem owns its own Params and binds them into GeneralScalarFunction/GeneralVectorFunction,
+   so that problems (and solvers) with different parameters can coexist in one process.
 */
-typedef double GeneralScalarFunction(const Vector &, double);
-typedef void GeneralVectorFunction(const Vector &, double, Vector &);
+typedef std::function<double(const Vector &, double)> GeneralScalarFunction;
+typedef std::function<void(const Vector &, double, Vector &)> GeneralVectorFunction;
 
 static const double pi = 4.0 * atan(1.0);
 
 namespace poisson0
 {
-   extern double k;
-   extern double offset;
+   struct Params
+   {
+      double k, offset;
+   };
 
-   double rhs(const Vector &x, double t);
+   double rhs(const Params &p, const Vector &x, double t);
 }
 
 namespace poisson_component
 {
-   extern Vector k, bdr_k;
-   extern double offset, bdr_offset;
-   extern double bdr_idx;
+   struct Params
+   {
+      Vector k, bdr_k;
+      double offset, bdr_offset;
+      double bdr_idx;
+   };
 
-   double bdr(const Vector &x, double t);
-   double rhs(const Vector &x, double t);
+   double bdr(const Params &p, const Vector &x, double t);
+   double rhs(const Params &p, const Vector &x, double t);
 }
 
 namespace poisson_spiral
 {
    static const int N = 2;
-   extern double L, Lw, k, s;
-   double rhs(const Vector &x, double t);
+   struct Params
+   {
+      double L, Lw, k, s;
+   };
+
+   double rhs(const Params &p, const Vector &x, double t);
 }
 
 namespace flow_problem
 {
 
-extern double nu;
-extern double del_u;  // complementary flux to ensure incompressibility.
-extern Vector x0;
+struct Params
+{
+   double nu;
+   /*
+      complementary flux to ensure incompressibility.
+      del_u and x0 are set by StokesSolver::SetComplementaryFlux.
+   */
+   double del_u;
+   Vector x0;
+};
 
-void dir(const Vector &x, Vector &y);
-void flux(const Vector &x, Vector &y);
+void dir(const Params &p, const Vector &x, Vector &y);
+void flux(const Params &p, const Vector &x, Vector &y);
 
 namespace channel_flow
 {
-   extern double L, U, x0;
-   void ubdr(const Vector &x, double t, Vector &y);
+   struct Params
+   {
+      double L, U, x0;
+   };
+
+   void ubdr(const Params &p, const Vector &x, double t, Vector &y);
 }
 
 namespace component_flow
 {
-   extern Vector u0, du, offsets;
-   extern DenseMatrix k;
-   void ubdr(const Vector &x, double t, Vector &y);
+   struct Params
+   {
+      Vector u0, du, offsets;
+      DenseMatrix k;
+   };
+
+   void ubdr(const flow_problem::Params &fp, const Params &p, const Vector &x, double t, Vector &y);
 }
 
 namespace backward_facing_step
 {
-   extern double u0, y0, y1;
-   extern Vector amp, ky, freq, t_offset;
-   
-   void ubdr(const Vector &x, double t, Vector &y);
-   void uic(const Vector &x, double t, Vector &y);
+   struct Params
+   {
+      double u0, y0, y1;
+      Vector amp, ky, freq, t_offset;
+   };
+
+   void ubdr(const Params &p, const Vector &x, double t, Vector &y);
+   void uic(const Params &p, const Vector &x, double t, Vector &y);
    void pic(const Vector &x, double t, Vector &y);
 }
 
 namespace lid_driven_cavity
 {
-   extern double u0, L;
-   
-   void ubdr(const Vector &x, double t, Vector &y);
+   struct Params
+   {
+      double u0, L;
+   };
+
+   void ubdr(const Params &p, const Vector &x, double t, Vector &y);
 }
 
 namespace periodic_flow_past_array
 {
-   extern Vector f;
-   void force(const Vector &x, double t, Vector &y);
+   struct Params
+   {
+      Vector f;
+   };
+
+   void force(const Params &p, const Vector &x, double t, Vector &y);
 }
 
 }
 
 namespace linelast_problem
 {
-extern double _lambda;
-extern double _mu;
+struct Params
+{
+   double lambda;
+   double mu;
+};
 
-double lambda(const Vector &x, double t);
-double mu(const Vector &x, double t);
+double lambda(const Params &p, const Vector &x, double t);
+double mu(const Params &p, const Vector &x, double t);
 
 }
 
 namespace linelast_disp
 {
-extern double rdisp_f;
+struct Params
+{
+   double rdisp_f;
+};
 
-void init_disp(const Vector &x, double t, Vector &u);
+void init_disp(const Params &p, const Vector &x, double t, Vector &u);
+void init_disp_lcantilever(const Params &p, const Vector &x, double t, Vector &u);
 }
 
 namespace linelast_force
 {
-extern double rforce_f;
+struct Params
+{
+   double rforce_f;
+};
 
-void tip_force(const Vector &x, double t, Vector &u);
+void tip_force(const Params &p, const Vector &x, double t, Vector &u);
 }
 
 namespace linelast_cwtrain
+{
+struct Params
 {
    // Probabilities
-   extern double lx;
-   extern double ly;
-   extern double rx;
-   extern double ry;
-   extern double dx;
-   extern double dy;
-   extern double ux;
-   extern double uy;
-   extern double bx;
-   extern double by;
+   double lx;
+   double ly;
+   double rx;
+   double ry;
+   double dx;
+   double dy;
+   double ux;
+   double uy;
+   double bx;
+   double by;
 
    // Constant force
-   extern double l_ux;
-   extern double l_uy;
-   extern double r_fx;
-   extern double r_fy;
-   extern double u_fx;
-   extern double u_fy;
-   extern double d_fx;
-   extern double d_fy;
-   extern double b_fx;
-   extern double b_fy;
-
-// Amplitudes
-extern double xu_amp;
-extern double xf_amp;
-extern double yu_amp;
-extern double yf_amp;
-extern double bxf_amp;
-extern double byf_amp;
-
-// Frequencies
-extern double xu_freq;
-extern double xf_freq;
-extern double yu_freq;
-extern double yf_freq;
-extern double bxf_freq;
-extern double byf_freq;
-
-// Sine offsets
-extern double xu_offset;
-extern double xf_offset;
-extern double yu_offset;
-extern double yf_offset;
-extern double bxf_offset;
-extern double byf_offset;
+   double l_ux;
+   double l_uy;
+   double r_fx;
+   double r_fy;
+   double u_fx;
+   double u_fy;
+   double d_fx;
+   double d_fy;
+   double b_fx;
+   double b_fy;
+
+   // Amplitudes
+   double xu_amp;
+   double xf_amp;
+   double yu_amp;
+   double yf_amp;
+   double bxf_amp;
+   double byf_amp;
+
+   // Frequencies
+   double xu_freq;
+   double xf_freq;
+   double yu_freq;
+   double yf_freq;
+   double bxf_freq;
+   double byf_freq;
+
+   // Sine offsets
+   double xu_offset;
+   double xf_offset;
+   double yu_offset;
+   double yf_offset;
+   double bxf_offset;
+   double byf_offset;
+};
 
 double perturb_func(const double x, const double amp, const double freq, const double offset);
-void left_disp(const Vector &x, double t, Vector &u);
-void up_disp(const Vector &x, double t, Vector &u);
-void down_disp(const Vector &x, double t, Vector &u);
-void right_disp(const Vector &x, double t, Vector &u);
-void body_force(const Vector &x, double t, Vector &u);
+void left_disp(const Params &p, const Vector &x, double t, Vector &u);
+void up_disp(const Params &p, const Vector &x, double t, Vector &u);
+void down_disp(const Params &p, const Vector &x, double t, Vector &u);
+void right_disp(const Params &p, const Vector &x, double t, Vector &u);
+void body_force(const Params &p, const Vector &x, double t, Vector &u);
 }
 
 namespace linelast_frame_wind
 {
-extern double qwind_f;
-extern double density;
-extern double g;
+struct Params
+{
+   double qwind_f;
+   double density;
+   double g;
+};
 
-void wind_load(const Vector &x, double t, Vector &f);
+void wind_load(const Params &p, const Vector &x, double t, Vector &f);
 
-void gravity_load(const Vector &x, double t, Vector &f);
+void gravity_load(const Params &p, const Vector &x, double t, Vector &f);
 
 void dirichlet(const Vector &x, double t, Vector &u);
 
@@ -196,14 +250,15 @@ void dirichlet(const Vector &x, double t, Vector &u);
 namespace advdiff_problem
 {
 
-extern bool analytic_flow;
-
 namespace advdiff_flow_past_array
 {
-   extern double q0, dq, qoffset;
-   extern Vector qk;
+   struct Params
+   {
+      double q0, dq, qoffset;
+      Vector qk;
+   };
 
-   double qbdr(const Vector &x, double t);
+   double qbdr(const Params &p, const Vector &x, double t);
 }  //  namespace advdiff_flow_past_array
 
 }  // namespace advdiff_problem
@@ -229,15 +284,23 @@ protected:
    std::size_t param_num;
    std::map<std::string, int> param_map;
 
-   Array<double *> param_ptr; // address of parameters in function_factory.
+   Array<double *> param_ptr; // address of parameters in the Params of this instance.
 
 public:
    ParameterizedProblem();
 
    virtual ~ParameterizedProblem() {};
 
+   /*
+      coefficient functions are bound to the address of this instance,
+      thus a ParameterizedProblem cannot be copied.
+   */
+   ParameterizedProblem(const ParameterizedProblem &) = delete;
+   ParameterizedProblem& operator=(const ParameterizedProblem &) = delete;
+
    const std::string GetProblemName() { return problem_name; }
    const int GetNumParams() { return param_num; }
+   const double GetParam(const int k) { return *param_ptr[k]; }
    const int GetParamIndex(const std::string &name)
    {
       if (!(param_map.count(name))) printf("%s\n", name.c_str());
@@ -246,27 +309,29 @@ public:
    }
 
    // virtual member functions cannot be passed down as argument.
-   // Instead use pointers to static functions.
-   function_factory::GeneralScalarFunction *scalar_rhs_ptr = NULL;
-   Array<function_factory::GeneralScalarFunction *> scalar_bdr_ptr;
-   function_factory::GeneralVectorFunction *vector_rhs_ptr = NULL;
-   Array<function_factory::GeneralVectorFunction *> vector_bdr_ptr;
+   // Instead use functions bound to the Params of this instance.
+   // An empty function means no function is specified.
+   function_factory::GeneralScalarFunction scalar_rhs_ptr;
+   std::vector<function_factory::GeneralScalarFunction> scalar_bdr_ptr;
+   function_factory::GeneralVectorFunction vector_rhs_ptr;
+   std::vector<function_factory::GeneralVectorFunction> vector_bdr_ptr;
    Array<int> battr;
    Array<BoundaryType> bdr_type; // abstract boundary type
 
    /* initial condition for time-dependent problem */
    /* size with number of variables */
-   Array<function_factory::GeneralVectorFunction *> ic_ptr;
+   std::vector<function_factory::GeneralVectorFunction> ic_ptr;
 
-   Array<function_factory::GeneralScalarFunction *> general_scalar_ptr;
-   Array<function_factory::GeneralVectorFunction *> general_vector_ptr;
+   std::vector<function_factory::GeneralScalarFunction> general_scalar_ptr;
+   std::vector<function_factory::GeneralVectorFunction> general_vector_ptr;
 
    // TODO: use variadic function? what would be the best format?
    // TODO: support other datatypes such as integer?
    virtual void SetParams(const std::string &key, const double &value);
    virtual void SetParams(const Array<int> &indexes, const Vector &values);
 
-   void SetSingleRun();
+   /* parameters are read from single_run/<problem_name> of parser */
+   void SetSingleRun(InputParser &parser = config);
 };
 
 class PoissonProblem : public ParameterizedProblem
@@ -279,6 +344,9 @@ public:
 
 class Poisson0 : public PoissonProblem
 {
+protected:
+   function_factory::poisson0::Params params;
+
 public:
    Poisson0();
    virtual ~Poisson0() {};
@@ -286,6 +354,9 @@ public:
 
 class PoissonComponent : public PoissonProblem
 {
+protected:
+   function_factory::poisson_component::Params params;
+
 public:
    PoissonComponent();
    virtual ~PoissonComponent() {};
@@ -298,6 +369,9 @@ private:
 
 class PoissonSpiral : public PoissonProblem
 {
+protected:
+   function_factory::poisson_spiral::Params params;
+
 public:
    PoissonSpiral();
    virtual ~PoissonSpiral() {};
@@ -307,12 +381,19 @@ class FlowProblem : public ParameterizedProblem
 {
 friend class StokesSolver;
 
+protected:
+   // viscosity and complementary flux shared by all flow problems.
+   function_factory::flow_problem::Params flow_params;
+
 public:
    virtual ~FlowProblem() {};
 };
 
 class ChannelFlow : public FlowProblem
 {
+protected:
+   function_factory::flow_problem::channel_flow::Params params;
+
 public:
    ChannelFlow();
    virtual ~ChannelFlow() {};
@@ -320,6 +401,9 @@ public:
 
 class ComponentFlow : public FlowProblem
 {
+protected:
+   function_factory::flow_problem::component_flow::Params params;
+
 public:
    ComponentFlow();
 };
@@ -341,6 +425,9 @@ protected:
 
 class BackwardFacingStep : public FlowProblem
 {
+protected:
+   function_factory::flow_problem::backward_facing_step::Params params;
+
 public:
    BackwardFacingStep();
    virtual ~BackwardFacingStep() {};
@@ -348,6 +435,9 @@ public:
 
 class LidDrivenCavity : public FlowProblem
 {
+protected:
+   function_factory::flow_problem::lid_driven_cavity::Params params;
+
 public:
    LidDrivenCavity();
    virtual ~LidDrivenCavity() {};
@@ -355,6 +445,9 @@ public:
 
 class PeriodicFlowPastArray : public FlowProblem
 {
+protected:
+   function_factory::flow_problem::periodic_flow_past_array::Params params;
+
 public:
    PeriodicFlowPastArray();
 };
@@ -371,70 +464,79 @@ class LinElastProblem : public ParameterizedProblem
 friend class LinElastSolver;
 
 protected:
-   Vector lambda, mu;
+   function_factory::linelast_problem::Params material;
 
 public:
    virtual ~LinElastProblem() {};
 };
+
 class LinElastDisp : public LinElastProblem
 {
+protected:
+   function_factory::linelast_disp::Params params;
+
 public:
    LinElastDisp();
 };
 
 class LinElastDispLCantilever : public LinElastProblem
 {
+protected:
+   function_factory::linelast_disp::Params params;
+
 public:
    LinElastDispLCantilever();
 };
 
 class LinElastDispLattice : public LinElastProblem
 {
+protected:
+   function_factory::linelast_disp::Params params;
+
 public:
    LinElastDispLattice();
 };
 
 class LinElastForceCantilever : public LinElastProblem
 {
+protected:
+   function_factory::linelast_force::Params params;
+   // displacement on the clamped boundary.
+   function_factory::linelast_disp::Params disp_params;
+
 public:
    LinElastForceCantilever();
 };
 
 class LinElastFrameWind : public LinElastProblem
 {
+protected:
+   function_factory::linelast_frame_wind::Params params;
+
 public:
    LinElastFrameWind();
 };
 
-namespace function_factory
-{
-
-namespace advdiff_problem
-{
-/*
-   flow_problem will be passed down to StokesSolver/SteadyNSSolver for obtaining velocity field.
-   It must be set appropriately within each AdvDiffSolver problems.
-*/
-extern FlowProblem *flow_problem;
-
-}  // namespace advdiff_problem
-
-}  // namespace function_factory
-
 class AdvDiffFlowPastArray : public FlowPastArray
 {
 protected:
    /*
-      flow_problem shares the same pointers with this class.
+      flow parameters of this class point to the Params of flow_problem.
       Thus every parameter set by this class is reflected to FlowPastArrayProblem as well.
       flow_problem will be passed down to StokesSolver/SteadyNSSolver for obtaining velocity field.
    */
    FlowPastArray *flow_problem = NULL;
 
+   function_factory::advdiff_problem::advdiff_flow_past_array::Params advdiff_params;
+
 public:
    AdvDiffFlowPastArray();
    virtual ~AdvDiffFlowPastArray();
 
+   // if true, the velocity field is given analytically and flow_problem is not solved.
+   bool analytic_flow = false;
+   FlowProblem* GetFlowProblem() { return flow_problem; }
+
 protected:
    void SetBattr() override
    {
@@ -445,6 +547,9 @@ protected:
 
 class LinElastComponentWiseTrain : public LinElastProblem
 {
+protected:
+   function_factory::linelast_cwtrain::Params params;
+
 public:
    LinElastComponentWiseTrain();
 };
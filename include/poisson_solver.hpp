@@ -100,6 +100,19 @@ public:
 
    virtual void SetParameterizedProblem(ParameterizedProblem *problem);
 
+   // Diffusion operator does not depend on the problem parameters.
+   bool IsOperatorParamIndependent() override { return true; }
+
+   // Number of system matrix blocks assembled on this rank. With distributed solve, only the owned rows.
+   const int GetNumAssembledBlocks() const
+   {
+      int num_blocks = 0;
+      for (int i = 0; i < mats.NumRows(); i++)
+         for (int j = 0; j < mats.NumCols(); j++)
+            if (mats(i, j)) num_blocks++;
+      return num_blocks;
+   }
+
 protected:
    virtual void SetMUMPSSolver();
 };
@@ -24,9 +24,9 @@ public:
    // Generate parameter space as listed in sample_generation/problem_name.
    virtual void SetParamSpaceSizes() override;
 
-   virtual void SetSampleParams(const int &index);
-   virtual void SetSampleParams(const Array<int> &index)
-   { SetSampleParams(GetSampleIndex(index)); }
+   virtual void SetSampleParams(const int &index, InputParser &parser = config);
+   virtual void SetSampleParams(const Array<int> &index, InputParser &parser = config)
+   { SetSampleParams(GetSampleIndex(index), parser); }
 
    // Determine the given index is assigned to the current process.
    virtual const int GetSampleIndex(const Array<int> &index);
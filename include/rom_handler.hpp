@@ -12,6 +12,7 @@
 #include "topology_handler.hpp"
 #include "linalg_utils.hpp"
 #include "hdf5_utils.hpp"
+#include "block_smoother.hpp"
 
 namespace mfem
 {
@@ -186,6 +187,15 @@ public:
 
    virtual void Solve(BlockVector &rhs, BlockVector &sol) = 0;
    virtual void Solve(BlockVector* U) = 0;
+
+   /*
+      Multi-RHS counterparts for a fixed operator, e.g. parameter sweeps over forcing/boundary data.
+      Each column is one global FOM vector (ordered as in ProjectGlobalToDomainBasis)
+      or one reduced vector.
+   */
+   virtual void ProjectGlobalToDomainBasis(const DenseMatrix &vecs, DenseMatrix &rom_vecs) = 0;
+   virtual void LiftUpGlobal(const DenseMatrix &rom_vecs, DenseMatrix &vecs) = 0;
+   virtual void Solve(const DenseMatrix &rhs, DenseMatrix &sol) = 0;
    virtual void NonlinearSolve(Operator &oper, BlockVector* U, Solver *prec=NULL) = 0;   
 
    virtual void SaveOperator(const std::string filename) = 0;
@@ -201,6 +211,24 @@ public:
    virtual void AppendReferenceBasis(const int &idx, const DenseMatrix &mat) = 0;
 };
 
+/*
+   Options of the ROM solve: the "solver" options and
+   the ROM preconditioner, nonlinear solver type and dense LU size limit.
+*/
+class ROMSolverOptions : public IterativeSolverOptions
+{
+protected:
+   void Compile(InputParser &parser) override;
+
+public:
+   std::string prec_str = "none";
+   std::string nlin_solver = "newton";
+   int dense_lu_max = 200;
+
+   ROMSolverOptions()
+      : IterativeSolverOptions("solver", 10000, 1.e-15, 1.e-15, 0) {}
+};
+
 class MFEMROMHandler : public ROMHandlerBase
 {
 protected:
@@ -208,6 +236,7 @@ protected:
    enum SolverType
    {
       DIRECT,
+      BLOCK_DIRECT,  // block-sparse dense LU, without assembling the monolithic matrix.
       CG,
       MINRES,
       GMRES,
@@ -215,6 +244,10 @@ protected:
    } linsol_type;
    MUMPSSolver::MatType mat_type;
 
+   // solver options, compiled again only when the input changes, instead of at every solve.
+   ROMSolverOptions solver_opts;
+   NonlinearSolverOptions nlin_opts;
+
    // component rom variables.
    Array<DenseMatrix*> ref_basis;
 
@@ -229,6 +262,7 @@ protected:
    HYPRE_BigInt sys_row_starts[2];
    HypreParMatrix *romMat_hypre = NULL;
    MUMPSSolver *mumps = NULL;
+   BlockDenseLUSolver *block_lu = NULL;
 
 public:
    MFEMROMHandler(TopologyHandler *input_topol, const Array<int> &input_var_offsets,
@@ -269,6 +303,10 @@ public:
    
    void Solve(BlockVector &rhs, BlockVector &sol) override;
    void Solve(BlockVector* U) override;
+
+   virtual void ProjectGlobalToDomainBasis(const DenseMatrix &vecs, DenseMatrix &rom_vecs) override;
+   virtual void LiftUpGlobal(const DenseMatrix &rom_vecs, DenseMatrix &vecs) override;
+   void Solve(const DenseMatrix &rhs, DenseMatrix &sol) override;
    void NonlinearSolve(Operator &oper, BlockVector* U, Solver *prec=NULL) override;
 
    virtual void SaveOperator(const std::string input_prefix="");
@@ -290,6 +328,8 @@ private:
    // void GetBlockSparsity(const SparseMatrix *mat, const Array<int> &block_offsets, Array2D<bool> &mat_zero_blocks);
    // bool CheckZeroBlock(const DenseMatrix &mat);
    void SetupDirectSolver();
+   // offsets of the global FOM vector blocks, in the order of ProjectGlobalToDomainBasis.
+   void GetGlobalFOMOffsets(Array<int> &fom_offsets);
 };
 
 
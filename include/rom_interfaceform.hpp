@@ -59,6 +59,13 @@ protected:
    /// @brief Energy norm criterion for NNLS.
    CAROM::NNLS_termination nnls_criterion = CAROM::NNLS_termination::L2;
 
+   /*
+      If true, each EQP system is distributed over all processes by interfaces.
+      Otherwise, the whole EQP system is built and solved on the calling process alone,
+      so that independent reference ports can be trained on different processes.
+   */
+   bool distributed_eqp = true;
+
 public:
    ROMInterfaceForm(Array<Mesh *> &meshes_, Array<FiniteElementSpace *> &fes_,
                     Array<FiniteElementSpace *> &comp_fes_, TopologyHandler *topol_);
@@ -110,8 +117,14 @@ public:
 
    void InterfaceGetGradient(const Vector &x, Array2D<SparseMatrix *> &mats) const override;
 
+   void SetDistributedEQP(const bool distributed_) { distributed_eqp = distributed_; }
+
    void TrainEQPForRefPort(const int p, const CAROM::Matrix &snapshot1, const CAROM::Matrix &snapshot2,
                            const Array2D<int> &snap_pair_idx, const double eqp_tol);
+   /* Number of rows of Gt over all integrators at the reference port p. */
+   const int GetEQPSystemSizeForRefPort(const int p);
+   /* Broadcast the EQP samples at the reference port p trained on the root process. */
+   void BroadcastEQPForRefPort(const int p, const int root);
 
    void SetupEQPSystem(const CAROM::Matrix &snapshot1, const CAROM::Matrix &snapshot2,
                        const Array2D<int> &snap_pair_idx,
@@ -44,9 +44,26 @@ protected:
    /// @brief Flag for precomputing necessary coefficients for fast computation.
    bool precompute = false;
 
+   /*
+      Number of threads for EQP evaluation in precompute mode (model_reduction/eqp/num_threads).
+      With deterministic mode, EQP samples are statically partitioned over threads,
+      so that the result is bitwise reproducible for a fixed number of threads.
+      Otherwise samples are dynamically scheduled for load balance.
+      Only domain integrators are threaded, and only with OpenMP and mfem built with MFEM_THREAD_SAFE.
+   */
+   int num_threads = 1;
+   bool deterministic = true;
+
    /// @brief Energy norm criterion for NNLS.
    CAROM::NNLS_termination nnls_criterion = CAROM::NNLS_termination::L2;
 
+   /*
+      If true, each EQP system is distributed over all processes by elements.
+      Otherwise, the whole EQP system is built and solved on the calling process alone,
+      so that independent EQP systems can be trained on different processes.
+   */
+   bool distributed_eqp = true;
+
    /*
       Flag for being reference ROMNonlinearForm.
       If not reference, all EQPElement arrays are view arrays, not owning them.
@@ -71,7 +88,23 @@ public:
 
    void SetBasis(DenseMatrix &basis_, const int offset=0);
 
+   void SetDistributedEQP(const bool distributed_) { distributed_eqp = distributed_; }
+
    void TrainEQP(const CAROM::Matrix &snapshots, const double eqp_tol = 1.0e-2);
+   /*
+      Train the EQP of the k-th integrator of the given type alone.
+      snapshots must not be distributed, i.e. already gathered.
+      Each integrator has an independent EQP system, so each can be trained on a different process.
+   */
+   void TrainEQPForIntegrator(const IntegratorType type, const int k,
+                              const CAROM::Matrix &snapshots, const double eqp_tol = 1.0e-2);
+   const int GetNumIntegrators(const IntegratorType type) const;
+   /* Number of rows of Gt over all integrators, i.e. candidate quadrature points. */
+   const int GetEQPSystemSize();
+   const int GetEQPSystemSize(const IntegratorType type, const int k);
+   /* Broadcast the EQP samples of all integrators trained on the root process. */
+   void BroadcastEQP(const int root);
+   void BroadcastEQPForIntegrator(const IntegratorType type, const int k, const int root);
    void TrainEQPForIntegrator(HyperReductionIntegrator *nlfi, const CAROM::Matrix &Gt,
                               const CAROM::Vector &rhs_Gw, const double eqp_tol,
                               Array<SampleInfo> &samples);
@@ -232,6 +265,16 @@ public:
    virtual Operator &GetGradient(const Vector &x) const;
 
 private:
+   /*
+      Threaded evaluation of a domain integrator over its EQP samples, in precompute mode.
+      Each thread accumulates into its own private y/jac,
+      which are then summed in the thread order.
+   */
+   void AddDomainVectorThreaded(HyperReductionIntegrator *nlfi, EQPElement *eqp_elem,
+                                const Vector &x, Vector &y) const;
+   void AddDomainGradThreaded(HyperReductionIntegrator *nlfi, EQPElement *eqp_elem,
+                              const Vector &x, DenseMatrix &jac) const;
+
    void PrecomputeDomainEQPSample(const IntegrationRule &ir, const DenseMatrix &basis, EQPSample &eqp_sample);
    void PrecomputeFaceEQPSample(const IntegrationRule &ir, const DenseMatrix &basis,
                                 FaceElementTransformations *T, EQPSample &eqp_sample);
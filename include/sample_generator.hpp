@@ -30,13 +30,93 @@ struct PortTag
 
 bool operator<(const PortTag &tag1, const PortTag &tag2);
 
+/*
+   Snapshots of a basis tag, streamed into a chunked HDF5 dataset as they arrive.
+   Only the snapshot being appended is held in memory.
+   The file is written per process, at GetFilename(prefix, rank).
+   The global sample index of each column is written in the sample_index dataset,
+   by which the columns of all processes are ordered when collected (see OrderBySample).
+   The ranks that wrote a file are listed in the manifest at GetManifestFilename(prefix),
+   which is the only file the reader probes for.
+*/
+class SnapshotStream
+{
+protected:
+   std::string prefix;
+   hid_t file_id = -1;
+   hid_t dset_id = -1;
+   int nrow = -1;
+   int ncol = 0;
+   Array<int> sample_idxs;
+
+public:
+   SnapshotStream(const std::string &prefix_, const int &rank, const int &nrow_);
+
+   virtual ~SnapshotStream() { Close(); }
+
+   static const std::string GetFilename(const std::string &prefix, const int &rank)
+   { return prefix + ".stream." + std::to_string(rank) + ".h5"; }
+   static const std::string GetManifestFilename(const std::string &prefix)
+   { return prefix + ".stream.h5"; }
+
+   static void WriteManifest(const std::string &prefix, const Array<int> &ranks);
+   // ranks of the stream files. Errors if any of the files is missing.
+   static void ReadManifest(const std::string &prefix, Array<int> &ranks);
+   /*
+      Global column order over the files, given the sample indices of the columns of each file.
+      Columns are sorted by their sample index. Columns of the same sample keep the file order,
+      and then the order they were appended in.
+      (src_file[g], src_col[g]) is the file and its column of the global column g.
+   */
+   static void OrderBySample(const std::vector<Array<int>> &samples, Array<int> &src_file, Array<int> &src_col);
+
+   const std::string GetPrefix() { return prefix; }
+
+   const int GetNumSnapshots() { return ncol; }
+   const Array<int>& GetSampleIndices() { return sample_idxs; }
+
+   // sample is the global sample index of the snapshot, or -1 if unknown.
+   void Append(const Vector &snapshot, const int &sample = -1);
+   void Close();
+};
+
 class SampleGenerator
 {
 protected:
+   MPI_Comm sample_comm;
    int num_procs;
    int proc_rank;
    Array<int> sample_offsets;
 
+   /*
+      Scheduling of the samples over processes in GenerateSamples (sample_generation/scheduler).
+         - static: each process takes its contiguous block of samples from DistributeSamples.
+         - dynamic: samples are handed out on demand from a counter on rank 0,
+                    which is incremented with MPI one-sided atomics. Processes with faster samples take more.
+                    Process r first takes the sample r, so that every process has at least one sample.
+      Either way, the files of a sample are named by its index, not by the process that solved it.
+      NOTE: the dynamic queue relies on passive-target progress of the counter on rank 0,
+      which depends on the MPI implementation. Without asynchronous progress
+      (e.g. MPICH with MPIR_CVAR_ASYNC_PROGRESS=0, or Open MPI over some transports),
+      a fetch may wait until rank 0 enters the MPI library, i.e. until rank 0 finishes its current sample.
+      Samples are still handed out exactly once, but every process may then stall on each fetch
+      for up to one sample of rank 0, which can make the schedule worse than the static one.
+      Enable asynchronous progress of the MPI library, or use the static scheduler, in that case.
+   */
+   enum ScheduleType
+   {
+      STATIC_SCHEDULE,
+      DYNAMIC_SCHEDULE,
+      NUM_SCHEDULE_TYPE
+   } schedule_type = DYNAMIC_SCHEDULE;
+   MPI_Win queue_win = MPI_WIN_NULL;
+   int *queue_counter = NULL;    // only allocated on rank 0.
+   int queue_next = -1;          // next sample of the static block, or the first dynamic sample.
+   int num_taken_samples = 0;
+   double queue_start_time = 0.0;
+   // global index of the sample being solved, recorded with its snapshot columns.
+   int current_sample = -1;
+
    // input path for parameter list
    std::string param_list_str;
 
@@ -60,6 +140,16 @@ protected:
    const bool incremental = false;
    Array<CAROM::Options*> snapshot_options;
    Array<CAROM::BasisGenerator*> snapshot_generators;
+   // whether the generator uses an incremental SVD, which does not keep the snapshot matrix.
+   Array<bool> incremental_svds;
+   /*
+      If stream_snapshots, snapshots are streamed into files instead of snapshot_generators,
+      which are NULL for streamed basis tags.
+      Streamed snapshot files are read back in blocks of collect_block_size columns.
+   */
+   bool stream_snapshots = false;
+   int collect_block_size = 32;
+   Array<SnapshotStream*> snapshot_streams;
    // each snapshot will be sorted out by its basis tag.
    std::vector<BasisTag> basis_tags;
    std::map<BasisTag, int> basis_tag2idx;
@@ -90,9 +180,10 @@ public:
    // Generate parameter space as listed in sample_generation/problem_name.
    virtual void SetParamSpaceSizes();
 
-   virtual void SetSampleParams(const int &index);
-   virtual void SetSampleParams(const Array<int> &index)
-   { SetSampleParams(GetSampleIndex(index)); }
+   // Sample parameters are written to parser, which can be a copy of config for a private sample.
+   virtual void SetSampleParams(const int &index, InputParser &parser = config);
+   virtual void SetSampleParams(const Array<int> &index, InputParser &parser = config)
+   { SetSampleParams(GetSampleIndex(index), parser); }
 
    // Determine the given index is assigned to the current process.
    void DistributeSamples();
@@ -103,17 +194,42 @@ public:
    bool IsMyJob(const int &index)
    { return ((index >= sample_offsets[proc_rank]) && (index < sample_offsets[proc_rank+1])); }
 
+   // Sample queue for GenerateSamples. Start/Finish are collective over the communicator.
+   void StartSampleQueue();
+   // next sample index for this process, or -1 if no sample is left. It is also set as the current sample.
+   const int GetNextSample();
+   // for the snapshots saved outside of the sample queue.
+   void SetCurrentSample(const int &index) { current_sample = index; }
+   /*
+      Close the queue, and report on rank 0 the number of samples, busy/idle time and utilization of each process.
+      busy_time is the time this process spent on its samples.
+   */
+   void FinishSampleQueue(const double &busy_time);
+
    const std::string GetSamplePath(const int& idx, const std::string &prefix = "");
 
    /*
-      Save each block of U_snapshots according to snapshot_basis_tags.
+      Save each block of U_snapshots according to snapshot_basis_tags, as the columns of the current sample.
       Number of blocks in U_snapshots must be equal to the size of snapshot_basis_tags.
       The appended column indices of each basis tag are stored in col_idxs.
    */
    void SaveSnapshot(BlockVector *U_snapshots, std::vector<BasisTag> &snapshot_basis_tags, Array<int> &col_idxs);
    void SaveSnapshotPorts(TopologyHandler *topol_handler, const Array<int> &col_idxs);
-   void AddSnapshotGenerator(const int &fom_vdofs, const std::string &prefix, const BasisTag &basis_tag);
+   /*
+      With svd_options, the SVD type of basis_tag (see SetSVDOptions) is set on the generator,
+      which is then used for FormReducedBasis.
+   */
+   void AddSnapshotGenerator(const int &fom_vdofs, const std::string &prefix, const BasisTag &basis_tag,
+                             const bool svd_options = false);
+   void AddSnapshotStream(const int &fom_vdofs, const std::string &prefix, const BasisTag &basis_tag);
+   const int GetNumSnapshots(const int &index);
+   // Collective over sample_comm, for the manifests of the streamed snapshots.
    void WriteSnapshots();
+   /*
+      Collective over sample_comm. The port column indices of all processes are gathered on rank 0,
+      translated into the global columns in the order the snapshots are collected,
+      and written in a single port file.
+   */
    void WriteSnapshotPorts();
    std::shared_ptr<const CAROM::Matrix> LookUpSnapshot(const BasisTag &basis_tag);
    Array2D<int>* LookUpSnapshotPortColOffsets(const PortTag &port_tag);
@@ -140,6 +256,30 @@ public:
 
 private:
    const int GetDimFromSnapshots(const std::string &filename);
+   // Rank 0 writes the manifest of every streamed basis tag, listing the ranks that streamed it.
+   void WriteStreamManifests();
+   // Gather the string of each process on rank 0, in the rank order. lists is empty on the other ranks.
+   void GatherStrings(const std::string &local, std::vector<std::string> &lists);
+   // Load the streamed snapshot files of filename into basis_generator in the sample order, in column blocks.
+   void LoadSnapshotStreams(const std::string &filename, const int &local_num_vdofs,
+                            CAROM::BasisGenerator *basis_generator);
+   // Tag-specific input in basis/tags. Returns a null node if not specified.
+   YAML::Node GetBasisTagInput(const BasisTag &basis_tag);
+   const int GetNumBasis(const BasisTag &basis_tag);
+   /*
+      Set the SVD type of basis_tag from basis/svd/type, or svd/type of its input in basis/tags.
+         - static: full SVD of the snapshot matrix (default).
+         - randomized: randomized range-finder SVD with (number_of_basis + oversampling) random vectors.
+         - incremental: incremental SVD updated with each collected snapshot,
+                        which does not keep the snapshot matrix.
+   */
+   void SetSVDOptions(const BasisTag &basis_tag, CAROM::Options &options, bool &incremental_svd);
+   /*
+      The randomized SVD needs (number_of_basis + oversampling) no larger than the number of snapshots,
+      which is known only after collecting them.
+      Otherwise the snapshots of index are moved into a static SVD generator, which gives the exact spectrum.
+   */
+   void CheckRandomizedSVD(const int &index, const std::string &basis_prefix);
    // Save all singular value spectrum. Calculate the coverage for ref_num_basis (optional).
    void SaveSV(CAROM::BasisGenerator *basis_generator, const std::string& prefix, const int &ref_num_basis = -1);
 
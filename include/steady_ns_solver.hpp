@@ -80,6 +80,15 @@ public:
 
    virtual void Mult(const Vector &x, Vector &y) const = 0;
    virtual Operator &GetGradient(const Vector &x) const = 0;
+
+protected:
+   /*
+      The sparsity pattern of the jacobian is fixed as that of linearOp.
+      jac_mono is allocated only once, and its values are reset to linearOp in place.
+   */
+   void ResetJacobian() const;
+   // Wraps jac_mono for the direct solver, if needed.
+   Operator& FinalizeJacobian() const;
 };
 
 class SteadyNSTensorROM : public SteadyNSROM
@@ -87,11 +96,19 @@ class SteadyNSTensorROM : public SteadyNSROM
 protected:
    Array<DenseTensor *> hs; // not owned by SteadyNSTensorROM.
 
+   /*
+      Subdomains grouped by their reference tensor.
+      In component mode, subdomains of the same component share one tensor,
+      which is contracted against all of their states at once.
+   */
+   Array<DenseTensor *> group_hs; // not owned by SteadyNSTensorROM.
+   Array<Array<int> *> group_subdomains;
+   mutable DenseMatrix x_batch, y_batch;
+
 public:
-   SteadyNSTensorROM(ROMHandlerBase *rom_handler, Array<DenseTensor *> &hs_, const bool direct_solve_=true)
-      : SteadyNSROM(hs_.Size(), rom_handler, direct_solve_), hs(hs_) {}
+   SteadyNSTensorROM(ROMHandlerBase *rom_handler, Array<DenseTensor *> &hs_, const bool direct_solve_=true);
 
-   virtual ~SteadyNSTensorROM() {}
+   virtual ~SteadyNSTensorROM();
 
    virtual void Mult(const Vector &x, Vector &y) const;
    virtual Operator &GetGradient(const Vector &x) const;
@@ -157,6 +174,8 @@ protected:
    Solver *J_solver = NULL;
    GMRESSolver *J_gmres = NULL;
    NewtonSolver *newton_solver = NULL;
+   // options of the Newton solve, compiled again only when the input changes.
+   NonlinearSolverOptions nlin_opts;
 
 public:
    SteadyNSSolver();
@@ -198,6 +217,20 @@ private:
    void AssembleROMTensorOper();
 
    void AllocateROMEQPElems();
+   /*
+      Schedule the independent EQP NNLS problems over the processes, balanced by their estimated sizes.
+      Each integrator (domain, interior face, boundary face) of each component,
+      and each reference port, is a separate task.
+   */
+   void TrainROMEQPElemsByTask(SampleGenerator *sample_generator, const double eqp_tol);
+   /*
+      EQP file format version.
+         1 (no attribute): EQ points/weights only.
+         2: precomputed coefficients of EQP samples as well.
+         3: basis fingerprint of the precomputed coefficients as well.
+      Coefficients without a fingerprint are computed again at loading.
+   */
+   static const int eqp_format_version = 3;
    void SaveEQPElems(const std::string &filename);
    void LoadEQPElems(const std::string &filename);
    void AssembleROMEQPOper();
@@ -200,7 +200,8 @@ public:
    virtual void SetParameterizedProblem(ParameterizedProblem *problem) override;
 
    // to ensure incompressibility for the problems with all velocity dirichlet bc.
-   void SetComplementaryFlux(const Array<bool> nz_dbcs);
+   // the complementary flux is set on the flow_params of the problem.
+   void SetComplementaryFlux(const Array<bool> nz_dbcs, function_factory::flow_problem::Params &flow_params);
 
    void EnrichSupremizer();
 
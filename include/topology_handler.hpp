@@ -51,6 +51,21 @@ struct TopologyData {
    Array<int> *global_bdr_attributes = NULL;
 };
 
+/*
+   Face element transformations of all interfaces within a port.
+   They are copied out of the meshes once, so that the interface
+   operators do not rebuild them from the mesh face information at every call.
+   tr1/tr2 refer to the adjacent element transformations elem1/elem2, owned here as well.
+*/
+struct PortTransformations {
+   int sub1 = -1, sub2 = -1;  // subdomain indexes of the port, whose meshes the transformations are built from.
+   Array<FaceElementTransformations *> tr1, tr2;
+   Array<IsoparametricTransformation *> elem1, elem2;
+
+   PortTransformations(const int s1, const int s2, const int num_itf);
+   ~PortTransformations();
+};
+
 const TopologyHandlerMode SetTopologyHandlerMode();
 
 class TopologyHandler
@@ -77,12 +92,18 @@ protected:
    Array<PortInfo> port_infos;
    Array<Array<InterfaceInfo>*> interface_infos;
 
+   // Cached interface transformations for each port, keyed by the port index. built at the first request.
+   Array<PortTransformations *> port_trs;
+
+   // Subdomain mesh k if it is already built, otherwise NULL. Does not build the mesh.
+   virtual Mesh* GetBuiltMesh(const int k) { return GetMesh(k); }
+
 public:
    TopologyHandler(const TopologyHandlerMode &input_type);
 
    // ownership of interface_infos changes depending on derived classes.
    // not deleting here.
-   virtual ~TopologyHandler() {}
+   virtual ~TopologyHandler();
 
    // access
    const TopologyHandlerMode GetType() { return type; }
@@ -133,6 +154,19 @@ public:
                                              FaceElementTransformations* &tr1,
                                              FaceElementTransformations* &tr2);
 
+   /*
+      Same as above, for the itf-th interface of the port p in the global configuration.
+      The transformations are built once from the subdomain meshes of the port and reused afterward.
+      Returned transformations are owned by TopologyHandler.
+      If m1/m2 are not the subdomain meshes of the port, falls back to GetInterfaceTransformations.
+   */
+   void GetPortInterfaceTransformations(Mesh *m1, Mesh *m2, const int &p, const int &itf,
+                                        FaceElementTransformations* &tr1,
+                                        FaceElementTransformations* &tr2);
+   // Invalidate the cached interface transformations of the ports on subdomain m (all ports if m < 0),
+   // when the subdomain meshes are (re-)built.
+   void ClearInterfaceTransformations(const int m = -1);
+
    virtual void TransferToGlobal(Array<GridFunction*> &us, Array<GridFunction*> &global_u, const int &num_var) = 0;
 
    virtual void PrintPortInfo(const int k = -1);
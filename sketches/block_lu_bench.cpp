@@ -0,0 +1,139 @@
+// Copyright 2023 Lawrence Livermore National Security, LLC. See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: MIT
+
+// Latency of BlockDenseLUSolver against MUMPS on a ROM-like block system:
+// an nx x ny array of subdomains, each a dense block coupled with its four neighbors.
+// With -saddle, each subdomain also has a pressure block with a zero diagonal tile.
+
+#include <fstream>
+#include <iostream>
+#include "mfem.hpp"
+#include "block_smoother.hpp"
+#include "etc.hpp"
+
+using namespace mfem;
+
+int main(int argc, char *argv[])
+{
+   MPI_Init(&argc, &argv);
+
+   int nx = 40, ny = 25;
+   int nbasis = 30, pbasis = 10;
+   int repeat = 10;
+   bool saddle = false;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&nx, "-nx", "--nx", "Number of subdomains in x.");
+   args.AddOption(&ny, "-ny", "--ny", "Number of subdomains in y.");
+   args.AddOption(&nbasis, "-nb", "--num-basis", "Number of basis per subdomain block.");
+   args.AddOption(&pbasis, "-np", "--num-pres-basis", "Number of pressure basis per subdomain, with -saddle.");
+   args.AddOption(&repeat, "-r", "--repeat", "Number of repeated solves.");
+   args.AddOption(&saddle, "-saddle", "--saddle-point", "-no-saddle", "--no-saddle-point",
+                  "Add zero-diagonal pressure blocks.");
+   args.ParseCheck();
+
+   const int nsub = nx * ny;
+   const int vars = (saddle) ? 2 : 1;
+   const int nblocks = vars * nsub;
+   Array<int> block_offsets(nblocks + 1);
+   block_offsets[0] = 0;
+   for (int m = 0; m < nsub; m++)
+   {
+      block_offsets[vars * m + 1] = nbasis;
+      if (saddle) block_offsets[vars * m + 2] = pbasis;
+   }
+   block_offsets.PartialSum();
+
+   auto neighbors = [nx, ny](const int m1, const int m2)
+   {
+      const int dx = abs(m1 % nx - m2 % nx), dy = abs(m1 / nx - m2 / nx);
+      return (dx + dy <= 1);
+   };
+
+   Array2D<SparseMatrix *> mats(nblocks, nblocks);
+   mats = NULL;
+   for (int i = 0; i < nblocks; i++)
+      for (int j = 0; j < nblocks; j++)
+      {
+         const bool vel_i = (i % vars == 0), vel_j = (j % vars == 0);
+         const int mi = i / vars, mj = j / vars;
+         if (vel_i && vel_j && !neighbors(mi, mj)) continue;
+         if ((vel_i != vel_j) && (mi != mj)) continue;
+         if (!vel_i && !vel_j) continue;
+
+         mats(i, j) = new SparseMatrix(block_offsets[i+1] - block_offsets[i],
+                                       block_offsets[j+1] - block_offsets[j]);
+         for (int ii = 0; ii < mats(i, j)->NumRows(); ii++)
+            for (int jj = 0; jj < mats(i, j)->NumCols(); jj++)
+            {
+               double val = UniformRandom();
+               if ((i == j) && (ii == jj)) val += 1.0e1 * nbasis;
+               mats(i, j)->Set(ii, jj, val);
+            }
+         mats(i, j)->Finalize();
+      }
+
+   BlockMatrix M(block_offsets);
+   for (int i = 0; i < nblocks; i++)
+      for (int j = 0; j < nblocks; j++)
+         if (mats(i, j)) M.SetBlock(i, j, mats(i, j));
+   SparseMatrix *M_mono = M.CreateMonolithic();
+
+   Vector x(block_offsets.Last()), y_block(block_offsets.Last()), y_mumps(block_offsets.Last());
+   for (int k = 0; k < x.Size(); k++)
+      x(k) = UniformRandom();
+
+   printf("subdomains: %d, blocks: %d, system size: %d, nonzeros: %d\n",
+          nsub, nblocks, M_mono->NumRows(), M_mono->NumNonZeroElems());
+
+   StopWatch chrono;
+
+   /* block dense LU */
+   BlockDenseLUSolver block_lu(block_offsets);
+   chrono.Clear();
+   chrono.Start();
+   for (int r = 0; r < repeat; r++)
+      block_lu.SetOperator(M);
+   chrono.Stop();
+   const double block_setup = chrono.RealTime() / repeat;
+
+   chrono.Clear();
+   chrono.Start();
+   for (int r = 0; r < repeat; r++)
+      block_lu.Mult(x, y_block);
+   chrono.Stop();
+   const double block_solve = chrono.RealTime() / repeat;
+
+   /* MUMPS, as set up in MFEMROMHandler::SetupDirectSolver */
+   HYPRE_BigInt glob_size = M_mono->NumRows();
+   HYPRE_BigInt row_starts[2] = {0, M_mono->NumRows()};
+   HypreParMatrix M_hypre(MPI_COMM_SELF, glob_size, row_starts, M_mono);
+   MUMPSSolver mumps(MPI_COMM_SELF);
+   mumps.SetMatrixSymType(MUMPSSolver::MatType::UNSYMMETRIC);
+   chrono.Clear();
+   chrono.Start();
+   for (int r = 0; r < repeat; r++)
+      mumps.SetOperator(M_hypre);
+   chrono.Stop();
+   const double mumps_setup = chrono.RealTime() / repeat;
+
+   chrono.Clear();
+   chrono.Start();
+   for (int r = 0; r < repeat; r++)
+      mumps.Mult(x, y_mumps);
+   chrono.Stop();
+   const double mumps_solve = chrono.RealTime() / repeat;
+
+   y_mumps -= y_block;
+   printf("difference between the solutions: %.5E\n", y_mumps.Normlinf());
+
+   printf("%15s\t%15s\t%15s\n", "solver", "factorize (s)", "solve (s)");
+   printf("%15s\t%15.5E\t%15.5E\n", "block_direct", block_setup, block_solve);
+   printf("%15s\t%15.5E\t%15.5E\n", "mumps", mumps_setup, mumps_solve);
+
+   delete M_mono;
+   DeletePointers(mats);
+   MPI_Finalize();
+   return 0;
+}
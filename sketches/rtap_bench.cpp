@@ -0,0 +1,89 @@
+// Copyright 2023 Lawrence Livermore National Security, LLC. See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: MIT
+
+// Timing of the blocked RtAP against the per-column loop it replaced:
+// a random sparse symmetric matrix of size nrow projected onto nbasis random columns.
+
+#include <fstream>
+#include <iostream>
+#include "mfem.hpp"
+#include "linalg_utils.hpp"
+#include "etc.hpp"
+
+using namespace mfem;
+
+int main(int argc, char *argv[])
+{
+   MPI_Init(&argc, &argv);
+
+   int nrow = 20000, nbasis = 80;
+   int nnz_per_row = 8;
+   int repeat = 5;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&nrow, "-n", "--num-rows", "Size of the sparse matrix.");
+   args.AddOption(&nbasis, "-nb", "--num-basis", "Number of basis columns.");
+   args.AddOption(&nnz_per_row, "-nnz", "--nnz-per-row", "Number of random nonzeros per row.");
+   args.AddOption(&repeat, "-r", "--repeat", "Number of repeated products.");
+   args.ParseCheck();
+
+   SparseMatrix A(nrow, nrow);
+   for (int i = 0; i < nrow; i++)
+   {
+      A.Add(i, i, 1.0);
+      for (int k = 0; k < nnz_per_row; k++)
+      {
+         const int j = UniformRandom(0, nrow-1);
+         const double val = UniformRandom();
+         A.Add(i, j, val);
+         A.Add(j, i, val);
+      }
+   }
+   A.Finalize();
+
+   DenseMatrix P(nrow, nbasis);
+   for (int i = 0; i < nrow; i++)
+      for (int j = 0; j < nbasis; j++)
+         P(i, j) = UniformRandom();
+
+   printf("matrix size: %d, nonzeros: %d, basis: %d\n", nrow, A.NumNonZeroElems(), nbasis);
+
+   StopWatch chrono;
+
+   /* per-column loop: one sparse matvec and nbasis dot products per column pair */
+   DenseMatrix ref(nbasis, nbasis);
+   Vector vec_i, vec_j, tmp(nrow);
+   chrono.Clear();
+   chrono.Start();
+   for (int r = 0; r < repeat; r++)
+      for (int i = 0; i < nbasis; i++)
+         for (int j = 0; j < nbasis; j++)
+         {
+            P.GetColumnReference(i, vec_i);
+            P.GetColumnReference(j, vec_j);
+            A.Mult(vec_j, tmp);
+            ref(i, j) = vec_i * tmp;
+         }
+   chrono.Stop();
+   const double loop_time = chrono.RealTime() / repeat;
+
+   /* blocked RtAP */
+   DenseMatrix test;
+   chrono.Clear();
+   chrono.Start();
+   for (int r = 0; r < repeat; r++)
+      RtAP(P, A, P, test);
+   chrono.Stop();
+   const double block_time = chrono.RealTime() / repeat;
+
+   test -= ref;
+   printf("difference between the products: %.5E\n", test.MaxMaxNorm());
+
+   printf("%15s\t%15s\n", "RtAP", "time (s)");
+   printf("%15s\t%15.5E\n", "per-column", loop_time);
+   printf("%15s\t%15.5E\n", "blocked", block_time);
+
+   MPI_Finalize();
+   return 0;
+}
@@ -6,10 +6,16 @@
 #include "input_parser.hpp"
 #include "linalg_utils.hpp"
 #include "etc.hpp"
+#include <sstream>
+#include <iomanip>
 
 using namespace std;
 using namespace mfem;
 
+std::map<std::string, Vector> AdvDiffSolver::flow_library;
+std::deque<std::string> AdvDiffSolver::flow_library_order;
+std::mutex AdvDiffSolver::flow_library_mutex;
+
 AdvDiffSolver::AdvDiffSolver()
    : PoissonSolver(), flow_visual(0), flow_fes(0), global_flow_visual(0)
 {
@@ -25,6 +31,26 @@ AdvDiffSolver::AdvDiffSolver()
    load_flow = config.GetOption<bool>("adv-diff/load_flow", false);
    if (save_flow || load_flow)
       flow_file = config.GetRequiredOption<std::string>("adv-diff/flow_file");
+
+   use_flow_library = config.GetOption<bool>("adv-diff/flow_library/enabled", false);
+   flow_library_size = config.GetOption<int>("adv-diff/flow_library/max_size", 4);
+   if (use_flow_library && (flow_library_size < 1))
+      mfem_error("AdvDiffSolver: adv-diff/flow_library/max_size must be positive!\n");
+   std::string library_prefix = config.GetOption<std::string>("adv-diff/flow_library/prefix", "");
+   if (use_flow_library && (library_prefix != ""))
+   {
+      // each rank keeps its own library file.
+      int rank, nproc;
+      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+      flow_library_file = library_prefix;
+      if (nproc > 1) flow_library_file += "." + std::to_string(rank);
+      flow_library_file += ".h5";
+   }
+
+   rom_flow = config.GetOption<bool>("adv-diff/rom_flow", false);
+   if (rom_flow && !use_rom)
+      mfem_warning("AdvDiffSolver: adv-diff/rom_flow is ignored, since main/use_rom is not set.\n");
 }
 
 AdvDiffSolver::~AdvDiffSolver()
@@ -79,17 +105,26 @@ bool AdvDiffSolver::Solve(SampleGenerator *sample_generator)
    // If using direct solver, returns always true.
    bool converged = true;
 
-   int maxIter = config.GetOption<int>("solver/max_iter", 10000);
-   double rtol = config.GetOption<double>("solver/relative_tolerance", 1.e-15);
-   double atol = config.GetOption<double>("solver/absolute_tolerance", 1.e-15);
-   int print_level = config.GetOption<int>("solver/print_level", 0);
+   solver_opts.Update(config);
+   int maxIter = solver_opts.max_iter;
+   double rtol = solver_opts.rtol;
+   double atol = solver_opts.atol;
+   int print_level = solver_opts.print_level;
+
+   // rows owned by this rank. without distributed solve, these are the entire vectors.
+   Vector RHS_loc, U_loc;
+   if (use_amg || direct_solve)
+   {
+      const int nrow_loc = sys_row_starts[1] - sys_row_starts[0];
+      RHS_loc.MakeRef(*RHS, sys_row_starts[0], nrow_loc);
+      U_loc.MakeRef(*U, sys_row_starts[0], nrow_loc);
+   }
 
-   // TODO: need to change when the actual parallelization is implemented.
    if (direct_solve)
    {
       assert(mumps);
       mumps->SetPrintLevel(print_level);
-      mumps->Mult(*RHS, *U);
+      mumps->Mult(RHS_loc, U_loc);
    }
    else
    {
@@ -100,10 +135,9 @@ bool AdvDiffSolver::Solve(SampleGenerator *sample_generator)
       // HypreBoomerAMG makes a meaningful difference in computation time.
       if (use_amg)
       {
-         // Initializating HypreParMatrix needs the monolithic sparse matrix.
-         assert(globalMat_mono != NULL);
+         assert(globalMat_hypre != NULL);
 
-         solver = new GMRESSolver(MPI_COMM_SELF);
+         solver = new GMRESSolver(globalMat_hypre->GetComm());
 
          M = new HypreBoomerAMG(*globalMat_hypre);
          M->SetPrintLevel(print_level);
@@ -115,7 +149,7 @@ bool AdvDiffSolver::Solve(SampleGenerator *sample_generator)
       {
          solver = new GMRESSolver();
          
-         if (config.GetOption<bool>("solver/block_diagonal_preconditioner", true))
+         if (solver_opts.block_diag_prec)
          {
             globalPrec = new BlockDiagonalPreconditioner(var_offsets);
             solver->SetPreconditioner(*globalPrec);
@@ -131,7 +165,10 @@ bool AdvDiffSolver::Solve(SampleGenerator *sample_generator)
       // The time for the setup above is much smaller than this Mult().
       // StopWatch test;
       // test.Start();
-      solver->Mult(*RHS, *U);
+      if (use_amg)
+         solver->Mult(RHS_loc, U_loc);
+      else
+         solver->Mult(*RHS, *U);
       // test.Stop();
       // printf("test: %f seconds.\n", test.RealTime());
       converged = solver->GetConverged();
@@ -148,6 +185,8 @@ bool AdvDiffSolver::Solve(SampleGenerator *sample_generator)
       delete solver;
    }
 
+   GatherDistributedVector(sys_row_starts, *U);
+
    /* save solution if sample generator is provided */
    if (converged && sample_generator)
       SaveSnapshots(sample_generator);
@@ -171,8 +210,12 @@ void AdvDiffSolver::SetFlowAtSubdomain(std::function<void(const Vector &, double
 
 void AdvDiffSolver::SetParameterizedProblem(ParameterizedProblem *problem)
 {
-   if (!function_factory::advdiff_problem::analytic_flow)
-      GetFlowField(function_factory::advdiff_problem::flow_problem);
+   AdvDiffFlowPastArray *advdiff_problem = dynamic_cast<AdvDiffFlowPastArray *>(problem);
+   if (!advdiff_problem)
+      mfem_error("AdvDiffSolver::SetParameterizedProblem - unknown advection-diffusion problem!\n");
+
+   if (!advdiff_problem->analytic_flow)
+      GetFlowField(advdiff_problem->GetFlowProblem());
 
    PoissonSolver::SetParameterizedProblem(problem);
 }
@@ -180,6 +223,7 @@ void AdvDiffSolver::SetParameterizedProblem(ParameterizedProblem *problem)
 void AdvDiffSolver::SaveVisualization()
 {
    if (!visual.save) return;
+   if (!IsOutputRank()) return;
 
    assert(paraviewColls.Size() > 0);
    for (int k = 0; k < paraviewColls.Size(); k++)
@@ -230,7 +274,7 @@ void AdvDiffSolver::SaveVisualization()
 void AdvDiffSolver::SetMUMPSSolver()
 {
    assert(globalMat_hypre);
-   mumps = new MUMPSSolver(MPI_COMM_SELF);
+   mumps = new MUMPSSolver(globalMat_hypre->GetComm());
    mumps->SetMatrixSymType(MUMPSSolver::MatType::UNSYMMETRIC);
    mumps->SetOperator(*globalMat_hypre);
 }
@@ -238,31 +282,54 @@ void AdvDiffSolver::SetMUMPSSolver()
 void AdvDiffSolver::GetFlowField(ParameterizedProblem *flow_problem)
 {
    assert(flow_problem);
-   mfem_warning("AdvDiffSolver: Obtaining flow field. This may take a while depending on the domain size.\n");
 
-   stokes_solver = new StokesSolver;
-   stokes_solver->InitVariables();
-   if (use_rom) stokes_solver->InitROMHandler();
-   stokes_solver->SetSolutionSaveMode(save_flow);
+   const std::string flow_key = GetFlowKey(flow_problem);
+   Vector flow;
 
    bool flow_loaded = false;
+   flow_from_library = false;
    if (load_flow && FileExists(flow_file))
    {
+      if (!stokes_solver) InitFlowSolver();
       stokes_solver->LoadSolution(flow_file);
       flow_loaded = true;
    }
-   else
+   else if (use_flow_library && FindFlowInLibrary(flow_key, flow))
    {
-      stokes_solver->SetParameterizedProblem(flow_problem);
-      // currently only support FOM.
-      stokes_solver->BuildOperators();
-      stokes_solver->SetupBCOperators();
-      stokes_solver->Assemble();
-      stokes_solver->Solve();
+      if (!stokes_solver) InitFlowSolver();
+
+      Vector &U_flow = *(stokes_solver->GetSolution());
+      if (U_flow.Size() == flow.Size())
+      {
+         // grid functions of stokes_solver are views of its solution vector.
+         U_flow = flow;
+         flow_loaded = true;
+         flow_from_library = true;
+      }
+      else
+         mfem_warning("AdvDiffSolver: flow field in the library does not match the flow solver. Solving again.\n");
    }
 
-   if (save_flow && (!flow_loaded))
-      stokes_solver->SaveSolution(flow_file);
+   if (!flow_loaded)
+   {
+      /*
+         StokesSolver does not support re-assembling its operators,
+         so a new flow solver is built for every flow field that is actually solved.
+         flow_coeffs refer to the grid functions of the old solver.
+      */
+      DeletePointers(flow_coeffs);
+      flow_coeffs = NULL;
+      delete stokes_solver;
+      InitFlowSolver();
+
+      SolveFlowField(flow_problem);
+
+      if (use_flow_library)
+         AddFlowToLibrary(flow_key, *(stokes_solver->GetSolution()));
+
+      if (save_flow)
+         stokes_solver->SaveSolution(flow_file);
+   }
 
    DeletePointers(flow_coeffs);
    const int stokes_numvar = stokes_solver->GetNumVar();
@@ -274,4 +341,179 @@ void AdvDiffSolver::GetFlowField(ParameterizedProblem *flow_problem)
       and it requires the grid function for its lifetime.
       Thus stokes_solver will be deleted at ~AdvDiffSolver().
    */
-}
\ No newline at end of file
+}
+
+void AdvDiffSolver::InitFlowSolver()
+{
+   stokes_solver = new StokesSolver;
+   stokes_solver->InitVariables();
+   if (use_rom) stokes_solver->InitROMHandler();
+   stokes_solver->SetSolutionSaveMode(save_flow);
+}
+
+void AdvDiffSolver::SolveFlowField(ParameterizedProblem *flow_problem)
+{
+   assert(stokes_solver);
+   mfem_warning("AdvDiffSolver: Obtaining flow field. This may take a while depending on the domain size.\n");
+
+   stokes_solver->SetParameterizedProblem(flow_problem);
+   stokes_solver->BuildOperators();
+   stokes_solver->SetupBCOperators();
+   stokes_solver->Assemble();
+
+   if (!(use_rom && rom_flow))
+   {
+      stokes_solver->Solve();
+      return;
+   }
+
+   /*
+      The flow ROM operator is always projected from the FOM operator,
+      since the operator files in model_reduction/save_operator belong to the advection-diffusion ROM.
+      The flow basis is found by the basis tags of the flow solver variables.
+   */
+   stokes_solver->LoadReducedBasis();
+   stokes_solver->ProjectOperatorOnReducedBasis();
+   stokes_solver->ProjectRHSOnReducedBasis();
+   stokes_solver->SolveROM();
+}
+
+const std::string AdvDiffSolver::GetFlowKey(ParameterizedProblem *flow_problem)
+{
+   assert(flow_problem);
+
+   std::ostringstream key;
+   key << std::setprecision(17);
+   key << flow_problem->GetProblemName();
+   for (int k = 0; k < flow_problem->GetNumParams(); k++)
+      key << "/" << flow_problem->GetParam(k);
+
+   // topology and discretization of the flow field.
+   key << "/topol" << topol_mode << "/" << numSub;
+   if (topol_mode == TopologyHandlerMode::SUBMESH)
+      key << "/" << config.GetOption<std::string>("mesh/filename", "");
+   else
+      key << "/" << config.GetOption<std::string>("mesh/component-wise/global_config", "");
+   key << "/ref" << config.GetOption<int>("mesh/uniform_refinement", 0);
+   key << "/order" << order;
+
+   key << "/" << ((use_rom && rom_flow) ? "rom" : "fom");
+   return key.str();
+}
+
+const int AdvDiffSolver::GetFlowLibrarySize()
+{
+   std::lock_guard<std::mutex> lock(flow_library_mutex);
+   return flow_library.size();
+}
+
+void AdvDiffSolver::ClearFlowLibrary()
+{
+   std::lock_guard<std::mutex> lock(flow_library_mutex);
+   flow_library.clear();
+   flow_library_order.clear();
+}
+
+const std::string AdvDiffSolver::GetFlowGroupName(const std::string &key)
+{
+   std::string grp_name;
+   for (const char c : key)
+   {
+      if (c == '/')
+         grp_name += "%2F";
+      else if (c == '%')
+         grp_name += "%25";
+      else
+         grp_name += c;
+   }
+   return grp_name;
+}
+
+bool AdvDiffSolver::FindFlowInLibrary(const std::string &key, Vector &flow)
+{
+   std::lock_guard<std::mutex> lock(flow_library_mutex);
+
+   if (flow_library.count(key))
+   {
+      flow = flow_library[key];
+      return true;
+   }
+
+   if ((flow_library_file == "") || (!FileExists(flow_library_file)))
+      return false;
+
+   hid_t file_id, grp_id;
+   herr_t errf = 0;
+   file_id = H5Fopen(flow_library_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   const std::string grp_name = GetFlowGroupName(key);
+   bool found = false;
+   if (hdf5_utils::pathExists(file_id, grp_name))
+   {
+      grp_id = H5Gopen2(file_id, grp_name.c_str(), H5P_DEFAULT);
+      assert(grp_id >= 0);
+
+      std::string file_key;
+      hdf5_utils::ReadAttribute(grp_id, "key", file_key);
+      if (file_key == key)
+      {
+         // not added to the in-memory library, which only keeps the flow fields solved in this run.
+         hdf5_utils::ReadDataset(grp_id, "solution", flow);
+         found = true;
+      }
+
+      errf = H5Gclose(grp_id);
+      assert(errf >= 0);
+   }
+
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   return found;
+}
+
+void AdvDiffSolver::AddFlowToLibrary(const std::string &key, const Vector &flow)
+{
+   std::lock_guard<std::mutex> lock(flow_library_mutex);
+
+   if (!flow_library.count(key))
+      flow_library_order.push_back(key);
+   flow_library[key] = flow;
+
+   // evict the oldest flow fields.
+   while (flow_library.size() > static_cast<size_t>(flow_library_size))
+   {
+      flow_library.erase(flow_library_order.front());
+      flow_library_order.pop_front();
+   }
+
+   if (flow_library_file == "")
+      return;
+
+   hid_t file_id, grp_id;
+   herr_t errf = 0;
+   if (FileExists(flow_library_file))
+      file_id = H5Fopen(flow_library_file.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+   else
+      file_id = H5Fcreate(flow_library_file.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   const std::string grp_name = GetFlowGroupName(key);
+   if (hdf5_utils::pathExists(file_id, grp_name))
+      mfem_warning("AdvDiffSolver: flow library file already has this flow field. Skip saving.\n");
+   else
+   {
+      grp_id = H5Gcreate(file_id, grp_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      assert(grp_id >= 0);
+
+      hdf5_utils::WriteAttribute(grp_id, "key", key);
+      hdf5_utils::WriteDataset(grp_id, "solution", flow);
+
+      errf = H5Gclose(grp_id);
+      assert(errf >= 0);
+   }
+
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+}
@@ -239,4 +239,263 @@ void BlockDSmoother::Mult(const Vector &x, Vector &y) const
    // }
 }
 
-}
\ No newline at end of file
+/*
+   BlockDenseLUSolver
+*/
+
+BlockDenseLUSolver::BlockDenseLUSolver(const Array<int> &offsets_)
+   : Solver(offsets_.Last()),
+     num_blocks(offsets_.Size() - 1),
+     offsets(offsets_),
+     order(offsets_.Size() - 1),
+     tiles(offsets_.Size() - 1, offsets_.Size() - 1),
+     diag_inv(offsets_.Size() - 1),
+     row_pattern(offsets_.Size() - 1),
+     col_pattern(offsets_.Size() - 1)
+{
+   tiles = NULL;
+   diag_inv = NULL;
+   for (int b = 0; b < num_blocks; b++)
+      order[b] = b;
+}
+
+BlockDenseLUSolver::BlockDenseLUSolver(const BlockMatrix &mat)
+   : BlockDenseLUSolver(mat.RowOffsets())
+{
+   SetOperator(mat);
+}
+
+BlockDenseLUSolver::~BlockDenseLUSolver()
+{
+   ClearTiles();
+}
+
+void BlockDenseLUSolver::ClearTiles()
+{
+   DeletePointers(tiles);
+   DeletePointers(diag_inv);
+   tiles = NULL;
+   diag_inv = NULL;
+   for (int b = 0; b < num_blocks; b++)
+   {
+      row_pattern[b].clear();
+      col_pattern[b].clear();
+   }
+}
+
+void BlockDenseLUSolver::AddTile(const int i, const int j)
+{
+   if (tiles(i, j)) return;
+
+   tiles(i, j) = new DenseMatrix(TileSize(i), TileSize(j));
+   *tiles(i, j) = 0.0;
+   row_pattern[i].insert(j);
+   col_pattern[j].insert(i);
+}
+
+void BlockDenseLUSolver::SetOperator(const Operator &op)
+{
+   assert(op.Height() == offsets.Last());
+   assert(op.Width() == offsets.Last());
+   ClearTiles();
+
+   const BlockMatrix *bmat = dynamic_cast<const BlockMatrix *>(&op);
+   const SparseMatrix *smat = dynamic_cast<const SparseMatrix *>(&op);
+   const HypreParMatrix *hmat = dynamic_cast<const HypreParMatrix *>(&op);
+   if (bmat)
+      SetTiles(*bmat);
+   else if (smat)
+      SetTiles(*smat);
+   else if (hmat)
+   {
+      // only for the serial matrix, as used for the ROM system.
+      assert(hmat->GetGlobalNumRows() == offsets.Last());
+      SparseMatrix diag;
+      hmat->GetDiag(diag);
+      SetTiles(diag);
+   }
+   else
+      mfem_error("BlockDenseLUSolver::SetOperator- unsupported operator type!\n");
+
+   Factorize();
+}
+
+void BlockDenseLUSolver::SetOrder(const Array<bool> &zero_diag)
+{
+   assert(zero_diag.Size() == num_blocks);
+   int k = 0;
+   for (int b = 0; b < num_blocks; b++)
+      if (!zero_diag[b]) order[k++] = b;
+   for (int b = 0; b < num_blocks; b++)
+      if (zero_diag[b]) order[k++] = b;
+   assert(k == num_blocks);
+}
+
+void BlockDenseLUSolver::SetTiles(const BlockMatrix &mat)
+{
+   assert(mat.NumRowBlocks() == num_blocks);
+   assert(mat.NumColBlocks() == num_blocks);
+   for (int b = 0; b <= num_blocks; b++)
+   {
+      assert(mat.RowOffsets()[b] == offsets[b]);
+      assert(mat.ColOffsets()[b] == offsets[b]);
+   }
+
+   Array<bool> zero_diag(num_blocks);
+   for (int b = 0; b < num_blocks; b++)
+      zero_diag[b] = (mat.IsZeroBlock(b, b) || (mat.GetBlock(b, b).MaxNorm() == 0.0));
+   SetOrder(zero_diag);
+
+   /* tiles are indexed by the elimination step. */
+   for (int i = 0; i < num_blocks; i++)
+      for (int j = 0; j < num_blocks; j++)
+      {
+         if (mat.IsZeroBlock(order[i], order[j])) continue;
+
+         AddTile(i, j);
+         mat.GetBlock(order[i], order[j]).ToDenseMatrix(*tiles(i, j));
+      }
+}
+
+void BlockDenseLUSolver::SetTiles(const SparseMatrix &mat)
+{
+   Array<int> row2block(offsets.Last());
+   for (int b = 0; b < num_blocks; b++)
+      for (int k = offsets[b]; k < offsets[b+1]; k++)
+         row2block[k] = b;
+
+   const int *I = mat.GetI(), *J = mat.GetJ();
+   const double *data = mat.GetData();
+
+   Array<bool> zero_diag(num_blocks);
+   zero_diag = true;
+   for (int r = 0; r < mat.NumRows(); r++)
+      for (int k = I[r]; k < I[r+1]; k++)
+         if ((row2block[J[k]] == row2block[r]) && (data[k] != 0.0))
+            zero_diag[row2block[r]] = false;
+   SetOrder(zero_diag);
+
+   Array<int> step(num_blocks);
+   for (int k = 0; k < num_blocks; k++)
+      step[order[k]] = k;
+
+   for (int r = 0; r < mat.NumRows(); r++)
+   {
+      const int bi = row2block[r];
+      for (int k = I[r]; k < I[r+1]; k++)
+      {
+         const int bj = row2block[J[k]];
+         AddTile(step[bi], step[bj]);
+         (*tiles(step[bi], step[bj]))(r - offsets[bi], J[k] - offsets[bj]) += data[k];
+      }
+   }
+}
+
+void BlockDenseLUSolver::Factorize()
+{
+   DenseMatrix Lik;
+   for (int k = 0; k < num_blocks; k++)
+   {
+      /*
+         A zero diagonal block is eliminated last, so its pivot is the Schur complement
+         of the preceding blocks. It is still zero only if the block does not couple with them.
+      */
+      if (!tiles(k, k) || (tiles(k, k)->MaxMaxNorm() == 0.0))
+      {
+         std::string msg = string_format("BlockDenseLUSolver::Factorize- singular block system! "
+                                         "Block %d (pivot step %d) has a zero pivot after eliminating all coupled blocks. "
+                                         "Use model_reduction/linear_solver_type: direct instead.\n", order[k], k);
+         mfem_error(msg.c_str());
+      }
+
+      diag_inv[k] = new DenseMatrix(*tiles(k, k));
+      diag_inv[k]->Invert();
+
+      /*
+         Right-looking block elimination.
+         Fill-in tiles (i, j) with i, j > k are created here,
+         before they are eliminated at the later steps.
+      */
+      for (std::set<int>::iterator it = col_pattern[k].upper_bound(k); it != col_pattern[k].end(); it++)
+      {
+         const int i = *it;
+         // L_ik = A_ik * A_kk^{-1}
+         Lik.SetSize(tiles(i, k)->NumRows(), tiles(i, k)->NumCols());
+         mfem::Mult(*tiles(i, k), *diag_inv[k], Lik);
+         *tiles(i, k) = Lik;
+
+         // Schur complement update A_ij -= L_ik * U_kj.
+         for (std::set<int>::iterator jt = row_pattern[k].upper_bound(k); jt != row_pattern[k].end(); jt++)
+         {
+            const int j = *jt;
+            AddTile(i, j);
+            AddMult_a(-1.0, Lik, *tiles(k, j), *tiles(i, j));
+         }
+      }
+   }
+}
+
+void BlockDenseLUSolver::Mult(const Vector &x, Vector &y) const
+{
+   assert(x.Size() == offsets.Last());
+   assert(y.Size() == offsets.Last());
+
+   BlockVector xb(const_cast<Vector &>(x).GetData(), offsets);
+   BlockVector yb(y.GetData(), offsets);
+
+   /* forward substitution with the unit lower block-triangular factor. */
+   for (int k = 0; k < num_blocks; k++)
+   {
+      Vector &yk = yb.GetBlock(order[k]);
+      yk = xb.GetBlock(order[k]);
+      for (std::set<int>::const_iterator it = row_pattern[k].begin(); (it != row_pattern[k].end()) && (*it < k); it++)
+         tiles(k, *it)->AddMult_a(-1.0, yb.GetBlock(order[*it]), yk);
+   }
+
+   /* backward substitution with the upper block-triangular factor. */
+   for (int k = num_blocks - 1; k >= 0; k--)
+   {
+      Vector &yk = yb.GetBlock(order[k]);
+      tmp = yk;
+      for (std::set<int>::const_iterator it = row_pattern[k].upper_bound(k); it != row_pattern[k].end(); it++)
+         tiles(k, *it)->AddMult_a(-1.0, yb.GetBlock(order[*it]), tmp);
+
+      diag_inv[k]->Mult(tmp, yk);
+   }
+}
+
+void BlockDenseLUSolver::Mult(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   assert(X.NumRows() == offsets.Last());
+   const int nrhs = X.NumCols();
+   Y.SetSize(offsets.Last(), nrhs);
+
+   /* Yb is indexed by the elimination step. */
+   Array<DenseMatrix *> Yb(num_blocks);
+   for (int k = 0; k < num_blocks; k++)
+   {
+      Yb[k] = new DenseMatrix;
+      X.GetSubMatrix(offsets[order[k]], offsets[order[k]+1], 0, nrhs, *Yb[k]);
+   }
+
+   /* forward substitution with the unit lower block-triangular factor. */
+   for (int k = 0; k < num_blocks; k++)
+      for (std::set<int>::const_iterator it = row_pattern[k].begin(); (it != row_pattern[k].end()) && (*it < k); it++)
+         AddMult_a(-1.0, *tiles(k, *it), *Yb[*it], *Yb[k]);
+
+   /* backward substitution with the upper block-triangular factor. */
+   DenseMatrix tmp_k;
+   for (int k = num_blocks - 1; k >= 0; k--)
+   {
+      tmp_k = *Yb[k];
+      for (std::set<int>::const_iterator it = row_pattern[k].upper_bound(k); it != row_pattern[k].end(); it++)
+         AddMult_a(-1.0, *tiles(k, *it), *Yb[*it], tmp_k);
+
+      mfem::Mult(*diag_inv[k], tmp_k, *Yb[k]);
+      Y.SetSubMatrix(offsets[order[k]], 0, *Yb[k]);
+   }
+
+   DeletePointers(Yb);
+}
+
+}
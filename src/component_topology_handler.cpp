@@ -7,6 +7,7 @@
 #include "hdf5.h"
 #include "hdf5_utils.hpp"
 #include <fstream>
+#include <array>
 
 using namespace std;
 using namespace mfem;
@@ -47,7 +48,7 @@ ComponentTopologyHandler::ComponentTopologyHandler()
       }
    }
 
-   // Do we really need to copy all meshes?
+   // Subdomain meshes are not copied here, only materialized on demand.
    SetupMeshes();
 
    bool success = ReadBoundariesFromFile(global_config);
@@ -67,7 +68,7 @@ ComponentTopologyHandler::ComponentTopologyHandler()
 
    SetupPorts();
 
-   // Do we really need to set boundary attributes of all meshes?
+   // Boundary attributes are set when each subdomain mesh is materialized.
    SetupBdrAttributes();
 }
 
@@ -101,9 +102,54 @@ void ComponentTopologyHandler::GetRefPortInfo(const int &ref_port_idx, int &comp
    attr2 = ref_ports[ref_port_idx]->Attr2;
 }
 
+Mesh* ComponentTopologyHandler::GetMesh(const int k)
+{
+   assert((k >= 0) && (k < numSub));
+   if (meshes[k] == NULL)
+   {
+      meshes[k] = BuildSubdomainMesh(k);
+      // transformations cached from a previous mesh of subdomain k are no longer valid.
+      ClearInterfaceTransformations(k);
+   }
+   return meshes[k];
+}
+
+const int ComponentTopologyHandler::GetNumMaterializedMeshes() const
+{
+   int num_meshes = 0;
+   for (int m = 0; m < meshes.Size(); m++)
+      if (meshes[m] != NULL) num_meshes++;
+   return num_meshes;
+}
+
+void ComponentTopologyHandler::TransformToSubdomain(const int m, const Vector &x, Vector &y) const
+{
+   assert((m >= 0) && (m < numSub));
+   switch (dim)
+   {
+      case 2:
+      {
+         mesh_config::RigidTransform2D(mesh_configs[m].trans, mesh_configs[m].rotate, x, y);
+         break;
+      }
+      case 3:
+      {
+         mesh_config::RigidTransform3D(mesh_configs[m].trans, mesh_configs[m].rotate, x, y);
+         break;
+      }
+      default:
+      {
+         mfem_error("ComponentTopologyHandler::TransformToSubdomain- unsupported dimension!\n");
+         break;
+      }
+   }
+}
+
 void ComponentTopologyHandler::ExportInfo(Array<Mesh*> &mesh_ptrs, TopologyData &topol_data)
 {
-   mesh_ptrs = meshes;
+   mesh_ptrs.SetSize(numSub);
+   for (int m = 0; m < numSub; m++)
+      mesh_ptrs[m] = GetMesh(m);
 
    topol_data.dim = dim;
    topol_data.numSub = numSub;
@@ -584,54 +630,61 @@ void ComponentTopologyHandler::SetupMeshes()
    meshes.SetSize(numSub);
    meshes = NULL;
 
-   for (int m = 0; m < numSub; m++)
-   {
-      meshes[m] = new Mesh(*components[mesh_types[m]]);
-
-      for (int d = 0; d < 3; d++)
-      {
-         mesh_config::trans[d] = mesh_configs[m].trans[d];
-         mesh_config::rotate[d] = mesh_configs[m].rotate[d];
-      }
-      meshes[m]->Transform(*tf_ptr);
-   }
-
-   for (int m = 0; m < numSub; m++) assert(meshes[m] != NULL);
-
    // Set up boundary attribute map from component to global.
    // Only the initialization.
    bdr_c2g.SetSize(numSub);
    bdr_attributes.SetSize(0);
    for (int m = 0; m < numSub; m++)
    {
-      bdr_c2g[m] = new Array<int>(meshes[m]->bdr_attributes.Size());
+      bdr_c2g[m] = new Array<int>(components[mesh_types[m]]->bdr_attributes.Size());
       *bdr_c2g[m] = -1;
    }
 }
 
 void ComponentTopologyHandler::SetupBdrAttributes()
 {
-   assert(meshes.Size() == numSub);
+   assert(bdr_c2g.Size() == numSub);
 
+   /*
+      all component boundaries must be mapped to global, before any subdomain mesh is materialized.
+      Previously a debug-only assert at the boundary attribute setting.
+      This is now checked in release builds as well, and an incomplete boundary configuration is a hard error.
+   */
    for (int m = 0; m < numSub; m++)
-   {
-      int c = mesh_types[m];
-      Mesh *comp = components[c];
+      for (int b = 0; b < bdr_c2g[m]->Size(); b++)
+         if ((*bdr_c2g[m])[b] < 0)
+         {
+            const int c = mesh_types[m];
+            printf("subdomain %d (component %s), boundary attribute %d.\n", m,
+                   comp_names[c].c_str(), components[c]->bdr_attributes[b]);
+            mfem_error("ComponentTopologyHandler: component boundary is not mapped to global!\n");
+         }
+}
 
-      // std::unordered_map<int,int> *c2g_map = bdr_c2g[m];
-      Array<int> *c2g_map = bdr_c2g[m];
-      for (int be = 0; be < comp->GetNBE(); be++)
-      {
-         int b_attr = comp->GetBdrAttribute(be);
-         int c_idx = comp->bdr_attributes.Find(b_attr);
-         assert(c_idx >= 0);
-         assert((*c2g_map)[c_idx] >= 0);
+Mesh* ComponentTopologyHandler::BuildSubdomainMesh(const int m)
+{
+   assert((m >= 0) && (m < numSub));
+   Mesh *comp = components[mesh_types[m]];
+   Mesh *mesh = new Mesh(*comp);
 
-         meshes[m]->SetBdrAttribute(be, (*c2g_map)[c_idx]);
-      }
+   // transform with the configuration of this subdomain, not through mesh_config::trans/rotate.
+   VectorFunctionCoefficient tf_coeff(dim,
+      [this, m](const Vector &x, Vector &y) { TransformToSubdomain(m, x, y); });
+   mesh->Transform(tf_coeff);
+
+   const Array<int> *c2g_map = bdr_c2g[m];
+   for (int be = 0; be < comp->GetNBE(); be++)
+   {
+      int b_attr = comp->GetBdrAttribute(be);
+      int c_idx = comp->bdr_attributes.Find(b_attr);
+      assert(c_idx >= 0);
+      assert((*c2g_map)[c_idx] >= 0);
 
-      UpdateBdrAttributes(*meshes[m]);
+      mesh->SetBdrAttribute(be, (*c2g_map)[c_idx]);
    }
+
+   UpdateBdrAttributes(*mesh);
+   return mesh;
 }
 
 void ComponentTopologyHandler::SetupReferenceInterfaces()
@@ -742,6 +795,82 @@ void ComponentTopologyHandler::SetupPorts()
    for (int p = 0; p < interface_infos.Size(); p++) assert(interface_infos[p] != NULL);
 }
 
+typedef std::array<long long, 3> PortCell;
+
+static PortCell GetPortCell(const double *x, const int dim, const double h)
+{
+   PortCell cell = {0, 0, 0};
+   for (int d = 0; d < dim; d++)
+      cell[d] = static_cast<long long>(floor(x[d] / h));
+   return cell;
+}
+
+void MatchPortVertices(const DenseMatrix &x1, const DenseMatrix &x2, const double threshold, Array<int> &match1to2)
+{
+   assert(threshold > 0.0);
+   const int dim = x1.NumRows();
+   assert((dim > 0) && (dim <= 3));
+   assert(x2.NumRows() == dim);
+   const int n1 = x1.NumCols(), n2 = x2.NumCols();
+
+   /*
+      Any cell size no smaller than threshold finds all candidates in the neighboring cells.
+      It is enlarged for large coordinates, so that the cell indices do not overflow.
+   */
+   const double h = max(threshold, 1.0e-15 * max(x1.MaxMaxNorm(), x2.MaxMaxNorm()));
+
+   // points of x2 in each cell, in the increasing order.
+   std::map<PortCell, std::vector<int>> cells;
+   for (int v2 = 0; v2 < n2; v2++)
+      cells[GetPortCell(x2.GetColumn(v2), dim, h)].push_back(v2);
+
+   int num_neighbors = 1;
+   for (int d = 0; d < dim; d++) num_neighbors *= 3;
+
+   std::vector<bool> matched(n2, false);
+   match1to2.SetSize(n1);
+   for (int v1 = 0; v1 < n1; v1++)
+   {
+      const double *p1 = x1.GetColumn(v1);
+      const PortCell cell1 = GetPortCell(p1, dim, h);
+
+      int best = -1;
+      for (int nb = 0; nb < num_neighbors; nb++)
+      {
+         PortCell cell = cell1;
+         for (int d = 0, code = nb; d < dim; d++, code /= 3)
+            cell[d] += (code % 3) - 1;
+
+         auto it = cells.find(cell);
+         if (it == cells.end()) continue;
+
+         for (const int v2 : it->second)
+         {
+            if ((best >= 0) && (v2 > best)) break;
+            if (matched[v2]) continue;
+
+            const double *p2 = x2.GetColumn(v2);
+            bool match = true;
+            for (int d = 0; d < dim; d++)
+               if (!(abs(p1[d] - p2[d]) < threshold))
+               {
+                  match = false;
+                  break;
+               }
+
+            if (match)
+            {
+               best = v2;
+               break;
+            }
+         }
+      }  // for (int nb = 0; nb < num_neighbors; nb++)
+
+      match1to2[v1] = best;
+      if (best >= 0) matched[best] = true;
+   }  // for (int v1 = 0; v1 < n1; v1++)
+}
+
 void ComponentTopologyHandler::BuildPortDataFromInput(const YAML::Node port_dict)
 {
    std::string port_name = config.GetRequiredOptionFromDict<std::string>("name", port_dict);
@@ -799,20 +928,31 @@ void ComponentTopologyHandler::BuildPortDataFromInput(const YAML::Node port_dict
    port->be_pairs.SetSize(be1.Size(), 2);
    port->be_pairs = -1;
 
+   /* port vertices in the order of their first appearance, deduplicated by a marker. */
    Array<int> vtx1(0), vtx2(0);
-   for (int b1 = 0; b1 < be1.Size(); b1++)
-   {
-      Array<int> b_vtx;
-      comp1->GetBdrElementVertices(be1[b1], b_vtx);
-      for (int v = 0; v < b_vtx.Size(); v++)
-         if (vtx1.Find(b_vtx[v]) < 0) vtx1.Append(b_vtx[v]);
-   }
-   for (int b2 = 0; b2 < be2.Size(); b2++)
    {
       Array<int> b_vtx;
-      comp2->GetBdrElementVertices(be2[b2], b_vtx);
-      for (int v = 0; v < b_vtx.Size(); v++)
-         if (vtx2.Find(b_vtx[v]) < 0) vtx2.Append(b_vtx[v]);
+      std::vector<bool> seen1(comp1->GetNV(), false), seen2(comp2->GetNV(), false);
+      for (int b1 = 0; b1 < be1.Size(); b1++)
+      {
+         comp1->GetBdrElementVertices(be1[b1], b_vtx);
+         for (int v = 0; v < b_vtx.Size(); v++)
+            if (!seen1[b_vtx[v]])
+            {
+               seen1[b_vtx[v]] = true;
+               vtx1.Append(b_vtx[v]);
+            }
+      }
+      for (int b2 = 0; b2 < be2.Size(); b2++)
+      {
+         comp2->GetBdrElementVertices(be2[b2], b_vtx);
+         for (int v = 0; v < b_vtx.Size(); v++)
+            if (!seen2[b_vtx[v]])
+            {
+               seen2[b_vtx[v]] = true;
+               vtx2.Append(b_vtx[v]);
+            }
+      }
    }
    assert(vtx1.Size() == vtx2.Size());
 
@@ -820,93 +960,76 @@ void ComponentTopologyHandler::BuildPortDataFromInput(const YAML::Node port_dict
    // Mesh::Transform transforms the node coordinates, instead of vertices.
    // For actual meshes, this does not matter.
    // comp2->Transform(mesh_config::Transform2D);
-   Array<Vector*> x2_trns(vtx2.Size());
-   x2_trns = NULL;
+   DenseMatrix x1(dim, vtx1.Size()), x2_trns(dim, vtx2.Size());
+   for (int v1 = 0; v1 < vtx1.Size(); v1++)
+   {
+      double *x1_v = comp1->GetVertex(vtx1[v1]);
+      for (int d = 0; d < dim; d++)
+         x1(d, v1) = x1_v[d];
+   }
+   Vector tmp_trns;
    for (int v2 = 0; v2 < vtx2.Size(); v2++)
    {
-      double *x2 = comp2->GetVertex(vtx2[v2]);
-      Vector tmp(x2, dim);
-      x2_trns[v2] = new Vector;
-      (*tf_ptr)(tmp, *x2_trns[v2]);
+      Vector tmp(comp2->GetVertex(vtx2[v2]), dim);
+      (*tf_ptr)(tmp, tmp_trns);
+      for (int d = 0; d < dim; d++)
+         x2_trns(d, v2) = tmp_trns(d);
    }
 
-   // double threshold = 1.e-10;
+   Array<int> match1to2;
+   MatchPortVertices(x1, x2_trns, vtx_gap_thrs, match1to2);
    for (int v1 = 0; v1 < vtx1.Size(); v1++)
    {
-      double *x1 = comp1->GetVertex(vtx1[v1]);
-      bool found_match = false;
-
-      double mingap = 1.e100;
-      for (int v2 = 0; v2 < vtx2.Size(); v2++)
+      if (match1to2[v1] < 0)
       {
-         if (port->vtx2to1.count(vtx2[v2])) continue;
-
-         // double *x2 = comp2->GetVertex(vtx2[v2]);
-         const double *x2 = x2_trns[v2]->Read();
-
-         bool match = true;
-         double tmp1 = 0.0;
-         for (int d = 0; d < dim; d++)
+         /* exhaustive search only for the report. */
+         double mingap = 1.e100;
+         for (int v2 = 0; v2 < vtx2.Size(); v2++)
          {
-            double tmp = abs(x1[d] - x2[d]);
-            tmp1 = max(tmp1, tmp);
-            match = (tmp < vtx_gap_thrs);
-            if (!match) break;
+            double gap = 0.0;
+            for (int d = 0; d < dim; d++)
+               gap = max(gap, abs(x1(d, v1) - x2_trns(d, v2)));
+            mingap = min(mingap, gap);
          }
-         mingap = min(mingap, tmp1);
+         printf("minimal gap: %.5E\n", mingap);
+         mfem_error("BuildPortDataFromInput: Cannot find the matching vertex!\n");
+      }
 
-         if (match)
-         {
-            port->vtx2to1[vtx2[v2]] = vtx1[v1];
-            found_match = true;
-            break;
-         }
-      }  // for (int v2 = 0; v2 < vtx2.Size(); v2++)
+      port->vtx2to1[vtx2[match1to2[v1]]] = vtx1[v1];
+   }
 
-      if (!found_match)
+   /* boundary elements of comp1 keyed by their sorted vertices, keeping the first one in order. */
+   std::map<std::vector<int>, int> be1_by_vtx;
+   {
+      Array<int> b1_vtx1;
+      for (int b1 = 0; b1 < be1.Size(); b1++)
       {
-         printf("minimal gap: %.5E\n", mingap);
-         mfem_error("BuildPortDataFromInput: Cannot find the matching vertex!\n");
+         comp1->GetBdrElementVertices(be1[b1], b1_vtx1);
+         b1_vtx1.Sort();
+         be1_by_vtx.emplace(std::vector<int>(b1_vtx1.begin(), b1_vtx1.end()), b1);
       }
-   }  // for (int v1 = 0; v1 < vtx1.Size(); v1++)
+   }
 
+   Array<int> b_vtx2;
    for (int b2 = 0; b2 < be2.Size(); b2++)
    {
-      Array<int> b_vtx2;
       comp2->GetBdrElementVertices(be2[b2], b_vtx2);
 
-      Array<int> b2_vtx1(b_vtx2.Size());
-      for (int v = 0; v < b2_vtx1.Size(); v++)
+      std::vector<int> b2_vtx1(b_vtx2.Size());
+      for (int v = 0; v < b_vtx2.Size(); v++)
       {
          assert(port->vtx2to1.count(b_vtx2[v]));
          b2_vtx1[v] = port->vtx2to1[b_vtx2[v]];
       }
-      b2_vtx1.Sort();
+      std::sort(b2_vtx1.begin(), b2_vtx1.end());
 
-      for (int b1 = 0; b1 < be1.Size(); b1++)
+      auto b1_it = be1_by_vtx.find(b2_vtx1);
+      if (b1_it != be1_by_vtx.end())
       {
-         Array<int> b1_vtx1;
-         comp1->GetBdrElementVertices(be1[b1], b1_vtx1);
-
-         assert(b2_vtx1.Size() == b1_vtx1.Size());
-         b1_vtx1.Sort();
-
-         bool match = true;
-         for (int v = 0; v < b1_vtx1.Size(); v++)
-            if (b1_vtx1[v] != b2_vtx1[v])
-            {
-               match = false;
-               break;
-            }
-         
-         if (match)
-         {
-            int *be_pair = port->be_pairs.GetRow(b2);
-            be_pair[0] = be1[b1];
-            be_pair[1] = be2[b2];
-            break;
-         }
-      }  // for (int b1 = 0; b1 < be1.Size(); b1++)
+         int *be_pair = port->be_pairs.GetRow(b2);
+         be_pair[0] = be1[b1_it->second];
+         be_pair[1] = be2[b2];
+      }
    }  // for (int b2 = 0; b2 < be2.Size(); b2++)
 
    for (int i = 0; i < port->be_pairs.NumRows(); i++)
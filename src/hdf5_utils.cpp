@@ -4,6 +4,9 @@
 
 #include "hdf5_utils.hpp"
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 using namespace mfem;
 
@@ -382,6 +385,186 @@ void WriteDataset(hid_t &source, std::string dataset, const Vector &value)
    assert(errf >= 0);
 }
 
+hid_t CreateExtendibleDataset(hid_t &source, std::string dataset, const int nrow)
+{
+   herr_t errf = 0;
+   assert(nrow > 0);
+
+   // transposed layout as in WriteDataset(DenseMatrix): dims[0] is the number of columns.
+   hsize_t dims[2] = {0, static_cast<hsize_t>(nrow)};
+   hsize_t max_dims[2] = {H5S_UNLIMITED, static_cast<hsize_t>(nrow)};
+   hsize_t chunk_dims[2] = {1, static_cast<hsize_t>(nrow)};
+
+   hid_t dspace_id = H5Screate_simple(2, dims, max_dims);
+   assert(dspace_id >= 0);
+
+   hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+   errf = H5Pset_chunk(plist_id, 2, chunk_dims);
+   assert(errf >= 0);
+
+   hid_t dset_id = H5Dcreate2(source, dataset.c_str(), H5T_NATIVE_DOUBLE, dspace_id, H5P_DEFAULT, plist_id, H5P_DEFAULT);
+   assert(dset_id >= 0);
+
+   errf = H5Pclose(plist_id);
+   assert(errf >= 0);
+   errf = H5Sclose(dspace_id);
+   assert(errf >= 0);
+
+   return dset_id;
+}
+
+void AppendColumn(hid_t &dset_id, const int nrow, int &ncol, const double *data)
+{
+   herr_t errf = 0;
+
+   hsize_t dims[2] = {static_cast<hsize_t>(ncol + 1), static_cast<hsize_t>(nrow)};
+   errf = H5Dset_extent(dset_id, dims);
+   assert(errf >= 0);
+
+   hid_t fspace_id = H5Dget_space(dset_id);
+   hsize_t start[2] = {static_cast<hsize_t>(ncol), 0};
+   hsize_t count[2] = {1, static_cast<hsize_t>(nrow)};
+   errf = H5Sselect_hyperslab(fspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+   assert(errf >= 0);
+
+   hid_t mspace_id = H5Screate_simple(2, count, NULL);
+   errf = H5Dwrite(dset_id, H5T_NATIVE_DOUBLE, mspace_id, fspace_id, H5P_DEFAULT, data);
+   assert(errf >= 0);
+
+   errf = H5Sclose(mspace_id);
+   assert(errf >= 0);
+   errf = H5Sclose(fspace_id);
+   assert(errf >= 0);
+
+   ncol++;
+}
+
+void GetMatrixDatasetSize(hid_t &source, std::string dataset, int &nrow, int &ncol)
+{
+   herr_t errf = 0;
+
+   hid_t dset_id = H5Dopen(source, dataset.c_str(), H5P_DEFAULT);
+   assert(dset_id >= 0);
+
+   hid_t dspace_id = H5Dget_space(dset_id);
+   int ndims = H5Sget_simple_extent_ndims(dspace_id);
+   assert(ndims == 2);
+
+   hsize_t dims[ndims];
+   errf = H5Sget_simple_extent_dims(dspace_id, dims, NULL);
+   assert(errf >= 0);
+
+   // transposed layout.
+   nrow = dims[1];
+   ncol = dims[0];
+
+   errf = H5Sclose(dspace_id);
+   assert(errf >= 0);
+   errf = H5Dclose(dset_id);
+   assert(errf >= 0);
+}
+
+void ReadDatasetBlock(hid_t &source, std::string dataset, const int row_begin, const int col_begin, DenseMatrix &value)
+{
+   herr_t errf = 0;
+   if ((value.NumRows() == 0) || (value.NumCols() == 0))
+      return;
+
+   hid_t dset_id = H5Dopen(source, dataset.c_str(), H5P_DEFAULT);
+   assert(dset_id >= 0);
+
+   // transposed layout: select columns as the rows of the dataset.
+   hid_t fspace_id = H5Dget_space(dset_id);
+   hsize_t start[2] = {static_cast<hsize_t>(col_begin), static_cast<hsize_t>(row_begin)};
+   hsize_t count[2] = {static_cast<hsize_t>(value.NumCols()), static_cast<hsize_t>(value.NumRows())};
+   errf = H5Sselect_hyperslab(fspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+   assert(errf >= 0);
+
+   hid_t mspace_id = H5Screate_simple(2, count, NULL);
+   errf = H5Dread(dset_id, H5T_NATIVE_DOUBLE, mspace_id, fspace_id, H5P_DEFAULT, value.Write());
+   assert(errf >= 0);
+
+   errf = H5Sclose(mspace_id);
+   assert(errf >= 0);
+   errf = H5Sclose(fspace_id);
+   assert(errf >= 0);
+   errf = H5Dclose(dset_id);
+   assert(errf >= 0);
+}
+
+double* MapDataset(hid_t &source, std::string dataset, int &size, void* &map_addr, size_t &map_length)
+{
+   herr_t errf = 0;
+   size = 0;
+   map_addr = NULL;
+   map_length = 0;
+
+   hid_t dset_id = H5Dopen(source, dataset.c_str(), H5P_DEFAULT);
+   assert(dset_id >= 0);
+
+   hid_t dspace_id = H5Dget_space(dset_id);
+   int ndims = H5Sget_simple_extent_ndims(dspace_id);
+   assert(ndims == 1);
+
+   hsize_t dims[1];
+   errf = H5Sget_simple_extent_dims(dspace_id, dims, NULL);
+   assert(errf >= 0);
+
+   hid_t dtype_id = H5Dget_type(dset_id);
+   const bool native = (H5Tequal(dtype_id, H5T_NATIVE_DOUBLE) > 0);
+   // HADDR_UNDEF if the dataset is chunked or not allocated.
+   const haddr_t offset = H5Dget_offset(dset_id);
+
+   double *data = NULL;
+   if (native && (dims[0] > 0) && (offset != HADDR_UNDEF) && (offset % sizeof(double) == 0))
+   {
+      ssize_t name_len = H5Fget_name(dset_id, NULL, 0);
+      assert(name_len > 0);
+      std::vector<char> filename(name_len + 1);
+      H5Fget_name(dset_id, filename.data(), name_len + 1);
+
+      int fd = open(filename.data(), O_RDONLY);
+      if (fd >= 0)
+      {
+         // mmap offset must be aligned to the page size.
+         const size_t page_size = sysconf(_SC_PAGESIZE);
+         const size_t page_offset = offset % page_size;
+         map_length = page_offset + dims[0] * sizeof(double);
+
+         // private mapping, so that the data can be modified in memory without touching the file.
+         map_addr = mmap(NULL, map_length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset - page_offset);
+         close(fd);
+
+         if (map_addr == MAP_FAILED)
+         {
+            map_addr = NULL;
+            map_length = 0;
+         }
+         else
+         {
+            data = reinterpret_cast<double *>(static_cast<char *>(map_addr) + page_offset);
+            size = dims[0];
+         }
+      }
+   }
+
+   errf = H5Tclose(dtype_id);
+   assert(errf >= 0);
+   errf = H5Sclose(dspace_id);
+   assert(errf >= 0);
+   errf = H5Dclose(dset_id);
+   assert(errf >= 0);
+
+   return data;
+}
+
+void UnmapDataset(void *map_addr, const size_t map_length)
+{
+   if (!map_addr) return;
+   int err = munmap(map_addr, map_length);
+   assert(err == 0);
+}
+
 void ReadDataset(hid_t &source, std::string dataset, DenseTensor &value)
 {
    herr_t errf = 0;
@@ -4,12 +4,74 @@
 
 #include "hyperreduction_integ.hpp"
 #include "linalg_utils.hpp"
+#include "utils/mpi_utils.h"  // this is from libROM/utils.
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
 namespace mfem
 {
 
+void EQPElement::AllocateCoefficients(
+   const int dim_, const int nbasis1_, const int nbasis2_, const bool has_dshape_,
+   const std::string &basis_fingerprint_)
+{
+   ReleaseCoefficients();
+
+   dim = dim_;
+   nbasis1 = nbasis1_;
+   nbasis2 = nbasis2_;
+   has_dshape = has_dshape_;
+   basis_fingerprint = basis_fingerprint_;
+   assert((dim > 0) && (nbasis1 > 0) && (nbasis2 >= 0));
+
+   coeffs.SetSize(GetCoefficientSize() * samples.Size());
+   coeffs = 0.0;
+
+   SetSampleViews();
+}
+
+void EQPElement::ReleaseCoefficients()
+{
+   coeffs.Destroy();
+   hdf5_utils::UnmapDataset(coeffs_map, coeffs_map_length);
+   coeffs_map = NULL;
+   coeffs_map_length = 0;
+   coeffs_loaded = false;
+   basis_fingerprint = "";
+}
+
+void EQPElement::SetSampleViews()
+{
+   assert(coeffs.Size() == GetCoefficientSize() * samples.Size());
+   const int dim2 = (has_dshape) ? dim * dim : 0;
+
+   double *d_coeffs = coeffs.GetData();
+   for (int s = 0; s < samples.Size(); s++)
+   {
+      EQPSample *sample = samples[s];
+
+      sample->weight = d_coeffs;
+      d_coeffs++;
+
+      sample->shape1.UseExternalData(d_coeffs, dim, nbasis1);
+      d_coeffs += dim * nbasis1;
+      sample->dshape1 = (has_dshape) ? d_coeffs : NULL;
+      d_coeffs += dim2 * nbasis1;
+
+      if (nbasis2 > 0)
+         sample->shape2.UseExternalData(d_coeffs, dim, nbasis2);
+      else
+         sample->shape2.ClearExternalData();
+      d_coeffs += dim * nbasis2;
+      sample->dshape2 = (has_dshape && (nbasis2 > 0)) ? d_coeffs : NULL;
+      d_coeffs += dim2 * nbasis2;
+   }
+   assert(d_coeffs == coeffs.GetData() + coeffs.Size());
+}
+
 void EQPElement::Save(hid_t file_id, const std::string &dsetname, const IntegratorType type)
 {
    std::string eldset;
@@ -48,6 +110,16 @@ void EQPElement::Save(hid_t file_id, const std::string &dsetname, const Integrat
    hdf5_utils::WriteDataset(grp_id, "quad-pt", qp);
    hdf5_utils::WriteDataset(grp_id, "quad-wt", qw);
 
+   if (coeffs.Size() > 0)
+   {
+      hdf5_utils::WriteAttribute(grp_id, "dim", dim);
+      hdf5_utils::WriteAttribute(grp_id, "nbasis1", nbasis1);
+      hdf5_utils::WriteAttribute(grp_id, "nbasis2", nbasis2);
+      hdf5_utils::WriteAttribute(grp_id, "has_dshape", has_dshape);
+      hdf5_utils::WriteAttribute(grp_id, "basis_fingerprint", basis_fingerprint);
+      hdf5_utils::WriteDataset(grp_id, "coefficients", coeffs);
+   }
+
    errf = H5Gclose(grp_id);
    assert(errf >= 0);
 }
@@ -79,12 +151,82 @@ void EQPElement::Load(hid_t file_id, const std::string &dsetname, const Integrat
    hdf5_utils::ReadDataset(grp_id, "quad-pt", qp);
    hdf5_utils::ReadDataset(grp_id, "quad-wt", qw);
 
-   errf = H5Gclose(grp_id);
-   assert(errf >= 0);
-
+   DeletePointers(samples);
    samples.SetSize(el.Size());
    for (int k = 0; k < el.Size(); k++)
       samples[k] = new EQPSample(SampleInfo({.el=el[k], .qp=qp[k], .qw=qw[k]}));
+
+   ReleaseCoefficients();
+   if (hdf5_utils::pathExists(grp_id, "coefficients"))
+   {
+      hdf5_utils::ReadAttribute(grp_id, "dim", dim);
+      hdf5_utils::ReadAttribute(grp_id, "nbasis1", nbasis1);
+      hdf5_utils::ReadAttribute(grp_id, "nbasis2", nbasis2);
+      hdf5_utils::ReadAttribute(grp_id, "has_dshape", has_dshape);
+      // without the fingerprint, the coefficients are never reused (see HasLoadedCoefficients).
+      if (H5Aexists(grp_id, "basis_fingerprint") > 0)
+         hdf5_utils::ReadAttribute(grp_id, "basis_fingerprint", basis_fingerprint);
+
+      int size;
+      double *data = hdf5_utils::MapDataset(grp_id, "coefficients", size, coeffs_map, coeffs_map_length);
+      if (data)
+         coeffs.SetDataAndSize(data, size);
+      else
+         hdf5_utils::ReadDataset(grp_id, "coefficients", coeffs);
+
+      SetSampleViews();
+      coeffs_loaded = true;
+   }
+
+   errf = H5Gclose(grp_id);
+   assert(errf >= 0);
+}
+
+void GetEQPElementRange(const int ne_global, const bool distributed, int &e_begin, int &e_end)
+{
+   e_begin = 0;
+   e_end = ne_global;
+   if (!distributed) return;
+
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   const int ne = CAROM::split_dimension(ne_global, MPI_COMM_WORLD);
+   std::vector<int> elem_offsets;
+   int dummy = CAROM::get_global_offsets(ne, elem_offsets, MPI_COMM_WORLD);
+   assert(dummy == ne_global);
+
+   e_begin = elem_offsets[rank];
+   e_end = elem_offsets[rank+1];
+}
+
+void BroadcastSampleInfos(Array<SampleInfo> &samples, const int root, MPI_Comm comm)
+{
+   int rank;
+   MPI_Comm_rank(comm, &rank);
+
+   int size = samples.Size();
+   MPI_Bcast(&size, 1, MPI_INT, root, comm);
+
+   Array<int> el(size), qp(size);
+   Array<double> qw(size);
+   if (rank == root)
+      for (int s = 0; s < size; s++)
+      {
+         el[s] = samples[s].el;
+         qp[s] = samples[s].qp;
+         qw[s] = samples[s].qw;
+      }
+
+   MPI_Bcast(el.GetData(), size, MPI_INT, root, comm);
+   MPI_Bcast(qp.GetData(), size, MPI_INT, root, comm);
+   MPI_Bcast(qw.GetData(), size, MPI_DOUBLE, root, comm);
+
+   if (rank == root) return;
+
+   samples.SetSize(size);
+   for (int s = 0; s < size; s++)
+      samples[s] = {.el = el[s], .qp = qp[s], .qw = qw[s]};
 }
 
 void HyperReductionIntegrator::AssembleQuadratureVector(
@@ -103,6 +245,32 @@ void HyperReductionIntegrator::AssembleQuadratureVector(
                "for face is not implemented for this class.");
 }
 
+void HyperReductionIntegrator::AssembleQuadratureVectors(
+   const FiniteElement &el, ElementTransformation &T, const IntegrationPoint &ip,
+   const double &iw, const DenseMatrix &eltests, DenseMatrix &elquads)
+{
+   elquads.SetSize(eltests.NumRows(), eltests.NumCols());
+   for (int i = 0; i < eltests.NumCols(); i++)
+   {
+      const Vector eltest(const_cast<double *>(eltests.GetColumn(i)), eltests.NumRows());
+      Vector elquad(elquads.GetColumn(i), elquads.NumRows());
+      AssembleQuadratureVector(el, T, ip, iw, eltest, elquad);
+   }
+}
+
+void HyperReductionIntegrator::AssembleQuadratureVectors(
+   const FiniteElement &el1, const FiniteElement &el2, FaceElementTransformations &T,
+   const IntegrationPoint &ip, const double &iw, const DenseMatrix &eltests, DenseMatrix &elquads)
+{
+   elquads.SetSize(eltests.NumRows(), eltests.NumCols());
+   for (int i = 0; i < eltests.NumCols(); i++)
+   {
+      const Vector eltest(const_cast<double *>(eltests.GetColumn(i)), eltests.NumRows());
+      Vector elquad(elquads.GetColumn(i), elquads.NumRows());
+      AssembleQuadratureVector(el1, el2, T, ip, iw, eltest, elquad);
+   }
+}
+
 void HyperReductionIntegrator::AssembleQuadratureGrad(
    const FiniteElement &el, ElementTransformation &T, const IntegrationPoint &ip,
    const double &iw, const Vector &eltest, DenseMatrix &quadmat)
@@ -175,6 +343,23 @@ void HyperReductionIntegrator::AddAssembleGrad_Fast(
                "even though this class is set to be precomputable!\n");
 }
 
+void HyperReductionIntegrator::ReserveFastScratch(const int num_threads)
+{
+   assert(num_threads > 0);
+   if (fast_scratch.size() < num_threads)
+      fast_scratch.resize(num_threads);
+}
+
+HyperReductionIntegrator::FastScratch& HyperReductionIntegrator::GetFastScratch()
+{
+   int tid = 0;
+#ifdef _OPENMP
+   tid = omp_get_thread_num();
+#endif
+   assert(tid < fast_scratch.size());
+   return fast_scratch[tid];
+}
+
 void HyperReductionIntegrator::GetBasisElement(
    DenseMatrix &basis, const int col, const Array<int> vdofs, Vector &basis_el, DofTransformation *dof_trans)
 {
@@ -323,6 +508,47 @@ void VectorConvectionTrilinearFormIntegrator::AssembleQuadratureVector(
    MultVWt(shape, vec2, ELV);
 }
 
+void VectorConvectionTrilinearFormIntegrator::AssembleQuadratureVectors(
+   const FiniteElement &el,
+   ElementTransformation &T,
+   const IntegrationPoint &ip,
+   const double &iw,
+   const DenseMatrix &eltests,
+   DenseMatrix &elquads)
+{
+   const int nd = el.GetDof();
+   const int eldim = el.GetDim();
+   const int ncol = eltests.NumCols();
+   assert(eltests.NumRows() == nd * eldim);
+   elquads.SetSize(nd * eldim, ncol);
+
+   /* local work space only, so that this can be called from multiple threads. */
+   Vector shape_ip(nd), vec1(eldim), vec2(eldim);
+   DenseMatrix dshape_ip(nd, eldim), gradEF_ip(eldim), EF_i, ELV_i;
+
+   /* geometry and shape functions are evaluated once for all columns. */
+   T.SetIntPoint(&ip);
+   el.CalcShape(ip, shape_ip);
+   el.CalcPhysDShape(T, dshape_ip);
+   double w = iw * T.Weight();
+   if (Q) { w *= Q->Eval(T, ip); }
+   if (vQ) { vQ->Eval(vec1, T, ip); }
+
+   for (int i = 0; i < ncol; i++)
+   {
+      EF_i.UseExternalData(const_cast<double *>(eltests.GetColumn(i)), nd, eldim);
+      ELV_i.UseExternalData(elquads.GetColumn(i), nd, eldim);
+
+      MultAtB(EF_i, dshape_ip, gradEF_ip);
+      if (!vQ)
+         EF_i.MultTranspose(shape_ip, vec1);
+      gradEF_ip.Mult(vec1, vec2);
+      vec2 *= w;
+
+      MultVWt(shape_ip, vec2, ELV_i);
+   }
+}
+
 void VectorConvectionTrilinearFormIntegrator::AssembleElementGrad(
    const FiniteElement &el,
    ElementTransformation &trans,
@@ -466,69 +692,89 @@ void VectorConvectionTrilinearFormIntegrator::AssembleQuadratureGrad(
 void VectorConvectionTrilinearFormIntegrator::AddAssembleVector_Fast(
    const EQPSample &eqp_sample, ElementTransformation &T, const Vector &x, Vector &y)
 {
-   const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
-   const double qw = eqp_sample.info.qw;
-   DenseMatrix *shape1 = eqp_sample.shape1;
-   const Array<DenseMatrix *> *gradEFs = &eqp_sample.dshape1;
+   const DenseMatrix &shape1 = eqp_sample.shape1;
+   assert(eqp_sample.dshape1);
 
-   T.SetIntPoint(&ip);
-   double w = qw * T.Weight();
-   if (Q) 
+   // jacobian determinant is already included in the precomputed weight.
+   double w = *eqp_sample.weight;
+   if (Q)
+   {
+      const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
+      T.SetIntPoint(&ip);
       w *= Q->Eval(T, ip);
+   }
 
-   dim = shape1->NumRows();
-   Vector vec1(dim), vec2(dim);
-   shape1->Mult(x, vec1);
-
+   const int dim = shape1.NumRows();
+   const int nbasis = shape1.NumCols();
+   FastScratch &scratch = GetFastScratch();
+   Vector &vec1 = scratch.vec1, &vec2 = scratch.vec2;
+   vec1.SetSize(dim);
+   vec2.SetSize(dim);
+   shape1.Mult(x, vec1);
+
+   /*
+      gradient matrices of all basis are contiguous,
+      so gradEF = sum_k x(k) * dshape1_k is a single matrix-vector product.
+   */
+   DenseMatrix &gradEF = scratch.mat1;
    gradEF.SetSize(dim);
-   gradEF = 0.0;
-   for (int k = 0; k < gradEFs->Size(); k++)
-      gradEF.Add(x(k), *((*gradEFs)[k]));
+   const DenseMatrix dshape1(eqp_sample.dshape1, dim * dim, nbasis);
+   Vector gradEF_vec(gradEF.GetData(), dim * dim);
+   dshape1.Mult(x, gradEF_vec);
    gradEF.Mult(vec1, vec2);
 
    assert(y.Size() == x.Size());
-   shape1->AddMultTranspose(vec2, y, w);
+   shape1.AddMultTranspose(vec2, y, w);
 }
 
 void VectorConvectionTrilinearFormIntegrator::AddAssembleGrad_Fast(
    const EQPSample &eqp_sample, ElementTransformation &T, const Vector &x, DenseMatrix &jac)
 {
-   const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
-   const double qw = eqp_sample.info.qw;
-   DenseMatrix *shape1 = eqp_sample.shape1;
-   const Array<DenseMatrix *> *gradEFs = &eqp_sample.dshape1;
-   
-   T.SetIntPoint(&ip);
-   double w = qw * T.Weight();
-   if (Q) 
+   const DenseMatrix &shape1 = eqp_sample.shape1;
+   assert(eqp_sample.dshape1);
+
+   // jacobian determinant is already included in the precomputed weight.
+   double w = *eqp_sample.weight;
+   if (Q)
+   {
+      const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
+      T.SetIntPoint(&ip);
       w *= Q->Eval(T, ip);
+   }
 
-   dim = shape1->NumRows();
-   int nbasis = shape1->NumCols();
-   Vector vec1(dim), vec2(dim);
-   shape1->Mult(x, vec1);
+   const int dim = shape1.NumRows();
+   const int nbasis = shape1.NumCols();
+   FastScratch &scratch = GetFastScratch();
+   Vector &vec1 = scratch.vec1;
+   vec1.SetSize(dim);
+   shape1.Mult(x, vec1);
 
+   DenseMatrix &gradEF = scratch.mat1;
    gradEF.SetSize(dim);
-   gradEF = 0.0;
-   for (int k = 0; k < gradEFs->Size(); k++)
-      gradEF.Add(x(k), *((*gradEFs)[k]));
+   const DenseMatrix dshape1(eqp_sample.dshape1, dim * dim, nbasis);
+   Vector gradEF_vec(gradEF.GetData(), dim * dim);
+   dshape1.Mult(x, gradEF_vec);
    gradEF *= w;
 
+   DenseMatrix &ELV = scratch.mat2;
    ELV.SetSize(dim, nbasis);
-   Mult(gradEF, *shape1, ELV);
+   Mult(gradEF, shape1, ELV);
 
-   for (int k = 0; k < nbasis; k++)
+   // column views only, which do not own any data.
+   Vector ELV_col, jac_col;
+   double *d_dshape = eqp_sample.dshape1;
+   for (int k = 0; k < nbasis; k++, d_dshape += dim * dim)
    {
-      ELV.GetColumnReference(k, vec2);
-      (*gradEFs)[k]->AddMult(vec1, vec2, w);
+      ELV.GetColumnReference(k, ELV_col);
+      const DenseMatrix gradEF_k(d_dshape, dim, dim);
+      gradEF_k.AddMult(vec1, ELV_col, w);
    }
 
-   Vector jac_col;
    for (int k = 0; k < nbasis; k++)
    {
       jac.GetColumnReference(k, jac_col);
-      ELV.GetColumnReference(k, vec2);
-      shape1->AddMultTranspose(vec2, jac_col);
+      ELV.GetColumnReference(k, ELV_col);
+      shape1.AddMultTranspose(ELV_col, jac_col);
    }
 }
 
@@ -672,6 +918,39 @@ void IncompressibleInviscidFluxNLFIntegrator::AssembleQuadratureVector(
    AddMult_a(w, dshape, uu, ELV);
 }
 
+void IncompressibleInviscidFluxNLFIntegrator::AssembleQuadratureVectors(
+   const FiniteElement &el, ElementTransformation &T, const IntegrationPoint &ip,
+   const double &iw, const DenseMatrix &eltests, DenseMatrix &elquads)
+{
+   const int nd = el.GetDof();
+   const int eldim = el.GetDim();
+   const int ncol = eltests.NumCols();
+   assert(eltests.NumRows() == nd * eldim);
+   elquads.SetSize(nd * eldim, ncol);
+
+   /* local work space only, so that this can be called from multiple threads. */
+   Vector shape_ip(nd), u1(eldim);
+   DenseMatrix dshape_ip(nd, eldim), uu_ip(eldim), EF_i, ELV_i;
+
+   /* geometry and shape functions are evaluated once for all columns. */
+   T.SetIntPoint(&ip);
+   el.CalcShape(ip, shape_ip);
+   el.CalcPhysDShape(T, dshape_ip);
+   double w = iw * T.Weight();
+   if (Q) { w *= Q->Eval(T, ip); }
+
+   for (int i = 0; i < ncol; i++)
+   {
+      EF_i.UseExternalData(const_cast<double *>(eltests.GetColumn(i)), nd, eldim);
+      ELV_i.UseExternalData(elquads.GetColumn(i), nd, eldim);
+      ELV_i = 0.0;
+
+      EF_i.MultTranspose(shape_ip, u1);
+      MultVVt(u1, uu_ip);
+      AddMult_a(w, dshape_ip, uu_ip, ELV_i);
+   }
+}
+
 void IncompressibleInviscidFluxNLFIntegrator::AssembleQuadratureGrad(
    const FiniteElement &el, ElementTransformation &trans, const IntegrationPoint &ip,
    const double &iw, const Vector &elfun, DenseMatrix &elmat)
@@ -729,54 +1008,72 @@ void IncompressibleInviscidFluxNLFIntegrator::AssembleQuadratureGrad(
 void IncompressibleInviscidFluxNLFIntegrator::AddAssembleVector_Fast(
    const EQPSample &eqp_sample, ElementTransformation &T, const Vector &x, Vector &y)
 {
-   const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
-   const double qw = eqp_sample.info.qw;
-   DenseMatrix *shape1 = eqp_sample.shape1;
-   const Array<DenseMatrix *> *dshape = &eqp_sample.dshape1;
-
-   T.SetIntPoint(&ip);
-   double w = qw * T.Weight();
-   if (Q) 
-      w *= Q->Eval(T, ip);
-
-   dim = shape1->NumRows();
-   Vector u1(dim);
-   shape1->Mult(x, u1);
+   const DenseMatrix &shape1 = eqp_sample.shape1;
+   assert(eqp_sample.dshape1);
 
-   Vector vec1(dim);
-   assert(y.Size() == dshape->Size());
-   for (int k = 0; k < dshape->Size(); k++)
+   // jacobian determinant is already included in the precomputed weight.
+   double w = *eqp_sample.weight;
+   if (Q)
    {
-      (*dshape)[k]->Mult(u1, vec1);
-      y(k) += w * (u1 * vec1);
+      const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
+      T.SetIntPoint(&ip);
+      w *= Q->Eval(T, ip);
    }
+
+   const int dim = shape1.NumRows();
+   const int nbasis = shape1.NumCols();
+   FastScratch &scratch = GetFastScratch();
+   Vector &u1 = scratch.vec1;
+   u1.SetSize(dim);
+   shape1.Mult(x, u1);
+
+   /*
+      y(k) += w * u1^T dshape1_k u1 for all k,
+      which is a single transposed matrix-vector product with u1 u1^T.
+   */
+   DenseMatrix &u1u1 = scratch.mat1;
+   u1u1.SetSize(dim);
+   MultVVt(u1, u1u1);
+   Vector u1u1_vec(u1u1.GetData(), dim * dim);
+
+   assert(y.Size() == nbasis);
+   const DenseMatrix dshape1(eqp_sample.dshape1, dim * dim, nbasis);
+   dshape1.AddMultTranspose(u1u1_vec, y, w);
 }
 
 void IncompressibleInviscidFluxNLFIntegrator::AddAssembleGrad_Fast(
    const EQPSample &eqp_sample, ElementTransformation &T, const Vector &x, DenseMatrix &jac)
 {
-   const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
-   const double qw = eqp_sample.info.qw;
-   DenseMatrix *shape1 = eqp_sample.shape1;
-   const Array<DenseMatrix *> *dshape = &eqp_sample.dshape1;
+   const DenseMatrix &shape1 = eqp_sample.shape1;
+   assert(eqp_sample.dshape1);
 
-   T.SetIntPoint(&ip);
-   double w = qw * T.Weight();
-   if (Q) 
+   // jacobian determinant is already included in the precomputed weight.
+   double w = *eqp_sample.weight;
+   if (Q)
+   {
+      const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
+      T.SetIntPoint(&ip);
       w *= Q->Eval(T, ip);
+   }
 
-   dim = shape1->NumRows();
-   int nbasis = shape1->NumCols();
-   Vector u1(dim), vec1(dim), vec2(nbasis);
-   shape1->Mult(x, u1);
+   const int dim = shape1.NumRows();
+   const int nbasis = shape1.NumCols();
+   FastScratch &scratch = GetFastScratch();
+   Vector &u1 = scratch.vec1, &vec1 = scratch.vec2, &vec2 = scratch.vec3;
+   u1.SetSize(dim);
+   vec1.SetSize(dim);
+   vec2.SetSize(nbasis);
+   shape1.Mult(x, u1);
 
    u1 *= w;
 
-   for (int i = 0; i < nbasis; i++)
+   double *d_dshape = eqp_sample.dshape1;
+   for (int i = 0; i < nbasis; i++, d_dshape += dim * dim)
    {
-      (*dshape)[i]->Mult(u1, vec1);
-      (*dshape)[i]->AddMultTranspose(u1, vec1);
-      shape1->MultTranspose(vec1, vec2);
+      const DenseMatrix dshape_i(d_dshape, dim, dim);
+      dshape_i.Mult(u1, vec1);
+      dshape_i.AddMultTranspose(u1, vec1);
+      shape1.MultTranspose(vec1, vec2);
 
       double *d_jac = jac.GetData() + i;
       for (int j = 0; j < nbasis; j++)
@@ -4,6 +4,11 @@
 
 #include "input_parser.hpp"
 #include <stdlib.h>
+#include <atomic>
+
+// source of the revision stamps, shared by all InputParser instances.
+// atomic, since private copies of config can be modified on different threads.
+static std::atomic<long> revision_counter(0);
 
 InputParser::InputParser(const std::string &input_file, const std::string forced_input)
 {
@@ -42,10 +47,16 @@ InputParser::InputParser(const std::string &input_file, const std::string forced
    }
 
    OverwriteOption(forced_input);
+   UpdateRevision();
 
    return;
 }
 
+void InputParser::UpdateRevision()
+{
+   revision = ++revision_counter;
+}
+
 YAML::Node InputParser::FindNodeFromDict(const std::string &keys, YAML::Node input_dict, bool create)
 {
    // Per tutorial of yaml-cpp, operator= *seems* to be a shallow copy.
@@ -99,4 +110,30 @@ void InputParser::OverwriteOption(const std::string &forced_input)
 
 // template int InputParser::GetRequiredOption<int>(const std::string&);
 
+void IterativeSolverOptions::Compile(InputParser &parser)
+{
+   max_iter = parser.GetOption<int>(prefix + "/max_iter", max_iter_default);
+   rtol = parser.GetOption<double>(prefix + "/relative_tolerance", rtol_default);
+   atol = parser.GetOption<double>(prefix + "/absolute_tolerance", atol_default);
+   print_level = parser.GetOption<int>(prefix + "/print_level", print_level_default);
+}
+
+void LinearSolverOptions::Compile(InputParser &parser)
+{
+   IterativeSolverOptions::Compile(parser);
+   block_diag_prec = parser.GetOption<bool>(prefix + "/block_diagonal_preconditioner", true);
+}
+
+void NonlinearSolverOptions::Compile(InputParser &parser)
+{
+   newton.Update(parser);
+   jacobian.Update(parser);
+
+   use_lbfgs = parser.GetOption<bool>("solver/use_lbfgs", false);
+   use_restart = parser.GetOption<bool>("solver/use_restart", false);
+   restart_file = "";
+   if (use_restart)
+      restart_file = parser.GetRequiredOption<std::string>("solver/restart_file");
+}
+
 InputParser config;
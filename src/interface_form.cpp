@@ -32,8 +32,6 @@ void InterfaceForm::AssembleInterfaceMatrices(Array2D<SparseMatrix *> &mats) con
 {
    assert(mats.NumRows() == numSub);
    assert(mats.NumCols() == numSub);
-   for (int i = 0; i < numSub; i++)
-      for (int j = 0; j < numSub; j++) assert(mats(i, j));
 
    const PortInfo *pInfo;
    Array<int> midx(2);
@@ -49,8 +47,15 @@ void InterfaceForm::AssembleInterfaceMatrices(Array2D<SparseMatrix *> &mats) con
       midx[0] = pInfo->Mesh1;
       midx[1] = pInfo->Mesh2;
       
+      // NULL row blocks (e.g. not owned by this rank with the distributed solve) are skipped.
+      bool any_block = false;
       for (int i = 0; i < 2; i++)
-         for (int j = 0; j < 2; j++) mats_p(i, j) = mats(midx[i], midx[j]);
+         for (int j = 0; j < 2; j++)
+         {
+            mats_p(i, j) = mats(midx[i], midx[j]);
+            any_block = any_block || (mats_p(i, j) != NULL);
+         }
+      if (!any_block) continue;
 
       mesh1 = meshes[midx[0]];
       mesh2 = meshes[midx[1]];
@@ -88,7 +93,7 @@ void InterfaceForm::InterfaceAddMult(const Vector &x, Vector &y) const
       Array<InterfaceInfo>* const interface_infos = topol_handler->GetInterfaceInfos(p);
       AssembleInterfaceVector(mesh1, mesh2, fes1, fes2, interface_infos,
                               x_tmp.GetBlock(midx[0]), x_tmp.GetBlock(midx[1]),
-                              y_tmp.GetBlock(midx[0]), y_tmp.GetBlock(midx[1]));
+                              y_tmp.GetBlock(midx[0]), y_tmp.GetBlock(midx[1]), p);
    }  // for (int p = 0; p < topol_handler->GetNumPorts(); p++)
 
    for (int i=0; i < y_tmp.NumBlocks(); ++i)
@@ -129,7 +134,7 @@ void InterfaceForm::InterfaceGetGradient(const Vector &x, Array2D<SparseMatrix *
 
       Array<InterfaceInfo>* const interface_infos = topol_handler->GetInterfaceInfos(p);
       AssembleInterfaceGrad(mesh1, mesh2, fes1, fes2, interface_infos,
-                            x_tmp.GetBlock(midx[0]), x_tmp.GetBlock(midx[1]), mats_p);
+                            x_tmp.GetBlock(midx[0]), x_tmp.GetBlock(midx[1]), mats_p, p);
    }  // for (int p = 0; p < topol_handler->GetNumPorts(); p++)
 }
 
@@ -167,6 +172,7 @@ void InterfaceForm::AssembleInterfaceMatrix(
 
             for (int i = 0; i < 2; i++) {
                for (int j = 0; j < 2; j++) {
+                  if (!mats(i, j)) continue;
                   mats(i, j)->AddSubMatrix(*vdofs[i], *vdofs[j], *elemmats(i,j), skip_zeros);
                }
             }
@@ -223,7 +229,7 @@ void InterfaceForm::AssembleInterfaceMatrixAtPort(
 
 void InterfaceForm::AssembleInterfaceVector(Mesh *mesh1, Mesh *mesh2,
    FiniteElementSpace *fes1, FiniteElementSpace *fes2, Array<InterfaceInfo> *interface_infos,
-   const Vector &x1, const Vector &x2, Vector &y1, Vector &y2) const
+   const Vector &x1, const Vector &x2, Vector &y1, Vector &y2, const int p) const
 {
    assert(x1.Size() == fes1->GetTrueVSize());
    assert(x2.Size() == fes2->GetTrueVSize());
@@ -239,7 +245,10 @@ void InterfaceForm::AssembleInterfaceVector(Mesh *mesh1, Mesh *mesh2,
    {
       InterfaceInfo *if_info = &((*interface_infos)[bn]);
 
-      topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
+      if (p >= 0)
+         topol_handler->GetPortInterfaceTransformations(mesh1, mesh2, p, bn, tr1, tr2);
+      else
+         topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
 
       if ((tr1 != NULL) && (tr2 != NULL))
       {
@@ -268,7 +277,7 @@ void InterfaceForm::AssembleInterfaceVector(Mesh *mesh1, Mesh *mesh2,
 
 void InterfaceForm::AssembleInterfaceGrad(Mesh *mesh1, Mesh *mesh2,
    FiniteElementSpace *fes1, FiniteElementSpace *fes2, Array<InterfaceInfo> *interface_infos,
-   const Vector &x1, const Vector &x2, Array2D<SparseMatrix*> &mats) const
+   const Vector &x1, const Vector &x2, Array2D<SparseMatrix*> &mats, const int p) const
 {
    assert(x1.Size() == fes1->GetTrueVSize());
    assert(x2.Size() == fes2->GetTrueVSize());
@@ -285,7 +294,10 @@ void InterfaceForm::AssembleInterfaceGrad(Mesh *mesh1, Mesh *mesh2,
    {
       InterfaceInfo *if_info = &((*interface_infos)[bn]);
 
-      topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
+      if (p >= 0)
+         topol_handler->GetPortInterfaceTransformations(mesh1, mesh2, p, bn, tr1, tr2);
+      else
+         topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
 
       if ((tr1 != NULL) && (tr2 != NULL))
       {
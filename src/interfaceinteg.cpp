@@ -54,6 +54,26 @@ void InterfaceNonlinearFormIntegrator::AssembleQuadratureVector(
              "   is not implemented for this class.");
 }
 
+void InterfaceNonlinearFormIntegrator::AssembleQuadratureVectors(
+   const FiniteElement &el1, const FiniteElement &el2,
+   FaceElementTransformations &Tr1, FaceElementTransformations &Tr2,
+   const IntegrationPoint &ip, const double &iw,
+   const DenseMatrix &eltests1, const DenseMatrix &eltests2,
+   DenseMatrix &elquads1, DenseMatrix &elquads2)
+{
+   assert(eltests1.NumCols() == eltests2.NumCols());
+   elquads1.SetSize(eltests1.NumRows(), eltests1.NumCols());
+   elquads2.SetSize(eltests2.NumRows(), eltests2.NumCols());
+   for (int i = 0; i < eltests1.NumCols(); i++)
+   {
+      const Vector eltest1(const_cast<double *>(eltests1.GetColumn(i)), eltests1.NumRows());
+      const Vector eltest2(const_cast<double *>(eltests2.GetColumn(i)), eltests2.NumRows());
+      Vector elquad1(elquads1.GetColumn(i), elquads1.NumRows());
+      Vector elquad2(elquads2.GetColumn(i), elquads2.NumRows());
+      AssembleQuadratureVector(el1, el2, Tr1, Tr2, ip, iw, eltest1, eltest2, elquad1, elquad2);
+   }
+}
+
 void InterfaceNonlinearFormIntegrator::AssembleQuadratureGrad(
    const FiniteElement &el1, const FiniteElement &el2,
    FaceElementTransformations &Tr1, FaceElementTransformations &Tr2,
@@ -1659,6 +1679,71 @@ void DGLaxFriedrichsFluxIntegrator::AssembleQuadratureVector(
    AssembleQuadVectorBase(el1, el2, &T, NULL, ip, iw, ndofs2, udof1, udof2, elv1, elv2);
 }
 
+void DGLaxFriedrichsFluxIntegrator::AssembleQuadratureVectors(
+   const FiniteElement &el1, const FiniteElement &el2, FaceElementTransformations &T,
+   const IntegrationPoint &ip, const double &iw, const DenseMatrix &eltests, DenseMatrix &elquads)
+{
+   dim = el1.GetDim();
+   ndofs1 = el1.GetDof();
+   ndofs2 = (T.Elem2No >= 0) ? el2.GetDof() : 0;
+   nvdofs = dim * (ndofs1 + ndofs2);
+   const int ncol = eltests.NumCols();
+   assert(eltests.NumRows() == nvdofs);
+   elquads.SetSize(nvdofs, ncol);
+   elquads = 0.0;
+
+   nor.SetSize(dim);
+   flux.SetSize(dim);
+   shape1.SetSize(ndofs1);
+   u1.SetSize(dim);
+   u2.SetSize(dim);
+   if (ndofs2) shape2.SetSize(ndofs2);
+
+   bool eval2 = (ndofs2 || UD);
+
+   /* geometry, shape functions and coefficients are evaluated once for all columns. */
+   T.SetAllIntPoints(&ip);
+   const IntegrationPoint &eip1 = T.GetElement1IntPoint();
+   el1.CalcShape(eip1, shape1);
+   if (ndofs2)
+      el2.CalcShape(T.GetElement2IntPoint(), shape2);
+   /* if Dirichlet bc, the boundary value is the same for all columns. */
+   else if (UD)
+      UD->Eval(u2, *(T.Elem1), eip1);
+
+   if (dim == 1)
+   {
+      nor(0) = 2*eip1.x - 1.0;
+   }
+   else
+   {
+      CalcOrtho(T.Jacobian(), nor);
+   }
+
+   w = iw;
+   if (Q) { w *= Q->Eval(T, ip); }
+
+   for (int i = 0; i < ncol; i++)
+   {
+      double *eltest = const_cast<double *>(eltests.GetColumn(i));
+      udof1.UseExternalData(eltest, ndofs1, dim);
+      elv1.UseExternalData(elquads.GetColumn(i), ndofs1, dim);
+      udof1.MultTranspose(shape1, u1);
+      if (ndofs2)
+      {
+         udof2.UseExternalData(eltest + ndofs1 * dim, ndofs2, dim);
+         elv2.UseExternalData(elquads.GetColumn(i) + ndofs1 * dim, ndofs2, dim);
+         udof2.MultTranspose(shape2, u2);
+      }
+
+      ComputeFluxDotN(u1, u2, nor, eval2, flux);
+
+      AddMult_a_VWt(-w, shape1, flux, elv1);
+      if (ndofs2)
+         AddMult_a_VWt(w, shape2, flux, elv2);
+   }
+}
+
 void DGLaxFriedrichsFluxIntegrator::AssembleQuadratureGrad(
    const FiniteElement &el1, const FiniteElement &el2, FaceElementTransformations &T,
    const IntegrationPoint &ip, const double &iw, const Vector &eltest, DenseMatrix &quadmat)
@@ -1714,12 +1799,12 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleVector_Fast(
 {
    const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
    const double qw = eqp_sample.info.qw;
-   DenseMatrix *shapes1 = eqp_sample.shape1;
-   DenseMatrix *shapes2 = eqp_sample.shape2;
+   const DenseMatrix &shapes1 = eqp_sample.shape1;
+   const DenseMatrix &shapes2 = eqp_sample.shape2;
 
    const bool el2 = (T.Elem2No >= 0);
 
-   dim = shapes1->NumRows();
+   dim = shapes1.NumRows();
    nor.SetSize(dim);
    flux.SetSize(dim);
    u1.SetSize(dim);
@@ -1733,9 +1818,9 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleVector_Fast(
    const IntegrationPoint &eip1 = T.GetElement1IntPoint();
    // const IntegrationPoint &eip2 = T.GetElement2IntPoint();
 
-   shapes1->Mult(x, u1);
+   shapes1.Mult(x, u1);
    if (el2)
-      shapes2->Mult(x, u2);
+      shapes2.Mult(x, u2);
    else if (UD)
       UD->Eval(u2, *(T.Elem1), eip1);
 
@@ -1754,8 +1839,8 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleVector_Fast(
    if (Q) { w *= Q->Eval(T, ip); }
 
    assert(y.Size() == x.Size());
-   shapes1->AddMultTranspose(flux, y, -w);
-   if (el2) shapes2->AddMultTranspose(flux, y, w);
+   shapes1.AddMultTranspose(flux, y, -w);
+   if (el2) shapes2.AddMultTranspose(flux, y, w);
 }
 
 void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
@@ -1763,12 +1848,12 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
 {
    const IntegrationPoint &ip = GetIntegrationRule()->IntPoint(eqp_sample.info.qp);
    const double qw = eqp_sample.info.qw;
-   DenseMatrix *shapes1 = eqp_sample.shape1;
-   DenseMatrix *shapes2 = eqp_sample.shape2;
+   const DenseMatrix &shapes1 = eqp_sample.shape1;
+   const DenseMatrix &shapes2 = eqp_sample.shape2;
 
    const bool el2 = (T.Elem2No >= 0);
 
-   dim = shapes1->NumRows();
+   dim = shapes1.NumRows();
    nor.SetSize(dim);
    flux.SetSize(dim);
    u1.SetSize(dim);
@@ -1784,9 +1869,9 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
    const IntegrationPoint &eip1 = T.GetElement1IntPoint();
    // const IntegrationPoint &eip2 = T.GetElement2IntPoint();
 
-   shapes1->Mult(x, u1);
+   shapes1.Mult(x, u1);
    if (el2)
-      shapes2->Mult(x, u2);
+      shapes2.Mult(x, u2);
    else if (UD)
       UD->Eval(u2, *(T.Elem1), eip1);
 
@@ -1805,12 +1890,17 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
    if (Q) 
       w *= Q->Eval(T, ip);
 
-   AddwRtAP(*shapes1, gradu1, *shapes1, jac, -w);
+   // non-owning views of the packed coefficients, as AddwRtAP takes non-const matrices.
+   DenseMatrix R1(shapes1.GetData(), dim, shapes1.NumCols());
+   DenseMatrix R2;
+   if (el2) R2.UseExternalData(shapes2.GetData(), dim, shapes2.NumCols());
+
+   AddwRtAP(R1, gradu1, R1, jac, -w);
    if (el2)
    {
-      AddwRtAP(*shapes2, gradu1, *shapes1, jac, w);
-      AddwRtAP(*shapes1, gradu2, *shapes2, jac, -w);
-      AddwRtAP(*shapes2, gradu2, *shapes2, jac, w);
+      AddwRtAP(R2, gradu1, R1, jac, w);
+      AddwRtAP(R1, gradu2, R2, jac, -w);
+      AddwRtAP(R2, gradu2, R2, jac, w);
    }
 }
 
@@ -1959,6 +2049,68 @@ void DGLaxFriedrichsFluxIntegrator::AssembleQuadratureVector(
    AssembleQuadVectorBase(el1, el2, &Tr1, &Tr2, ip, iw, ndofs2, udof1, udof2, elv1, elv2);
 }
 
+void DGLaxFriedrichsFluxIntegrator::AssembleQuadratureVectors(
+   const FiniteElement &el1, const FiniteElement &el2,
+   FaceElementTransformations &Tr1, FaceElementTransformations &Tr2,
+   const IntegrationPoint &ip, const double &iw,
+   const DenseMatrix &eltests1, const DenseMatrix &eltests2,
+   DenseMatrix &elquads1, DenseMatrix &elquads2)
+{
+   dim = el1.GetDim();
+   ndofs1 = el1.GetDof();
+   ndofs2 = el2.GetDof();
+   nvdofs = dim * (ndofs1 + ndofs2);
+   const int ncol = eltests1.NumCols();
+   assert(eltests2.NumCols() == ncol);
+   assert(eltests1.NumRows() == dim * ndofs1);
+   assert(eltests2.NumRows() == dim * ndofs2);
+   elquads1.SetSize(dim * ndofs1, ncol);
+   elquads2.SetSize(dim * ndofs2, ncol);
+   elquads1 = 0.0; elquads2 = 0.0;
+
+   nor.SetSize(dim);
+   flux.SetSize(dim);
+   shape1.SetSize(ndofs1);
+   shape2.SetSize(ndofs2);
+   u1.SetSize(dim);
+   u2.SetSize(dim);
+
+   /* geometry, shape functions and coefficients are evaluated once for all column pairs. */
+   Tr1.SetAllIntPoints(&ip);
+   Tr2.SetAllIntPoints(&ip);
+   const IntegrationPoint &eip1 = Tr1.GetElement1IntPoint();
+   const IntegrationPoint &eip2 = Tr2.GetElement1IntPoint();
+   el1.CalcShape(eip1, shape1);
+   el2.CalcShape(eip2, shape2);
+
+   if (dim == 1)
+   {
+      nor(0) = 2*eip1.x - 1.0;
+   }
+   else
+   {
+      CalcOrtho(Tr1.Jacobian(), nor);
+   }
+
+   w = iw;
+   if (Q) { w *= Q->Eval(Tr1, ip); }
+
+   for (int i = 0; i < ncol; i++)
+   {
+      udof1.UseExternalData(const_cast<double *>(eltests1.GetColumn(i)), ndofs1, dim);
+      udof2.UseExternalData(const_cast<double *>(eltests2.GetColumn(i)), ndofs2, dim);
+      elv1.UseExternalData(elquads1.GetColumn(i), ndofs1, dim);
+      elv2.UseExternalData(elquads2.GetColumn(i), ndofs2, dim);
+      udof1.MultTranspose(shape1, u1);
+      udof2.MultTranspose(shape2, u2);
+
+      ComputeFluxDotN(u1, u2, nor, true, flux);
+
+      AddMult_a_VWt(-w, shape1, flux, elv1);
+      AddMult_a_VWt(w, shape2, flux, elv2);
+   }
+}
+
 void DGLaxFriedrichsFluxIntegrator::AssembleQuadratureGrad(
    const FiniteElement &el1, const FiniteElement &el2,
    FaceElementTransformations &Tr1, FaceElementTransformations &Tr2,
@@ -2026,10 +2178,10 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleVector_Fast(
    const IntegrationRule *ir = GetIntegrationRule();
    const IntegrationPoint &ip = ir->IntPoint(eqp_sample.info.qp);
    const double qw = eqp_sample.info.qw;
-   DenseMatrix *shapes1 = eqp_sample.shape1;
-   DenseMatrix *shapes2 = eqp_sample.shape2;
+   const DenseMatrix &shapes1 = eqp_sample.shape1;
+   const DenseMatrix &shapes2 = eqp_sample.shape2;
 
-   dim = shapes1->NumRows();
+   dim = shapes1.NumRows();
    nor.SetSize(dim);
    flux.SetSize(dim);
    u1.SetSize(dim);
@@ -2041,8 +2193,8 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleVector_Fast(
    const IntegrationPoint &eip1 = Tr1.GetElement1IntPoint();
    // const IntegrationPoint &eip2 = T.GetElement2IntPoint();
 
-   shapes1->Mult(x1, u1);
-   shapes2->Mult(x2, u2);
+   shapes1.Mult(x1, u1);
+   shapes2.Mult(x2, u2);
 
    if (dim == 1)
    {
@@ -2060,8 +2212,8 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleVector_Fast(
 
    assert(y1.Size() == x1.Size());
    assert(y2.Size() == x2.Size());
-   shapes1->AddMultTranspose(flux, y1, -w);
-   shapes2->AddMultTranspose(flux, y2, w);
+   shapes1.AddMultTranspose(flux, y1, -w);
+   shapes2.AddMultTranspose(flux, y2, w);
 }
 
 void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
@@ -2072,10 +2224,10 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
    const IntegrationRule *ir = GetIntegrationRule();
    const IntegrationPoint &ip = ir->IntPoint(eqp_sample.info.qp);
    const double qw = eqp_sample.info.qw;
-   DenseMatrix *shapes1 = eqp_sample.shape1;
-   DenseMatrix *shapes2 = eqp_sample.shape2;
+   const DenseMatrix &shapes1 = eqp_sample.shape1;
+   const DenseMatrix &shapes2 = eqp_sample.shape2;
 
-   dim = shapes1->NumRows();
+   dim = shapes1.NumRows();
    nor.SetSize(dim);
    flux.SetSize(dim);
    u1.SetSize(dim);
@@ -2089,8 +2241,8 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
    const IntegrationPoint &eip1 = Tr1.GetElement1IntPoint();
    // const IntegrationPoint &eip2 = T.GetElement2IntPoint();
 
-   shapes1->Mult(x1, u1);
-   shapes2->Mult(x2, u2);
+   shapes1.Mult(x1, u1);
+   shapes2.Mult(x2, u2);
 
    if (dim == 1)
    {
@@ -2108,10 +2260,14 @@ void DGLaxFriedrichsFluxIntegrator::AddAssembleGrad_Fast(
    if (Q) 
       w *= Q->Eval(Tr1, ip);
 
-   AddwRtAP(*shapes1, gradu1, *shapes1, *jac(0, 0), -w);
-   AddwRtAP(*shapes2, gradu1, *shapes1, *jac(1, 0), w);
-   AddwRtAP(*shapes1, gradu2, *shapes2, *jac(0, 1), -w);
-   AddwRtAP(*shapes2, gradu2, *shapes2, *jac(1, 1), w);
+   // non-owning views of the packed coefficients, as AddwRtAP takes non-const matrices.
+   DenseMatrix R1(shapes1.GetData(), dim, shapes1.NumCols());
+   DenseMatrix R2(shapes2.GetData(), dim, shapes2.NumCols());
+
+   AddwRtAP(R1, gradu1, R1, *jac(0, 0), -w);
+   AddwRtAP(R2, gradu1, R1, *jac(1, 0), w);
+   AddwRtAP(R1, gradu2, R2, *jac(0, 1), -w);
+   AddwRtAP(R2, gradu2, R2, *jac(1, 1), w);
 }
 
 }
@@ -4,6 +4,9 @@
 
 #include "linalg_utils.hpp"
 #include "utils/HDFDatabase.h"
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
 
 using namespace mfem;
 using namespace std;
@@ -183,6 +186,85 @@ void modifiedGramSchmidt(DenseMatrix& mat)
    }
 }
 
+/* a pivot of the Gram matrix below this relative to its diagonal breaks CholQR down. */
+static const double cholqr_breakdown_tol = 1.0e-14;
+/* maximum deviation of Q^T * Q from identity accepted for BlockOrthonormalize. */
+static const double orthonormality_tol = 1.0e-12;
+
+/*
+   One pass of CholQR: mat = mat * R^{-1}, with R^T * R = mat^T * mat.
+   Returns false without modifying mat if the Cholesky factorization breaks down.
+*/
+static bool CholQRPass(DenseMatrix& mat)
+{
+   const int ncol = mat.NumCols();
+   DenseMatrix gram(ncol), L(ncol);
+   MultAtB(mat, mat, gram);
+
+   /* lower Cholesky factor L = R^T of the Gram matrix. */
+   L = 0.0;
+   for (int j = 0; j < ncol; j++)
+   {
+      double pivot = gram(j, j);
+      for (int k = 0; k < j; k++)
+         pivot -= L(j, k) * L(j, k);
+      if (!(pivot > cholqr_breakdown_tol * gram(j, j)))
+         return false;
+      L(j, j) = sqrt(pivot);
+
+      for (int i = j + 1; i < ncol; i++)
+      {
+         double val = gram(i, j);
+         for (int k = 0; k < j; k++)
+            val -= L(i, k) * L(j, k);
+         L(i, j) = val / L(j, j);
+      }
+   }
+
+   /* R^{-1} = L^{-T} is upper triangular. */
+   DenseMatrix Rinv(ncol);
+   Rinv = 0.0;
+   for (int j = 0; j < ncol; j++)
+   {
+      // column j of L^{-1} by forward substitution, stored as row j of L^{-T}.
+      for (int i = j; i < ncol; i++)
+      {
+         double val = (i == j) ? 1.0 : 0.0;
+         for (int k = j; k < i; k++)
+            val -= L(i, k) * Rinv(j, k);
+         Rinv(j, i) = val / L(i, i);
+      }
+   }
+
+   DenseMatrix tmp(mat);
+   Mult(tmp, Rinv, mat);
+   return true;
+}
+
+void BlockOrthonormalize(DenseMatrix& mat)
+{
+   const int ncol = mat.NumCols();
+   if (ncol == 0) return;
+
+   bool success = CholQRPass(mat) && CholQRPass(mat);
+
+   if (success)
+   {
+      DenseMatrix gram(ncol);
+      MultAtB(mat, mat, gram);
+      for (int i = 0; i < ncol; i++)
+         gram(i, i) -= 1.0;
+      success = (gram.MaxMaxNorm() < orthonormality_tol);
+   }
+
+   if (!success)
+   {
+      /* ill-conditioned columns: modified Gram-Schmidt with reorthogonalization. */
+      modifiedGramSchmidt(mat);
+      modifiedGramSchmidt(mat);
+   }
+}
+
 void Orthonormalize(DenseMatrix& mat1, DenseMatrix& mat)
 {
    const int num_row = mat.NumRows();
@@ -190,22 +272,319 @@ void Orthonormalize(DenseMatrix& mat1, DenseMatrix& mat)
    const int num_col1 = mat1.NumCols();
    assert(num_row == mat1.NumRows());
 
-   Vector vec_c, tmp;
-   double tmp_dot;
    /* we don't assume mat1 is normalized. */
+   Vector norm1(num_col1), tmp;
    for (int i = 0; i < num_col1; i++)
    {
       mat1.GetColumnReference(i, tmp);
-      tmp_dot = (tmp * tmp);
-      for (int c = 0; c < num_col; c++)
+      norm1(i) = 1.0 / (tmp * tmp);
+   }
+
+   /* block classical Gram-Schmidt, twice for the loss of orthogonality in the first pass. */
+   DenseMatrix coeff(num_col1, num_col);
+   for (int pass = 0; pass < 2; pass++)
+   {
+      MultAtB(mat1, mat, coeff);
+      coeff.LeftScaling(norm1);
+      AddMult_a(-1.0, mat1, coeff, mat);
+   }
+
+   BlockOrthonormalize(mat);
+}
+
+/* relative tolerance under which a new NNLS column is regarded as linearly dependent. */
+static const double nnls_dependence_tol = 1.0e-12;
+/* NNLS solution entries below this are removed from the passive set. */
+static const double nnls_zero_tol = 1.0e-14;
+
+/*
+   Append the column j of G as the column np of the thin QR factorization Q * R,
+   by modified Gram-Schmidt with one reorthogonalization.
+   Returns false if the column is numerically dependent on the first np columns of Q.
+*/
+static bool AppendNNLSColumn(const DenseMatrix &G, const int j, const int np,
+                             DenseMatrix &Q, DenseMatrix &R)
+{
+   const int m = G.NumRows();
+   Vector q(Q.GetColumn(np), m), qk;
+   for (int i = 0; i < m; i++)
+      q(i) = G(i, j);
+
+   const double gnorm = q.Norml2();
+   for (int k = 0; k < np; k++)
+      R(k, np) = 0.0;
+
+   for (int pass = 0; pass < 2; pass++)
+      for (int k = 0; k < np; k++)
       {
-         mat.GetColumnReference(c, vec_c);
-         vec_c.Add(-(tmp * vec_c) / tmp_dot, tmp);
+         Q.GetColumnReference(k, qk);
+         const double rk = qk * q;
+         R(k, np) += rk;
+         q.Add(-rk, qk);
       }
+
+   const double qnorm = q.Norml2();
+   if (qnorm <= nnls_dependence_tol * gnorm)
+      return false;
+
+   q /= qnorm;
+   R(np, np) = qnorm;
+   return true;
+}
+
+/* Least-squares solution z of the first np columns of Q * R against b. */
+static void SolveNNLSLeastSquares(DenseMatrix &Q, const DenseMatrix &R, const int np,
+                                  const Vector &b, Vector &z)
+{
+   Vector qk;
+   z.SetSize(np);
+   for (int k = 0; k < np; k++)
+   {
+      Q.GetColumnReference(k, qk);
+      z(k) = qk * b;
    }
 
-   /* modified Gram-Schmidt orthonormalization */
-   modifiedGramSchmidt(mat);
+   for (int k = np - 1; k >= 0; k--)
+   {
+      for (int l = k + 1; l < np; l++)
+         z(k) -= R(k, l) * z(l);
+      z(k) /= R(k, k);
+   }
+}
+
+bool SolveBoundedNNLS(const DenseMatrix &G, const Vector &rhs_lb, const Vector &rhs_ub, Vector &sol,
+                      const CAROM::NNLS_termination criterion, const int max_iter)
+{
+   const int m = G.NumRows();
+   const int n = G.NumCols();
+   assert((rhs_lb.Size() == m) && (rhs_ub.Size() == m));
+
+   // least-squares target at the center of the bounds.
+   Vector b(m), halfgap(m);
+   add(0.5, rhs_lb, 0.5, rhs_ub, b);
+   add(0.5, rhs_ub, -0.5, rhs_lb, halfgap);
+   const double l2_halfgap = halfgap.Norml2();
+
+   sol.SetSize(n);
+   sol = 0.0;
+
+   /* 0: free, 1: passive, -1: excluded as a dependent or non-improving column. */
+   Array<int> state(n);
+   state = 0;
+   // passive set, in the order of the columns of Q.
+   Array<int> passive, passive_old;
+   int np = 0;
+
+   const int max_np = std::min(m, n);
+   DenseMatrix Q(m, max_np), R(max_np);
+   Vector res(b), grad(n), z;
+
+   bool converged = false;
+   for (int iter = 0; iter < max_iter; iter++)
+   {
+      /* check the termination with G * sol = b - res. */
+      if (criterion == CAROM::NNLS_termination::L2)
+         converged = (res.Norml2() <= l2_halfgap);
+      else
+      {
+         converged = true;
+         for (int i = 0; i < m; i++)
+         {
+            const double Gx = b(i) - res(i);
+            if ((Gx < rhs_lb(i)) || (Gx > rhs_ub(i)))
+            {
+               converged = false;
+               break;
+            }
+         }
+      }
+      if (converged || (np == max_np)) break;
+
+      /* the free column most correlated with the residual enters the passive set. */
+      G.MultTranspose(res, grad);
+      int jmax = -1;
+      double gmax = 0.0;
+      for (int j = 0; j < n; j++)
+         if ((state[j] == 0) && (grad(j) > gmax))
+         {
+            jmax = j;
+            gmax = grad(j);
+         }
+      if (jmax < 0) break;
+
+      if (!AppendNNLSColumn(G, jmax, np, Q, R))
+      {
+         state[jmax] = -1;
+         continue;
+      }
+      state[jmax] = 1;
+      passive.Append(jmax);
+      np++;
+
+      SolveNNLSLeastSquares(Q, R, np, b, z);
+      /*
+         In exact arithmetic the new entry is positive.
+         Otherwise the column does not improve the solution, and would cycle forever.
+      */
+      if (z(np - 1) <= 0.0)
+      {
+         state[jmax] = -1;
+         passive.DeleteLast();
+         np--;
+         continue;
+      }
+
+      /* inner loop: move toward z while keeping sol feasible. */
+      while (true)
+      {
+         double alpha = 1.0;
+         int kmin = -1;
+         for (int k = 0; k < np; k++)
+         {
+            if (z(k) > 0.0) continue;
+            const double xk = sol(passive[k]);
+            if ((kmin < 0) || (xk / (xk - z(k)) < alpha))
+            {
+               alpha = xk / (xk - z(k));
+               kmin = k;
+            }
+         }
+         const bool feasible = (kmin < 0);
+
+         if (feasible)
+         {
+            for (int k = 0; k < np; k++)
+               sol(passive[k]) = z(k);
+            break;
+         }
+
+         for (int k = 0; k < np; k++)
+            sol(passive[k]) += alpha * (z(k) - sol(passive[k]));
+         // the blocking entry leaves the passive set regardless of round-off.
+         sol(passive[kmin]) = 0.0;
+
+         /* remove vanishing entries from the passive set and refactorize. */
+         passive_old = passive;
+         passive.SetSize(0);
+         np = 0;
+         for (int k = 0; k < passive_old.Size(); k++)
+         {
+            const int j = passive_old[k];
+            if ((sol(j) > nnls_zero_tol) && AppendNNLSColumn(G, j, np, Q, R))
+            {
+               passive.Append(j);
+               np++;
+            }
+            else
+            {
+               sol(j) = 0.0;
+               state[j] = 0;
+            }
+         }
+         if (np == 0) break;
+
+         SolveNNLSLeastSquares(Q, R, np, b, z);
+      }
+
+      /* residual of the updated solution. */
+      res = b;
+      for (int k = 0; k < np; k++)
+      {
+         const int j = passive[k];
+         for (int i = 0; i < m; i++)
+            res(i) -= sol(j) * G(i, j);
+      }
+
+      /*
+         Excluded columns were dependent on, or not improving with, the previous passive set and residual.
+         Both have changed, so they are candidates again.
+         In exact arithmetic, the least-squares residual strictly decreases with every accepted column,
+         so this does not cycle. max_iter bounds it otherwise.
+      */
+      for (int j = 0; j < n; j++)
+         if (state[j] < 0) state[j] = 0;
+   }
+
+   return converged;
+}
+
+/* number of basis columns processed together in the blocked RtAP kernels. */
+static const int rtap_block_width = 16;
+/* relative tolerance under which A is treated as symmetric in RtAP. */
+static const double rtap_symmetry_tol = 1.0e-14;
+
+void MultDenseBlock(const Operator& A,
+                    const DenseMatrix& P,
+                    DenseMatrix& AP)
+{
+   assert(A.NumCols() == P.NumRows());
+
+   const int nrow = A.NumRows();
+   const int ncol = P.NumCols();
+   AP.SetSize(nrow, ncol);
+   if ((nrow == 0) || (ncol == 0)) return;
+
+   const SparseMatrix *spA = dynamic_cast<const SparseMatrix *>(&A);
+   if ((!spA) || (!spA->Finalized()))
+   {
+      /* generic operator: one action per column, written in-place into AP. */
+      Vector P_j, AP_j;
+      for (int j = 0; j < ncol; j++)
+      {
+         const_cast<DenseMatrix &>(P).GetColumnReference(j, P_j);
+         AP.GetColumnReference(j, AP_j);
+         A.Mult(P_j, AP_j);
+      }
+      return;
+   }
+
+   /*
+      Multi-vector SpMM. The CSR structure is traversed once per block of
+      rtap_block_width columns, instead of once per column.
+   */
+   const int *I = spA->GetI();
+   const int *J = spA->GetJ();
+   const double *data = spA->GetData();
+   const int prow = P.NumRows();
+   const double *d_P = P.Data();
+   double *d_AP = AP.Data();
+
+   double acc[rtap_block_width];
+   for (int j0 = 0; j0 < ncol; j0 += rtap_block_width)
+   {
+      const int nb = std::min(rtap_block_width, ncol - j0);
+      const double *P_blk = d_P + j0 * prow;
+      double *AP_blk = d_AP + j0 * nrow;
+
+      for (int r = 0; r < nrow; r++)
+      {
+         for (int b = 0; b < nb; b++) acc[b] = 0.0;
+
+         for (int k = I[r]; k < I[r+1]; k++)
+         {
+            const double a = data[k];
+            const double *P_row = P_blk + J[k];
+            for (int b = 0; b < nb; b++)
+               acc[b] += a * P_row[b * prow];
+         }
+
+         for (int b = 0; b < nb; b++)
+            AP_blk[r + b * nrow] = acc[b];
+      }
+   }
+}
+
+void MultTransposeDenseBlock(const SparseMatrix& A,
+                             const DenseMatrix& P,
+                             DenseMatrix& AtP)
+{
+   assert(A.Finalized());
+   assert(A.NumRows() == P.NumRows());
+
+   /* transposing costs only O(nnz), after which the multi-vector SpMM applies. */
+   SparseMatrix *At = Transpose(A);
+   MultDenseBlock(*At, P, AtP);
+   delete At;
 }
 
 void RtAP(DenseMatrix& R,
@@ -218,19 +597,42 @@ void RtAP(DenseMatrix& R,
 
    const int num_row = R.NumCols();
    const int num_col = P.NumCols();
+
+   DenseMatrix AP;
+   MultDenseBlock(A, P, AP);
+
+   /*
+      Symmetric fast path: for R == P and a symmetric A, only the upper
+      triangle of P^t A P is computed, one column block at a time, and mirrored.
+   */
+   const SparseMatrix *spA = dynamic_cast<const SparseMatrix *>(&A);
+   const bool symmetric = (&R == &P) && spA && spA->Finalized()
+                          && (spA->IsSymmetric() <= rtap_symmetry_tol * spA->MaxNorm());
+   if (!symmetric)
+   {
+      // BLAS-backed gemm, if mfem is built with LAPACK.
+      MultAtB(R, AP, RtAP);
+      return;
+   }
+
+   const int nrow = P.NumRows();
    RtAP.SetSize(num_row, num_col);
-   Vector vec_i, vec_j;
-   for (int i = 0; i < num_row; i++)
-      for (int j = 0; j < num_col; j++)
-      {
-         R.GetColumnReference(i, vec_i);
-         P.GetColumnReference(j, vec_j);
-         // NOTE: mfem::SparseMatrix.InnerProduct(x, y) computes y^t A x
-         Vector tmp(vec_i.Size());
-         tmp = 0.0;
-         A.Mult(vec_j, tmp);
-         RtAP(i, j) = vec_i * tmp;
-      }
+   DenseMatrix P_upper, AP_blk, RtAP_blk;
+   for (int j0 = 0; j0 < num_col; j0 += rtap_block_width)
+   {
+      const int j1 = std::min(j0 + rtap_block_width, num_col);
+
+      // columns of P up to j1 and columns [j0, j1) of AP are contiguous.
+      P_upper.UseExternalData(P.Data(), nrow, j1);
+      AP_blk.UseExternalData(AP.Data() + j0 * nrow, nrow, j1 - j0);
+      MultAtB(P_upper, AP_blk, RtAP_blk);
+
+      for (int j = j0; j < j1; j++)
+         for (int i = 0; i <= j; i++)
+            RtAP(i, j) = RtAP(j, i) = RtAP_blk(i, j - j0);
+   }
+   P_upper.ClearExternalData();
+   AP_blk.ClearExternalData();
 }
 
 DenseMatrix* DenseRtAP(DenseMatrix& R,
@@ -249,19 +651,14 @@ SparseMatrix* SparseRtAP(DenseMatrix& R,
 
    const int num_row = R.NumCols();
    const int num_col = P.NumCols();
+
+   DenseMatrix RAP_dense;
+   RtAP(R, A, P, RAP_dense);
+
    SparseMatrix *RAP = new SparseMatrix(num_row, num_col);
-   Vector vec_i, vec_j;
    for (int i = 0; i < num_row; i++)
       for (int j = 0; j < num_col; j++)
-      {
-         R.GetColumnReference(i, vec_i);
-         P.GetColumnReference(j, vec_j);
-         // NOTE: mfem::SparseMatrix.InnerProduct(x, y) computes y^t A x
-         Vector tmp(vec_i.Size());
-         tmp = 0.0;
-         A.Mult(vec_j, tmp);
-         RAP->Set(i, j, vec_i * tmp);
-      }
+         RAP->Set(i, j, RAP_dense(i, j));
    RAP->Finalize();
 
    return RAP;
@@ -280,18 +677,10 @@ void AddwRtAP(DenseMatrix& R,
    const int num_col = P.NumCols();
    assert(RtAP.NumRows() == num_row);
    assert(RtAP.NumCols() == num_col);
-   
-   Vector vec_i, vec_j;
-   Vector tmp(R.NumRows());
-   for (int i = 0; i < num_row; i++)
-      for (int j = 0; j < num_col; j++)
-      {
-         R.GetColumnReference(i, vec_i);
-         P.GetColumnReference(j, vec_j);
-         
-         A.Mult(vec_j, tmp);
-         RtAP(i, j) += w * (vec_i * tmp);
-      }
+
+   DenseMatrix RAP_dense;
+   mfem::RtAP(R, A, P, RAP_dense);
+   RtAP.Add(w, RAP_dense);
 }
 
 void AddwRtAP(DenseMatrix& R,
@@ -307,18 +696,12 @@ void AddwRtAP(DenseMatrix& R,
    const int num_col = P.NumCols();
    assert(RtAP.NumRows() == num_row);
    assert(RtAP.NumCols() == num_col);
-   
-   Vector vec_i, vec_j;
-   Vector tmp(R.NumRows());
+
+   DenseMatrix RAP_dense;
+   mfem::RtAP(R, A, P, RAP_dense);
    for (int i = 0; i < num_row; i++)
       for (int j = 0; j < num_col; j++)
-      {
-         R.GetColumnReference(i, vec_i);
-         P.GetColumnReference(j, vec_j);
-         
-         A.Mult(vec_j, tmp);
-         RtAP.Add(i, j, w * (vec_i * tmp));
-      }
+         RtAP.Add(i, j, w * RAP_dense(i, j));
 }
 
 template<typename T>
@@ -574,53 +957,115 @@ void AddSubMatrixRtAP(const DenseMatrix& R, const Array<int> &Rrows,
          RAP.Add(i, j, (*d_tmp));
 }
 
+/*
+   Dense kernels for the tensor contractions.
+   DenseTensor slices T_{..k} are column-major matrices, so all kernels below
+   stream through the tensor contiguously. The inner loops are unit-stride and
+   free of loop-carried pointer increments, so that the compiler vectorizes them
+   with the SIMD width of the target (e.g. AVX2/AVX-512 with -march=native).
+*/
+
+/* y += A * x, for a column-major A of size nrow x ncol. Four columns are accumulated per sweep over y. */
+static inline void DenseColAddMult(const double *A, const int nrow, const int ncol,
+                                   const double *x, double *y)
+{
+   int j = 0;
+   for (; j + 3 < ncol; j += 4)
+   {
+      const double *a0 = A + j * nrow;
+      const double *a1 = a0 + nrow, *a2 = a1 + nrow, *a3 = a2 + nrow;
+      const double x0 = x[j], x1 = x[j+1], x2 = x[j+2], x3 = x[j+3];
+      for (int i = 0; i < nrow; i++)
+         y[i] += a0[i] * x0 + a1[i] * x1 + a2[i] * x2 + a3[i] * x3;
+   }
+   for (; j < ncol; j++)
+   {
+      const double *aj = A + j * nrow;
+      const double xj = x[j];
+      for (int i = 0; i < nrow; i++)
+         y[i] += aj[i] * xj;
+   }
+}
+
+/* dot product with independent partial sums. */
+static inline double DenseDot(const double *a, const double *b, const int n)
+{
+   double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+   int i = 0;
+   for (; i + 3 < n; i += 4)
+   {
+      s0 += a[i] * b[i];
+      s1 += a[i+1] * b[i+1];
+      s2 += a[i+2] * b[i+2];
+      s3 += a[i+3] * b[i+3];
+   }
+   for (; i < n; i++)
+      s0 += a[i] * b[i];
+   return (s0 + s1) + (s2 + s3);
+}
+
 void TensorContract(const DenseTensor &tensor, const Vector &xi, const Vector &xj, Vector &yk)
+{
+   yk.SetSize(tensor.SizeK());
+   yk = 0.0;
+   TensorAddScaledContract(tensor, 1.0, xi, xj, yk);
+}
+
+void TensorAddScaledContract(const DenseTensor &tensor, const double w, const Vector &xi, const Vector &xj, Vector &yk)
 {
    assert(xi.Size() == tensor.SizeI());
    assert(xj.Size() == tensor.SizeJ());
    yk.SetSize(tensor.SizeK());
 
-   const double *tdata = tensor.Data();
-   const double *dxi, *dxj;
-   double *dyk = yk.HostWrite();
-   for (int k = 0; k < tensor.SizeK(); k++, dyk++)
+   const int ni = tensor.SizeI(), nj = tensor.SizeJ(), nk = tensor.SizeK();
+   const double *tdata = tensor.HostRead();
+   const double *dxi = xi.HostRead();
+   const double *dxj = xj.HostRead();
+   double *dyk = yk.HostReadWrite();
+
+   /*
+      The j-contracted column C_{ik} = T_{ijk} * x_j is formed for each k
+      while the slice is in cache, then y_k += w * C_{ik} * x_i.
+   */
+   Vector Ck(ni);
+   double *dC = Ck.HostWrite();
+   for (int k = 0; k < nk; k++, tdata += ni * nj)
    {
-      (*dyk) = 0.0;
-
-      dxj = xj.HostRead();
-      for (int j = 0; j < tensor.SizeJ(); j++, dxj++)
-      {
-         dxi = xi.HostRead();
-         for (int i = 0; i < tensor.SizeI(); i++, dxi++, tdata++)
-         {
-            (*dyk) += (*tdata) * (*dxi) * (*dxj);
-         }
-      }
+      for (int i = 0; i < ni; i++) dC[i] = 0.0;
+      DenseColAddMult(tdata, ni, nj, dxj, dC);
+      dyk[k] += w * DenseDot(dC, dxi, ni);
    }
 
    return;
 }
 
-void TensorAddScaledContract(const DenseTensor &tensor, const double w, const Vector &xi, const Vector &xj, Vector &yk)
+void TensorAddScaledContract(const DenseTensor &tensor, const double w, const DenseMatrix &Xi, const DenseMatrix &Xj, DenseMatrix &Y)
 {
-   assert(xi.Size() == tensor.SizeI());
-   assert(xj.Size() == tensor.SizeJ());
-   yk.SetSize(tensor.SizeK());
+   const int ni = tensor.SizeI(), nj = tensor.SizeJ(), nk = tensor.SizeK();
+   const int nb = Xi.NumCols();
+   assert(Xi.NumRows() == ni);
+   assert(Xj.NumRows() == nj);
+   assert(Xj.NumCols() == nb);
+   assert(Y.NumRows() == nk);
+   assert(Y.NumCols() == nb);
 
-   const double *tdata = tensor.Data();
-   const double *dxi, *dxj;
-   double *dyk = yk.HostWrite();
-   for (int k = 0; k < tensor.SizeK(); k++, dyk++)
+   const double *tdata = tensor.HostRead();
+   const double *dXi = Xi.HostRead();
+   double *dY = Y.HostReadWrite();
+
+   /*
+      For each slice, the j-contracted matrix C_{ib} = T_{ijk} * Xj_{jb}
+      is formed with one gemm over the whole batch,
+      then Y_{kb} += w * C_{ib} * Xi_{ib}.
+   */
+   DenseMatrix Tk, Ck(ni, nb);
+   const double *dC = Ck.HostRead();
+   for (int k = 0; k < nk; k++, tdata += ni * nj)
    {
-      dxj = xj.HostRead();
-      for (int j = 0; j < tensor.SizeJ(); j++, dxj++)
-      {
-         dxi = xi.HostRead();
-         for (int i = 0; i < tensor.SizeI(); i++, dxi++, tdata++)
-         {
-            (*dyk) += w * (*tdata) * (*dxi) * (*dxj);
-         }
-      }
+      Tk.UseExternalData(const_cast<double *>(tdata), ni, nj);
+      mfem::Mult(Tk, Xj, Ck);
+      for (int b = 0; b < nb; b++)
+         dY[k + b * nk] += w * DenseDot(dC + b * ni, dXi + b * ni, ni);
    }
 
    return;
@@ -628,73 +1073,57 @@ void TensorAddScaledContract(const DenseTensor &tensor, const double w, const Ve
 
 void TensorMult(const DenseTensor &tensor, const Vector &x, DenseMatrix &M)
 {
+   assert(x.Size() == tensor.SizeK());
+   assert(M.NumRows() == tensor.SizeI());
+   assert(M.NumCols() == tensor.SizeJ());
    M = 0.0;
-   
-   const double *tdata = tensor.HostRead();
-   const double *dx = x.HostRead();
-   double *dM;
 
-   for (int k = 0; k < tensor.SizeK(); k++, dx++)
-   {
-      dM = M.HostReadWrite();
-      for (int j = 0; j < tensor.SizeJ(); j++)
-         for (int i = 0; i < tensor.SizeI(); i++, tdata++, dM++)
-            (*dM) += (*tdata) * (*dx);
-   }
+   // the tensor is a column-major (I*J) x K matrix.
+   DenseColAddMult(tensor.HostRead(), tensor.SizeI() * tensor.SizeJ(), tensor.SizeK(),
+                   x.HostRead(), M.HostReadWrite());
 
    return;
 }
 
 void TensorAddMultOnJ(const DenseTensor &tensor, const Vector &x, DenseMatrix &M)
-{  
-   const double *tdata;
-   const double *dx;
+{
+   assert(x.Size() == tensor.SizeJ());
+   assert(M.NumRows() == tensor.SizeI());
+   assert(M.NumCols() == tensor.SizeK());
+
+   const int ni = tensor.SizeI(), nj = tensor.SizeJ();
+   const double *tdata = tensor.HostRead();
+   const double *dx = x.HostRead();
    double *dM = M.HostReadWrite();
 
-   const int stride = tensor.SizeI();
-   for (int k = 0; k < tensor.SizeK(); k++)
-   {
-      for (int i = 0; i < tensor.SizeI(); i++, dM++)
-      {
-         dx = x.HostRead();
-         tdata = tensor.GetData(k) + i;
-         for (int j = 0; j < tensor.SizeJ(); j++)
-         {
-            (*dM) += (*tdata) * (*dx);
-            tdata += stride;
-         }
-      }
-   }
+   for (int k = 0; k < tensor.SizeK(); k++, tdata += ni * nj, dM += ni)
+      DenseColAddMult(tdata, ni, nj, dx, dM);
 
    return;
 }
 
 void TensorAddMultTranspose(const DenseTensor &tensor, const Vector &x, const int axis, DenseMatrix &M)
 {
-   int size_ax, size_nx;
-   int offset, stride;
+   TensorAddScaledMultTranspose(tensor, 1.0, x, axis, M);
+}
+
+void TensorAddScaledMultTranspose(const DenseTensor &tensor, const double w, const Vector &x, const int axis, DenseMatrix &M)
+{
+   const int ni = tensor.SizeI(), nj = tensor.SizeJ(), nk = tensor.SizeK();
    switch (axis)
    {
       case 0:
       {
-         assert(x.Size() == tensor.SizeI());
-         assert(M.NumRows() == tensor.SizeK());
-         assert(M.NumCols() == tensor.SizeJ());
-         size_ax = tensor.SizeI();
-         size_nx = tensor.SizeJ();
-         offset = tensor.SizeI();
-         stride = 1;
+         assert(x.Size() == ni);
+         assert(M.NumRows() == nk);
+         assert(M.NumCols() == nj);
       }
       break;
       case 1:
       {
-         assert(x.Size() == tensor.SizeJ());
-         assert(M.NumRows() == tensor.SizeK());
-         assert(M.NumCols() == tensor.SizeI());
-         size_ax = tensor.SizeJ();
-         size_nx = tensor.SizeI();
-         offset = 1;
-         stride = tensor.SizeI();
+         assert(x.Size() == nj);
+         assert(M.NumRows() == nk);
+         assert(M.NumCols() == ni);
       }
       break;
       default:
@@ -702,80 +1131,91 @@ void TensorAddMultTranspose(const DenseTensor &tensor, const Vector &x, const in
          break;
    }
 
-   const double *tdata, *dx;
+   const double *tdata = tensor.HostRead();
+   const double *dx = x.HostRead();
    double *dM = M.HostReadWrite();
 
-   for (int nx = 0; nx < size_nx; nx++)
+   Vector Ck((axis == 1) ? ni : 0);
+   double *dC = Ck.HostWrite();
+   for (int k = 0; k < nk; k++, tdata += ni * nj)
    {
-      for (int k = 0; k < tensor.SizeK(); k++, dM++)
+      if (axis == 0)
       {
-         // commented for AddMultTranspose.
-         // (*dM) = 0.0;
-
-         dx = x.HostRead();
-         tdata = tensor.GetData(k) + offset * nx;
-         for (int ax = 0; ax < size_ax; ax++, dx++)
-         {
-            (*dM) += (*tdata) * (*dx);
-            tdata += stride;
-         }
+         // M_{kj} += w * T_{ijk} * x_i: a column dot product per j.
+         for (int j = 0; j < nj; j++)
+            dM[k + j * nk] += w * DenseDot(tdata + j * ni, dx, ni);
+      }
+      else
+      {
+         // M_{ki} += w * T_{ijk} * x_j: a column-major gemv on the slice.
+         for (int i = 0; i < ni; i++) dC[i] = 0.0;
+         DenseColAddMult(tdata, ni, nj, dx, dC);
+         for (int i = 0; i < ni; i++)
+            dM[k + i * nk] += w * dC[i];
       }
    }
 
    return;
 }
 
-void TensorAddScaledMultTranspose(const DenseTensor &tensor, const double w, const Vector &x, const int axis, DenseMatrix &M)
+void TensorAddFusedMultTranspose(const DenseTensor &tensor, const Vector &x, DenseMatrix &M)
 {
-   int size_ax, size_nx;
-   int offset, stride;
-   switch (axis)
-   {
-      case 0:
-      {
-         assert(x.Size() == tensor.SizeI());
-         assert(M.NumRows() == tensor.SizeK());
-         assert(M.NumCols() == tensor.SizeJ());
-         size_ax = tensor.SizeI();
-         size_nx = tensor.SizeJ();
-         offset = tensor.SizeI();
-         stride = 1;
-      }
-      break;
-      case 1:
-      {
-         assert(x.Size() == tensor.SizeJ());
-         assert(M.NumRows() == tensor.SizeK());
-         assert(M.NumCols() == tensor.SizeI());
-         size_ax = tensor.SizeJ();
-         size_nx = tensor.SizeI();
-         offset = 1;
-         stride = tensor.SizeI();
-      }
-      break;
-      default:
-         mfem_error("TensorMult axis should be between 0 and 1!\n");
-         break;
-   }
+   const int n = tensor.SizeI(), nk = tensor.SizeK();
+   assert(tensor.SizeJ() == n);
+   assert(x.Size() == n);
+   assert(M.NumRows() == nk);
+   assert(M.NumCols() == n);
 
-   const double *tdata, *dx;
+   const double *tdata = tensor.HostRead();
+   const double *dx = x.HostRead();
    double *dM = M.HostReadWrite();
 
-   for (int nx = 0; nx < size_nx; nx++)
+   Vector Ck(n);
+   double *dC = Ck.HostWrite();
+   for (int k = 0; k < nk; k++, tdata += n * n)
    {
-      for (int k = 0; k < tensor.SizeK(); k++, dM++)
+      for (int i = 0; i < n; i++) dC[i] = 0.0;
+
+      /*
+         Each column of the slice is read once for both contractions:
+         axis 0 takes its dot product with x, axis 1 accumulates it scaled by x_j.
+      */
+      int j = 0;
+      for (; j + 3 < n; j += 4)
       {
-         // commented for AddMultTranspose.
-         // (*dM) = 0.0;
-
-         dx = x.HostRead();
-         tdata = tensor.GetData(k) + offset * nx;
-         for (int ax = 0; ax < size_ax; ax++, dx++)
+         const double *a0 = tdata + j * n;
+         const double *a1 = a0 + n, *a2 = a1 + n, *a3 = a2 + n;
+         const double x0 = dx[j], x1 = dx[j+1], x2 = dx[j+2], x3 = dx[j+3];
+         double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+         for (int i = 0; i < n; i++)
+         {
+            const double xi = dx[i];
+            s0 += a0[i] * xi;
+            s1 += a1[i] * xi;
+            s2 += a2[i] * xi;
+            s3 += a3[i] * xi;
+            dC[i] += a0[i] * x0 + a1[i] * x1 + a2[i] * x2 + a3[i] * x3;
+         }
+         dM[k + j * nk] += s0;
+         dM[k + (j+1) * nk] += s1;
+         dM[k + (j+2) * nk] += s2;
+         dM[k + (j+3) * nk] += s3;
+      }
+      for (; j < n; j++)
+      {
+         const double *aj = tdata + j * n;
+         const double xj = dx[j];
+         double sj = 0.0;
+         for (int i = 0; i < n; i++)
          {
-            (*dM) += w * (*tdata) * (*dx);
-            tdata += stride;
+            sj += aj[i] * dx[i];
+            dC[i] += aj[i] * xj;
          }
+         dM[k + j * nk] += sj;
       }
+
+      for (int i = 0; i < n; i++)
+         dM[k + i * nk] += dC[i];
    }
 
    return;
@@ -945,6 +1385,33 @@ void CGOptimizer::Mult(const Vector &rhs, Vector &sol) const
    return;
 }
 
+void DenseLUSolver::SetOperator(const Operator &op)
+{
+   height = op.Height();
+   width = op.Width();
+   assert(height == width);
+
+   const DenseMatrix *dmat = dynamic_cast<const DenseMatrix *>(&op);
+   const SparseMatrix *smat = dynamic_cast<const SparseMatrix *>(&op);
+   const HypreParMatrix *hmat = dynamic_cast<const HypreParMatrix *>(&op);
+   if (dmat)
+      mat = *dmat;
+   else if (smat)
+      smat->ToDenseMatrix(mat);
+   else if (hmat)
+   {
+      // only for the serial case on MPI_COMM_SELF.
+      assert(hmat->GetGlobalNumRows() == height);
+      SparseMatrix diag;
+      hmat->GetDiag(diag);
+      diag.ToDenseMatrix(mat);
+   }
+   else
+      mfem_error("DenseLUSolver::SetOperator- unsupported operator type!\n");
+
+   inv.Factor(mat);
+}
+
 void GetBasisElement(
    const DenseMatrix &basis, const int col, const Array<int> vdofs, Vector &basis_el, DofTransformation *dof_trans)
 {
@@ -954,4 +1421,64 @@ void GetBasisElement(
    if (dof_trans) {dof_trans->InvTransformPrimal(basis_el); }
 }
 
+void GetBasisElementBlock(const DenseMatrix &basis, const Array<int> &vdofs,
+                          DenseMatrix &basis_el, const int offset)
+{
+   const int nb = basis.NumCols();
+   basis_el.SetSize(vdofs.Size(), nb);
+   for (int j = 0; j < nb; j++)
+   {
+      const double *col = basis.GetColumn(j) + offset;
+      for (int a = 0; a < vdofs.Size(); a++)
+         basis_el(a, j) = (vdofs[a] >= 0) ? col[vdofs[a]] : -col[-1-vdofs[a]];
+   }
+}
+
+void GetSnapshotElementBlock(const CAROM::Matrix &snapshots, const Array<int> &vdofs,
+                             DenseMatrix &snap_el, const Array<int> *cols)
+{
+   assert(!snapshots.distributed());
+   const int nsnap = (cols) ? cols->Size() : snapshots.numColumns();
+   const int ncol_total = snapshots.numColumns();
+   const double *data = snapshots.getData();
+
+   snap_el.SetSize(vdofs.Size(), nsnap);
+   for (int a = 0; a < vdofs.Size(); a++)
+   {
+      const int k = (vdofs[a] >= 0) ? vdofs[a] : -1-vdofs[a];
+      const double sign = (vdofs[a] >= 0) ? 1.0 : -1.0;
+      const double *row = data + static_cast<size_t>(k) * ncol_total;
+      if (cols)
+         for (int i = 0; i < nsnap; i++)
+            snap_el(a, i) = sign * row[(*cols)[i]];
+      else
+         for (int i = 0; i < nsnap; i++)
+            snap_el(a, i) = sign * row[i];
+   }
+}
+
+std::string BasisFingerprint(const DenseMatrix &basis)
+{
+   const uint64_t prime = 1099511628211ULL;
+   uint64_t hash = 14695981039346656037ULL;
+   auto append = [&hash, prime](const void *data, const size_t size)
+   {
+      const unsigned char *bytes = static_cast<const unsigned char *>(data);
+      for (size_t b = 0; b < size; b++)
+      {
+         hash ^= bytes[b];
+         hash *= prime;
+      }
+   };
+
+   const int nrow = basis.NumRows(), ncol = basis.NumCols();
+   append(&nrow, sizeof(int));
+   append(&ncol, sizeof(int));
+   append(basis.GetData(), sizeof(double) * static_cast<size_t>(nrow) * ncol);
+
+   std::ostringstream oss;
+   oss << std::hex << std::setw(16) << std::setfill('0') << hash;
+   return oss.str();
+}
+
 }
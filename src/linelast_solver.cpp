@@ -13,6 +13,10 @@ using namespace mfem;
 LinElastSolver::LinElastSolver()
     : MultiBlockSolver()
 {
+   // the system matrix and its solvers are on MPI_COMM_SELF.
+   if (distributed_solve)
+      mfem_error("LinElastSolver: solver/distributed is supported only for poisson and adv-diff solvers!\n");
+
    alpha = config.GetOption<double>("discretization/interface/alpha", -1.0);
    kappa = config.GetOption<double>("discretization/interface/kappa", (order + 1) * (order + 1));
 
@@ -241,11 +245,7 @@ void LinElastSolver::AssembleOperator()
 {
    // SanityCheckOnCoeffs();
    MFEM_ASSERT(as.Size() == numSub, "BilinearForm bs != numSub.\n");
-   for (int m = 0; m < numSub; m++)
-   {
-      MFEM_ASSERT(as[m], "LinearForm or BilinearForm pointer of a subdomain is not associated!\n");
-      as[m]->Assemble();
-   }
+   AssembleSubdomainForms(as);
    mats.SetSize(numSub, numSub);
    for (int i = 0; i < numSub; i++)
    {
@@ -308,10 +308,11 @@ bool LinElastSolver::Solve(SampleGenerator *sample_generator)
    // If using direct solver, returns always true.
    bool converged = true;
 
-   int maxIter = config.GetOption<int>("solver/max_iter", 10000);
-   double rtol = config.GetOption<double>("solver/relative_tolerance", 1.e-15);
-   double atol = config.GetOption<double>("solver/absolute_tolerance", 1.e-15);
-   int print_level = config.GetOption<int>("solver/print_level", 0);
+   solver_opts.Update(config);
+   int maxIter = solver_opts.max_iter;
+   double rtol = solver_opts.rtol;
+   double atol = solver_opts.atol;
+   int print_level = solver_opts.print_level;
 
    // TODO: need to change when the actual parallelization is implemented.
    cout << "direct_solve is: " << direct_solve << endl;
@@ -345,7 +346,7 @@ bool LinElastSolver::Solve(SampleGenerator *sample_generator)
       {
          solver = new CGSolver();
 
-         if (config.GetOption<bool>("solver/block_diagonal_preconditioner", true))
+         if (solver_opts.block_diag_prec)
          {
             globalPrec = new BlockDiagonalPreconditioner(var_offsets);
             solver->SetPreconditioner(*globalPrec);
@@ -470,18 +471,18 @@ void LinElastSolver::SetParameterizedProblem(ParameterizedProblem *problem)
       
       /* Neumann bc does not require a function specified for zero */
       if (problem->vector_bdr_ptr[b])
-         AddBCFunction(*(problem->vector_bdr_ptr[b]), problem->battr[b]);
+         AddBCFunction(problem->vector_bdr_ptr[b], problem->battr[b]);
    }
 
    // Set RHS
-   if (problem->vector_rhs_ptr != NULL){
-      AddRHSFunction(*(problem->vector_rhs_ptr));
+   if (problem->vector_rhs_ptr){
+      AddRHSFunction(problem->vector_rhs_ptr);
    }
 
    // Add initial condition
-   if (problem->general_vector_ptr[0] != NULL)
+   if (problem->general_vector_ptr[0])
    {
-      SetupIC(*(problem->general_vector_ptr[0]));
+      SetupIC(problem->general_vector_ptr[0]);
    }
 }
 
@@ -14,6 +14,9 @@
 #include "etc.hpp"
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 
 using namespace std;
 using namespace mfem;
@@ -142,40 +145,93 @@ std::vector<BasisTag> GetGlobalBasisTagList(const TopologyHandlerMode &topol_mod
 
 void GenerateSamples(MPI_Comm comm)
 {
-   // save the original config.dict_
-   YAML::Node dict0 = YAML::Clone(config.dict_);
+   // save the original config options
+   YAML::Node dict0 = YAML::Clone(config.GetDict());
    ParameterizedProblem *problem = InitParameterizedProblem();
    SampleGenerator *sample_generator = InitSampleGenerator(comm);
    SampleGeneratorType sample_gen_type = sample_generator->GetType();
    sample_generator->SetParamSpaceSizes();
    MultiBlockSolver *test = NULL;
 
-   int s = 0;
-   while (s < sample_generator->GetTotalSampleSize())
+   // samples are scheduled over ranks, each of which solves its own sample.
+   int nproc;
+   MPI_Comm_size(comm, &nproc);
+   if (config.GetOption<bool>("solver/distributed", false) && (nproc > 1))
+      mfem_error("GenerateSamples: solver/distributed is only for a single FOM run!\n");
+
+   /*
+      Reuse the same solver over the samples.
+      Meshes, FE spaces and parameter-independent operators are built only once,
+      and only RHS/BC operators are re-assembled for each sample.
+      The sampling parameters must not change the mesh/discretization inputs.
+   */
+   bool reuse_solver = config.GetOption<bool>("sample_generation/reuse_solver", false);
+   if (reuse_solver && config.GetOption<bool>("visualization/enabled", false))
    {
-      if (!sample_generator->IsMyJob(s)) continue;
+      mfem_warning("GenerateSamples: reuse_solver does not support visualization. Solver will be re-initialized for each sample.\n");
+      reuse_solver = false;
+   }
+
+   enum { INIT, ASSEMBLE, SOLVE, SAVE, NUM_PHASE };
+   StopWatch timers[NUM_PHASE];
+   int num_full_assemble = 0, num_rhs_assemble = 0;
 
-      // NOTE: this will change config.dict_
+   // samples are handed out on demand (sample_generation/scheduler). file names only depend on the sample index.
+   sample_generator->StartSampleQueue();
+   int s = sample_generator->GetNextSample();
+   while (s >= 0)
+   {
+      // NOTE: this will change config options
       sample_generator->SetSampleParams(s);
 
-      test = InitSolver();
-      test->InitVariables();
-      if (test->UseRom())
-         test->InitROMHandler();
+      int file_idx = s + sample_generator->GetFileOffset();
 
-      problem->SetSingleRun();
-      test->SetParameterizedProblem(problem);
+      bool rhs_only = false;
+      if (reuse_solver && test)
+      {
+         timers[ASSEMBLE].Start();
+         problem->SetSingleRun();
+         rhs_only = test->UpdateParameterizedProblem(problem);
+         timers[ASSEMBLE].Stop();
+
+         if (!rhs_only)
+         {
+            delete test;
+            test = NULL;
+         }
+      }
+
+      if (!rhs_only)
+      {
+         timers[INIT].Start();
+         test = InitSolver();
+         test->InitVariables();
+         if (test->UseRom())
+            test->InitROMHandler();
+
+         problem->SetSingleRun();
+         test->SetParameterizedProblem(problem);
+
+         const std::string visual_path = sample_generator->GetSamplePath(file_idx, test->GetVisualizationPrefix());
+         test->InitVisualization(visual_path);
+         timers[INIT].Stop();
+
+         timers[ASSEMBLE].Start();
+         test->BuildOperators();
+         test->SetupBCOperators();
+         test->Assemble();
+         timers[ASSEMBLE].Stop();
+         num_full_assemble++;
+      }
+      else
+         num_rhs_assemble++;
 
-      int file_idx = s + sample_generator->GetFileOffset();
-      const std::string visual_path = sample_generator->GetSamplePath(file_idx, test->GetVisualizationPrefix());
       std::string sol_file = sample_generator->GetSamplePath(file_idx, test->GetSolutionFilePrefix());
       sol_file += ".h5";
-      test->InitVisualization(visual_path);
-      test->BuildOperators();
-      test->SetupBCOperators();
-      test->Assemble();
 
+      timers[SOLVE].Start();
       bool converged = test->Solve(sample_generator);
+      timers[SOLVE].Stop();
       if (!converged)
       {
          // If deterministic, terminate the sampling here.
@@ -186,26 +242,47 @@ void GenerateSamples(MPI_Comm comm)
             // if random, try another sample.
             mfem_warning("A sample solution failed to converge. Trying another sample.\n");
             delete test;
+            test = NULL;
             continue;
          }
       }
-         
+
+      timers[SAVE].Start();
       test->SaveSolution(sol_file);
       test->SaveVisualization();
+      timers[SAVE].Stop();
 
       sample_generator->ReportStatus(s);
 
-      delete test;
+      if (!reuse_solver)
+      {
+         delete test;
+         test = NULL;
+      }
 
-      s++;
+      s = sample_generator->GetNextSample();
    }
+   delete test;
+
+   double busy_time = 0.0;
+   for (int k = 0; k < NUM_PHASE; k++)
+      busy_time += timers[k].RealTime();
+   sample_generator->FinishSampleQueue(busy_time);
+
    sample_generator->WriteSnapshots();
    sample_generator->WriteSnapshotPorts();
 
+   printf("Rank %d - sample generation: %d full assembly, %d rhs-only assembly.\n",
+          sample_generator->GetProcRank(), num_full_assemble, num_rhs_assemble);
+   printf("%10s\t%10s\t%10s\t%10s\n", "init", "assemble", "solve", "save");
+   for (int k = 0; k < NUM_PHASE; k++)
+      printf("%.3E\t", timers[k].RealTime());
+   printf("\n");
+
    delete sample_generator;
    delete problem;
-   // restore the original config.dict_
-   config.dict_ = dict0;
+   // restore the original config options
+   config.SetDict(dict0);
 }
 
 void CollectSamples(SampleGenerator *sample_generator)
@@ -488,7 +565,7 @@ double SingleRun(MPI_Comm comm, const std::string output_file)
       RandomSampleGenerator *generator = new RandomSampleGenerator(comm);
       generator->SetParamSpaceSizes();
       int idx = UniformRandom(0, generator->GetTotalSampleSize()-1);
-      // NOTE: this will change config.dict_
+      // NOTE: this will change config options
       generator->SetSampleParams(idx);
       delete generator;
    }
@@ -674,7 +751,7 @@ double SingleRun(MPI_Comm comm, const std::string output_file)
    }
 
    // save results to output file.
-   if (output_file.length() > 0)
+   if ((output_file.length() > 0) && test->IsOutputRank())
    {
       hid_t file_id;
       herr_t errf = 0;
@@ -701,3 +778,262 @@ double SingleRun(MPI_Comm comm, const std::string output_file)
    // return the maximum error over all variables.
    return error.Max();
 }
+
+/*
+   (Re-)assemble the ROM operator of ServeROM, following SingleRun.
+   With load_elems, the ROM elements/operator are loaded from the file first.
+   The NONE building level assembles the FOM domain operators, so it must be called only on a new solver.
+*/
+static void AssembleServeOperator(MultiBlockSolver *test, const bool load_elems)
+{
+   ROMHandlerBase *rom = test->GetROMHandler();
+   const ROMBuildingLevel save_operator = rom->GetBuildingLevel();
+   const std::string filename = rom->GetOperatorPrefix() + ".h5";
+
+   if (save_operator == ROMBuildingLevel::COMPONENT)
+   {
+      if (test->GetTopologyMode() == TopologyHandlerMode::SUBMESH)
+         mfem_error("Submesh does not support component rom building level!\n");
+
+      if (load_elems)
+         test->LoadROMLinElems(filename);
+      test->AssembleROMMat();
+   }
+   else if (save_operator == ROMBuildingLevel::GLOBAL)
+   {
+      // global operator is fixed as saved in the file.
+      if (load_elems)
+         test->LoadROMOperatorFromFile(filename);
+   }
+   else if (save_operator == ROMBuildingLevel::NONE)
+   {
+      test->BuildDomainOperators();
+      test->SetupDomainBCOperators();
+      test->AssembleOperator();
+      test->ProjectOperatorOnReducedBasis();
+   }
+   else
+      mfem_error("ServeROM - Unknown ROMBuildingLevel!\n");
+}
+
+/*
+   Set the parameters of a query line on the config options.
+   A query line is either
+      key1=value1:key2=value2:...   (the same format as --forced-input), or
+      value1 value2 ...             (values for the keys in serve/parameters, in order).
+   Returns false with msg if the line is not valid.
+*/
+static bool SetServeQuery(const std::string &line, const std::vector<std::string> &param_keys, std::string &msg)
+{
+   std::stringstream ss(line);
+
+   if (line.find('=') == std::string::npos)
+   {
+      if (param_keys.size() == 0)
+      {
+         msg = "serve/parameters must be specified for a parameter vector query.";
+         return false;
+      }
+
+      double val;
+      int k = 0;
+      while (ss >> val)
+      {
+         if (k >= param_keys.size())
+         {
+            msg = "more than " + std::to_string(param_keys.size()) + " parameter values.";
+            return false;
+         }
+         config.SetOption(param_keys[k++], val);
+      }
+      if (!ss.eof())
+      {
+         msg = "invalid parameter value.";
+         return false;
+      }
+      if (k != param_keys.size())
+      {
+         msg = "expected " + std::to_string(param_keys.size()) + " parameter values.";
+         return false;
+      }
+      return true;
+   }
+
+   std::string kv, key, val, dummy;
+   while (std::getline(ss, kv, ':'))
+   {
+      std::stringstream kvss(kv);
+      bool success = true;
+      success = success && (std::getline(kvss, key, '='));
+      success = success && (std::getline(kvss, val, '='));
+      success = success && (!std::getline(kvss, dummy, '='));
+      if (!success)
+      {
+         msg = kv + " is not a valid key=value pair.";
+         return false;
+      }
+      config.SetOption(key, YAML::Load(val));
+   }
+   return true;
+}
+
+/*
+   Initialize the solver of ServeROM on the current config options,
+   and assemble its RHS and ROM operator for problem.
+*/
+static MultiBlockSolver* InitServeSolver(ParameterizedProblem *problem)
+{
+   MultiBlockSolver *test = InitSolver();
+   if (!test->UseRom())
+      mfem_error("ServeROM: main/use_rom must be enabled!\n");
+   if (test->IsNonlinear())
+      mfem_error("ServeROM: nonlinear ROM is not supported yet!\n");
+
+   test->InitVariables();
+   test->InitROMHandler();
+
+   problem->SetSingleRun();
+   test->SetParameterizedProblem(problem);
+   test->BuildRHSOperators();
+   test->SetupRHSBCOperators();
+   test->AssembleRHS();
+
+   test->LoadReducedBasis();
+   AssembleServeOperator(test, true);
+   return test;
+}
+
+static void PrintLatencyStats(const std::string &label, std::vector<double> latency)
+{
+   const int n = latency.size();
+   if (n == 0) return;
+
+   std::sort(latency.begin(), latency.end());
+   double sum = 0.0;
+   for (int k = 0; k < n; k++) sum += latency[k];
+
+   printf("stats %s: %d queries, mean %.3E, min %.3E, p50 %.3E, p95 %.3E, max %.3E seconds.\n",
+          label.c_str(), n, sum / n, latency[0], latency[n / 2],
+          latency[std::min(n - 1, static_cast<int>(0.95 * n))], latency[n - 1]);
+   fflush(stdout);
+}
+
+void ServeROM(MPI_Comm comm)
+{
+   int nproc;
+   MPI_Comm_size(comm, &nproc);
+   if (nproc > 1)
+      mfem_error("ServeROM: serve mode runs on a single process!\n");
+
+   // save the original config options. each query is set on top of it.
+   YAML::Node dict0 = YAML::Clone(config.GetDict());
+   std::vector<std::string> param_keys = config.GetOption<std::vector<std::string>>("serve/parameters", {});
+   const bool print_sol = config.GetOption<bool>("serve/print_reduced_solution", true);
+
+   ParameterizedProblem *problem = InitParameterizedProblem();
+
+   StopWatch setupTimer;
+   setupTimer.Start();
+   MultiBlockSolver *test = InitServeSolver(problem);
+   setupTimer.Stop();
+   printf("ServeROM - setup time: %f seconds. Waiting for queries.\n", setupTimer.RealTime());
+   if (!test->IsOperatorParamIndependent())
+      printf("ServeROM - the operator of this solver depends on the parameters. "
+             "It is re-assembled for every query.\n");
+   fflush(stdout);
+
+   /*
+      Each line of stdin is one query. An empty line closes a batch, and "quit" or EOF ends the server.
+      A response line per query starts with "response", followed by
+         query index, status, assemble/solve time, l2/max norms of the FOM-lifted solution,
+         and the reduced solution.
+   */
+   std::vector<double> latency, batch_latency;
+   int num_query = 0, num_reassemble = 0;
+   StopWatch assembleTimer, solveTimer;
+   std::string line, msg;
+   while (std::getline(std::cin, line))
+   {
+      if (line == "quit") break;
+      if (line.empty())
+      {
+         PrintLatencyStats("batch", batch_latency);
+         batch_latency.clear();
+         continue;
+      }
+
+      const int q = num_query++;
+      assembleTimer.Clear();
+      solveTimer.Clear();
+
+      assembleTimer.Start();
+      config.SetDict(YAML::Clone(dict0));
+      if (!SetServeQuery(line, param_keys, msg))
+      {
+         printf("response %d error %s\n", q, msg.c_str());
+         fflush(stdout);
+         continue;
+      }
+
+      /*
+         Only the RHS is re-assembled, reusing the ROM operator and its factorization.
+         If the boundary condition types change (or the operator depends on the parameters),
+         the ROM operator is re-assembled and re-factorized.
+         The NONE building level re-initializes the solver, as SampleGenerate does, to rebuild the FOM operators.
+      */
+      problem->SetSingleRun();
+      if (!test->UpdateParameterizedProblem(problem))
+      {
+         if (test->GetROMHandler()->GetBuildingLevel() == ROMBuildingLevel::NONE)
+         {
+            delete test;
+            test = InitServeSolver(problem);
+         }
+         else
+         {
+            // UpdateParameterizedProblem has already set the problem.
+            test->BuildRHSOperators();
+            test->SetupRHSBCOperators();
+            test->AssembleRHS();
+            AssembleServeOperator(test, false);
+         }
+         num_reassemble++;
+      }
+      test->ProjectRHSOnReducedBasis();
+      assembleTimer.Stop();
+
+      solveTimer.Start();
+      test->SolveROM();
+      solveTimer.Stop();
+
+      const double elapsed = assembleTimer.RealTime() + solveTimer.RealTime();
+      latency.push_back(elapsed);
+      batch_latency.push_back(elapsed);
+
+      BlockVector *U = test->GetSolution();
+      std::ostringstream response;
+      response << std::scientific << std::setprecision(15);
+      response << "response " << q << " ok"
+               << " assemble " << assembleTimer.RealTime()
+               << " solve " << solveTimer.RealTime()
+               << " norm_l2 " << U->Norml2()
+               << " norm_max " << U->Normlinf();
+      if (print_sol)
+      {
+         const BlockVector *rom_sol = test->GetROMHandler()->GetReducedSolution();
+         response << " reduced_solution " << rom_sol->Size();
+         for (int k = 0; k < rom_sol->Size(); k++)
+            response << " " << (*rom_sol)(k);
+      }
+      printf("%s\n", response.str().c_str());
+      fflush(stdout);
+   }
+   PrintLatencyStats("batch", batch_latency);
+   PrintLatencyStats("total", latency);
+   printf("ServeROM - %d queries, %d operator re-assembly.\n", num_query, num_reassemble);
+
+   delete test;
+   delete problem;
+   // restore the original config options
+   config.SetDict(dict0);
+}
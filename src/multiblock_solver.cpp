@@ -47,6 +47,10 @@ MultiBlockSolver::MultiBlockSolver()
    dim = topol_data.dim;
    global_bdr_attributes = *(topol_data.global_bdr_attributes);
    numBdr = global_bdr_attributes.Size();
+
+   // subdomain ownership for the distributed solve.
+   sub_begin = (distributed_solve) ? (rank * numSub) / nproc : 0;
+   sub_end = (distributed_solve) ? ((rank + 1) * numSub) / nproc : numSub;
 }
 
 MultiBlockSolver::~MultiBlockSolver()
@@ -86,6 +90,19 @@ void MultiBlockSolver::ParseInputs()
    // solver option;
    use_amg = config.GetOption<bool>("solver/use_amg", true);
    direct_solve = config.GetOption<bool>("solver/direct_solve", false);
+   solver_opts.Update(config);
+
+   num_threads = config.GetOption<int>("solver/num_threads", 1);
+#if !defined(_OPENMP) || !defined(MFEM_THREAD_SAFE)
+   // mfem finite elements keep mutable scratch, unless mfem is built with MFEM_THREAD_SAFE.
+   if (num_threads > 1)
+   {
+      mfem_warning("MultiBlockSolver: concurrent assembly requires OpenMP and mfem built with MFEM_THREAD_SAFE.\n"
+                   "                  Subdomain forms are assembled serially.\n");
+      num_threads = 1;
+   }
+#endif
+
 
    visual.save = config.GetOption<bool>("visualization/enabled", false);
    if (visual.save)
@@ -116,10 +133,105 @@ void MultiBlockSolver::ParseInputs()
    use_rom = config.GetOption<bool>("main/use_rom", false);
    separate_variable_basis = config.GetOption<bool>("model_reduction/separate_variable_basis", false);
 
+   distributed_solve = config.GetOption<bool>("solver/distributed", false) && (nproc > 1);
+   if (distributed_solve)
+   {
+      // NOTE: only PoissonSolver (and AdvDiffSolver) assemble and solve the rows distributed over ranks.
+      // The other solvers reject solver/distributed in their constructors.
+      if (!(use_amg || direct_solve))
+         mfem_error("MultiBlockSolver: solver/distributed requires either solver/use_amg or solver/direct_solve!\n");
+      // each rank assembles only its own rows, while ROM projection needs the entire operator.
+      if (use_rom)
+         mfem_error("MultiBlockSolver: solver/distributed is only for FOM runs without main/use_rom!\n");
+   }
+
    // save solution if single run.
    SetSolutionSaveMode(config.GetOption<bool>("save_solution/enabled", false));
 }
 
+HypreParMatrix* MultiBlockSolver::CreateSystemMatrix(
+   SparseMatrix *mono, HYPRE_BigInt &glob_size, HYPRE_BigInt *row_starts) const
+{
+   assert(mono);
+   assert(mono->Finalized());
+   assert(!distributed_solve);
+
+   glob_size = mono->NumRows();
+   row_starts[0] = 0;
+   row_starts[1] = glob_size;
+   return new HypreParMatrix(MPI_COMM_SELF, glob_size, row_starts, mono);
+}
+
+HypreParMatrix* MultiBlockSolver::CreateSystemMatrix(
+   const Array2D<SparseMatrix *> &blocks, const Array<int> &offsets,
+   HYPRE_BigInt &glob_size, HYPRE_BigInt *row_starts) const
+{
+   assert(distributed_solve);
+   assert(offsets.Size() == numSub + 1);
+   assert((blocks.NumRows() == numSub) && (blocks.NumCols() == numSub));
+
+   // the row partition follows the subdomain ownership.
+   glob_size = offsets.Last();
+   row_starts[0] = offsets[sub_begin];
+   row_starts[1] = offsets[sub_end];
+   const int nrow_loc = row_starts[1] - row_starts[0];
+
+   /* local CSR rows, concatenating the column blocks of each owned row block. */
+   Array<int> I_loc(nrow_loc + 1);
+   I_loc = 0;
+   for (int i = sub_begin; i < sub_end; i++)
+      for (int j = 0; j < numSub; j++)
+      {
+         if (!blocks(i, j)) continue;
+         assert(blocks(i, j)->Finalized());
+         const int r0 = offsets[i] - row_starts[0];
+         for (int r = 0; r < blocks(i, j)->NumRows(); r++)
+            I_loc[r0 + r + 1] += blocks(i, j)->RowSize(r);
+      }
+   I_loc.PartialSum();
+
+   Array<HYPRE_BigInt> J_loc(I_loc.Last());
+   Vector data_loc(I_loc.Last());
+   // next entry to fill in each local row.
+   Array<int> fill(nrow_loc);
+   for (int r = 0; r < nrow_loc; r++)
+      fill[r] = I_loc[r];
+   for (int i = sub_begin; i < sub_end; i++)
+      for (int j = 0; j < numSub; j++)
+      {
+         if (!blocks(i, j)) continue;
+         const int *I = blocks(i, j)->GetI();
+         const int *J = blocks(i, j)->GetJ();
+         const double *A = blocks(i, j)->GetData();
+         const int r0 = offsets[i] - row_starts[0];
+         for (int r = 0; r < blocks(i, j)->NumRows(); r++)
+            for (int k = I[r]; k < I[r + 1]; k++, fill[r0 + r]++)
+            {
+               J_loc[fill[r0 + r]] = offsets[j] + J[k];
+               data_loc[fill[r0 + r]] = A[k];
+            }
+      }
+
+   // the local CSR arrays are copied into the HypreParMatrix.
+   return new HypreParMatrix(MPI_COMM_WORLD, nrow_loc, glob_size, glob_size,
+                             I_loc.GetData(), J_loc.GetData(), data_loc.GetData(),
+                             row_starts, row_starts);
+}
+
+void MultiBlockSolver::GatherDistributedVector(const HYPRE_BigInt *row_starts, Vector &x) const
+{
+   if (!distributed_solve) return;
+
+   int nrow_loc = row_starts[1] - row_starts[0];
+   int row_loc = row_starts[0];
+   Array<int> counts(nproc), displs(nproc);
+   MPI_Allgather(&nrow_loc, 1, MPI_INT, counts.GetData(), 1, MPI_INT, MPI_COMM_WORLD);
+   MPI_Allgather(&row_loc, 1, MPI_INT, displs.GetData(), 1, MPI_INT, MPI_COMM_WORLD);
+
+   MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, x.GetData(), counts.GetData(), displs.GetData(),
+                  MPI_DOUBLE, MPI_COMM_WORLD);
+}
+
 void MultiBlockSolver::SetSolutionSaveMode(const bool save_sol_)
 {
    // save solution if single run.
@@ -457,6 +569,7 @@ void MultiBlockSolver::InitUnifiedParaview(const std::string& file_prefix)
 void MultiBlockSolver::SaveVisualization()
 {
    if (!visual.save) return;
+   if (!IsOutputRank()) return;
 
    if (visual.unified_view)
    {
@@ -504,9 +617,35 @@ void MultiBlockSolver::SetParameterizedProblem(ParameterizedProblem *problem)
    }
 }
 
+bool MultiBlockSolver::UpdateParameterizedProblem(ParameterizedProblem *problem)
+{
+   /* domain BC operators depend on the boundary types. */
+   Array<BoundaryType> bdr_type0(bdr_type);
+   Array<bool> bc_exists0(numBdr);
+   for (int b = 0; b < numBdr; b++)
+      bc_exists0[b] = BCExistsOnBdr(b);
+
+   SetParameterizedProblem(problem);
+
+   if (!IsOperatorParamIndependent())
+      return false;
+
+   for (int b = 0; b < numBdr; b++)
+      if ((bdr_type[b] != bdr_type0[b]) || (BCExistsOnBdr(b) != bc_exists0[b]))
+         return false;
+
+   BuildRHSOperators();
+   SetupRHSBCOperators();
+   AssembleRHS();
+
+   return true;
+}
+
 void MultiBlockSolver::SaveSolution(std::string filename)
 {
    if (!save_sol) return;
+   // the gathered solution is the same on all ranks. avoid concurrent H5Fcreate on the same file.
+   if (!IsOutputRank()) return;
 
    if (filename == "")
    {
@@ -530,6 +669,7 @@ void MultiBlockSolver::SaveSolution(std::string filename)
 void MultiBlockSolver::SaveSolutionWithTime(std::string filename, const int step, const double time)
 {
    SaveSolution(filename);
+   if (!IsOutputRank()) return;
    printf("Saving time/time step ...");
 
    hid_t file_id;
@@ -692,6 +832,17 @@ void MultiBlockSolver::SolveROM()
    rom_handler->Solve(U_domain);
 }
 
+void MultiBlockSolver::SolveROM(const DenseMatrix &RHS_cols, DenseMatrix &U_cols)
+{
+   assert(!nonlinear_mode);
+   assert(RHS_cols.NumRows() == U->Size());
+
+   DenseMatrix rom_rhs, rom_sol;
+   rom_handler->ProjectGlobalToDomainBasis(RHS_cols, rom_rhs);
+   rom_handler->Solve(rom_rhs, rom_sol);
+   rom_handler->LiftUpGlobal(rom_sol, U_cols);
+}
+
 void MultiBlockSolver::ComputeSubdomainErrorAndNorm(GridFunction *fom_sol, GridFunction *rom_sol, double &error, double &norm)
 {
    assert(fom_sol && rom_sol);
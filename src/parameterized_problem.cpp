@@ -15,15 +15,13 @@ namespace function_factory
 namespace poisson0
 {
 
-double k, offset;
-
-double rhs(const Vector &x, double t)
+double rhs(const Params &p, const Vector &x, double t)
 {
    double tmp = 0.0;
    for (int d = 0; d < x.Size(); d++)
       tmp += x(d);
-   tmp *= poisson0::k;
-   tmp += poisson0::offset;
+   tmp *= p.k;
+   tmp += p.offset;
    return sin(2.0 * pi * tmp);
 }
 
@@ -32,27 +30,23 @@ double rhs(const Vector &x, double t)
 namespace poisson_component
 {
 
-Vector k(3), bdr_k(3);
-double offset, bdr_offset;
-double bdr_idx;
-
-double bdr(const Vector &x, double t)
+double bdr(const Params &p, const Vector &x, double t)
 {
-   assert(bdr_k.Size() >= x.Size());
+   assert(p.bdr_k.Size() >= x.Size());
    double tmp = 0.0;
    for (int d = 0; d < x.Size(); d++)
-      tmp += poisson_component::bdr_k(d) * x(d);
-   tmp += poisson_component::bdr_offset;
+      tmp += p.bdr_k(d) * x(d);
+   tmp += p.bdr_offset;
    return sin(2.0 * pi * tmp);
 }
 
-double rhs(const Vector &x, double t)
+double rhs(const Params &p, const Vector &x, double t)
 {
-   assert(k.Size() >= x.Size());
+   assert(p.k.Size() >= x.Size());
    double tmp = 0.0;
    for (int d = 0; d < x.Size(); d++)
-      tmp += poisson_component::k(d) * x(d);
-   tmp += poisson_component::offset;
+      tmp += p.k(d) * x(d);
+   tmp += p.offset;
    return sin(2.0 * pi * tmp);
 }
 
@@ -61,10 +55,10 @@ double rhs(const Vector &x, double t)
 namespace poisson_spiral
 {
 
-double L, Lw, k, s;
-
-double rhs(const Vector &x, double t)
+double rhs(const Params &p, const Vector &x, double t)
 {
+   const double L = p.L, Lw = p.Lw, k = p.k, s = p.s;
+
    double r = 0.0;
    for (int d = 0; d < x.Size(); d++) r += (x(d) - 0.5 * L) * (x(d) - 0.5 * L);
    r = sqrt(r);
@@ -90,39 +84,33 @@ double rhs(const Vector &x, double t)
 namespace flow_problem
 {
 
-double nu;
-double del_u;
-Vector x0;
-
-void dir(const Vector &x, Vector &y)
+void dir(const Params &p, const Vector &x, Vector &y)
 {
    const int dim = x.Size();
    y.SetSize(dim);
    y = x;
 
-   assert(x0.Size() == dim);
-   y -= x0;
+   assert(p.x0.Size() == dim);
+   y -= p.x0;
 }
 
-void flux(const Vector &x, Vector &y)
+void flux(const Params &p, const Vector &x, Vector &y)
 {
-   dir(x, y);
-   y *= del_u;
+   dir(p, x, y);
+   y *= p.del_u;
 }
 
 namespace channel_flow
 {
 
-double L, U, x0;
-
-void ubdr(const Vector &x, double t, Vector &y)
+void ubdr(const Params &p, const Vector &x, double t, Vector &y)
 {
    const int dim = x.Size();
    y.SetSize(dim);
    y = 0.0;
 
-   double yc = (x(1) - x0) / L;
-   y(0) = U * (1.0 - 4.0 * yc * yc);
+   double yc = (x(1) - p.x0) / p.L;
+   y(0) = p.U * (1.0 - 4.0 * yc * yc);
 }
 
 }  // namespace channel_flow
@@ -130,10 +118,7 @@ void ubdr(const Vector &x, double t, Vector &y)
 namespace component_flow
 {
 
-Vector u0, du, offsets;
-DenseMatrix k;
-
-void ubdr(const Vector &x, double t, Vector &y)
+void ubdr(const flow_problem::Params &fp, const Params &p, const Vector &x, double t, Vector &y)
 {
    const int dim = x.Size();
    y.SetSize(dim);
@@ -141,15 +126,15 @@ void ubdr(const Vector &x, double t, Vector &y)
    for (int i = 0; i < dim; i++)
    {
       double kx = 0.0;
-      for (int j = 0; j < dim; j++) kx += k(j, i) * x(j);
-      kx -= offsets(i);
+      for (int j = 0; j < dim; j++) kx += p.k(j, i) * x(j);
+      kx -= p.offsets(i);
       kx *= 2.0 * function_factory::pi;
-      y(i) = u0(i) + du(i) * sin(kx);
+      y(i) = p.u0(i) + p.du(i) * sin(kx);
    }
 
    // ensure incompressibility.
    Vector del_u(dim);
-   flow_problem::flux(x, del_u);
+   flow_problem::flux(fp, x, del_u);
    y -= del_u;
 }
 
@@ -158,35 +143,32 @@ void ubdr(const Vector &x, double t, Vector &y)
 namespace backward_facing_step
 {
 
-double u0, y0, y1;
-Vector amp, ky, freq, t_offset;
-
-void ubdr(const Vector &x, double t, Vector &y)
+void ubdr(const Params &p, const Vector &x, double t, Vector &y)
 {
    const int dim = x.Size();
    y.SetSize(dim);
    y = 0.0;
 
-   double ygap = (y1 - y0);
-   y(0) = - u0 * 4.0 / ygap / ygap * (y0 - x(1)) * (y1 - x(1));
+   double ygap = (p.y1 - p.y0);
+   y(0) = - p.u0 * 4.0 / ygap / ygap * (p.y0 - x(1)) * (p.y1 - x(1));
 
-   for (int m = 0; m < amp.Size(); m++)
+   for (int m = 0; m < p.amp.Size(); m++)
    {
-      if (amp(m) == 0.0) continue;
+      if (p.amp(m) == 0.0) continue;
 
-      y(1) += amp(m) * sin(pi * ky(m) * (x(1) - y0) / ygap)
-                     * sin(2. * pi * (freq(m) * t + t_offset(m)));
+      y(1) += p.amp(m) * sin(pi * p.ky(m) * (x(1) - p.y0) / ygap)
+                       * sin(2. * pi * (p.freq(m) * t + p.t_offset(m)));
    }
 }
 
-void uic(const Vector &x, double t, Vector &y)
+void uic(const Params &p, const Vector &x, double t, Vector &y)
 {
    const int dim = x.Size();
    y.SetSize(dim);
    y = 0.0;
 
-   double ygap = (y1 - y0);
-   y(0) = (x(1) < y0) ? 0.0 : - u0 * 4.0 / ygap / ygap * (y0 - x(1)) * (y1 - x(1));
+   double ygap = (p.y1 - p.y0);
+   y(0) = (x(1) < p.y0) ? 0.0 : - p.u0 * 4.0 / ygap / ygap * (p.y0 - x(1)) * (p.y1 - x(1));
 }
 
 void pic(const Vector &x, double t, Vector &y)
@@ -200,15 +182,13 @@ void pic(const Vector &x, double t, Vector &y)
 namespace lid_driven_cavity
 {
 
-double u0, L;
-
-void ubdr(const Vector &x, double t, Vector &y)
+void ubdr(const Params &p, const Vector &x, double t, Vector &y)
 {
    const int dim = x.Size();
    y.SetSize(dim);
    y = 0.0;
 
-   y(0) = 4.0 / L / L * u0 * x(0) * (L - x(0));
+   y(0) = 4.0 / p.L / p.L * p.u0 * x(0) * (p.L - x(0));
 }
 
 }  // namespace lid_driven_cavity
@@ -216,13 +196,11 @@ void ubdr(const Vector &x, double t, Vector &y)
 namespace periodic_flow_past_array
 {
 
-Vector f;
-
-void force(const Vector &x, double t, Vector &y)
+void force(const Params &p, const Vector &x, double t, Vector &y)
 {
    const int dim = x.Size();
    y.SetSize(dim);
-   y = f;
+   y = p.f;
 }
 
 }  // namespace periodic_flow_past_array
@@ -232,29 +210,24 @@ void force(const Vector &x, double t, Vector &y)
 namespace linelast_problem
 {
 
-double _lambda;
-double _mu;
-
-double lambda(const Vector &x, double t){return _lambda;};
-double mu(const Vector &x, double t){return _mu;};
+double lambda(const Params &p, const Vector &x, double t){return p.lambda;};
+double mu(const Params &p, const Vector &x, double t){return p.mu;};
 
 }
 
 namespace linelast_disp
 {
 
-double rdisp_f;
-
-void init_disp(const Vector &x, double t, Vector &u)
+void init_disp(const Params &p, const Vector &x, double t, Vector &u)
 {
    u = 0.0;
-   u(u.Size()-1) = -0.2*x(0)*rdisp_f;
+   u(u.Size()-1) = -0.2*x(0)*p.rdisp_f;
 }
 
-void init_disp_lcantilever(const Vector &x, double t, Vector &u)
+void init_disp_lcantilever(const Params &p, const Vector &x, double t, Vector &u)
 {
    u = 0.0;
-   u(u.Size()-1) = -0.2*(x(u.Size()-1) - 5.0)*rdisp_f;
+   u(u.Size()-1) = -0.2*(x(u.Size()-1) - 5.0)*p.rdisp_f;
 }
 
 }  // namespace linelast_disp
@@ -262,12 +235,10 @@ void init_disp_lcantilever(const Vector &x, double t, Vector &u)
 namespace linelast_force
 {
 
-double rforce_f;
-
-void tip_force(const Vector &x, double t, Vector &f)
+void tip_force(const Params &p, const Vector &x, double t, Vector &f)
 {
    f = 0.0;
-   f(f.Size()-1) = -1.0e-2* rforce_f;
+   f(f.Size()-1) = -1.0e-2* p.rforce_f;
 }
 
 }  // namespace linelast_force
@@ -275,20 +246,16 @@ void tip_force(const Vector &x, double t, Vector &f)
 namespace linelast_frame_wind
 {
 
-double qwind_f;
-double density;
-double g;
-
-void gravity_load(const Vector &x, double t, Vector &f)
+void gravity_load(const Params &p, const Vector &x, double t, Vector &f)
 {
    f = 0.0;
-   f(f.Size()-1) = -density * g;
+   f(f.Size()-1) = -p.density * p.g;
 }
 
-void wind_load(const Vector &x, double t, Vector &f)
+void wind_load(const Params &p, const Vector &x, double t, Vector &f)
 {
    f = 0.0;
-   f(0) = qwind_f;
+   f(0) = p.qwind_f;
 }
 
 void dirichlet(const Vector &x, double t, Vector &u)
@@ -302,23 +269,17 @@ void dirichlet(const Vector &x, double t, Vector &u)
 namespace advdiff_problem
 {
 
-bool analytic_flow;
-FlowProblem *flow_problem;
-
 namespace advdiff_flow_past_array
 {
 
-double q0, dq, qoffset;
-Vector qk;
-
-double qbdr(const Vector &x, double t)
+double qbdr(const Params &p, const Vector &x, double t)
 {
-   assert(qk.Size() >= x.Size());
+   assert(p.qk.Size() >= x.Size());
    double tmp = 0.0;
    for (int d = 0; d < x.Size(); d++)
-      tmp += advdiff_flow_past_array::qk(d) * x(d);
-   tmp += advdiff_flow_past_array::qoffset;
-   return advdiff_flow_past_array::q0 + advdiff_flow_past_array::dq * sin(2.0 * pi * tmp);
+      tmp += p.qk(d) * x(d);
+   tmp += p.qoffset;
+   return p.q0 + p.dq * sin(2.0 * pi * tmp);
 }
 
 }  // namespace advdiff_flow_past_array
@@ -327,97 +288,50 @@ double qbdr(const Vector &x, double t)
 
 namespace linelast_cwtrain
 {
-   // Probabilities
-   double lx;
-   double ly;
-   double rx;
-   double ry;
-   double dx;
-   double dy;
-   double ux;
-   double uy;
-   double bx;
-   double by;
-
-   // Constant force
-   double l_ux;
-   double l_uy;
-   double r_fx;
-   double r_fy;
-   double u_fx;
-   double u_fy;
-   double d_fx;
-   double d_fy;
-   double b_fx;
-   double b_fy;
-
-   // Amplitudes
-   double xu_amp;
-   double xf_amp;
-   double yu_amp;
-   double yf_amp;
-   double bxf_amp;
-   double byf_amp;
-
-   // Frequencies
-   double xu_freq;
-   double xf_freq;
-   double yu_freq;
-   double yf_freq;
-   double bxf_freq;
-   double byf_freq;
-
-   // Sine offsets
-   double xu_offset;
-   double xf_offset;
-   double yu_offset;
-   double yf_offset;
-   double bxf_offset;
-   double byf_offset;
 
 double perturb_func(const double x, const double amp, const double freq, const double offset)
 {
    return amp * sin(pi * freq *( x / 3.0 + 2 * offset) );
 }
 
-void left_disp(const Vector &x, double t, Vector &u)
+void left_disp(const Params &p, const Vector &x, double t, Vector &u)
 {
-   if (lx >= 0.5)
-      u(0) = l_ux + perturb_func(x(0), xu_amp, xu_freq, xu_offset);
-   if (ly >= 0.5)
-      u(1) = l_uy + perturb_func(x(1), yu_amp, yu_freq, yu_offset);
+   if (p.lx >= 0.5)
+      u(0) = p.l_ux + perturb_func(x(0), p.xu_amp, p.xu_freq, p.xu_offset);
+   if (p.ly >= 0.5)
+      u(1) = p.l_uy + perturb_func(x(1), p.yu_amp, p.yu_freq, p.yu_offset);
 }
 
-void right_disp(const Vector &x, double t, Vector &u)
+void right_disp(const Params &p, const Vector &x, double t, Vector &u)
 {
-   if (rx >= 0.5)
-      u(0) = r_fx + perturb_func(x(0), xf_amp, xf_freq, xf_offset);
-   if (ry >= 0.5)
-      u(1) = r_fy + perturb_func(x(1), yf_amp, yf_freq, yf_offset);
+   if (p.rx >= 0.5)
+      u(0) = p.r_fx + perturb_func(x(0), p.xf_amp, p.xf_freq, p.xf_offset);
+   if (p.ry >= 0.5)
+      u(1) = p.r_fy + perturb_func(x(1), p.yf_amp, p.yf_freq, p.yf_offset);
 }
 
-void up_disp(const Vector &x, double t, Vector &u)
+void up_disp(const Params &p, const Vector &x, double t, Vector &u)
 {
-   if (ux >= 0.5)
-      u(0) = u_fx + perturb_func(x(0), xf_amp, xf_freq, xf_offset);
-   if (uy >= 0.5)
-      u(1) = u_fy + perturb_func(x(1), yf_amp, yf_freq, yf_offset);
+   if (p.ux >= 0.5)
+      u(0) = p.u_fx + perturb_func(x(0), p.xf_amp, p.xf_freq, p.xf_offset);
+   if (p.uy >= 0.5)
+      u(1) = p.u_fy + perturb_func(x(1), p.yf_amp, p.yf_freq, p.yf_offset);
 }
 
-void down_disp(const Vector &x, double t, Vector &u)
+void down_disp(const Params &p, const Vector &x, double t, Vector &u)
 {
-   if (dx >= 0.5)
-      u(0) = d_fx + perturb_func(x(0), xf_amp, xf_freq, xf_offset);
-   if (dy >= 0.5)
-      u(1) = d_fy + perturb_func(x(1), yf_amp, yf_freq, yf_offset);
+   if (p.dx >= 0.5)
+      u(0) = p.d_fx + perturb_func(x(0), p.xf_amp, p.xf_freq, p.xf_offset);
+   if (p.dy >= 0.5)
+      u(1) = p.d_fy + perturb_func(x(1), p.yf_amp, p.yf_freq, p.yf_offset);
 }
 
-void body_force(const Vector &x, double t, Vector &u)
+void body_force(const Params &p, const Vector &x, double t, Vector &u)
 {
-   if (bx >= 0.5)
-      u(0) = b_fx + perturb_func(x(0), bxf_amp, bxf_freq, bxf_offset);
-   if (by >= 0.5)
-      u(1) = b_fy + perturb_func(x(1), byf_amp, byf_freq, byf_offset);
+   if (p.bx >= 0.5)
+      u(0) = p.b_fx + perturb_func(x(0), p.bxf_amp, p.bxf_freq, p.bxf_offset);
+   if (p.by >= 0.5)
+      u(1) = p.b_fy + perturb_func(x(1), p.byf_amp, p.byf_freq, p.byf_offset);
 }
 
 }  // namespace linelast_cwtrain
@@ -430,11 +344,8 @@ ParameterizedProblem::ParameterizedProblem()
    battr.SetSize(1); battr = -1;
    bdr_type.SetSize(1); bdr_type = BoundaryType::NUM_BDR_TYPE;
 
-   scalar_bdr_ptr.SetSize(1);
-   vector_bdr_ptr.SetSize(1);
-
-   scalar_bdr_ptr = NULL;
-   vector_bdr_ptr = NULL;
+   scalar_bdr_ptr.resize(1);
+   vector_bdr_ptr.resize(1);
 };
 
 void ParameterizedProblem::SetParams(const std::string &key, const double &value)
@@ -457,18 +368,18 @@ void ParameterizedProblem::SetParams(const Array<int> &indexes, const Vector &va
       (*param_ptr[indexes[idx]]) = values(idx);
 }
 
-void ParameterizedProblem::SetSingleRun()
+void ParameterizedProblem::SetSingleRun(InputParser &parser)
 {
    std::string problem_name = GetProblemName();
    std::string param_list_str("single_run/" + problem_name);
-   YAML::Node param_list = config.FindNode(param_list_str);
+   YAML::Node param_list = parser.FindNode(param_list_str);
    if (!param_list) mfem_error("Single Run - cannot find the problem name!\n");
 
    // size_t num_params = param_list.size();
    // for (int p = 0; p < num_params; p++)
    // {
-   //    std::string param_name = config.GetRequiredOptionFromDict<std::string>("parameter_name", param_list[p]);
-   //    double value = config.GetRequiredOptionFromDict<double>("value", param_list[p]);
+   //    std::string param_name = parser.GetRequiredOptionFromDict<std::string>("parameter_name", param_list[p]);
+   //    double value = parser.GetRequiredOptionFromDict<double>("value", param_list[p]);
    //    SetParams(param_name, value);
    // }
 
@@ -572,23 +483,20 @@ Poisson0::Poisson0()
    battr = -1;
    bdr_type = BoundaryType::ZERO;
 
-   scalar_bdr_ptr.SetSize(1);
-   vector_bdr_ptr.SetSize(1);
-
-   // pointer to static function.
-   scalar_bdr_ptr = NULL;
-   scalar_rhs_ptr = &(function_factory::poisson0::rhs);
+   // function bound to the parameters of this instance.
+   scalar_rhs_ptr = [this](const Vector &x, double t)
+                    { return function_factory::poisson0::rhs(params, x, t); };
 
    // Default values.
-   function_factory::poisson0::k = 1.0;
-   function_factory::poisson0::offset = 0.0;
+   params.k = 1.0;
+   params.offset = 0.0;
 
    param_map["k"] = 0;
    param_map["offset"] = 1;
 
    param_ptr.SetSize(2);
-   param_ptr[0] = &(function_factory::poisson0::k);
-   param_ptr[1] = &(function_factory::poisson0::offset);
+   param_ptr[0] = &(params.k);
+   param_ptr[1] = &(params.offset);
 }
 
 /*
@@ -603,16 +511,20 @@ PoissonComponent::PoissonComponent()
    battr = -1;
    bdr_type = BoundaryType::DIRICHLET;
 
-   // pointer to static function.
-   scalar_rhs_ptr = &(function_factory::poisson_component::rhs);
-   scalar_bdr_ptr = &(function_factory::poisson_component::bdr);
+   // functions bound to the parameters of this instance.
+   scalar_rhs_ptr = [this](const Vector &x, double t)
+                    { return function_factory::poisson_component::rhs(params, x, t); };
+   scalar_bdr_ptr[0] = [this](const Vector &x, double t)
+                       { return function_factory::poisson_component::bdr(params, x, t); };
 
    // Default values: a constant right-hand side with homogeneous Dirichlet BC.
-   function_factory::poisson_component::k = 0.0;
-   function_factory::poisson_component::offset = 0.1;
-   function_factory::poisson_component::bdr_k = 0.0;
-   function_factory::poisson_component::bdr_offset = 0.0;
-   function_factory::poisson_component::bdr_idx = -1.0;
+   params.k.SetSize(3);
+   params.bdr_k.SetSize(3);
+   params.k = 0.0;
+   params.offset = 0.1;
+   params.bdr_k = 0.0;
+   params.bdr_offset = 0.0;
+   params.bdr_idx = -1.0;
 
    for (int d = 0; d < 3; d++)
    {
@@ -626,17 +538,17 @@ PoissonComponent::PoissonComponent()
    param_ptr.SetSize(param_num);
    for (int d = 0; d < 3; d++)
    {
-      param_ptr[d] = &(function_factory::poisson_component::k[d]);
-      param_ptr[d + 4] = &(function_factory::poisson_component::bdr_k[d]);
+      param_ptr[d] = &(params.k[d]);
+      param_ptr[d + 4] = &(params.bdr_k[d]);
    }
-   param_ptr[3] = &(function_factory::poisson_component::offset);
-   param_ptr[7] = &(function_factory::poisson_component::bdr_offset);
-   param_ptr[8] = &(function_factory::poisson_component::bdr_idx);
+   param_ptr[3] = &(params.offset);
+   param_ptr[7] = &(params.bdr_offset);
+   param_ptr[8] = &(params.bdr_idx);
 }
 
 void PoissonComponent::SetBattr()
 {
-   double bidx = function_factory::poisson_component::bdr_idx;
+   double bidx = params.bdr_idx;
    battr.SetSize(1);
    battr = -1;
    if (bidx >= 0.0)
@@ -669,15 +581,15 @@ PoissonSpiral::PoissonSpiral()
    battr = -1;
    bdr_type = BoundaryType::ZERO;
 
-   // pointer to static function.
-   scalar_bdr_ptr = NULL;
-   scalar_rhs_ptr = &(function_factory::poisson_spiral::rhs);
+   // function bound to the parameters of this instance.
+   scalar_rhs_ptr = [this](const Vector &x, double t)
+                    { return function_factory::poisson_spiral::rhs(params, x, t); };
 
    // Default values.
-   function_factory::poisson_spiral::L = 1.0;
-   function_factory::poisson_spiral::Lw = 0.2;
-   function_factory::poisson_spiral::k = 1.0;
-   function_factory::poisson_spiral::s = 0.6;
+   params.L = 1.0;
+   params.Lw = 0.2;
+   params.k = 1.0;
+   params.s = 0.6;
 
    param_map["L"] = 0;
    param_map["Lw"] = 1;
@@ -685,10 +597,10 @@ PoissonSpiral::PoissonSpiral()
    param_map["s"] = 3;
 
    param_ptr.SetSize(param_num);
-   param_ptr[0] = &(function_factory::poisson_spiral::L);
-   param_ptr[1] = &(function_factory::poisson_spiral::Lw);
-   param_ptr[2] = &(function_factory::poisson_spiral::k);
-   param_ptr[3] = &(function_factory::poisson_spiral::s);
+   param_ptr[0] = &(params.L);
+   param_ptr[1] = &(params.Lw);
+   param_ptr[2] = &(params.k);
+   param_ptr[3] = &(params.s);
 }
 
 /*
@@ -706,18 +618,17 @@ ChannelFlow::ChannelFlow()
    bdr_type[1] = BoundaryType::NEUMANN;
    bdr_type[3] = BoundaryType::DIRICHLET;
 
-   // pointer to static function.
-   vector_bdr_ptr.SetSize(5);
-   vector_rhs_ptr = NULL;
-   vector_bdr_ptr = &(function_factory::flow_problem::channel_flow::ubdr);
+   // function bound to the parameters of this instance.
+   vector_bdr_ptr.assign(5, [this](const Vector &x, double t, Vector &y)
+                            { function_factory::flow_problem::channel_flow::ubdr(params, x, t, y); });
 
    param_num = 4;
 
    // Default values.
-   function_factory::flow_problem::nu = 1.0;
-   function_factory::flow_problem::channel_flow::L = 1.0;
-   function_factory::flow_problem::channel_flow::U = 1.0;
-   function_factory::flow_problem::channel_flow::x0 = 0.5;
+   flow_params.nu = 1.0;
+   params.L = 1.0;
+   params.U = 1.0;
+   params.x0 = 0.5;
 
    param_map["nu"] = 0;
    param_map["L"] = 1;
@@ -725,10 +636,10 @@ ChannelFlow::ChannelFlow()
    param_map["x0"] = 3;
 
    param_ptr.SetSize(param_num);
-   param_ptr[0] = &(function_factory::flow_problem::nu);
-   param_ptr[1] = &(function_factory::flow_problem::channel_flow::L);
-   param_ptr[2] = &(function_factory::flow_problem::channel_flow::U);
-   param_ptr[3] = &(function_factory::flow_problem::channel_flow::x0);
+   param_ptr[0] = &(flow_params.nu);
+   param_ptr[1] = &(params.L);
+   param_ptr[2] = &(params.U);
+   param_ptr[3] = &(params.x0);
 }
 
 ComponentFlow::ComponentFlow()
@@ -741,23 +652,22 @@ ComponentFlow::ComponentFlow()
    bdr_type = BoundaryType::DIRICHLET;
    bdr_type[4] = BoundaryType::ZERO;
 
-   // pointer to static function.
-   vector_bdr_ptr.SetSize(5);
-   vector_rhs_ptr = NULL;
-   vector_bdr_ptr = &(function_factory::flow_problem::component_flow::ubdr);
+   // function bound to the parameters of this instance.
+   vector_bdr_ptr.assign(5, [this](const Vector &x, double t, Vector &y)
+                            { function_factory::flow_problem::component_flow::ubdr(flow_params, params, x, t, y); });
 
    param_num = 1 + 3 * 3 + 3 * 3;
-   function_factory::flow_problem::component_flow::u0.SetSize(3);
-   function_factory::flow_problem::component_flow::du.SetSize(3);
-   function_factory::flow_problem::component_flow::offsets.SetSize(3);
-   function_factory::flow_problem::component_flow::k.SetSize(3);
+   params.u0.SetSize(3);
+   params.du.SetSize(3);
+   params.offsets.SetSize(3);
+   params.k.SetSize(3);
 
    // Default values.
-   function_factory::flow_problem::nu = 1.0;
-   function_factory::flow_problem::component_flow::u0 = 0.0;
-   function_factory::flow_problem::component_flow::du = 1.0;
-   function_factory::flow_problem::component_flow::offsets = 0.0;
-   function_factory::flow_problem::component_flow::k = 1.0;
+   flow_params.nu = 1.0;
+   params.u0 = 0.0;
+   params.du = 1.0;
+   params.offsets = 0.0;
+   params.k = 1.0;
 
    std::vector<std::string> xc(3), uc(3);
    xc[0] = "_x";
@@ -778,14 +688,14 @@ ComponentFlow::ComponentFlow()
    }
 
    param_ptr.SetSize(param_num);
-   param_ptr[0] = &(function_factory::flow_problem::nu);
+   param_ptr[0] = &(flow_params.nu);
    for (int i = 0; i < 3; i++)
    {
-      param_ptr[1+i] = &(function_factory::flow_problem::component_flow::u0[i]);
-      param_ptr[4+i] = &(function_factory::flow_problem::component_flow::du[i]);
-      param_ptr[7+i] = &(function_factory::flow_problem::component_flow::offsets[i]);
+      param_ptr[1+i] = &(params.u0[i]);
+      param_ptr[4+i] = &(params.du[i]);
+      param_ptr[7+i] = &(params.offsets[i]);
       for (int j = 0; j < 3; j++)
-         param_ptr[10 + 3*i + j] = &(function_factory::flow_problem::component_flow::k(j,i));
+         param_ptr[10 + 3*i + j] = &(params.k(j,i));
    }
 }
 
@@ -794,7 +704,7 @@ ComponentFlow::ComponentFlow()
 */
 
 FlowPastArray::FlowPastArray()
-   : ComponentFlow(), u0(&function_factory::flow_problem::component_flow::u0)
+   : ComponentFlow(), u0(&params.u0)
 {}
 
 void FlowPastArray::SetParams(const std::string &key, const double &value)
@@ -856,33 +766,33 @@ BackwardFacingStep::BackwardFacingStep()
    bdr_type[1] = BoundaryType::ZERO;
    bdr_type[2] = BoundaryType::NEUMANN;
 
-   // pointer to static function.
-   vector_bdr_ptr.SetSize(3);
-   vector_rhs_ptr = NULL;
+   // function bound to the parameters of this instance.
    /* technically only vector_bdr_ptr[0] will be used. */
-   vector_bdr_ptr = &(function_factory::flow_problem::backward_facing_step::ubdr);
+   vector_bdr_ptr.assign(3, [this](const Vector &x, double t, Vector &y)
+                            { function_factory::flow_problem::backward_facing_step::ubdr(params, x, t, y); });
 
-   /* pointer to initial condition */
-   ic_ptr.SetSize(2);
-   ic_ptr[0] = &(function_factory::flow_problem::backward_facing_step::uic);
-   ic_ptr[1] = &(function_factory::flow_problem::backward_facing_step::pic);
+   /* initial condition */
+   ic_ptr.resize(2);
+   ic_ptr[0] = [this](const Vector &x, double t, Vector &y)
+               { function_factory::flow_problem::backward_facing_step::uic(params, x, t, y); };
+   ic_ptr[1] = function_factory::flow_problem::backward_facing_step::pic;
 
    param_num = 4 + 2 * 4;
 
    // Default values.
-   function_factory::flow_problem::nu = 1.0;
-   function_factory::flow_problem::backward_facing_step::y0 = 0.0;
-   function_factory::flow_problem::backward_facing_step::y1 = 1.0;
-   function_factory::flow_problem::backward_facing_step::u0 = 1.0;
-
-   function_factory::flow_problem::backward_facing_step::amp.SetSize(2);
-   function_factory::flow_problem::backward_facing_step::ky.SetSize(2);
-   function_factory::flow_problem::backward_facing_step::freq.SetSize(2);
-   function_factory::flow_problem::backward_facing_step::t_offset.SetSize(2);
-   function_factory::flow_problem::backward_facing_step::amp = 0.0;
-   function_factory::flow_problem::backward_facing_step::ky = 0.0;
-   function_factory::flow_problem::backward_facing_step::freq = 0.0;
-   function_factory::flow_problem::backward_facing_step::t_offset = 0.0;
+   flow_params.nu = 1.0;
+   params.y0 = 0.0;
+   params.y1 = 1.0;
+   params.u0 = 1.0;
+
+   params.amp.SetSize(2);
+   params.ky.SetSize(2);
+   params.freq.SetSize(2);
+   params.t_offset.SetSize(2);
+   params.amp = 0.0;
+   params.ky = 0.0;
+   params.freq = 0.0;
+   params.t_offset = 0.0;
 
    param_map["nu"] = 0;
    param_map["y0"] = 1;
@@ -890,10 +800,10 @@ BackwardFacingStep::BackwardFacingStep()
    param_map["u0"] = 3;
 
    param_ptr.SetSize(param_num);
-   param_ptr[0] = &(function_factory::flow_problem::nu);
-   param_ptr[1] = &(function_factory::flow_problem::backward_facing_step::y0);
-   param_ptr[2] = &(function_factory::flow_problem::backward_facing_step::y1);
-   param_ptr[3] = &(function_factory::flow_problem::backward_facing_step::u0);
+   param_ptr[0] = &(flow_params.nu);
+   param_ptr[1] = &(params.y0);
+   param_ptr[2] = &(params.y1);
+   param_ptr[3] = &(params.u0);
 
    for (int m = 0; m < 2; m++)
    {
@@ -901,10 +811,10 @@ BackwardFacingStep::BackwardFacingStep()
       param_map["ky" + std::to_string(m)] = 5 + m * 4;
       param_map["freq" + std::to_string(m)] = 6 + m * 4;
       param_map["t_offset" + std::to_string(m)] = 7 + m * 4;
-      param_ptr[4 + m * 4] = &(function_factory::flow_problem::backward_facing_step::amp[m]);
-      param_ptr[5 + m * 4] = &(function_factory::flow_problem::backward_facing_step::ky[m]);
-      param_ptr[6 + m * 4] = &(function_factory::flow_problem::backward_facing_step::freq[m]);
-      param_ptr[7 + m * 4] = &(function_factory::flow_problem::backward_facing_step::t_offset[m]);
+      param_ptr[4 + m * 4] = &(params.amp[m]);
+      param_ptr[5 + m * 4] = &(params.ky[m]);
+      param_ptr[6 + m * 4] = &(params.freq[m]);
+      param_ptr[7 + m * 4] = &(params.t_offset[m]);
    }
 }
 
@@ -928,27 +838,26 @@ LidDrivenCavity::LidDrivenCavity()
    bdr_type[2] = BoundaryType::DIRICHLET;
    bdr_type[0] = BoundaryType::DIRICHLET;
 
-   // pointer to static function.
-   vector_bdr_ptr.SetSize(5);
-   vector_rhs_ptr = NULL;
+   // function bound to the parameters of this instance.
    /* technically only vector_bdr_ptr[2] will be used. */
-   vector_bdr_ptr = &(function_factory::flow_problem::lid_driven_cavity::ubdr);
+   vector_bdr_ptr.assign(5, [this](const Vector &x, double t, Vector &y)
+                            { function_factory::flow_problem::lid_driven_cavity::ubdr(params, x, t, y); });
 
    param_num = 3;
 
    // Default values.
-   function_factory::flow_problem::nu = 1.0;
-   function_factory::flow_problem::lid_driven_cavity::u0 = 1.0;
-   function_factory::flow_problem::lid_driven_cavity::L = 1.0;
+   flow_params.nu = 1.0;
+   params.u0 = 1.0;
+   params.L = 1.0;
 
    param_map["nu"] = 0;
    param_map["u0"] = 1;
    param_map["L"] = 2;
 
    param_ptr.SetSize(param_num);
-   param_ptr[0] = &(function_factory::flow_problem::nu);
-   param_ptr[1] = &(function_factory::flow_problem::lid_driven_cavity::u0);
-   param_ptr[2] = &(function_factory::flow_problem::lid_driven_cavity::L);
+   param_ptr[0] = &(flow_params.nu);
+   param_ptr[1] = &(params.u0);
+   param_ptr[2] = &(params.L);
 }
 
 /*
@@ -963,17 +872,17 @@ PeriodicFlowPastArray::PeriodicFlowPastArray()
    bdr_type.SetSize(1);
    bdr_type = BoundaryType::ZERO;
 
-   // pointer to static function.
-   vector_bdr_ptr.SetSize(1);
-   vector_bdr_ptr = NULL;
-   vector_rhs_ptr = &(function_factory::flow_problem::periodic_flow_past_array::force);
+   // function bound to the parameters of this instance.
+   vector_bdr_ptr.resize(1);
+   vector_rhs_ptr = [this](const Vector &x, double t, Vector &y)
+                    { function_factory::flow_problem::periodic_flow_past_array::force(params, x, t, y); };
 
    param_num = 4;
-   function_factory::flow_problem::periodic_flow_past_array::f.SetSize(3);
+   params.f.SetSize(3);
 
    // Default values.
-   function_factory::flow_problem::nu = 1.0;
-   function_factory::flow_problem::periodic_flow_past_array::f = 0.0;
+   flow_params.nu = 1.0;
+   params.f = 0.0;
 
    param_map["nu"] = 0;
    param_map["fx"] = 1;
@@ -981,9 +890,9 @@ PeriodicFlowPastArray::PeriodicFlowPastArray()
    param_map["fz"] = 3;
 
    param_ptr.SetSize(param_num);
-   param_ptr[0] = &(function_factory::flow_problem::nu);
+   param_ptr[0] = &(flow_params.nu);
    for (int i = 0; i < 3; i++)
-      param_ptr[1+i] = &(function_factory::flow_problem::periodic_flow_past_array::f[i]);
+      param_ptr[1+i] = &(params.f[i]);
 
 }
 
@@ -1002,9 +911,8 @@ ForceDrivenCorner::ForceDrivenCorner()
    bdr_type[2] = BoundaryType::NEUMANN;
    bdr_type[3] = BoundaryType::NEUMANN;
 
-   // pointer to static function.
-   vector_bdr_ptr.SetSize(5);
-   vector_bdr_ptr = NULL;
+   // no boundary function.
+   vector_bdr_ptr.assign(5, nullptr);
 }
 
 /*
@@ -1014,244 +922,251 @@ ForceDrivenCorner::ForceDrivenCorner()
 LinElastDisp::LinElastDisp()
     : LinElastProblem()
 {
-   // pointer to static function.
+   // functions bound to the parameters of this instance.
    bdr_type.SetSize(3);
    battr.SetSize(3);
-   vector_bdr_ptr.SetSize(3);
-   for (size_t i = 0; i < vector_bdr_ptr.Size(); i++)
+   vector_bdr_ptr.resize(3);
+   function_factory::GeneralVectorFunction init_disp = [this](const Vector &x, double t, Vector &u)
+                                                       { function_factory::linelast_disp::init_disp(params, x, t, u); };
+   for (size_t i = 0; i < vector_bdr_ptr.size(); i++)
    {
       bdr_type[i] = BoundaryType::DIRICHLET;
       battr[i] = i+1;
-      vector_bdr_ptr[i] = &(function_factory::linelast_disp::init_disp);
+      vector_bdr_ptr[i] = init_disp;
    }
 
    battr[2] = 3;
    bdr_type[2] = BoundaryType::ZERO;
-   vector_bdr_ptr[2] = NULL;
+   vector_bdr_ptr[2] = nullptr;
    
    // Set materials
-   general_scalar_ptr.SetSize(2);
-   general_scalar_ptr[0] = function_factory::linelast_problem::lambda;
-   general_scalar_ptr[1] = function_factory::linelast_problem::mu;
+   general_scalar_ptr.resize(2);
+   general_scalar_ptr[0] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::lambda(material, x, t); };
+   general_scalar_ptr[1] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::mu(material, x, t); };
 
    // Set IC
-   general_vector_ptr.SetSize(1);
-   general_vector_ptr[0] = function_factory::linelast_disp::init_disp;
+   general_vector_ptr.resize(1);
+   general_vector_ptr[0] = init_disp;
    
    // Default values.
-   function_factory::linelast_disp::rdisp_f = 1.0;
-   function_factory::linelast_problem::_lambda = 1.0;
-   function_factory::linelast_problem::_mu = 1.0;
+   params.rdisp_f = 1.0;
+   material.lambda = 1.0;
+   material.mu = 1.0;
 
    param_map["rdisp_f"] = 0;
    param_map["lambda"] = 1;
    param_map["mu"] = 2;
 
    param_ptr.SetSize(3);
-   param_ptr[0] = &(function_factory::linelast_disp::rdisp_f);
-   param_ptr[1] = &(function_factory::linelast_problem::_lambda);
-   param_ptr[2] = &(function_factory::linelast_problem::_mu);
+   param_ptr[0] = &(params.rdisp_f);
+   param_ptr[1] = &(material.lambda);
+   param_ptr[2] = &(material.mu);
 }
 
 LinElastDispLCantilever::LinElastDispLCantilever()
     : LinElastProblem()
 {
-   // pointer to static function.
+   // functions bound to the parameters of this instance.
    bdr_type.SetSize(3);
    battr.SetSize(3);
-   vector_bdr_ptr.SetSize(3);
+   vector_bdr_ptr.resize(3);
    for (size_t i = 0; i < 2; i++)
    {
       battr[i] = i+1;
       bdr_type[i] = BoundaryType::DIRICHLET;
-      vector_bdr_ptr[i] = &(function_factory::linelast_disp::init_disp_lcantilever);
+      vector_bdr_ptr[i] = [this](const Vector &x, double t, Vector &u)
+                          { function_factory::linelast_disp::init_disp_lcantilever(params, x, t, u); };
    }
 
    /* homogeneous Neumann bc */
    battr[2] = 3;
    bdr_type[2] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[2] = NULL;
    
    // Set materials
-   general_scalar_ptr.SetSize(2);
-   general_scalar_ptr[0] = function_factory::linelast_problem::lambda;
-   general_scalar_ptr[1] = function_factory::linelast_problem::mu;
+   general_scalar_ptr.resize(2);
+   general_scalar_ptr[0] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::lambda(material, x, t); };
+   general_scalar_ptr[1] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::mu(material, x, t); };
    
    // Default values.
-   function_factory::linelast_disp::rdisp_f = 1.0;
-   function_factory::linelast_problem::_lambda = 1.0;
-   function_factory::linelast_problem::_mu = 1.0;
+   params.rdisp_f = 1.0;
+   material.lambda = 1.0;
+   material.mu = 1.0;
 
    param_map["rdisp_f"] = 0;
    param_map["lambda"] = 1;
    param_map["mu"] = 2;
 
    param_ptr.SetSize(3);
-   param_ptr[0] = &(function_factory::linelast_disp::rdisp_f);
-   param_ptr[1] = &(function_factory::linelast_problem::_lambda);
-   param_ptr[2] = &(function_factory::linelast_problem::_mu);
+   param_ptr[0] = &(params.rdisp_f);
+   param_ptr[1] = &(material.lambda);
+   param_ptr[2] = &(material.mu);
 
-   general_vector_ptr.SetSize(1);
-   general_vector_ptr[0] = NULL;
+   general_vector_ptr.resize(1);
 }
 
 LinElastDispLattice::LinElastDispLattice()
     : LinElastProblem()
 {
-   // pointer to static function.
+   // functions bound to the parameters of this instance.
    bdr_type.SetSize(5);
    battr.SetSize(5);
-   vector_bdr_ptr.SetSize(5);
+   vector_bdr_ptr.resize(5);
+   function_factory::GeneralVectorFunction init_disp = [this](const Vector &x, double t, Vector &u)
+                                                       { function_factory::linelast_disp::init_disp(params, x, t, u); };
 
    // Down
    battr[0] = 1;
    bdr_type[0] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[0] = NULL;
 
    // Right
    battr[1] = 2;
    bdr_type[1] = BoundaryType::DIRICHLET;
-   vector_bdr_ptr[1] = &(function_factory::linelast_disp::init_disp);
+   vector_bdr_ptr[1] = init_disp;
 
    // Up
    battr[2] = 3;
    bdr_type[2] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[2] = NULL;
 
    // Left
    battr[3] = 4;
    bdr_type[3] = BoundaryType::DIRICHLET;
-   vector_bdr_ptr[3] = &(function_factory::linelast_disp::init_disp);
+   vector_bdr_ptr[3] = init_disp;
 
    // None
    battr[4] = 5;
    bdr_type[4] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[4] = NULL;
 
    // Set materials
-   general_scalar_ptr.SetSize(2);
-   general_scalar_ptr[0] = function_factory::linelast_problem::lambda;
-   general_scalar_ptr[1] = function_factory::linelast_problem::mu;
+   general_scalar_ptr.resize(2);
+   general_scalar_ptr[0] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::lambda(material, x, t); };
+   general_scalar_ptr[1] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::mu(material, x, t); };
 
    // Default values.
-   function_factory::linelast_disp::rdisp_f = 1.0;
-   function_factory::linelast_problem::_lambda = 1.0;
-   function_factory::linelast_problem::_mu = 1.0;
+   params.rdisp_f = 1.0;
+   material.lambda = 1.0;
+   material.mu = 1.0;
 
    param_map["rdisp_f"] = 0;
    param_map["lambda"] = 1;
    param_map["mu"] = 2;
 
    param_ptr.SetSize(3);
-   param_ptr[0] = &(function_factory::linelast_disp::rdisp_f);
-   param_ptr[1] = &(function_factory::linelast_problem::_lambda);
-   param_ptr[2] = &(function_factory::linelast_problem::_mu);
+   param_ptr[0] = &(params.rdisp_f);
+   param_ptr[1] = &(material.lambda);
+   param_ptr[2] = &(material.mu);
 
-   general_vector_ptr.SetSize(1);
-   general_vector_ptr[0] = NULL;
+   general_vector_ptr.resize(1);
 
 }
 
 LinElastForceCantilever::LinElastForceCantilever()
     : LinElastProblem()
 {
-   // pointer to static function.
+   // functions bound to the parameters of this instance.
    bdr_type.SetSize(5);
    battr.SetSize(5);
-   vector_bdr_ptr.SetSize(5);
+   vector_bdr_ptr.resize(5);
 
    // Down
    battr[0] = 1;
    bdr_type[0] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[0] = NULL;
 
    // Right
    battr[1] = 2;
    bdr_type[1] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[1] = &(function_factory::linelast_force::tip_force);
+   vector_bdr_ptr[1] = [this](const Vector &x, double t, Vector &f)
+                       { function_factory::linelast_force::tip_force(params, x, t, f); };
 
    // Up
    battr[2] = 3;
    bdr_type[2] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[2] = NULL;
 
    // Left
    battr[3] = 4;
    bdr_type[3] = BoundaryType::DIRICHLET;
-   vector_bdr_ptr[3] = &(function_factory::linelast_disp::init_disp);
+   vector_bdr_ptr[3] = [this](const Vector &x, double t, Vector &u)
+                       { function_factory::linelast_disp::init_disp(disp_params, x, t, u); };
 
    // None
    battr[4] = 5;
    bdr_type[4] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[4] = NULL;
    
    // Set materials
-   general_scalar_ptr.SetSize(2);
-   general_scalar_ptr[0] = function_factory::linelast_problem::lambda;
-   general_scalar_ptr[1] = function_factory::linelast_problem::mu;
+   general_scalar_ptr.resize(2);
+   general_scalar_ptr[0] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::lambda(material, x, t); };
+   general_scalar_ptr[1] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::mu(material, x, t); };
    
    // Default values.
-   function_factory::linelast_force::rforce_f = 1.0;
-   function_factory::linelast_problem::_lambda = 1.0;
-   function_factory::linelast_problem::_mu = 1.0;
+   params.rforce_f = 1.0;
+   material.lambda = 1.0;
+   material.mu = 1.0;
+   // the left boundary is clamped.
+   disp_params.rdisp_f = 0.0;
 
    param_map["rforce_f"] = 0;
    param_map["lambda"] = 1;
    param_map["mu"] = 2;
 
    param_ptr.SetSize(3);
-   param_ptr[0] = &(function_factory::linelast_force::rforce_f);
-   param_ptr[1] = &(function_factory::linelast_problem::_lambda);
-   param_ptr[2] = &(function_factory::linelast_problem::_mu);
+   param_ptr[0] = &(params.rforce_f);
+   param_ptr[1] = &(material.lambda);
+   param_ptr[2] = &(material.mu);
 
-   general_vector_ptr.SetSize(1);
-   general_vector_ptr[0] = NULL;
+   general_vector_ptr.resize(1);
 }
 
 LinElastFrameWind::LinElastFrameWind()
     : LinElastProblem()
 {
-   // pointer to static function.
+   // functions bound to the parameters of this instance.
    bdr_type.SetSize(5);
    battr.SetSize(5);
-   vector_bdr_ptr.SetSize(5);
+   vector_bdr_ptr.resize(5);
 
    // battr 1: Wind load
    battr[0] = 1;
    bdr_type[0] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[0] = &(function_factory::linelast_frame_wind::wind_load);
+   vector_bdr_ptr[0] = [this](const Vector &x, double t, Vector &f)
+                       { function_factory::linelast_frame_wind::wind_load(params, x, t, f); };
 
    // battr 2: Line load (to be implemented)
    battr[1] = 2;
    bdr_type[1] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[1] = NULL;
 
    // battr 3: Other load (To be implemented)
    battr[2] = 3;
    bdr_type[2] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[2] = NULL;
 
    // battr 4: Dirichlet BCs
    battr[3] = 4;
    bdr_type[3] = BoundaryType::DIRICHLET;
-   vector_bdr_ptr[3] = &(function_factory::linelast_frame_wind::dirichlet);
+   vector_bdr_ptr[3] = function_factory::linelast_frame_wind::dirichlet;
 
    // battr 5: Unloaded
    battr[4] = 3;
    bdr_type[4] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[4] = NULL;
 
    // Set materials
-   general_scalar_ptr.SetSize(2);
-   general_scalar_ptr[0] = function_factory::linelast_problem::lambda;
-   general_scalar_ptr[1] = function_factory::linelast_problem::mu;
+   general_scalar_ptr.resize(2);
+   general_scalar_ptr[0] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::lambda(material, x, t); };
+   general_scalar_ptr[1] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::mu(material, x, t); };
 
    // Default values.
-   function_factory::linelast_problem::_lambda = 3846153846.0;
-   function_factory::linelast_problem::_mu = 769230769.0;
-   function_factory::linelast_frame_wind::qwind_f = 500.0; // [N]
-   function_factory::linelast_frame_wind::density = 78.5; //[kg/m2]
-   function_factory::linelast_frame_wind::g = 9.81; 
+   material.lambda = 3846153846.0;
+   material.mu = 769230769.0;
+   params.qwind_f = 500.0; // [N]
+   params.density = 78.5; //[kg/m2]
+   params.g = 9.81; 
 
    param_map["lambda"] = 0;
    param_map["mu"] = 1;
@@ -1260,16 +1175,16 @@ LinElastFrameWind::LinElastFrameWind()
    param_map["g"] = 4;
 
    param_ptr.SetSize(5);
-   param_ptr[0] = &(function_factory::linelast_problem::_lambda);
-   param_ptr[1] = &(function_factory::linelast_problem::_mu);
-   param_ptr[2] = &(function_factory::linelast_frame_wind::qwind_f);
-   param_ptr[3] = &(function_factory::linelast_frame_wind::density);
-   param_ptr[4] = &(function_factory::linelast_frame_wind::g);
+   param_ptr[0] = &(material.lambda);
+   param_ptr[1] = &(material.mu);
+   param_ptr[2] = &(params.qwind_f);
+   param_ptr[3] = &(params.density);
+   param_ptr[4] = &(params.g);
 
-   general_vector_ptr.SetSize(1);
-   general_vector_ptr[0] = NULL; // for now, change if current params doesn't work well enough.
+   general_vector_ptr.resize(1); // for now, change if current params doesn't work well enough.
 
-   vector_rhs_ptr = &(function_factory::linelast_frame_wind::gravity_load);
+   vector_rhs_ptr = [this](const Vector &x, double t, Vector &f)
+                    { function_factory::linelast_frame_wind::gravity_load(params, x, t, f); };
 }
 
 /*
@@ -1279,21 +1194,23 @@ LinElastFrameWind::LinElastFrameWind()
 AdvDiffFlowPastArray::AdvDiffFlowPastArray()
    : FlowPastArray(), flow_problem(new FlowPastArray)
 {
-   function_factory::advdiff_problem::analytic_flow = false;
-   function_factory::advdiff_problem::flow_problem = flow_problem;
-
    bdr_type.SetSize(5);
    bdr_type = BoundaryType::DIRICHLET;
    bdr_type[4] = BoundaryType::NEUMANN;
 
-   scalar_rhs_ptr = NULL;
-   scalar_bdr_ptr.SetSize(5);
-   scalar_bdr_ptr = &(function_factory::advdiff_problem::advdiff_flow_past_array::qbdr);
+   // function bound to the parameters of this instance.
+   scalar_bdr_ptr.assign(5, [this](const Vector &x, double t)
+                            { return function_factory::advdiff_problem::advdiff_flow_past_array::qbdr(advdiff_params, x, t); });
 
    // q0 + dq + qoffset + qk(3)
    param_num += 1 + 1 + 1 + 3;
    const int p0 = flow_problem->GetNumParams();
 
+   // flow parameters are set directly on flow_problem.
+   for (int p = 0; p < p0; p++)
+      param_ptr[p] = flow_problem->param_ptr[p];
+   u0 = flow_problem->u0;
+
    param_map["q0"] = p0;
    param_map["dq"] = p0 + 1;
    param_map["qoffset"] = p0 + 2;
@@ -1302,17 +1219,17 @@ AdvDiffFlowPastArray::AdvDiffFlowPastArray()
    param_map["qk_z"] = p0 + 5;
 
    // default values.
-   function_factory::advdiff_problem::advdiff_flow_past_array::q0 = 1.0;
-   function_factory::advdiff_problem::advdiff_flow_past_array::dq = 0.1;
-   function_factory::advdiff_problem::advdiff_flow_past_array::qoffset = 0.0;
-   function_factory::advdiff_problem::advdiff_flow_past_array::qk.SetSize(3);
-   function_factory::advdiff_problem::advdiff_flow_past_array::qk = 0.0;
-
-   param_ptr.Append(&(function_factory::advdiff_problem::advdiff_flow_past_array::q0));
-   param_ptr.Append(&(function_factory::advdiff_problem::advdiff_flow_past_array::dq));
-   param_ptr.Append(&(function_factory::advdiff_problem::advdiff_flow_past_array::qoffset));
+   advdiff_params.q0 = 1.0;
+   advdiff_params.dq = 0.1;
+   advdiff_params.qoffset = 0.0;
+   advdiff_params.qk.SetSize(3);
+   advdiff_params.qk = 0.0;
+
+   param_ptr.Append(&(advdiff_params.q0));
+   param_ptr.Append(&(advdiff_params.dq));
+   param_ptr.Append(&(advdiff_params.qoffset));
    for (int j = 0; j < 3; j++)
-      param_ptr.Append(&(function_factory::advdiff_problem::advdiff_flow_past_array::qk(j)));
+      param_ptr.Append(&(advdiff_params.qk(j)));
 }
 
 AdvDiffFlowPastArray::~AdvDiffFlowPastArray()
@@ -1323,92 +1240,97 @@ AdvDiffFlowPastArray::~AdvDiffFlowPastArray()
 LinElastComponentWiseTrain::LinElastComponentWiseTrain()
     : LinElastProblem()
 {
-   // pointer to static function.
+   // functions bound to the parameters of this instance.
    bdr_type.SetSize(5);
    battr.SetSize(5);
-   vector_bdr_ptr.SetSize(5);
+   vector_bdr_ptr.resize(5);
 
    // Down
    battr[0] = 1;
    bdr_type[0] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[0] = &(function_factory::linelast_cwtrain::down_disp);
+   vector_bdr_ptr[0] = [this](const Vector &x, double t, Vector &u)
+                       { function_factory::linelast_cwtrain::down_disp(params, x, t, u); };
 
    // Right
    battr[1] = 2;
    bdr_type[1] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[1] = &(function_factory::linelast_cwtrain::right_disp);
+   vector_bdr_ptr[1] = [this](const Vector &x, double t, Vector &u)
+                       { function_factory::linelast_cwtrain::right_disp(params, x, t, u); };
 
    // Up
    battr[2] = 3;
    bdr_type[2] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[2] = &(function_factory::linelast_cwtrain::up_disp);
+   vector_bdr_ptr[2] = [this](const Vector &x, double t, Vector &u)
+                       { function_factory::linelast_cwtrain::up_disp(params, x, t, u); };
 
    // Left
    battr[3] = 4;
    bdr_type[3] = BoundaryType::DIRICHLET;
-   vector_bdr_ptr[3] = &(function_factory::linelast_cwtrain::left_disp);
+   vector_bdr_ptr[3] = [this](const Vector &x, double t, Vector &u)
+                       { function_factory::linelast_cwtrain::left_disp(params, x, t, u); };
 
    // None
    battr[4] = 5;
    bdr_type[4] = BoundaryType::NEUMANN;
-   vector_bdr_ptr[4] = NULL;
 
    // Set materials
-   general_scalar_ptr.SetSize(2);
-   general_scalar_ptr[0] = function_factory::linelast_problem::lambda;
-   general_scalar_ptr[1] = function_factory::linelast_problem::mu;
+   general_scalar_ptr.resize(2);
+   general_scalar_ptr[0] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::lambda(material, x, t); };
+   general_scalar_ptr[1] = [this](const Vector &x, double t)
+                           { return function_factory::linelast_problem::mu(material, x, t); };
 
    // Probabilities default values
-   function_factory::linelast_cwtrain::lx = 0.0;
-   function_factory::linelast_cwtrain::ly = 0.0;
-   function_factory::linelast_cwtrain::rx = 0.0;
-   function_factory::linelast_cwtrain::ry = 0.0;
-   function_factory::linelast_cwtrain::dx = 0.0;
-   function_factory::linelast_cwtrain::dy = 0.0;
-   function_factory::linelast_cwtrain::ux = 0.0;
-   function_factory::linelast_cwtrain::uy = 0.0;
-   function_factory::linelast_cwtrain::bx = 0.0;
-   function_factory::linelast_cwtrain::by = 0.0;
+   params.lx = 0.0;
+   params.ly = 0.0;
+   params.rx = 0.0;
+   params.ry = 0.0;
+   params.dx = 0.0;
+   params.dy = 0.0;
+   params.ux = 0.0;
+   params.uy = 0.0;
+   params.bx = 0.0;
+   params.by = 0.0;
 
    // Constant force default values
-   function_factory::linelast_cwtrain::l_ux= 0.0;
-   function_factory::linelast_cwtrain::l_uy = 0.0;
-   function_factory::linelast_cwtrain::r_fx = 0.0;
-   function_factory::linelast_cwtrain::r_fy = 0.0;
-   function_factory::linelast_cwtrain::u_fx = 0.0;
-   function_factory::linelast_cwtrain::u_fy = 0.0;
-   function_factory::linelast_cwtrain::d_fx = 0.0;
-   function_factory::linelast_cwtrain::d_fy = 0.0;
-   function_factory::linelast_cwtrain::b_fx = 0.0;
-   function_factory::linelast_cwtrain::b_fy = 0.0;
+   params.l_ux = 0.0;
+   params.l_uy = 0.0;
+   params.r_fx = 0.0;
+   params.r_fy = 0.0;
+   params.u_fx = 0.0;
+   params.u_fy = 0.0;
+   params.d_fx = 0.0;
+   params.d_fy = 0.0;
+   params.b_fx = 0.0;
+   params.b_fy = 0.0;
 
    // Amplitudes default values
-   function_factory::linelast_cwtrain::xu_amp = 1.0;
-   function_factory::linelast_cwtrain::yu_amp = 1.0;
-   function_factory::linelast_cwtrain::xf_amp = 1.0;
-   function_factory::linelast_cwtrain::yf_amp = 1.0;
-   function_factory::linelast_cwtrain::bxf_amp = 1.0;
-   function_factory::linelast_cwtrain::byf_amp = 1.0;
+   params.xu_amp = 1.0;
+   params.yu_amp = 1.0;
+   params.xf_amp = 1.0;
+   params.yf_amp = 1.0;
+   params.bxf_amp = 1.0;
+   params.byf_amp = 1.0;
 
    // Frequencies default values
-   function_factory::linelast_cwtrain::xu_freq = 1.0;
-   function_factory::linelast_cwtrain::yu_freq = 1.0;
-   function_factory::linelast_cwtrain::xf_freq = 1.0;
-   function_factory::linelast_cwtrain::yf_freq = 1.0;
-   function_factory::linelast_cwtrain::bxf_freq = 1.0;
-   function_factory::linelast_cwtrain::byf_freq = 1.0;
+   params.xu_freq = 1.0;
+   params.yu_freq = 1.0;
+   params.xf_freq = 1.0;
+   params.yf_freq = 1.0;
+   params.bxf_freq = 1.0;
+   params.byf_freq = 1.0;
 
    // Sine offsets default values
-   function_factory::linelast_cwtrain::yu_offset = 0.0;
-   function_factory::linelast_cwtrain::xu_offset = 0.0;
-   function_factory::linelast_cwtrain::xf_offset = 0.0;
-   function_factory::linelast_cwtrain::yf_offset = 0.0;
-   function_factory::linelast_cwtrain::bxf_offset = 0.0;
-   function_factory::linelast_cwtrain::byf_offset = 0.0;
+   params.yu_offset = 0.0;
+   params.xu_offset = 0.0;
+   params.xf_offset = 0.0;
+   params.yf_offset = 0.0;
+   params.bxf_offset = 0.0;
+   params.byf_offset = 0.0;
    
    // Material parameters default values
-   function_factory::linelast_problem::_lambda = 1.0;
-   function_factory::linelast_problem::_mu = 1.0;
+   material.lambda = 1.0;
+   material.mu = 1.0;
 
    // Parameter map
    param_map["l_ux"] = 0;
@@ -1453,48 +1375,49 @@ LinElastComponentWiseTrain::LinElastComponentWiseTrain()
    param_map["by"] = 39;
 
    param_ptr.SetSize(40);
-   param_ptr[0] = &(function_factory::linelast_cwtrain::l_ux);
-   param_ptr[1] = &(function_factory::linelast_cwtrain::l_uy);
-   param_ptr[2] = &(function_factory::linelast_cwtrain::r_fx);
-   param_ptr[3] = &(function_factory::linelast_cwtrain::r_fy);
-   param_ptr[4] = &(function_factory::linelast_cwtrain::u_fx);
-   param_ptr[5] = &(function_factory::linelast_cwtrain::u_fy);
-   param_ptr[6] = &(function_factory::linelast_cwtrain::d_fx);
-   param_ptr[7] = &(function_factory::linelast_cwtrain::d_fy);
-   param_ptr[8] = &(function_factory::linelast_cwtrain::lx);
-   param_ptr[9] = &(function_factory::linelast_cwtrain::ly);
-   param_ptr[10] = &(function_factory::linelast_cwtrain::rx);
-   param_ptr[11] = &(function_factory::linelast_cwtrain::ry);
-   param_ptr[12] = &(function_factory::linelast_cwtrain::dx);
-   param_ptr[13] = &(function_factory::linelast_cwtrain::dy);
-   param_ptr[14] = &(function_factory::linelast_cwtrain::ux);
-   param_ptr[15] = &(function_factory::linelast_cwtrain::uy);
-   param_ptr[16] = &(function_factory::linelast_problem::_lambda);
-   param_ptr[17] = &(function_factory::linelast_problem::_mu);
-   param_ptr[18] = &(function_factory::linelast_cwtrain::xu_amp);
-   param_ptr[19] = &(function_factory::linelast_cwtrain::xu_freq);
-   param_ptr[20] = &(function_factory::linelast_cwtrain::xu_offset);
-   param_ptr[21] = &(function_factory::linelast_cwtrain::xf_amp);
-   param_ptr[22] = &(function_factory::linelast_cwtrain::xf_freq);
-   param_ptr[23] = &(function_factory::linelast_cwtrain::xf_offset);
-   param_ptr[24] = &(function_factory::linelast_cwtrain::yu_amp);
-   param_ptr[25] = &(function_factory::linelast_cwtrain::yu_freq);
-   param_ptr[26] = &(function_factory::linelast_cwtrain::yu_offset);
-   param_ptr[27] = &(function_factory::linelast_cwtrain::yf_amp);
-   param_ptr[28] = &(function_factory::linelast_cwtrain::yf_freq);
-   param_ptr[29] = &(function_factory::linelast_cwtrain::yf_offset);
-
-   param_ptr[30] = &(function_factory::linelast_cwtrain::b_fx);
-   param_ptr[31] = &(function_factory::linelast_cwtrain::b_fy);
-   param_ptr[32] = &(function_factory::linelast_cwtrain::bxf_amp);
-   param_ptr[33] = &(function_factory::linelast_cwtrain::bxf_freq);
-   param_ptr[34] = &(function_factory::linelast_cwtrain::bxf_offset);
-   param_ptr[35] = &(function_factory::linelast_cwtrain::byf_amp);
-   param_ptr[36] = &(function_factory::linelast_cwtrain::byf_freq);
-   param_ptr[37] = &(function_factory::linelast_cwtrain::byf_offset);
-   param_ptr[38] = &(function_factory::linelast_cwtrain::bx);
-   param_ptr[39] = &(function_factory::linelast_cwtrain::by);
-
-   general_vector_ptr.SetSize(1);
-   general_vector_ptr[0] = &(function_factory::linelast_cwtrain::body_force); 
+   param_ptr[0] = &(params.l_ux);
+   param_ptr[1] = &(params.l_uy);
+   param_ptr[2] = &(params.r_fx);
+   param_ptr[3] = &(params.r_fy);
+   param_ptr[4] = &(params.u_fx);
+   param_ptr[5] = &(params.u_fy);
+   param_ptr[6] = &(params.d_fx);
+   param_ptr[7] = &(params.d_fy);
+   param_ptr[8] = &(params.lx);
+   param_ptr[9] = &(params.ly);
+   param_ptr[10] = &(params.rx);
+   param_ptr[11] = &(params.ry);
+   param_ptr[12] = &(params.dx);
+   param_ptr[13] = &(params.dy);
+   param_ptr[14] = &(params.ux);
+   param_ptr[15] = &(params.uy);
+   param_ptr[16] = &(material.lambda);
+   param_ptr[17] = &(material.mu);
+   param_ptr[18] = &(params.xu_amp);
+   param_ptr[19] = &(params.xu_freq);
+   param_ptr[20] = &(params.xu_offset);
+   param_ptr[21] = &(params.xf_amp);
+   param_ptr[22] = &(params.xf_freq);
+   param_ptr[23] = &(params.xf_offset);
+   param_ptr[24] = &(params.yu_amp);
+   param_ptr[25] = &(params.yu_freq);
+   param_ptr[26] = &(params.yu_offset);
+   param_ptr[27] = &(params.yf_amp);
+   param_ptr[28] = &(params.yf_freq);
+   param_ptr[29] = &(params.yf_offset);
+
+   param_ptr[30] = &(params.b_fx);
+   param_ptr[31] = &(params.b_fy);
+   param_ptr[32] = &(params.bxf_amp);
+   param_ptr[33] = &(params.bxf_freq);
+   param_ptr[34] = &(params.bxf_offset);
+   param_ptr[35] = &(params.byf_amp);
+   param_ptr[36] = &(params.byf_freq);
+   param_ptr[37] = &(params.byf_offset);
+   param_ptr[38] = &(params.bx);
+   param_ptr[39] = &(params.by);
+
+   general_vector_ptr.resize(1);
+   general_vector_ptr[0] = [this](const Vector &x, double t, Vector &u)
+                           { function_factory::linelast_cwtrain::body_force(params, x, t, u); };
 }
\ No newline at end of file
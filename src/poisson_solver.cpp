@@ -165,6 +165,8 @@ void PoissonSolver::BuildRHSOperators()
 {
    SanityCheckOnCoeffs();
 
+   // clean up the previous rhs operators, if rebuilt for a new parameter.
+   DeletePointers(bs);
    bs.SetSize(numSub);
 
    // These are heavily system-dependent.
@@ -265,7 +267,8 @@ void PoissonSolver::AssembleRHS()
 
    MFEM_ASSERT(bs.Size() == numSub, "LinearForm bs != numSub.\n");
 
-   for (int m = 0; m < numSub; m++)
+   // with distributed_solve, the rows of the other subdomains are not used.
+   for (int m = sub_begin; m < sub_end; m++)
    {
       MFEM_ASSERT(bs[m], "LinearForm or BilinearForm pointer of a subdomain is not associated!\n");
       bs[m]->Assemble();
@@ -282,28 +285,58 @@ void PoissonSolver::AssembleOperator()
 
    MFEM_ASSERT(as.Size() == numSub, "BilinearForm bs != numSub.\n");
 
-   for (int m = 0; m < numSub; m++)
-   {
-      MFEM_ASSERT(as[m], "LinearForm or BilinearForm pointer of a subdomain is not associated!\n");
-      as[m]->Assemble();
-   }
+   // only the subdomains owned by this rank, with distributed_solve.
+   AssembleSubdomainForms(as, sub_begin, sub_end);
 
    mats.SetSize(numSub, numSub);
-   for (int i = 0; i < numSub; i++)
+   mats = NULL;
+   if (distributed_solve)
    {
-      for (int j = 0; j < numSub; j++)
+      /*
+         Only the row blocks of the owned subdomains are allocated.
+         Off-diagonal blocks are needed only for the subdomains sharing a port.
+      */
+      for (int i = sub_begin; i < sub_end; i++)
+         mats(i, i) = &(as[i]->SpMat());
+      for (int p = 0; p < topol_handler->GetNumPorts(); p++)
       {
-         if (i == j) {
-            mats(i, i) = &(as[i]->SpMat());
-         } else {
-            mats(i, j) = new SparseMatrix(fes[i]->GetTrueVSize(), fes[j]->GetTrueVSize());
+         const PortInfo *pInfo = topol_handler->GetPortInfo(p);
+         const int m1 = pInfo->Mesh1, m2 = pInfo->Mesh2;
+         if ((m1 >= sub_begin) && (m1 < sub_end) && (!mats(m1, m2)))
+            mats(m1, m2) = new SparseMatrix(fes[m1]->GetTrueVSize(), fes[m2]->GetTrueVSize());
+         if ((m2 >= sub_begin) && (m2 < sub_end) && (!mats(m2, m1)))
+            mats(m2, m1) = new SparseMatrix(fes[m2]->GetTrueVSize(), fes[m1]->GetTrueVSize());
+      }
+   }
+   else
+   {
+      for (int i = 0; i < numSub; i++)
+      {
+         for (int j = 0; j < numSub; j++)
+         {
+            if (i == j) {
+               mats(i, i) = &(as[i]->SpMat());
+            } else {
+               mats(i, j) = new SparseMatrix(fes[i]->GetTrueVSize(), fes[j]->GetTrueVSize());
+            }
          }
       }
    }
    AssembleInterfaceMatrices();
 
-   for (int m = 0; m < numSub; m++)
+   for (int m = sub_begin; m < sub_end; m++)
       as[m]->Finalize();
+   for (int i = 0; i < numSub; i++)
+      for (int j = 0; j < numSub; j++)
+         if ((i != j) && (mats(i, j))) mats(i, j)->Finalize();
+
+   if (distributed_solve)
+   {
+      // distributed over ranks by subdomains, assembled from the owned rows only.
+      globalMat_hypre = CreateSystemMatrix(mats, var_offsets, sys_glob_size, sys_row_starts);
+      if (direct_solve) SetMUMPSSolver();
+      return;
+   }
 
    // globalMat = new BlockOperator(block_offsets);
    // NOTE: currently, domain-decomposed system will have a significantly different sparsity pattern.
@@ -311,24 +344,13 @@ void PoissonSolver::AssembleOperator()
    // This is quite inevitable, but is it desirable?
    globalMat = new BlockMatrix(var_offsets);
    for (int i = 0; i < numSub; i++)
-   {
       for (int j = 0; j < numSub; j++)
-      {
-         if (i != j) mats(i, j)->Finalize();
-
          globalMat->SetBlock(i, j, mats(i, j));
-      }
-   }
 
    if (use_amg || direct_solve)
    {
       globalMat_mono = globalMat->CreateMonolithic();
-
-      // TODO: need to change when the actual parallelization is implemented.
-      sys_glob_size = globalMat_mono->NumRows();
-      sys_row_starts[0] = 0;
-      sys_row_starts[1] = globalMat_mono->NumRows();
-      globalMat_hypre = new HypreParMatrix(MPI_COMM_SELF, sys_glob_size, sys_row_starts, globalMat_mono);
+      globalMat_hypre = CreateSystemMatrix(globalMat_mono, sys_glob_size, sys_row_starts);
 
       if (direct_solve) SetMUMPSSolver();
    }
@@ -432,17 +454,26 @@ bool PoissonSolver::Solve(SampleGenerator *sample_generator)
    // If using direct solver, returns always true.
    bool converged = true;
 
-   int maxIter = config.GetOption<int>("solver/max_iter", 10000);
-   double rtol = config.GetOption<double>("solver/relative_tolerance", 1.e-15);
-   double atol = config.GetOption<double>("solver/absolute_tolerance", 1.e-15);
-   int print_level = config.GetOption<int>("solver/print_level", 0);
+   solver_opts.Update(config);
+   int maxIter = solver_opts.max_iter;
+   double rtol = solver_opts.rtol;
+   double atol = solver_opts.atol;
+   int print_level = solver_opts.print_level;
+
+   // rows owned by this rank. without distributed solve, these are the entire vectors.
+   Vector RHS_loc, U_loc;
+   if (use_amg || direct_solve)
+   {
+      const int nrow_loc = sys_row_starts[1] - sys_row_starts[0];
+      RHS_loc.MakeRef(*RHS, sys_row_starts[0], nrow_loc);
+      U_loc.MakeRef(*U, sys_row_starts[0], nrow_loc);
+   }
 
-   // TODO: need to change when the actual parallelization is implemented.
    if (direct_solve)
    {
       assert(mumps);
       mumps->SetPrintLevel(print_level);
-      mumps->Mult(*RHS, *U);
+      mumps->Mult(RHS_loc, U_loc);
    }
    else
    {
@@ -453,10 +484,9 @@ bool PoissonSolver::Solve(SampleGenerator *sample_generator)
       // HypreBoomerAMG makes a meaningful difference in computation time.
       if (use_amg)
       {
-         // Initializating HypreParMatrix needs the monolithic sparse matrix.
-         assert(globalMat_mono != NULL);
+         assert(globalMat_hypre != NULL);
 
-         solver = new CGSolver(MPI_COMM_SELF);
+         solver = new CGSolver(globalMat_hypre->GetComm());
 
          M = new HypreBoomerAMG(*globalMat_hypre);
          M->SetPrintLevel(print_level);
@@ -468,7 +498,7 @@ bool PoissonSolver::Solve(SampleGenerator *sample_generator)
       {
          solver = new CGSolver();
          
-         if (config.GetOption<bool>("solver/block_diagonal_preconditioner", true))
+         if (solver_opts.block_diag_prec)
          {
             globalPrec = new BlockDiagonalPreconditioner(var_offsets);
             solver->SetPreconditioner(*globalPrec);
@@ -484,7 +514,10 @@ bool PoissonSolver::Solve(SampleGenerator *sample_generator)
       // The time for the setup above is much smaller than this Mult().
       // StopWatch test;
       // test.Start();
-      solver->Mult(*RHS, *U);
+      if (use_amg)
+         solver->Mult(RHS_loc, U_loc);
+      else
+         solver->Mult(*RHS, *U);
       // test.Stop();
       // printf("test: %f seconds.\n", test.RealTime());
       converged = solver->GetConverged();
@@ -501,6 +534,8 @@ bool PoissonSolver::Solve(SampleGenerator *sample_generator)
       delete solver;
    }
 
+   GatherDistributedVector(sys_row_starts, *U);
+
    /* save solution if sample generator is provided */
    if (converged && sample_generator)
       SaveSnapshots(sample_generator);
@@ -559,6 +594,7 @@ void PoissonSolver::SetParameterizedProblem(ParameterizedProblem *problem)
       rhs_coeffs.SetSize(0);
    }
    // clean up boundary functions for parametrized problem.
+   DeletePointers(bdr_coeffs);
    bdr_coeffs = NULL;
 
    for (int b = 0; b < problem->battr.Size(); b++)
@@ -568,7 +604,7 @@ void PoissonSolver::SetParameterizedProblem(ParameterizedProblem *problem)
          case BoundaryType::DIRICHLET:
          { 
             assert(problem->scalar_bdr_ptr[b]);
-            AddBCFunction(*(problem->scalar_bdr_ptr[b]), problem->battr[b]);
+            AddBCFunction(problem->scalar_bdr_ptr[b], problem->battr[b]);
             break;
          }
          case BoundaryType::NEUMANN: break;
@@ -578,8 +614,8 @@ void PoissonSolver::SetParameterizedProblem(ParameterizedProblem *problem)
       }
    }
 
-   if (problem->scalar_rhs_ptr != NULL)
-      AddRHSFunction(*(problem->scalar_rhs_ptr));
+   if (problem->scalar_rhs_ptr)
+      AddRHSFunction(problem->scalar_rhs_ptr);
    else
       AddRHSFunction(0.0);
 }
@@ -587,7 +623,7 @@ void PoissonSolver::SetParameterizedProblem(ParameterizedProblem *problem)
 void PoissonSolver::SetMUMPSSolver()
 {
    assert(globalMat_hypre);
-   mumps = new MUMPSSolver(MPI_COMM_SELF);
+   mumps = new MUMPSSolver(globalMat_hypre->GetComm());
    mumps->SetMatrixSymType(MUMPSSolver::MatType::SYMMETRIC_POSITIVE_DEFINITE);
    mumps->SetOperator(*globalMat_hypre);
 }
\ No newline at end of file
@@ -56,10 +56,10 @@ const Array<int> RandomSampleGenerator::GetSampleIndex(const int &index)
    return nested_idx;
 }
 
-void RandomSampleGenerator::SetSampleParams(const int &index)
+void RandomSampleGenerator::SetSampleParams(const int &index, InputParser &parser)
 {
    assert(params.Size() == num_sampling_params);
    
    for (int p = 0; p < num_sampling_params; p++)
-      params[p]->SetRandomParam(config);
+      params[p]->SetRandomParam(parser);
 }
\ No newline at end of file
@@ -334,6 +334,7 @@ MFEMROMHandler::MFEMROMHandler(
 
    std::string solver_type_str = config.GetOption<std::string>("model_reduction/linear_solver_type", "cg");
    if (solver_type_str == "direct")       linsol_type = MFEMROMHandler::SolverType::DIRECT;
+   else if (solver_type_str == "block_direct")  linsol_type = MFEMROMHandler::SolverType::BLOCK_DIRECT;
    else if (solver_type_str == "cg")      linsol_type = MFEMROMHandler::SolverType::CG;
    else if (solver_type_str == "minres")      linsol_type = MFEMROMHandler::SolverType::MINRES;
    else
@@ -355,6 +356,16 @@ MFEMROMHandler::MFEMROMHandler(
       if (mat_type == MUMPSSolver::MatType::SYMMETRIC_INDEFINITE)
          mfem_warning("MUMPS matrix type SYMMETRIC_INDEFINITE can be unstable, returning inaccurate answer.\n");
    }
+
+   solver_opts.Update(config);
+}
+
+void ROMSolverOptions::Compile(InputParser &parser)
+{
+   IterativeSolverOptions::Compile(parser);
+   prec_str = parser.GetOption<std::string>("model_reduction/preconditioner", "none");
+   nlin_solver = parser.GetOption<std::string>("model_reduction/nonlinear_solver_type", "newton");
+   dense_lu_max = parser.GetOption<int>("model_reduction/dense_lu_max_size", 200);
 }
 
 MFEMROMHandler::~MFEMROMHandler()
@@ -364,6 +375,7 @@ MFEMROMHandler::~MFEMROMHandler()
    delete romMat_mono;
    delete romMat_hypre;
    delete mumps;
+   delete block_lu;
 }
 
 void MFEMROMHandler::LoadReducedBasis()
@@ -532,11 +544,11 @@ void MFEMROMHandler::Solve(BlockVector &rhs, BlockVector &sol)
 {
    assert(operator_loaded);
 
-   int maxIter = config.GetOption<int>("solver/max_iter", 10000);
-   double rtol = config.GetOption<double>("solver/relative_tolerance", 1.e-15);
-   double atol = config.GetOption<double>("solver/absolute_tolerance", 1.e-15);
-   int print_level = config.GetOption<int>("solver/print_level", 0);   
-   std::string prec_str = config.GetOption<std::string>("model_reduction/preconditioner", "none");
+   solver_opts.Update(config);
+   int maxIter = solver_opts.max_iter;
+   double rtol = solver_opts.rtol;
+   double atol = solver_opts.atol;
+   int print_level = solver_opts.print_level;
 
    if (linsol_type == SolverType::DIRECT)
    {
@@ -544,16 +556,21 @@ void MFEMROMHandler::Solve(BlockVector &rhs, BlockVector &sol)
       mumps->SetPrintLevel(print_level);
       mumps->Mult(rhs, sol);
    }
+   else if (linsol_type == SolverType::BLOCK_DIRECT)
+   {
+      assert(block_lu);
+      block_lu->Mult(rhs, sol);
+   }
    else
    {
-      IterativeSolver *solver = SetIterativeSolver(linsol_type, prec_str);
+      IterativeSolver *solver = SetIterativeSolver(linsol_type, solver_opts.prec_str);
       HypreParMatrix *parRomMat = NULL;
       Solver *M = NULL;    // preconditioner.
       Operator *K = NULL;  // operator.
       HypreBoomerAMG *amgM = NULL;
       // GSSmoother *gsM = NULL;
 
-      if (prec_str == "amg")
+      if (solver_opts.prec_str == "amg")
       {
          // TODO: need to change when the actual parallelization is implemented.
          HYPRE_BigInt glob_size = rom_block_offsets.Last();
@@ -561,35 +578,35 @@ void MFEMROMHandler::Solve(BlockVector &rhs, BlockVector &sol)
          parRomMat = new HypreParMatrix(MPI_COMM_SELF, glob_size, row_starts, romMat_mono);
          K = parRomMat;
       }
-      else if ((prec_str == "gs") || (prec_str == "none"))
+      else if ((solver_opts.prec_str == "gs") || (solver_opts.prec_str == "none"))
          K = romMat_mono;
       else
          K = romMat;
 
-      if (prec_str == "amg")
+      if (solver_opts.prec_str == "amg")
       {
          amgM = new HypreBoomerAMG(*parRomMat);
          amgM->SetPrintLevel(print_level);
          M = amgM;
       }
-      else if (prec_str == "gs")
+      else if (solver_opts.prec_str == "gs")
       {
          M = new GSSmoother(*romMat_mono);
       }
-      else if (prec_str == "block_gs")
+      else if (solver_opts.prec_str == "block_gs")
       {
          M = new BlockGSSmoother(*romMat);
       }
-      else if (prec_str == "block_jacobi")
+      else if (solver_opts.prec_str == "block_jacobi")
       {
          M = new BlockDSmoother(*romMat);
       }
-      else if (prec_str != "none")
+      else if (solver_opts.prec_str != "none")
       {
          mfem_error("Unknown preconditioner for ROM!\n");
       }
 
-      if (prec_str != "none")
+      if (solver_opts.prec_str != "none")
          solver->SetPreconditioner(*M);
       solver->SetOperator(*K);
       
@@ -605,7 +622,7 @@ void MFEMROMHandler::Solve(BlockVector &rhs, BlockVector &sol)
       // printf("ROM-solve-only time: %f seconds.\n", solveTimer.RealTime());
 
       // delete the created objects.
-      if (prec_str == "amg")
+      if (solver_opts.prec_str == "amg")
          delete parRomMat;
       delete M;
       delete solver;
@@ -618,6 +635,7 @@ void MFEMROMHandler::Solve(BlockVector* U)
    assert(reduced_rhs);
 
    printf("Solve ROM.\n");
+   delete reduced_sol;
    reduced_sol = new BlockVector(rom_block_offsets);
    (*reduced_sol) = 0.0;
 
@@ -627,14 +645,135 @@ void MFEMROMHandler::Solve(BlockVector* U)
    LiftUpGlobal(*reduced_sol, *U);
 }
 
+void MFEMROMHandler::GetGlobalFOMOffsets(Array<int> &fom_offsets)
+{
+   assert(basis_loaded);
+   fom_offsets.SetSize(num_rom_blocks + 1);
+   fom_offsets = 0;
+
+   int m, v, fom_idx;
+   DenseMatrix *basis_i;
+   for (int i = 0; i < num_rom_blocks; i++)
+   {
+      GetDomainAndVariableIndex(i, m, v);
+      fom_idx = (separate_variable)? v + m * num_var : m;
+
+      GetDomainBasis(i, basis_i);
+      fom_offsets[fom_idx + 1] = basis_i->NumRows();
+   }
+   fom_offsets.PartialSum();
+}
+
+void MFEMROMHandler::ProjectGlobalToDomainBasis(const DenseMatrix &vecs, DenseMatrix &rom_vecs)
+{
+   Array<int> fom_offsets;
+   GetGlobalFOMOffsets(fom_offsets);
+   assert(vecs.NumRows() == fom_offsets.Last());
+
+   const int ncol = vecs.NumCols();
+   rom_vecs.SetSize(rom_block_offsets.Last(), ncol);
+
+   int m, v, fom_idx;
+   DenseMatrix *basis_i;
+   DenseMatrix vec_i, rom_vec_i;
+   for (int i = 0; i < num_rom_blocks; i++)
+   {
+      GetDomainAndVariableIndex(i, m, v);
+      fom_idx = (separate_variable)? v + m * num_var : m;
+
+      GetDomainBasis(i, basis_i);
+      vecs.GetSubMatrix(fom_offsets[fom_idx], fom_offsets[fom_idx + 1], 0, ncol, vec_i);
+      rom_vec_i.SetSize(basis_i->NumCols(), ncol);
+      MultAtB(*basis_i, vec_i, rom_vec_i);
+      rom_vecs.SetSubMatrix(rom_block_offsets[i], 0, rom_vec_i);
+   }
+}
+
+void MFEMROMHandler::LiftUpGlobal(const DenseMatrix &rom_vecs, DenseMatrix &vecs)
+{
+   assert(rom_vecs.NumRows() == rom_block_offsets.Last());
+   Array<int> fom_offsets;
+   GetGlobalFOMOffsets(fom_offsets);
+
+   const int ncol = rom_vecs.NumCols();
+   vecs.SetSize(fom_offsets.Last(), ncol);
+
+   int m, v, fom_idx;
+   DenseMatrix *basis_i;
+   DenseMatrix vec_i, rom_vec_i;
+   for (int i = 0; i < num_rom_blocks; i++)
+   {
+      GetDomainAndVariableIndex(i, m, v);
+      fom_idx = (separate_variable)? v + m * num_var : m;
+
+      GetDomainBasis(i, basis_i);
+      rom_vecs.GetSubMatrix(rom_block_offsets[i], rom_block_offsets[i + 1], 0, ncol, rom_vec_i);
+      vec_i.SetSize(basis_i->NumRows(), ncol);
+      mfem::Mult(*basis_i, rom_vec_i, vec_i);
+      vecs.SetSubMatrix(fom_offsets[fom_idx], 0, vec_i);
+   }
+}
+
+void MFEMROMHandler::Solve(const DenseMatrix &rhs, DenseMatrix &sol)
+{
+   assert(operator_loaded);
+   assert(rhs.NumRows() == rom_block_offsets.Last());
+
+   const int nrow = rhs.NumRows(), ncol = rhs.NumCols();
+   sol.SetSize(nrow, ncol);
+   sol = 0.0;
+
+   if (linsol_type == SolverType::BLOCK_DIRECT)
+   {
+      assert(block_lu);
+      block_lu->Mult(rhs, sol);
+      return;
+   }
+
+   /* column views of rhs/sol */
+   Array<Vector *> X(ncol), Y(ncol);
+   for (int k = 0; k < ncol; k++)
+   {
+      X[k] = new Vector(const_cast<double *>(rhs.GetColumn(k)), nrow);
+      Y[k] = new Vector(sol.GetColumn(k), nrow);
+   }
+
+   if (linsol_type == SolverType::DIRECT)
+   {
+      assert(mumps);
+      solver_opts.Update(config);
+      mumps->SetPrintLevel(solver_opts.print_level);
+
+      // one MUMPS solve phase with the existing factorization for all columns.
+      Array<const Vector *> Xc(ncol);
+      for (int k = 0; k < ncol; k++) Xc[k] = X[k];
+      mumps->ArrayMult(Xc, Y);
+   }
+   else
+   {
+      // iterative solvers have no factorization to share.
+      for (int k = 0; k < ncol; k++)
+      {
+         BlockVector rhs_k(X[k]->GetData(), rom_block_offsets);
+         BlockVector sol_k(Y[k]->GetData(), rom_block_offsets);
+         Solve(rhs_k, sol_k);
+      }
+   }
+
+   DeletePointers(X);
+   DeletePointers(Y);
+}
+
 void MFEMROMHandler::NonlinearSolve(Operator &oper, BlockVector* U, Solver *prec)
 {
    assert(U->NumBlocks() == num_rom_blocks);
 
    printf("Solve ROM.\n");
+   delete reduced_sol;
    reduced_sol = new BlockVector(rom_block_offsets);
-   bool use_restart = config.GetOption<bool>("solver/use_restart", false);
-   if (use_restart)
+   solver_opts.Update(config);
+   nlin_opts.Update(config);
+   if (nlin_opts.use_restart)
       ProjectGlobalToDomainBasis(U, reduced_sol);
    else
    {
@@ -642,29 +781,47 @@ void MFEMROMHandler::NonlinearSolve(Operator &oper, BlockVector* U, Solver *prec
          (*reduced_sol)(k) = 1.0e-1 * UniformRandom();
    }
 
-   int maxIter = config.GetOption<int>("solver/max_iter", 100);
-   double rtol = config.GetOption<double>("solver/relative_tolerance", 1.e-10);
-   double atol = config.GetOption<double>("solver/absolute_tolerance", 1.e-10);
-   int print_level = config.GetOption<int>("solver/print_level", 0);   
+   int maxIter = nlin_opts.newton.max_iter;
+   double rtol = nlin_opts.newton.rtol;
+   double atol = nlin_opts.newton.atol;
+   int print_level = nlin_opts.newton.print_level;
 
-   int jac_maxIter = config.GetOption<int>("solver/jacobian/max_iter", 10000);
-   double jac_rtol = config.GetOption<double>("solver/jacobian/relative_tolerance", 1.e-10);
-   double jac_atol = config.GetOption<double>("solver/jacobian/absolute_tolerance", 1.e-10);
-   int jac_print_level = config.GetOption<int>("solver/jacobian/print_level", -1);
-   std::string prec_str = config.GetOption<std::string>("model_reduction/preconditioner", "none");
-   if (prec_str != "none") assert(prec);
+   int jac_maxIter = nlin_opts.jacobian.max_iter;
+   double jac_rtol = nlin_opts.jacobian.rtol;
+   double jac_atol = nlin_opts.jacobian.atol;
+   int jac_print_level = nlin_opts.jacobian.print_level;
+   if (solver_opts.prec_str != "none") assert(prec);
 
    Solver *J_solver = NULL;
+   DenseLUSolver *dense_lu = NULL;
+   BlockDenseLUSolver *jac_block_lu = NULL;
    if (linsol_type == SolverType::DIRECT)
    {
-      mumps = new MUMPSSolver(MPI_COMM_SELF);
-      mumps->SetMatrixSymType(mat_type);
-      mumps->SetPrintLevel(jac_print_level);
-      J_solver = mumps;
+      /* small reduced jacobians are factorized faster as dense matrices. */
+      if (oper.Height() <= solver_opts.dense_lu_max)
+      {
+         dense_lu = new DenseLUSolver;
+         J_solver = dense_lu;
+      }
+      else
+      {
+         mumps = new MUMPSSolver(MPI_COMM_SELF);
+         mumps->SetMatrixSymType(mat_type);
+         mumps->SetPrintLevel(jac_print_level);
+         // the jacobian sparsity pattern is fixed over Newton iterations.
+         mumps->SetReorderingReuse(true);
+         J_solver = mumps;
+      }
+   }
+   else if (linsol_type == SolverType::BLOCK_DIRECT)
+   {
+      // the jacobian is partitioned with the same ROM block offsets.
+      jac_block_lu = new BlockDenseLUSolver(rom_block_offsets);
+      J_solver = jac_block_lu;
    }
    else
    {
-      IterativeSolver *iter_solver = SetIterativeSolver(linsol_type, prec_str);
+      IterativeSolver *iter_solver = SetIterativeSolver(linsol_type, solver_opts.prec_str);
       iter_solver->SetAbsTol(jac_atol);
       iter_solver->SetRelTol(jac_rtol);
       iter_solver->SetMaxIter(jac_maxIter);
@@ -673,9 +830,7 @@ void MFEMROMHandler::NonlinearSolve(Operator &oper, BlockVector* U, Solver *prec
       J_solver = iter_solver;
    }
 
-   std::string nlin_solver = config.GetOption<std::string>("model_reduction/nonlinear_solver_type", "newton");
-
-   if (nlin_solver == "newton")
+   if (solver_opts.nlin_solver == "newton")
    {
       NewtonSolver newton_solver;
       newton_solver.SetSolver(*J_solver);
@@ -687,7 +842,7 @@ void MFEMROMHandler::NonlinearSolve(Operator &oper, BlockVector* U, Solver *prec
 
       newton_solver.Mult(*reduced_rhs, *reduced_sol);
    }
-   else if (nlin_solver == "cg")
+   else if (solver_opts.nlin_solver == "cg")
    {
       CGOptimizer optim;
       optim.SetOperator(oper);
@@ -702,6 +857,9 @@ void MFEMROMHandler::NonlinearSolve(Operator &oper, BlockVector* U, Solver *prec
       mfem_error("MFEMROMHandler::NonlinearSolve- Unknown ROM nonlinear solver type!\n");
 
    LiftUpGlobal(*reduced_sol, *U);
+
+   delete dense_lu;
+   delete jac_block_lu;
 }
 
 SparseMatrix* MFEMROMHandler::ProjectToRefBasis(const int &i, const int &j, const Operator *mat)
@@ -922,7 +1080,7 @@ void MFEMROMHandler::SetRomMat(BlockMatrix *input_mat, const bool init_direct_so
    delete romMat_mono;
    romMat_mono = romMat->CreateMonolithic();
 
-   if ((linsol_type == SolverType::DIRECT) && (init_direct_solver))
+   if (((linsol_type == SolverType::DIRECT) || (linsol_type == SolverType::BLOCK_DIRECT)) && (init_direct_solver))
       SetupDirectSolver();
    operator_loaded = true;
 }
@@ -1041,11 +1199,19 @@ IterativeSolver* MFEMROMHandler::SetIterativeSolver(const MFEMROMHandler::Solver
 void MFEMROMHandler::SetupDirectSolver()
 {
    // If nonlinear mode, Jacobian will keep changing within Solve, thus no need of initial LU factorization.
+   if (linsol_type == MFEMROMHandler::SolverType::BLOCK_DIRECT)
+   {
+      assert(romMat);
+      delete block_lu;
+      block_lu = new BlockDenseLUSolver(*romMat);
+      return;
+   }
    if ((linsol_type != MFEMROMHandler::SolverType::DIRECT))
       return;
 
    assert(romMat_mono);
-   delete romMat_hypre, mumps;
+   delete romMat_hypre;
+   delete mumps;
 
    // TODO: need to change when the actual parallelization is implemented.
    sys_glob_size = romMat_mono->NumRows();
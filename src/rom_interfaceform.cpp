@@ -4,6 +4,7 @@
 
 #include "rom_interfaceform.hpp"
 #include "etc.hpp"
+#include "linalg_utils.hpp"
 #include "utils/mpi_utils.h"  // this is from libROM/utils.
 
 using namespace std;
@@ -139,8 +140,7 @@ void ROMInterfaceForm::InterfaceAddMult(const Vector &x, Vector &y) const
             EQPSample *sample = eqp_elem->GetSample(i);
 
             int itf = sample->info.el;
-            InterfaceInfo *if_info = &((*interface_infos)[itf]);
-            topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
+            topol_handler->GetPortInterfaceTransformations(mesh1, mesh2, p, itf, tr1, tr2);
             const IntegrationPoint &ip = ir->IntPoint(sample->info.qp);
 
             if (precompute)
@@ -264,8 +264,7 @@ void ROMInterfaceForm::InterfaceGetGradient(const Vector &x, Array2D<SparseMatri
             EQPSample *sample = eqp_elem->GetSample(i);
 
             int itf = sample->info.el;
-            InterfaceInfo *if_info = &((*interface_infos)[itf]);
-            topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
+            topol_handler->GetPortInterfaceTransformations(mesh1, mesh2, p, itf, tr1, tr2);
             const IntegrationPoint &ip = ir->IntPoint(sample->info.qp);
 
             if (precompute)
@@ -332,11 +331,11 @@ void ROMInterfaceForm::TrainEQPForRefPort(const int p,
       TODO(kevin): this is a boilerplate for parallel POD/EQP training.
       Full parallelization will have to consider local matrix construction from local snapshot/basis matrix.
    */
-   assert(snapshot1.distributed());
-   assert(snapshot2.distributed());
    CAROM::Matrix snapshot1_work(snapshot1), snapshot2_work(snapshot2);
-   snapshot1_work.gather();
-   snapshot2_work.gather();
+   if (snapshot1_work.distributed())
+      snapshot1_work.gather();
+   if (snapshot2_work.distributed())
+      snapshot2_work.gather();
    assert(snapshot1_work.numRows() >= fes1->GetTrueVSize());
    assert(snapshot2_work.numRows() >= fes2->GetTrueVSize());
 
@@ -348,7 +347,7 @@ void ROMInterfaceForm::TrainEQPForRefPort(const int p,
 
    // NOTE(kevin): these will be resized within the routines as needed.
    // just initializing with distribute option.
-   CAROM::Matrix Gt(1,1, true);
+   CAROM::Matrix Gt(1,1, distributed_eqp);
    CAROM::Vector rhs_Gw(1, false);
 
    Array<SampleInfo> samples;
@@ -368,6 +367,38 @@ void ROMInterfaceForm::TrainEQPForRefPort(const int p,
    }
 }
 
+const int ROMInterfaceForm::GetEQPSystemSizeForRefPort(const int p)
+{
+   const int nitf = topol_handler->GetRefInterfaceInfos(p)->Size();
+
+   int size = 0;
+   for (int it = 0; it < fnfi.Size(); it++)
+      size += nitf * fnfi[it]->GetIntegrationRule()->GetNPoints();
+
+   return size;
+}
+
+void ROMInterfaceForm::BroadcastEQPForRefPort(const int p, const int root)
+{
+   assert((p >= 0) && (p < numRefPorts));
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   Array<SampleInfo> samples;
+   for (int it = 0; it < fnfi.Size(); it++)
+   {
+      if (rank == root)
+      {
+         EQPElement *eqp_elem = fnfi_ref_sample[p + it * numRefPorts];
+         assert(eqp_elem);
+         eqp_elem->GetSampleInfos(samples);
+      }
+      BroadcastSampleInfos(samples, root);
+      if (rank != root)
+         UpdateInterFaceIntegratorSampling(it, p, samples);
+   }
+}
+
 void ROMInterfaceForm::SetupEQPSystem(
    const CAROM::Matrix &snapshot1, const CAROM::Matrix &snapshot2,
    const Array2D<int> &snap_pair_idx,
@@ -384,8 +415,6 @@ void ROMInterfaceForm::SetupEQPSystem(
       Also, while snapshot/basis are distributed according to vdofs,
       EQP system will be distributed according to elements.
    */
-   int rank;
-   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
    assert(!snapshot1.distributed());
    assert(!snapshot2.distributed());
@@ -424,10 +453,10 @@ void ROMInterfaceForm::SetupEQPSystem(
    // assert((snap2_idx.Min() >= 0) && (snap2_idx.Max() < nsnap2));
 
    const int ne_global = itf_infos->Size();
-   const int ne = CAROM::split_dimension(ne_global, MPI_COMM_WORLD);
-   std::vector<int> elem_offsets;
-   int dummy = CAROM::get_global_offsets(ne, elem_offsets, MPI_COMM_WORLD);
-   assert(dummy == ne_global);
+   // the EQP system is distributed over elements only if Gt is distributed.
+   int e_begin, e_end;
+   GetEQPElementRange(ne_global, Gt.distributed(), e_begin, e_end);
+   const int ne = e_end - e_begin;
 
    const int NQ = ne * nqe;
 
@@ -440,90 +469,68 @@ void ROMInterfaceForm::SetupEQPSystem(
          where the "exact" quadrature solution is ir0->GetWeights().
    */
    Gt.setSize(NQ, NB * nsnap);
-   assert(Gt.distributed());
    
-   Vector v1_i(fes1->GetTrueVSize()), v2_i(fes2->GetTrueVSize());
-   Vector r(nqe);
+   /* snapshot columns of each side, in the order of the snapshot pairs. */
+   Array<int> snap1_idx(nsnap), snap2_idx(nsnap);
+   for (int i = 0; i < nsnap; ++i)
+   {
+      snap1_idx[i] = snap_pair_idx(i, 0);
+      snap2_idx[i] = snap_pair_idx(i, 1);
+   }
 
    Array<int> vdofs1, vdofs2;
-   Vector el_x1, el_x2, el_tr1, el_tr2;
-   DenseMatrix el_quad1, el_quad2;
+   DenseMatrix el_x1, el_x2, el_tr1, el_tr2, el_quad1, el_quad2, r1, r2;
 
    FaceElementTransformations *tr1, *tr2;
    const FiniteElement *fe1, *fe2;
 
-   /* fill out quadrature evaluation of all snapshot-basis weak forms */
-   for (int i = 0; i < nsnap; ++i)
+   /*
+      Interfaces are visited once in the outer loop, evaluating all snapshot pairs at once.
+      Interface transformations are shared objects, thus this loop is not threaded.
+   */
+   for (int e = e_begin, eidx = 0; e < e_end; e++, eidx++)
    {
-      // NOTE(kevin): have to copy the vector since libROM matrix is row-major.
-      for (int k = 0; k < fes1->GetTrueVSize(); ++k)
-         v1_i[k] = snapshot1(k, snap_pair_idx(i, 0));
-      for (int k = 0; k < fes2->GetTrueVSize(); ++k)
-         v2_i[k] = snapshot2(k, snap_pair_idx(i, 1));
-
-      for (int e = elem_offsets[rank], eidx = 0; e < elem_offsets[rank+1]; e++, eidx++)
-      {
-         InterfaceInfo *if_info = &((*itf_infos)[e]);
-         topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
-         assert((tr1 != NULL) && (tr2 != NULL));
+      InterfaceInfo *if_info = &((*itf_infos)[e]);
+      topol_handler->GetInterfaceTransformations(mesh1, mesh2, if_info, tr1, tr2);
+      assert((tr1 != NULL) && (tr2 != NULL));
 
-         fes1->GetElementVDofs(tr1->Elem1No, vdofs1);
-         fes2->GetElementVDofs(tr2->Elem1No, vdofs2);
+      fes1->GetElementVDofs(tr1->Elem1No, vdofs1);
+      fes2->GetElementVDofs(tr2->Elem1No, vdofs2);
 
-         v1_i.GetSubVector(vdofs1, el_x1);
-         v2_i.GetSubVector(vdofs2, el_x2);
+      fe1 = fes1->GetFE(tr1->Elem1No);
+      fe2 = fes2->GetFE(tr2->Elem1No);
 
-         fe1 = fes1->GetFE(tr1->Elem1No);
-         fe2 = fes2->GetFE(tr2->Elem1No);
+      /* interface restriction of all snapshots and basis vectors, once per interface. */
+      GetSnapshotElementBlock(snapshot1, vdofs1, el_x1, &snap1_idx);
+      GetSnapshotElementBlock(snapshot2, vdofs2, el_x2, &snap2_idx);
+      GetBasisElementBlock(basis1, vdofs1, el_tr1, basis1_offset);
+      GetBasisElementBlock(basis2, vdofs2, el_tr2, basis2_offset);
 
-         const int nd1 = fe1->GetDof();
-         const int nd2 = fe2->GetDof();
-         el_quad1.SetSize(nd1 * vdim1, nqe);
-         el_quad2.SetSize(nd2 * vdim2, nqe);
-
-         for (int p = 0; p < ir->GetNPoints(); p++)
+      for (int m = 0; m < nqe; ++m)
+      {
+         nlfi->AssembleQuadratureVectors(
+            *fe1, *fe2, *tr1, *tr2, ir->IntPoint(m), 1.0, el_x1, el_x2, el_quad1, el_quad2);
+
+         /*
+            two bases are independent, thus stored independently.
+            r1(j, i) = G(j + (i*NB), (eidx*nqe) + m),
+            r2(j, i) = G(j + NB1 + (i*NB), (eidx*nqe) + m).
+         */
+         MultAtB(el_tr1, el_quad1, r1);
+         MultAtB(el_tr2, el_quad2, r2);
+
+         double *Gt_row = Gt.getData() + static_cast<size_t>(m + (eidx * nqe)) * Gt.numColumns();
+         for (int i = 0; i < nsnap; ++i)
          {
-            Vector EQ1(el_quad1.GetColumn(p), nd1 * vdim1);
-            Vector EQ2(el_quad2.GetColumn(p), nd2 * vdim2);
-
-            const IntegrationPoint &ip = ir->IntPoint(p);
-            nlfi->AssembleQuadratureVector(
-               *fe1, *fe2, *tr1, *tr2, ip, 1.0, el_x1, el_x2, EQ1, EQ2);
+            std::copy(r1.GetColumn(i), r1.GetColumn(i) + NB1, Gt_row + i * NB);
+            std::copy(r2.GetColumn(i), r2.GetColumn(i) + NB2, Gt_row + NB1 + i * NB);
          }
-
-         /* two bases are independent, thus stored independently. */
-         for (int j = 0; j < NB1; ++j)
-         {
-            Vector v1_j(basis1.GetColumn(j) + basis1_offset, fes1->GetVSize());
-            v1_j.GetSubVector(vdofs1, el_tr1);
-
-            el_quad1.MultTranspose(el_tr1, r);
-
-            for (int m = 0; m < nqe; ++m)
-               Gt(m + (eidx * nqe), j + (i * NB)) = r[m];
-         }  // for (int j = 0; j < NB1; ++j)
-         for (int j = 0; j < NB2; ++j)
-         {
-            Vector v2_j(basis2.GetColumn(j) + basis2_offset, fes2->GetVSize());
-            v2_j.GetSubVector(vdofs2, el_tr2);
-
-            el_quad2.MultTranspose(el_tr2, r);
-
-            for (int m = 0; m < nqe; ++m)
-               Gt(m + (eidx * nqe), j + NB1 + (i * NB)) = r[m];
-         }  // for (int j = 0; j < NB2; ++j)
-      }  // for (int e = 0; e < ne; ++e)
-
-      // if (precondition)
-      // {
-         // // Preconditioning is done by (V^T M(p_i) V)^{-1} (of size NB x NB).
-         // PreconditionNNLS(fespace_R, new VectorFEMassIntegrator(a_coeff), BR, i, Gt);
-      // }
-   }  // for (int i = 0; i < nsnap; ++i)
+      }  // for (int m = 0; m < nqe; ++m)
+   }  // for (int e = e_begin; e < e_end; e++)
 
    /* Fill out FOM quadrature weights */
    Array<double> const& w_el = ir->GetWeights();
-   CAROM::Vector w(ne * nqe, true);
+   CAROM::Vector w(ne * nqe, Gt.distributed());
    for (int i = 0; i < ne; ++i)
       for (int j = 0; j < nqe; ++j)
          w(j + (i * nqe)) = w_el[j];
@@ -548,7 +555,7 @@ void ROMInterfaceForm::TrainEQPForIntegrator(
    // CAROM::Vector & sol)
    double nnls_tol = 1.0e-11;
    int maxNNLSnnz = 0;
-   CAROM::Vector eqpSol(Gt.numRows(), true);
+   CAROM::Vector eqpSol(Gt.numRows(), Gt.distributed());
    int nnz = 0;
    {
       CAROM::NNLSSolver nnls(nnls_tol, 0, maxNNLSnnz, 2, 1.0e-4, 1.0e-14,
@@ -576,7 +583,21 @@ void ROMInterfaceForm::TrainEQPForIntegrator(
          The optimization will continue until
             max_i || rhs_Gw(i) - eqp_Gw(i) || / || rhs_Gw(i) || < eqp_tol
       */
-      nnls.solve_parallel_with_scalapack(Gt, rhs_lb, rhs_ub, eqpSol);
+      if (Gt.distributed())
+         nnls.solve_parallel_with_scalapack(Gt, rhs_lb, rhs_ub, eqpSol);
+      else
+      {
+         /*
+            A local EQP system is solved without any communication,
+            so that independent systems can be trained on different processes.
+            Gt is row-major, thus its data is G in column-major.
+         */
+         DenseMatrix G(Gt.getData(), Gt.numColumns(), Gt.numRows());
+         Vector lb(rhs_lb.getData(), rhs_lb.dim()), ub(rhs_ub.getData(), rhs_ub.dim());
+         Vector sol(eqpSol.getData(), eqpSol.dim());
+         if (!SolveBoundedNNLS(G, lb, ub, sol, nnls_criterion))
+            mfem_warning("TrainEQPForIntegrator- local NNLS did not satisfy the tolerance!\n");
+      }
 
       nnz = 0;
       for (int i = 0; i < eqpSol.dim(); ++i)
@@ -613,13 +634,23 @@ void ROMInterfaceForm::TrainEQPForIntegrator(
       TODO(kevin): this is a boilerplate for parallel POD/EQP training.
       Full parallelization will treat EQ points/weights locally per each process.
    */
-   std::vector<int> eqp_sol_offsets, eqp_sol_cnts;
-   int eqp_sol_dim = CAROM::get_global_offsets(eqpSol.dim(), eqp_sol_offsets, MPI_COMM_WORLD);
-   for (int k = 0; k < eqp_sol_offsets.size() - 1; k++)
-      eqp_sol_cnts.push_back(eqp_sol_offsets[k + 1] - eqp_sol_offsets[k]);
-   CAROM::Vector eqpSol_global(eqp_sol_dim, false);
-   MPI_Allgatherv(eqpSol.getData(), eqpSol.dim(), MPI_DOUBLE, eqpSol_global.getData(),
-                  eqp_sol_cnts.data(), eqp_sol_offsets.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+   CAROM::Vector eqpSol_global(1, false);
+   if (eqpSol.distributed())
+   {
+      std::vector<int> eqp_sol_offsets, eqp_sol_cnts;
+      int eqp_sol_dim = CAROM::get_global_offsets(eqpSol.dim(), eqp_sol_offsets, MPI_COMM_WORLD);
+      for (int k = 0; k < eqp_sol_offsets.size() - 1; k++)
+         eqp_sol_cnts.push_back(eqp_sol_offsets[k + 1] - eqp_sol_offsets[k]);
+      eqpSol_global.setSize(eqp_sol_dim);
+      MPI_Allgatherv(eqpSol.getData(), eqpSol.dim(), MPI_DOUBLE, eqpSol_global.getData(),
+                     eqp_sol_cnts.data(), eqp_sol_offsets.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+   }
+   else
+   {
+      eqpSol_global.setSize(eqpSol.dim());
+      for (int i = 0; i < eqpSol.dim(); i++)
+         eqpSol_global(i) = eqpSol(i);
+   }
 
    samples.SetSize(0);
    for (int i = 0; i < eqpSol_global.dim(); ++i)
@@ -736,12 +767,19 @@ void ROMInterfaceForm::PrecomputeCoefficients()
          fes1 = comp_fes[c1];
          fes2 = comp_fes[c2];
 
+         // coefficients loaded from the EQP file are used as they are.
+         const int dim = fes1->GetMesh()->Dimension();
+         const std::string fingerprint = BasisFingerprint(*basis1) + BasisFingerprint(*basis2);
+         if (eqp_elem->HasLoadedCoefficients(dim, basis1->NumCols(), basis2->NumCols(), false, fingerprint))
+            continue;
+
          mesh1 = topol_handler->GetComponentMesh(c1);
          if (c1 == c2)
             mesh2 = new Mesh(*mesh1);
          else
             mesh2 = topol_handler->GetComponentMesh(c2);
 
+         eqp_elem->AllocateCoefficients(dim, basis1->NumCols(), basis2->NumCols(), false, fingerprint);
          for (int i = 0; i < eqp_elem->Size(); i++)
          {
             EQPSample *sample = eqp_elem->GetSample(i);
@@ -792,10 +830,13 @@ void ROMInterfaceForm::PrecomputeEQPSample(
    const IntegrationPoint &eip2 = tr2->GetElement1IntPoint();
    fe2->CalcShape(eip2, shape2);
 
+   // coefficients are written into the packed buffer of the EQPElement.
+   assert(eqp_sample.weight);
+   assert((eqp_sample.shape1.NumRows() == dim) && (eqp_sample.shape1.NumCols() == nbasis1));
+   assert((eqp_sample.shape2.NumRows() == dim) && (eqp_sample.shape2.NumCols() == nbasis2));
+   *eqp_sample.weight = eqp_sample.info.qw;
+
    Vector basis1_i, basis2_i;
-   DenseMatrix *vec1s, *vec2s;
-   vec1s = new DenseMatrix(dim, nbasis1);
-   vec2s = new DenseMatrix(dim, nbasis2);
 
    Vector vec1, vec2;
    DenseMatrix elv1, elv2;
@@ -804,7 +845,7 @@ void ROMInterfaceForm::PrecomputeEQPSample(
       GetBasisElement(basis1, i, vdofs1, basis1_i);
       elv1.UseExternalData(basis1_i.GetData(), ndofs1, dim);
 
-      vec1s->GetColumnReference(i, vec1);
+      eqp_sample.shape1.GetColumnReference(i, vec1);
       elv1.MultTranspose(shape1, vec1);
    }
 
@@ -813,13 +854,10 @@ void ROMInterfaceForm::PrecomputeEQPSample(
       GetBasisElement(basis2, i, vdofs2, basis2_i);
       elv2.UseExternalData(basis2_i.GetData(), ndofs2, dim);
 
-      vec2s->GetColumnReference(i, vec2);
+      eqp_sample.shape2.GetColumnReference(i, vec2);
       elv2.MultTranspose(shape2, vec2);
    }
 
-   eqp_sample.shape1 = vec1s;
-   eqp_sample.shape2 = vec2s;
-
    // TODO(kevin): compute dshape1, dshape2.
 }
 
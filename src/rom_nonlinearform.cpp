@@ -5,6 +5,9 @@
 #include "rom_nonlinearform.hpp"
 #include "linalg_utils.hpp"
 #include "utils/mpi_utils.h"  // this is from libROM/utils.
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -22,6 +25,19 @@ ROMNonlinearForm::ROMNonlinearForm(const int num_basis, FiniteElementSpace *f, c
    else
       mfem_error("ROMNonlinearForm: unknown NNLS criterion!\n");
 
+   num_threads = config.GetOption<int>("model_reduction/eqp/num_threads", 1);
+   deterministic = config.GetOption<bool>("model_reduction/eqp/deterministic", true);
+   assert(num_threads > 0);
+#if !defined(_OPENMP) || !defined(MFEM_THREAD_SAFE)
+   // coefficients and finite elements keep mutable scratch, unless mfem is built with MFEM_THREAD_SAFE.
+   if (num_threads > 1)
+   {
+      mfem_warning("ROMNonlinearForm: threaded EQP evaluation requires OpenMP and mfem built with MFEM_THREAD_SAFE.\n"
+                   "                  EQP evaluation runs on a single thread.\n");
+      num_threads = 1;
+   }
+#endif
+
    for (int k = 0; k < Nt; k++) jac_timers[k] = new StopWatch;
 }
 
@@ -113,6 +129,12 @@ void ROMNonlinearForm::Mult(const Vector &x, Vector &y) const
          EQPElement *eqp_elem = dnfi_sample[k];
          assert(eqp_elem);
 
+         if (precompute && (num_threads > 1))
+         {
+            AddDomainVectorThreaded(dnfi[k], eqp_elem, x, y);
+            continue;
+         }
+
          int prev_el = -1;
          for (int i = 0; i < eqp_elem->Size(); i++)
          {
@@ -145,6 +167,10 @@ void ROMNonlinearForm::Mult(const Vector &x, Vector &y) const
       }  // for (int k = 0; k < dnfi.Size(); k++)
    }  // if (dnfi.Size())
 
+   /*
+      Face integrators are evaluated serially: their fast paths use the integrator scratch members,
+      and face transformations are shared objects owned by the mesh.
+   */
    if (fnfi.Size())
    {
       FaceElementTransformations *tr = NULL;
@@ -371,6 +397,15 @@ Operator& ROMNonlinearForm::GetGradient(const Vector &x) const
 
          int prev_el = -1;
          jac_timers[1]->Stop();
+
+         if (precompute && (num_threads > 1))
+         {
+            jac_timers[3]->Start();
+            AddDomainGradThreaded(dnfi[k], eqp_elem, x, *Grad);
+            jac_timers[3]->Stop();
+            continue;
+         }
+
          for (int i = 0; i < eqp_elem->Size(); i++)
          {
             jac_timers[2]->Start();
@@ -588,12 +623,117 @@ Operator& ROMNonlinearForm::GetGradient(const Vector &x) const
    return *mGrad;
 }
 
+void ROMNonlinearForm::AddDomainVectorThreaded(
+   HyperReductionIntegrator *nlfi, EQPElement *eqp_elem, const Vector &x, Vector &y) const
+{
+   assert(precompute);
+   Mesh *mesh = fes->GetMesh();
+   const int nsample = eqp_elem->Size();
+
+   std::vector<Vector> y_thread(num_threads);
+   for (int t = 0; t < num_threads; t++)
+   {
+      y_thread[t].SetSize(y.Size());
+      y_thread[t] = 0.0;
+   }
+   nlfi->ReserveFastScratch(num_threads);
+
+   #pragma omp parallel num_threads(num_threads)
+   {
+      int tid = 0;
+#ifdef _OPENMP
+      tid = omp_get_thread_num();
+#endif
+      Vector &y_t = y_thread[tid];
+      // Mesh::GetElementTransformation(el) returns a shared object, thus not used here.
+      IsoparametricTransformation T;
+
+      if (deterministic)
+      {
+         #pragma omp for schedule(static)
+         for (int i = 0; i < nsample; i++)
+         {
+            EQPSample *sample = eqp_elem->GetSample(i);
+            mesh->GetElementTransformation(sample->info.el, &T);
+            nlfi->AddAssembleVector_Fast(*sample, T, x, y_t);
+         }
+      }
+      else
+      {
+         #pragma omp for schedule(dynamic, 16)
+         for (int i = 0; i < nsample; i++)
+         {
+            EQPSample *sample = eqp_elem->GetSample(i);
+            mesh->GetElementTransformation(sample->info.el, &T);
+            nlfi->AddAssembleVector_Fast(*sample, T, x, y_t);
+         }
+      }
+   }
+
+   // reduction in the thread order.
+   for (int t = 0; t < num_threads; t++)
+      y += y_thread[t];
+}
+
+void ROMNonlinearForm::AddDomainGradThreaded(
+   HyperReductionIntegrator *nlfi, EQPElement *eqp_elem, const Vector &x, DenseMatrix &jac) const
+{
+   assert(precompute);
+   Mesh *mesh = fes->GetMesh();
+   const int nsample = eqp_elem->Size();
+
+   std::vector<DenseMatrix> jac_thread(num_threads);
+   for (int t = 0; t < num_threads; t++)
+   {
+      jac_thread[t].SetSize(jac.NumRows(), jac.NumCols());
+      jac_thread[t] = 0.0;
+   }
+   nlfi->ReserveFastScratch(num_threads);
+
+   #pragma omp parallel num_threads(num_threads)
+   {
+      int tid = 0;
+#ifdef _OPENMP
+      tid = omp_get_thread_num();
+#endif
+      DenseMatrix &jac_t = jac_thread[tid];
+      // Mesh::GetElementTransformation(el) returns a shared object, thus not used here.
+      IsoparametricTransformation T;
+
+      if (deterministic)
+      {
+         #pragma omp for schedule(static)
+         for (int i = 0; i < nsample; i++)
+         {
+            EQPSample *sample = eqp_elem->GetSample(i);
+            mesh->GetElementTransformation(sample->info.el, &T);
+            nlfi->AddAssembleGrad_Fast(*sample, T, x, jac_t);
+         }
+      }
+      else
+      {
+         #pragma omp for schedule(dynamic, 16)
+         for (int i = 0; i < nsample; i++)
+         {
+            EQPSample *sample = eqp_elem->GetSample(i);
+            mesh->GetElementTransformation(sample->info.el, &T);
+            nlfi->AddAssembleGrad_Fast(*sample, T, x, jac_t);
+         }
+      }
+   }
+
+   // reduction in the thread order.
+   for (int t = 0; t < num_threads; t++)
+      jac += jac_thread[t];
+}
+
 void ROMNonlinearForm::PrecomputeCoefficients()
 {
    assert(basis);
    assert(basis->NumCols() == height);
 
    Mesh *mesh = fes->GetMesh();
+   const std::string fingerprint = BasisFingerprint(*basis);
 
    if (dnfi.Size())
    {
@@ -604,6 +744,11 @@ void ROMNonlinearForm::PrecomputeCoefficients()
          assert(ir);
          assert(eqp_elem);
 
+         // coefficients loaded from the EQP file are used as they are.
+         if (eqp_elem->HasLoadedCoefficients(mesh->Dimension(), basis->NumCols(), 0, true, fingerprint))
+            continue;
+
+         eqp_elem->AllocateCoefficients(mesh->Dimension(), basis->NumCols(), 0, true, fingerprint);
          for (int i = 0; i < eqp_elem->Size(); i++)
             PrecomputeDomainEQPSample(*ir, *basis, *eqp_elem->GetSample(i));
       }  // for (int k = 0; k < dnfi.Size(); k++)
@@ -618,6 +763,11 @@ void ROMNonlinearForm::PrecomputeCoefficients()
          assert(ir);
          assert(eqp_elem);
 
+         // coefficients loaded from the EQP file are used as they are.
+         if (eqp_elem->HasLoadedCoefficients(mesh->Dimension(), basis->NumCols(), basis->NumCols(), false, fingerprint))
+            continue;
+
+         eqp_elem->AllocateCoefficients(mesh->Dimension(), basis->NumCols(), basis->NumCols(), false, fingerprint);
          for (int i = 0; i < eqp_elem->Size(); i++)
             PrecomputeInteriorFaceEQPSample(*ir, *basis, *eqp_elem->GetSample(i));
       }  // for (int k = 0; k < fnfi.Size(); k++)
@@ -653,6 +803,11 @@ void ROMNonlinearForm::PrecomputeCoefficients()
          assert(ir);
          assert(eqp_elem);
 
+         // coefficients loaded from the EQP file are used as they are.
+         if (eqp_elem->HasLoadedCoefficients(mesh->Dimension(), basis->NumCols(), 0, false, fingerprint))
+            continue;
+
+         eqp_elem->AllocateCoefficients(mesh->Dimension(), basis->NumCols(), 0, false, fingerprint);
          for (int i = 0; i < eqp_elem->Size(); i++)
          {
             EQPSample *sample = eqp_elem->GetSample(i);
@@ -691,11 +846,25 @@ void ROMNonlinearForm::TrainEQP(const CAROM::Matrix &snapshots, const double eqp
    /*
       TODO(kevin): this is a boilerplate for parallel POD/EQP training.
       Full parallelization will have to consider local matrix construction from local snapshot/basis matrix.
+      Snapshots already gathered are used as they are, e.g. for local EQP training.
    */
-   assert(snapshots.distributed());
    CAROM::Matrix snapshots_work(snapshots);
-   snapshots_work.gather();
-   const int nrow_global = snapshots_work.numRows();
+   if (snapshots_work.distributed())
+      snapshots_work.gather();
+
+   for (int k = 0; k < dnfi.Size(); k++)
+      TrainEQPForIntegrator(IntegratorType::DOMAIN, k, snapshots_work, eqp_tol);
+   for (int k = 0; k < fnfi.Size(); k++)
+      TrainEQPForIntegrator(IntegratorType::INTERIORFACE, k, snapshots_work, eqp_tol);
+   for (int k = 0; k < bfnfi.Size(); k++)
+      TrainEQPForIntegrator(IntegratorType::BDRFACE, k, snapshots_work, eqp_tol);
+}
+
+void ROMNonlinearForm::TrainEQPForIntegrator(
+   const IntegratorType type, const int k, const CAROM::Matrix &snapshots, const double eqp_tol)
+{
+   assert(!snapshots.distributed());
+   const int nrow_global = snapshots.numRows();
    assert(basis);
    assert(nrow_global >= fes->GetTrueVSize());
    if (nrow_global > fes->GetTrueVSize())
@@ -703,56 +872,151 @@ void ROMNonlinearForm::TrainEQP(const CAROM::Matrix &snapshots, const double eqp
 
    // NOTE(kevin): these will be resized within the routines as needed.
    // just initializing with distribute option.
-   CAROM::Matrix Gt(1,1, true);
+   CAROM::Matrix Gt(1,1, distributed_eqp);
    CAROM::Vector rhs_Gw(1, false);
 
    Array<SampleInfo> samples;
    Array<int> fidxs;
    Mesh *mesh = fes->GetMesh();
 
-   for (int k = 0; k < dnfi.Size(); k++)
+   switch (type)
    {
-      SetupEQPSystemForDomainIntegrator(snapshots_work, dnfi[k], Gt, rhs_Gw);
-      TrainEQPForIntegrator(dnfi[k], Gt, rhs_Gw, eqp_tol, samples);
-      UpdateDomainIntegratorSampling(k, samples);
+      case IntegratorType::DOMAIN:
+      {
+         assert((k >= 0) && (k < dnfi.Size()));
+         SetupEQPSystemForDomainIntegrator(snapshots, dnfi[k], Gt, rhs_Gw);
+         TrainEQPForIntegrator(dnfi[k], Gt, rhs_Gw, eqp_tol, samples);
+         UpdateDomainIntegratorSampling(k, samples);
+      }
+      break;
+      case IntegratorType::INTERIORFACE:
+      {
+         assert((k >= 0) && (k < fnfi.Size()));
+         SetupEQPSystemForInteriorFaceIntegrator(snapshots, fnfi[k], Gt, rhs_Gw, fidxs);
+         TrainEQPForIntegrator(fnfi[k], Gt, rhs_Gw, eqp_tol, samples);
+         for (int s = 0; s < samples.Size(); s++)
+            samples[s].el = fidxs[samples[s].el];
+         UpdateInteriorFaceIntegratorSampling(k, samples);
+      }
+      break;
+      case IntegratorType::BDRFACE:
+      {
+         assert((k >= 0) && (k < bfnfi.Size()));
+
+         // Determine the boundary attributes to process for k-th boundary face integrator.
+         Array<int> bdr_attr_marker(mesh->bdr_attributes.Size() ?
+                                    mesh->bdr_attributes.Max() : 0);
+         bdr_attr_marker = 0;
+         if (bfnfi_marker[k] == NULL)
+            bdr_attr_marker = 1;
+         else
+         {
+            Array<int> &bdr_marker = *bfnfi_marker[k];
+            MFEM_ASSERT(bdr_marker.Size() == bdr_attr_marker.Size(),
+                        "invalid boundary marker for boundary face integrator #"
+                        << k << ", counting from zero");
+            for (int i = 0; i < bdr_attr_marker.Size(); i++)
+            {
+               bdr_attr_marker[i] |= bdr_marker[i];
+            }
+         }
+
+         SetupEQPSystemForBdrFaceIntegrator(snapshots, bfnfi[k], bdr_attr_marker, Gt, rhs_Gw, fidxs);
+         TrainEQPForIntegrator(bfnfi[k], Gt, rhs_Gw, eqp_tol, samples);
+         for (int s = 0; s < samples.Size(); s++)
+            samples[s].el = fidxs[samples[s].el];
+         UpdateBdrFaceIntegratorSampling(k, samples);
+      }
+      break;
+      default:
+         mfem_error("Unknown Integrator type!\n");
    }
+}
 
-   for (int k = 0; k < fnfi.Size(); k++)
+const int ROMNonlinearForm::GetNumIntegrators(const IntegratorType type) const
+{
+   switch (type)
    {
-      SetupEQPSystemForInteriorFaceIntegrator(snapshots_work, fnfi[k], Gt, rhs_Gw, fidxs);
-      TrainEQPForIntegrator(fnfi[k], Gt, rhs_Gw, eqp_tol, samples);
-      for (int s = 0; s < samples.Size(); s++)
-         samples[s].el = fidxs[samples[s].el];
-      UpdateInteriorFaceIntegratorSampling(k, samples);
+      case IntegratorType::DOMAIN:        return dnfi.Size();
+      case IntegratorType::INTERIORFACE:  return fnfi.Size();
+      case IntegratorType::BDRFACE:       return bfnfi.Size();
+      default:
+         mfem_error("Unknown Integrator type!\n");
    }
+   return 0;
+}
 
-   // Which boundary attributes need to be processed?
-   Array<int> bdr_attr_marker(mesh->bdr_attributes.Size() ?
-                              mesh->bdr_attributes.Max() : 0);
-
+const int ROMNonlinearForm::GetEQPSystemSize()
+{
+   int size = 0;
+   for (int k = 0; k < dnfi.Size(); k++)
+      size += GetEQPSystemSize(IntegratorType::DOMAIN, k);
+   for (int k = 0; k < fnfi.Size(); k++)
+      size += GetEQPSystemSize(IntegratorType::INTERIORFACE, k);
    for (int k = 0; k < bfnfi.Size(); k++)
+      size += GetEQPSystemSize(IntegratorType::BDRFACE, k);
+
+   return size;
+}
+
+const int ROMNonlinearForm::GetEQPSystemSize(const IntegratorType type, const int k)
+{
+   Mesh *mesh = fes->GetMesh();
+   switch (type)
    {
-      // Determine the boundary attributes to process for k-th boundary face integrator.
-      bdr_attr_marker = 0;
-      if (bfnfi_marker[k] == NULL)
-         bdr_attr_marker = 1;
-      else
+      case IntegratorType::DOMAIN:
       {
-         Array<int> &bdr_marker = *bfnfi_marker[k];
-         MFEM_ASSERT(bdr_marker.Size() == bdr_attr_marker.Size(),
-                     "invalid boundary marker for boundary face integrator #"
-                     << k << ", counting from zero");
-         for (int i = 0; i < bdr_attr_marker.Size(); i++)
-         {
-            bdr_attr_marker[i] |= bdr_marker[i];
-         }
+         assert((k >= 0) && (k < dnfi.Size()));
+         return fes->GetNE() * dnfi[k]->GetIntegrationRule()->GetNPoints();
       }
+      case IntegratorType::INTERIORFACE:
+      {
+         assert((k >= 0) && (k < fnfi.Size()));
+         int nif = 0;
+         for (int f = 0; f < mesh->GetNumFaces(); f++)
+            if (mesh->FaceIsInterior(f)) nif++;
+         return nif * fnfi[k]->GetIntegrationRule()->GetNPoints();
+      }
+      case IntegratorType::BDRFACE:
+      {
+         assert((k >= 0) && (k < bfnfi.Size()));
+         // NOTE: boundary markers are not considered, so this is an upper bound.
+         return fes->GetNBE() * bfnfi[k]->GetIntegrationRule()->GetNPoints();
+      }
+      default:
+         mfem_error("Unknown Integrator type!\n");
+   }
+   return 0;
+}
+
+void ROMNonlinearForm::BroadcastEQP(const int root)
+{
+   for (int k = 0; k < dnfi.Size(); k++)
+      BroadcastEQPForIntegrator(IntegratorType::DOMAIN, k, root);
+   for (int k = 0; k < fnfi.Size(); k++)
+      BroadcastEQPForIntegrator(IntegratorType::INTERIORFACE, k, root);
+   for (int k = 0; k < bfnfi.Size(); k++)
+      BroadcastEQPForIntegrator(IntegratorType::BDRFACE, k, root);
+}
+
+void ROMNonlinearForm::BroadcastEQPForIntegrator(const IntegratorType type, const int k, const int root)
+{
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   Array<SampleInfo> samples;
+   if (rank == root)
+      GetEQPForIntegrator(type, k)->GetSampleInfos(samples);
+   BroadcastSampleInfos(samples, root);
+   if (rank == root) return;
 
-      SetupEQPSystemForBdrFaceIntegrator(snapshots_work, bfnfi[k], bdr_attr_marker, Gt, rhs_Gw, fidxs);
-      TrainEQPForIntegrator(bfnfi[k], Gt, rhs_Gw, eqp_tol, samples);
-      for (int s = 0; s < samples.Size(); s++)
-         samples[s].el = fidxs[samples[s].el];
-      UpdateBdrFaceIntegratorSampling(k, samples);
+   switch (type)
+   {
+      case IntegratorType::DOMAIN:        UpdateDomainIntegratorSampling(k, samples); break;
+      case IntegratorType::INTERIORFACE:  UpdateInteriorFaceIntegratorSampling(k, samples); break;
+      case IntegratorType::BDRFACE:       UpdateBdrFaceIntegratorSampling(k, samples); break;
+      default:
+         mfem_error("Unknown Integrator type!\n");
    }
 }
 
@@ -772,7 +1036,7 @@ void ROMNonlinearForm::TrainEQPForIntegrator(
    const double normRHS = rhs_Gw.norm();
    double nnls_tol = 1.0e-11;
    int maxNNLSnnz = 0;
-   CAROM::Vector eqpSol(Gt.numRows(), true);
+   CAROM::Vector eqpSol(Gt.numRows(), Gt.distributed());
    int nnz = 0;
    {
       CAROM::NNLSSolver nnls(nnls_tol, 0, maxNNLSnnz, 2, 1.0e-4, 1.0e-14,
@@ -800,7 +1064,21 @@ void ROMNonlinearForm::TrainEQPForIntegrator(
          The optimization will continue until
             max_i || rhs_Gw(i) - eqp_Gw(i) || / || rhs_Gw(i) || < eqp_tol
       */
-      nnls.solve_parallel_with_scalapack(Gt, rhs_lb, rhs_ub, eqpSol);
+      if (Gt.distributed())
+         nnls.solve_parallel_with_scalapack(Gt, rhs_lb, rhs_ub, eqpSol);
+      else
+      {
+         /*
+            A local EQP system is solved without any communication,
+            so that independent systems can be trained on different processes.
+            Gt is row-major, thus its data is G in column-major.
+         */
+         DenseMatrix G(Gt.getData(), Gt.numColumns(), Gt.numRows());
+         Vector lb(rhs_lb.getData(), rhs_lb.dim()), ub(rhs_ub.getData(), rhs_ub.dim());
+         Vector sol(eqpSol.getData(), eqpSol.dim());
+         if (!SolveBoundedNNLS(G, lb, ub, sol, nnls_criterion))
+            mfem_warning("TrainEQPForIntegrator- local NNLS did not satisfy the tolerance!\n");
+      }
 
       nnz = 0;
       for (int i = 0; i < eqpSol.dim(); ++i)
@@ -836,13 +1114,23 @@ void ROMNonlinearForm::TrainEQPForIntegrator(
       TODO(kevin): this is a boilerplate for parallel POD/EQP training.
       Full parallelization will treat EQ points/weights locally per each process.
    */
-   std::vector<int> eqp_sol_offsets, eqp_sol_cnts;
-   int eqp_sol_dim = CAROM::get_global_offsets(eqpSol.dim(), eqp_sol_offsets, MPI_COMM_WORLD);
-   for (int k = 0; k < eqp_sol_offsets.size() - 1; k++)
-      eqp_sol_cnts.push_back(eqp_sol_offsets[k + 1] - eqp_sol_offsets[k]);
-   CAROM::Vector eqpSol_global(eqp_sol_dim, false);
-   MPI_Allgatherv(eqpSol.getData(), eqpSol.dim(), MPI_DOUBLE, eqpSol_global.getData(),
-                  eqp_sol_cnts.data(), eqp_sol_offsets.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+   CAROM::Vector eqpSol_global(1, false);
+   if (eqpSol.distributed())
+   {
+      std::vector<int> eqp_sol_offsets, eqp_sol_cnts;
+      int eqp_sol_dim = CAROM::get_global_offsets(eqpSol.dim(), eqp_sol_offsets, MPI_COMM_WORLD);
+      for (int k = 0; k < eqp_sol_offsets.size() - 1; k++)
+         eqp_sol_cnts.push_back(eqp_sol_offsets[k + 1] - eqp_sol_offsets[k]);
+      eqpSol_global.setSize(eqp_sol_dim);
+      MPI_Allgatherv(eqpSol.getData(), eqpSol.dim(), MPI_DOUBLE, eqpSol_global.getData(),
+                     eqp_sol_cnts.data(), eqp_sol_offsets.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+   }
+   else
+   {
+      eqpSol_global.setSize(eqpSol.dim());
+      for (int i = 0; i < eqpSol.dim(); i++)
+         eqpSol_global(i) = eqpSol(i);
+   }
 
    samples.SetSize(0);
    for (int i = 0; i < eqpSol_global.dim(); ++i)
@@ -868,8 +1156,6 @@ void ROMNonlinearForm::SetupEQPSystemForDomainIntegrator(
       Also, while snapshot/basis are distributed according to vdofs,
       EQP system will be distributed according to elements.
    */
-   int rank;
-   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
    assert(!snapshots.distributed());
    assert(basis);
@@ -886,82 +1172,87 @@ void ROMNonlinearForm::SetupEQPSystemForDomainIntegrator(
    const int nsnap = snapshots.numColumns();
 
    const int ne_global = fes->GetNE();
-   const int ne = CAROM::split_dimension(ne_global, MPI_COMM_WORLD);
-   std::vector<int> elem_offsets;
-   int dummy = CAROM::get_global_offsets(ne, elem_offsets, MPI_COMM_WORLD);
-   assert(dummy == ne_global);
+   // the EQP system is distributed over elements only if Gt is distributed.
+   int e_begin, e_end;
+   GetEQPElementRange(ne_global, Gt.distributed(), e_begin, e_end);
+   const int ne = e_end - e_begin;
 
    const int NQ = ne * nqe;
 
    // Compute G of size (NB * nsnap) x NQ, but only store its transpose Gt.
    Gt.setSize(NQ, NB * nsnap);
-   assert(Gt.distributed());
    // For 0 <= j < NB, 0 <= i < nsnap, 0 <= e < ne, 0 <= m < nqe,
    // G(j + (i*NB), (e*nqe) + m)
    // is the coefficient of v_j^T M(p_i) V v_i at point m of element e,
    // with respect to the integration rule weight at that point,
    // where the "exact" quadrature solution is ir0->GetWeights().
 
-   Vector v_i(fes->GetTrueVSize());
-   Vector r(nqe);
-
+   Mesh *mesh = fes->GetMesh();
    Array<int> vdofs;
-   Vector el_x, el_tr;
-   DenseMatrix el_quad;
-   const FiniteElement *fe;
-   ElementTransformation *T;
-   DofTransformation *doftrans;
 
-   /* fill out quadrature evaluation of all snapshot-basis weak forms */
-   for (int i = 0; i < nsnap; ++i)
+   /*
+      Elements are visited once in the outer loop, evaluating all snapshots at once.
+      Element partitions are threaded if the integrator is thread-safe,
+      which also requires mfem built with MFEM_THREAD_SAFE (see the constructor) for the finite elements.
+      DofTransformation objects are shared within FiniteElementSpace, thus not threaded if any element has one.
+   */
+   bool threaded = (num_threads > 1) && nlfi->ThreadSafeQuadratureVectors();
+#if !defined(_OPENMP) || !defined(MFEM_THREAD_SAFE)
+   threaded = false;
+#endif
+   for (int e = e_begin; threaded && (e < e_end); e++)
+      if (fes->GetElementVDofs(e, vdofs))
+         threaded = false;
+
+   #pragma omp parallel num_threads((threaded) ? num_threads : 1)
    {
-      // NOTE(kevin): have to copy the vector since libROM matrix is row-major.
-      for (int k = 0; k < fes->GetTrueVSize(); ++k)
-         v_i[k] = snapshots(k, i);
-
-      for (int e = elem_offsets[rank], eidx = 0; e < elem_offsets[rank+1]; e++, eidx++)
+      Array<int> vdofs_e;
+      DenseMatrix el_x, el_tr, el_quad, r;
+      Vector col;
+      // Mesh::GetElementTransformation(el) returns a shared object, thus not used here.
+      IsoparametricTransformation T;
+
+      #pragma omp for schedule(dynamic, 4)
+      for (int e = e_begin; e < e_end; e++)
       {
-         fe = fes->GetFE(e);
-         doftrans = fes->GetElementVDofs(e, vdofs);
-         T = fes->GetElementTransformation(e);
-         v_i.GetSubVector(vdofs, el_x);
-
-         if (doftrans) { doftrans->InvTransformPrimal(el_x); }
-
-         const int nd = fe->GetDof();
-         el_quad.SetSize(nd * vdim, nqe);
-         for (int i = 0; i < ir->GetNPoints(); i++)
-         {
-            Vector EQ(el_quad.GetColumn(i), nd * vdim);
-
-            const IntegrationPoint &ip = ir->IntPoint(i);
-            nlfi->AssembleQuadratureVector(*fe, *T, ip, 1.0, el_x, EQ);
-            if (doftrans) { doftrans->TransformDual(EQ); }
-         }
-         // nlfi->AssembleElementQuadrature(*fe, *T, el_x, el_quad);
+         const int eidx = e - e_begin;
+         const FiniteElement *fe = fes->GetFE(e);
+         DofTransformation *doftrans = fes->GetElementVDofs(e, vdofs_e);
+         mesh->GetElementTransformation(e, &T);
+
+         /* element restriction of all snapshots and basis vectors, once per element. */
+         GetSnapshotElementBlock(snapshots, vdofs_e, el_x);
+         GetBasisElementBlock(*basis, vdofs_e, el_tr);
+         if (doftrans)
+            for (int i = 0; i < nsnap; i++)
+            {
+               el_x.GetColumnReference(i, col);
+               doftrans->InvTransformPrimal(col);
+            }
 
-         for (int j = 0; j < NB; ++j)
+         for (int m = 0; m < nqe; ++m)
          {
-            Vector v_j(basis->GetColumn(j), fes->GetVSize());
-            v_j.GetSubVector(vdofs, el_tr);
-
-            el_quad.MultTranspose(el_tr, r);
-
-            for (int m = 0; m < nqe; ++m)
-               Gt(m + (eidx * nqe), j + (i * NB)) = r[m];
-         }  // for (int j = 0; j < NB; ++j)
-      }  // for (int e = 0; e < ne; ++e)
+            nlfi->AssembleQuadratureVectors(*fe, T, ir->IntPoint(m), 1.0, el_x, el_quad);
+            if (doftrans)
+               for (int i = 0; i < nsnap; i++)
+               {
+                  el_quad.GetColumnReference(i, col);
+                  doftrans->TransformDual(col);
+               }
 
-      // if (precondition)
-      // {
-         // // Preconditioning is done by (V^T M(p_i) V)^{-1} (of size NB x NB).
-         // PreconditionNNLS(fespace_R, new VectorFEMassIntegrator(a_coeff), BR, i, Gt);
-      // }
-   }  // for (int i = 0; i < nsnap; ++i)
+            /*
+               r(j, i) = G(j + (i*NB), (eidx*nqe) + m),
+               which is exactly the row (eidx*nqe) + m of the row-major Gt.
+            */
+            MultAtB(el_tr, el_quad, r);
+            std::copy(r.Data(), r.Data() + NB * nsnap, Gt.getData() + static_cast<size_t>(m + (eidx * nqe)) * Gt.numColumns());
+         }  // for (int m = 0; m < nqe; ++m)
+      }  // for (int e = e_begin; e < e_end; e++)
+   }
 
    /* Fill out FOM quadrature weights */
    Array<double> const& w_el = ir->GetWeights();
-   CAROM::Vector w(ne * nqe, true);
+   CAROM::Vector w(ne * nqe, Gt.distributed());
    for (int i = 0; i < ne; ++i)
       for (int j = 0; j < nqe; ++j)
          w(j + (i * nqe)) = w_el[j];
@@ -984,8 +1275,6 @@ void ROMNonlinearForm::SetupEQPSystemForInteriorFaceIntegrator(
       Also, while snapshot/basis are distributed according to vdofs,
       EQP system will be distributed according to elements.
    */
-   int rank;
-   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
    assert(!snapshots.distributed());
    assert(basis);
@@ -1012,84 +1301,58 @@ void ROMNonlinearForm::SetupEQPSystemForInteriorFaceIntegrator(
    }
 
    const int ne_global = fidxs.Size();
-   const int ne = CAROM::split_dimension(ne_global, MPI_COMM_WORLD);
-   std::vector<int> elem_offsets;
-   int dummy = CAROM::get_global_offsets(ne, elem_offsets, MPI_COMM_WORLD);
-   assert(dummy == ne_global);
+   // the EQP system is distributed over elements only if Gt is distributed.
+   int e_begin, e_end;
+   GetEQPElementRange(ne_global, Gt.distributed(), e_begin, e_end);
+   const int ne = e_end - e_begin;
 
    const int NQ = ne * nqe;
 
    // Compute G of size (NB * nsnap) x NQ, but only store its transpose Gt.
    Gt.setSize(NQ, NB * nsnap);
-   assert(Gt.distributed());
    // For 0 <= j < NB, 0 <= i < nsnap, 0 <= e < ne, 0 <= m < nqe,
    // G(j + (i*NB), (e*nqe) + m)
    // is the coefficient of v_j^T M(p_i) V v_i at point m of element e,
    // with respect to the integration rule weight at that point,
    // where the "exact" quadrature solution is ir0->GetWeights().
 
-   Vector v_i(fes->GetTrueVSize());
-   Vector r(nqe);
-
    Array<int> vdofs, vdofs2;
-   Vector el_x, el_tr;
-   DenseMatrix el_quad;
-   
+   DenseMatrix el_x, el_tr, el_quad, r;
    const FiniteElement *fe1, *fe2;
 
-   /* fill out quadrature evaluation of all snapshot-basis weak forms */
-   for (int i = 0; i < nsnap; ++i)
+   /*
+      Faces are visited once in the outer loop, evaluating all snapshots at once.
+      Mesh face transformations are shared objects, thus this loop is not threaded.
+   */
+   for (int e = e_begin, eidx = 0; e < e_end; e++, eidx++)
    {
-      // NOTE(kevin): have to copy the vector since libROM matrix is row-major.
-      for (int k = 0; k < fes->GetTrueVSize(); ++k)
-         v_i[k] = snapshots(k, i);
-
-      for (int e = elem_offsets[rank], eidx = 0; e < elem_offsets[rank+1]; e++, eidx++)
-      {
-         tr = mesh->GetInteriorFaceTransformations(fidxs[e]);
-         assert(tr != NULL);
-
-         fes->GetElementVDofs(tr->Elem1No, vdofs);
-         fes->GetElementVDofs(tr->Elem2No, vdofs2);
-         vdofs.Append (vdofs2);
+      tr = mesh->GetInteriorFaceTransformations(fidxs[e]);
+      assert(tr != NULL);
 
-         v_i.GetSubVector(vdofs, el_x);
+      fes->GetElementVDofs(tr->Elem1No, vdofs);
+      fes->GetElementVDofs(tr->Elem2No, vdofs2);
+      vdofs.Append (vdofs2);
 
-         fe1 = fes->GetFE(tr->Elem1No);
-         fe2 = fes->GetFE(tr->Elem2No);
+      fe1 = fes->GetFE(tr->Elem1No);
+      fe2 = fes->GetFE(tr->Elem2No);
 
-         const int nd = fe1->GetDof() + fe2->GetDof();
-         el_quad.SetSize(nd * vdim, nqe);
-         for (int i = 0; i < ir->GetNPoints(); i++)
-         {
-            Vector EQ(el_quad.GetColumn(i), nd * vdim);
-
-            const IntegrationPoint &ip = ir->IntPoint(i);
-            nlfi->AssembleQuadratureVector(*fe1, *fe2, *tr, ip, 1.0, el_x, EQ);
-         }
+      /* face restriction of all snapshots and basis vectors, once per face. */
+      GetSnapshotElementBlock(snapshots, vdofs, el_x);
+      GetBasisElementBlock(*basis, vdofs, el_tr);
 
-         for (int j = 0; j < NB; ++j)
-         {
-            Vector v_j(basis->GetColumn(j), fes->GetVSize());
-            v_j.GetSubVector(vdofs, el_tr);
-
-            el_quad.MultTranspose(el_tr, r);
-
-            for (int m = 0; m < nqe; ++m)
-               Gt(m + (eidx * nqe), j + (i * NB)) = r[m];
-         }  // for (int j = 0; j < NB; ++j)
-      }  // for (int e = 0; e < ne; ++e)
+      for (int m = 0; m < nqe; ++m)
+      {
+         nlfi->AssembleQuadratureVectors(*fe1, *fe2, *tr, ir->IntPoint(m), 1.0, el_x, el_quad);
 
-      // if (precondition)
-      // {
-         // // Preconditioning is done by (V^T M(p_i) V)^{-1} (of size NB x NB).
-         // PreconditionNNLS(fespace_R, new VectorFEMassIntegrator(a_coeff), BR, i, Gt);
-      // }
-   }  // for (int i = 0; i < nsnap; ++i)
+         // r(j, i) = G(j + (i*NB), (eidx*nqe) + m), i.e. the row (eidx*nqe) + m of Gt.
+         MultAtB(el_tr, el_quad, r);
+         std::copy(r.Data(), r.Data() + NB * nsnap, Gt.getData() + static_cast<size_t>(m + (eidx * nqe)) * Gt.numColumns());
+      }  // for (int m = 0; m < nqe; ++m)
+   }  // for (int e = e_begin; e < e_end; e++)
 
    /* Fill out FOM quadrature weights */
    Array<double> const& w_el = ir->GetWeights();
-   CAROM::Vector w(ne * nqe, true);
+   CAROM::Vector w(ne * nqe, Gt.distributed());
    for (int i = 0; i < ne; ++i)
       for (int j = 0; j < nqe; ++j)
          w(j + (i * nqe)) = w_el[j];
@@ -1112,8 +1375,6 @@ void ROMNonlinearForm::SetupEQPSystemForBdrFaceIntegrator(
       Also, while snapshot/basis are distributed according to vdofs,
       EQP system will be distributed according to elements.
    */
-   int rank;
-   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
    assert(!snapshots.distributed());
    assert(basis);
@@ -1143,87 +1404,61 @@ void ROMNonlinearForm::SetupEQPSystemForBdrFaceIntegrator(
    }
 
    const int ne_global = bidxs.Size();
-   const int ne = CAROM::split_dimension(ne_global, MPI_COMM_WORLD);
-   std::vector<int> elem_offsets;
-   int dummy = CAROM::get_global_offsets(ne, elem_offsets, MPI_COMM_WORLD);
-   assert(dummy == ne_global);
+   // the EQP system is distributed over elements only if Gt is distributed.
+   int e_begin, e_end;
+   GetEQPElementRange(ne_global, Gt.distributed(), e_begin, e_end);
+   const int ne = e_end - e_begin;
 
    const int NQ = ne * nqe;
 
    // Compute G of size (NB * nsnap) x NQ, but only store its transpose Gt.
    Gt.setSize(NQ, NB * nsnap);
-   assert(Gt.distributed());
    // For 0 <= j < NB, 0 <= i < nsnap, 0 <= e < ne, 0 <= m < nqe,
    // G(j + (i*NB), (e*nqe) + m)
    // is the coefficient of v_j^T M(p_i) V v_i at point m of element e,
    // with respect to the integration rule weight at that point,
    // where the "exact" quadrature solution is ir0->GetWeights().
 
-   Vector v_i(fes->GetTrueVSize());
-   Vector r(nqe);
-
-   Array<int> vdofs, vdofs2;
-   Vector el_x, el_tr;
-   DenseMatrix el_quad;
-   
+   Array<int> vdofs;
+   DenseMatrix el_x, el_tr, el_quad, r;
    const FiniteElement *fe1, *fe2;
 
-   /* fill out quadrature evaluation of all snapshot-basis weak forms */
-   for (int i = 0; i < nsnap; ++i)
+   /*
+      Boundary faces are visited once in the outer loop, evaluating all snapshots at once.
+      Mesh face transformations are shared objects, thus this loop is not threaded.
+   */
+   for (int e = e_begin, eidx = 0; e < e_end; e++, eidx++)
    {
-      // NOTE(kevin): have to copy the vector since libROM matrix is row-major.
-      for (int k = 0; k < fes->GetTrueVSize(); ++k)
-         v_i[k] = snapshots(k, i);
-
-      for (int e = elem_offsets[rank], eidx = 0; e < elem_offsets[rank+1]; e++, eidx++)
-      {
-         const int bdr_attr = mesh->GetBdrAttribute(bidxs[e]);
-         tr = mesh->GetBdrFaceTransformations(bidxs[e]);
-         assert(tr != NULL);
-         assert(bdr_attr_marker[bdr_attr-1] != 0);
+      const int bdr_attr = mesh->GetBdrAttribute(bidxs[e]);
+      tr = mesh->GetBdrFaceTransformations(bidxs[e]);
+      assert(tr != NULL);
+      assert(bdr_attr_marker[bdr_attr-1] != 0);
 
-         fes->GetElementVDofs(tr->Elem1No, vdofs);
+      fes->GetElementVDofs(tr->Elem1No, vdofs);
 
-         v_i.GetSubVector(vdofs, el_x);
+      fe1 = fes->GetFE(tr->Elem1No);
+      // The fe2 object is really a dummy and not used on the boundaries,
+      // but we can't dereference a NULL pointer, and we don't want to
+      // actually make a fake element.
+      fe2 = fe1;
 
-         fe1 = fes->GetFE(tr->Elem1No);
-         // The fe2 object is really a dummy and not used on the boundaries,
-         // but we can't dereference a NULL pointer, and we don't want to
-         // actually make a fake element.
-         fe2 = fe1;
+      /* face restriction of all snapshots and basis vectors, once per face. */
+      GetSnapshotElementBlock(snapshots, vdofs, el_x);
+      GetBasisElementBlock(*basis, vdofs, el_tr);
 
-         const int nd = fe1->GetDof();
-         el_quad.SetSize(nd * vdim, nqe);
-         for (int i = 0; i < ir->GetNPoints(); i++)
-         {
-            Vector EQ(el_quad.GetColumn(i), nd * vdim);
-
-            const IntegrationPoint &ip = ir->IntPoint(i);
-            nlfi->AssembleQuadratureVector(*fe1, *fe2, *tr, ip, 1.0, el_x, EQ);
-         }
-
-         for (int j = 0; j < NB; ++j)
-         {
-            Vector v_j(basis->GetColumn(j), fes->GetVSize());
-            v_j.GetSubVector(vdofs, el_tr);
-
-            el_quad.MultTranspose(el_tr, r);
-
-            for (int m = 0; m < nqe; ++m)
-               Gt(m + (eidx * nqe), j + (i * NB)) = r[m];
-         }  // for (int j = 0; j < NB; ++j)
-      }  // for (int e = 0; e < ne; ++e)
+      for (int m = 0; m < nqe; ++m)
+      {
+         nlfi->AssembleQuadratureVectors(*fe1, *fe2, *tr, ir->IntPoint(m), 1.0, el_x, el_quad);
 
-      // if (precondition)
-      // {
-         // // Preconditioning is done by (V^T M(p_i) V)^{-1} (of size NB x NB).
-         // PreconditionNNLS(fespace_R, new VectorFEMassIntegrator(a_coeff), BR, i, Gt);
-      // }
-   }  // for (int i = 0; i < nsnap; ++i)
+         // r(j, i) = G(j + (i*NB), (eidx*nqe) + m), i.e. the row (eidx*nqe) + m of Gt.
+         MultAtB(el_tr, el_quad, r);
+         std::copy(r.Data(), r.Data() + NB * nsnap, Gt.getData() + static_cast<size_t>(m + (eidx * nqe)) * Gt.numColumns());
+      }  // for (int m = 0; m < nqe; ++m)
+   }  // for (int e = e_begin; e < e_end; e++)
 
    /* Fill out FOM quadrature weights */
    Array<double> const& w_el = ir->GetWeights();
-   CAROM::Vector w(ne * nqe, true);
+   CAROM::Vector w(ne * nqe, Gt.distributed());
    for (int i = 0; i < ne; ++i)
       for (int j = 0; j < nqe; ++j)
          w(j + (i * nqe)) = w_el[j];
@@ -1373,23 +1608,24 @@ void ROMNonlinearForm::PrecomputeDomainEQPSample(
    fe->CalcShape(ip, shape);
    fe->CalcPhysDShape(*T, dshape);
 
-   Vector basis_i;
-   DenseMatrix *vec1s = new DenseMatrix(dim, nbasis);
-   eqp_sample.dshape1.SetSize(0);
+   // coefficients are written into the packed buffer of the EQPElement.
+   assert(eqp_sample.weight && eqp_sample.dshape1);
+   assert((eqp_sample.shape1.NumRows() == dim) && (eqp_sample.shape1.NumCols() == nbasis));
+   *eqp_sample.weight = eqp_sample.info.qw * T->Weight();
+
+   Vector basis_i, vec1;
+   DenseMatrix gradEF1;
    for (int i = 0; i < nbasis; i++)
    {
       GetBasisElement(basis, i, vdofs, basis_i, doftrans);
       EF.UseExternalData(basis_i.GetData(), nd, dim);
 
-      Vector vec1;
-      vec1s->GetColumnReference(i, vec1);
+      eqp_sample.shape1.GetColumnReference(i, vec1);
       EF.MultTranspose(shape, vec1);
 
-      DenseMatrix *gradEF1 = new DenseMatrix(dim);
-      MultAtB(EF, dshape, *gradEF1);
-      eqp_sample.dshape1.Append(gradEF1);
+      gradEF1.UseExternalData(eqp_sample.dshape1 + i * dim * dim, dim, dim);
+      MultAtB(EF, dshape, gradEF1);
    }
-   eqp_sample.shape1 = vec1s;
 }
 
 void ROMNonlinearForm::PrecomputeFaceEQPSample(
@@ -1432,11 +1668,13 @@ void ROMNonlinearForm::PrecomputeFaceEQPSample(
       fe2->CalcShape(eip2, shape2);
    }
 
-   Vector basis_i;
-   DenseMatrix *vec1s, *vec2s;
-   vec1s = new DenseMatrix(dim, nbasis);
-   if (el2) vec2s = new DenseMatrix(dim, nbasis);
+   // coefficients are written into the packed buffer of the EQPElement.
+   assert(eqp_sample.weight);
+   assert((eqp_sample.shape1.NumRows() == dim) && (eqp_sample.shape1.NumCols() == nbasis));
+   if (el2) assert(eqp_sample.shape2.NumCols() == nbasis);
+   *eqp_sample.weight = eqp_sample.info.qw;
 
+   Vector basis_i;
    Vector vec1, vec2;
    DenseMatrix elv1, elv2;
    for (int i = 0; i < nbasis; i++)
@@ -1445,19 +1683,16 @@ void ROMNonlinearForm::PrecomputeFaceEQPSample(
       elv1.UseExternalData(basis_i.GetData(), ndofs1, dim);
       if (el2) elv2.UseExternalData(basis_i.GetData() + ndofs1 * dim, ndofs2, dim);
 
-      vec1s->GetColumnReference(i, vec1);
+      eqp_sample.shape1.GetColumnReference(i, vec1);
       elv1.MultTranspose(shape1, vec1);
 
       if (el2)
       {
-         vec2s->GetColumnReference(i, vec2);
+         eqp_sample.shape2.GetColumnReference(i, vec2);
          elv2.MultTranspose(shape2, vec2);
       }
    }
 
-   eqp_sample.shape1 = vec1s;
-   if (el2) eqp_sample.shape2 = vec2s;
-
    // TODO(kevin): compute dshape1 and dshape2 as well.
 }
 
@@ -6,6 +6,10 @@
 #include "hdf5_utils.hpp"
 #include "etc.hpp"
 #include "utils/mpi_utils.h"  // this is from libROM/utils.
+#include <algorithm>
+#include <set>
+#include <tuple>
+#include <sstream>
 
 using namespace mfem;
 using namespace std;
@@ -24,11 +28,118 @@ bool operator<(const PortTag &tag1, const PortTag &tag2)
    return (tag1.Attr2 == tag2.Attr2) ? false : (tag1.Attr2 < tag2.Attr2);
 }
 
+/*
+   SnapshotStream
+*/
+
+SnapshotStream::SnapshotStream(const std::string &prefix_, const int &rank, const int &nrow_)
+   : prefix(prefix_), nrow(nrow_)
+{
+   file_id = H5Fcreate(GetFilename(prefix, rank).c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   dset_id = hdf5_utils::CreateExtendibleDataset(file_id, "snapshot", nrow);
+}
+
+void SnapshotStream::Append(const Vector &snapshot, const int &sample)
+{
+   assert(dset_id >= 0);
+   assert(snapshot.Size() == nrow);
+   hdf5_utils::AppendColumn(dset_id, nrow, ncol, snapshot.Read());
+   sample_idxs.Append(sample);
+   assert(sample_idxs.Size() == ncol);
+}
+
+void SnapshotStream::Close()
+{
+   herr_t errf = 0;
+   if (file_id >= 0)
+      hdf5_utils::WriteDataset(file_id, "sample_index", sample_idxs);
+   if (dset_id >= 0)
+   {
+      errf = H5Dclose(dset_id);
+      assert(errf >= 0);
+      dset_id = -1;
+   }
+   if (file_id >= 0)
+   {
+      errf = H5Fclose(file_id);
+      assert(errf >= 0);
+      file_id = -1;
+   }
+}
+
+void SnapshotStream::WriteManifest(const std::string &prefix, const Array<int> &ranks)
+{
+   hid_t file_id;
+   herr_t errf = 0;
+   file_id = H5Fcreate(GetManifestFilename(prefix).c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   hdf5_utils::WriteAttribute(file_id, "number_of_files", ranks.Size());
+   hdf5_utils::WriteDataset(file_id, "ranks", ranks);
+
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+}
+
+void SnapshotStream::ReadManifest(const std::string &prefix, Array<int> &ranks)
+{
+   hid_t file_id;
+   herr_t errf = 0;
+   file_id = H5Fopen(GetManifestFilename(prefix).c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   int num_files = -1;
+   hdf5_utils::ReadAttribute(file_id, "number_of_files", num_files);
+   hdf5_utils::ReadDataset(file_id, "ranks", ranks);
+   if (ranks.Size() != num_files)
+      mfem_error("SnapshotStream::ReadManifest- inconsistent manifest!\n");
+
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   for (int k = 0; k < ranks.Size(); k++)
+      if (!FileExists(GetFilename(prefix, ranks[k])))
+      {
+         printf("missing stream file: %s\n", GetFilename(prefix, ranks[k]).c_str());
+         mfem_error("SnapshotStream::ReadManifest- stream file listed in the manifest does not exist!\n");
+      }
+}
+
+void SnapshotStream::OrderBySample(const std::vector<Array<int>> &samples, Array<int> &src_file, Array<int> &src_col)
+{
+   std::vector<std::tuple<int, int, int>> cols;
+   for (int k = 0; k < samples.size(); k++)
+      for (int c = 0; c < samples[k].Size(); c++)
+         cols.push_back(std::make_tuple(samples[k][c], k, c));
+   std::sort(cols.begin(), cols.end());
+
+   src_file.SetSize(cols.size());
+   src_col.SetSize(cols.size());
+   for (int g = 0; g < cols.size(); g++)
+   {
+      src_file[g] = std::get<1>(cols[g]);
+      src_col[g] = std::get<2>(cols[g]);
+   }
+}
+
+/*
+   SampleGenerator
+*/
+
 SampleGenerator::SampleGenerator(MPI_Comm comm)
+   : sample_comm(comm)
 {
    MPI_Comm_size(comm, &num_procs);
    MPI_Comm_rank(comm, &proc_rank);
 
+   std::string schedule_str = config.GetOption<std::string>("sample_generation/scheduler", "dynamic");
+   if (schedule_str == "static")          schedule_type = STATIC_SCHEDULE;
+   else if (schedule_str == "dynamic")    schedule_type = DYNAMIC_SCHEDULE;
+   else
+      mfem_error("SampleGenerator: unknown sample_generation/scheduler!\n");
+
    sample_dir = config.GetOption<std::string>("sample_generation/file_path/directory", ".");
    std::string problem_name = config.GetOption<std::string>("parameterized_problem/name", "sample");
    sample_prefix = config.GetOption<std::string>("sample_generation/file_path/prefix", problem_name);
@@ -65,6 +176,11 @@ SampleGenerator::SampleGenerator(MPI_Comm comm)
    snapshot_generators.SetSize(0);
    snapshot_options.SetSize(0);
 
+   // Streaming snapshots for out-of-core sample generation.
+   stream_snapshots = config.GetOption<bool>("sample_generation/stream_snapshots", false);
+   collect_block_size = config.GetOption<int>("sample_collection/block_size", 32);
+   assert(collect_block_size > 0);
+
    // BasisGenerator options.
    update_right_SV = config.GetOption<bool>("basis/svd/update_right_sv", false);
    save_sv = config.GetOption<bool>("basis/svd/save_spectrum", false);
@@ -75,7 +191,10 @@ SampleGenerator::~SampleGenerator()
    DeletePointers(params);
    DeletePointers(snapshot_generators);
    DeletePointers(snapshot_options);
+   DeletePointers(snapshot_streams);
    DeletePointers(port_colidxs);
+   if (queue_win != MPI_WIN_NULL)
+      MPI_Win_free(&queue_win);
 }
 
 void SampleGenerator::SetParamSpaceSizes()
@@ -120,6 +239,102 @@ void SampleGenerator::DistributeSamples()
    assert(sample_offsets[num_procs] == total_samples);
 }
 
+void SampleGenerator::StartSampleQueue()
+{
+   assert(sample_offsets.Size() == num_procs + 1);
+   assert(queue_win == MPI_WIN_NULL);
+
+   num_taken_samples = 0;
+   if ((schedule_type == STATIC_SCHEDULE) || (num_procs == 1))
+      queue_next = sample_offsets[proc_rank];
+   else
+   {
+      queue_next = proc_rank;
+
+      /* the first num_procs samples are already taken, one for each process. */
+      MPI_Aint win_size = (proc_rank == 0) ? sizeof(int) : 0;
+      MPI_Win_allocate(win_size, sizeof(int), MPI_INFO_NULL, sample_comm, &queue_counter, &queue_win);
+      if (proc_rank == 0)
+      {
+         MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, queue_win);
+         *queue_counter = num_procs;
+         MPI_Win_unlock(0, queue_win);
+      }
+   }
+
+   MPI_Barrier(sample_comm);
+   queue_start_time = MPI_Wtime();
+}
+
+const int SampleGenerator::GetNextSample()
+{
+   int sample = -1;
+   if (queue_win == MPI_WIN_NULL)
+   {
+      // static block.
+      if (queue_next < sample_offsets[proc_rank+1])
+         sample = queue_next++;
+   }
+   else if (queue_next >= 0)
+   {
+      // the first sample of this process.
+      sample = queue_next;
+      queue_next = -1;
+   }
+   else
+   {
+      const int one = 1;
+      MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, queue_win);
+      MPI_Fetch_and_op(&one, &sample, MPI_INT, 0, 0, MPI_SUM, queue_win);
+      MPI_Win_unlock(0, queue_win);
+   }
+
+   if ((sample < 0) || (sample >= total_samples))
+      return -1;
+
+   num_taken_samples++;
+   current_sample = sample;
+   return sample;
+}
+
+void SampleGenerator::FinishSampleQueue(const double &busy_time)
+{
+   const double wall_time = MPI_Wtime() - queue_start_time;
+
+   if (queue_win != MPI_WIN_NULL)
+   {
+      MPI_Win_free(&queue_win);
+      queue_counter = NULL;
+   }
+
+   /* number of samples, busy time, wall time of each process. */
+   double stat[3] = {static_cast<double>(num_taken_samples), busy_time, wall_time};
+   Array<double> stats((proc_rank == 0) ? 3 * num_procs : 0);
+   MPI_Gather(stat, 3, MPI_DOUBLE, stats.GetData(), 3, MPI_DOUBLE, 0, sample_comm);
+
+   if (proc_rank != 0) return;
+
+   // every process waits until the last one finishes.
+   double makespan = 0.0;
+   for (int r = 0; r < num_procs; r++)
+      makespan = max(makespan, stats[3 * r + 2]);
+
+   double total_busy = 0.0;
+   printf("==========  SampleGenerator Schedule (%s)  ==========\n",
+          (schedule_type == STATIC_SCHEDULE) ? "static" : "dynamic");
+   printf("%6s\t%8s\t%10s\t%10s\t%11s\n", "rank", "samples", "busy (s)", "idle (s)", "utilization");
+   for (int r = 0; r < num_procs; r++)
+   {
+      const double busy = stats[3 * r + 1];
+      total_busy += busy;
+      printf("%6d\t%8d\t%.3E\t%.3E\t%10.1f%%\n", r, static_cast<int>(stats[3 * r]), busy,
+             makespan - busy, (makespan > 0.0) ? 100.0 * busy / makespan : 100.0);
+   }
+   printf("makespan: %.3E s, overall utilization: %.1f%%\n", makespan,
+          (makespan > 0.0) ? 100.0 * total_busy / (num_procs * makespan) : 100.0);
+   printf("=====================================================\n");
+}
+
 const int SampleGenerator::GetSampleIndex(const Array<int> &index)
 {
    assert(index.Size() == num_sampling_params);
@@ -155,14 +370,14 @@ const Array<int> SampleGenerator::GetSampleIndex(const int &index)
    return nested_idx;
 }
 
-void SampleGenerator::SetSampleParams(const int &index)
+void SampleGenerator::SetSampleParams(const int &index, InputParser &parser)
 {
    assert(params.Size() == num_sampling_params);
 
    const Array<int> nested_idx = GetSampleIndex(index);
 
    for (int p = 0; p < num_sampling_params; p++)
-      params[p]->SetParam(nested_idx[p], config);
+      params[p]->SetParam(nested_idx[p], parser);
 }
 
 const std::string SampleGenerator::GetSamplePath(const int &idx, const std::string& prefix)
@@ -189,17 +404,25 @@ void SampleGenerator::SaveSnapshot(BlockVector *U_snapshots, std::vector<BasisTa
       if (!basis_tag2idx.count(snapshot_basis_tags[s]))
       {
          const int fom_vdofs = U_snapshots->BlockSize(s);
-         AddSnapshotGenerator(fom_vdofs, GetSamplePrefix(), snapshot_basis_tags[s]);
+         if (stream_snapshots)
+            AddSnapshotStream(fom_vdofs, GetSamplePrefix(), snapshot_basis_tags[s]);
+         else
+            AddSnapshotGenerator(fom_vdofs, GetSamplePrefix(), snapshot_basis_tags[s]);
       }
 
       /* add the snapshot into the corresponding snapshot generator */
       int index = basis_tag2idx[snapshot_basis_tags[s]];
-      bool addSample = snapshot_generators[index]->takeSample(U_snapshots->GetBlock(s).GetData());
-      assert(addSample);
+      if (snapshot_streams[index])
+         snapshot_streams[index]->Append(U_snapshots->GetBlock(s), current_sample);
+      else
+      {
+         bool addSample = snapshot_generators[index]->takeSample(U_snapshots->GetBlock(s).GetData());
+         assert(addSample);
+      }
 
       /* save the column index in each snapshot matrix, for port data. */
       /* 0-based index */
-      col_idxs[s] = snapshot_generators[index]->getNumSamples() - 1;
+      col_idxs[s] = GetNumSnapshots(index) - 1;
    }
 }
 
@@ -263,72 +486,287 @@ void SampleGenerator::SaveSnapshotPorts(TopologyHandler *topol_handler, const Ar
    }
 }
 
-void SampleGenerator::AddSnapshotGenerator(const int &fom_vdofs, const std::string &prefix, const BasisTag &basis_tag)
+void SampleGenerator::AddSnapshotGenerator(const int &fom_vdofs, const std::string &prefix, const BasisTag &basis_tag,
+                                           const bool svd_options)
 {
    const std::string filename = GetBaseFilename(prefix, basis_tag);
 
    snapshot_options.Append(new CAROM::Options(fom_vdofs, max_num_snapshots, 1, update_right_SV));
    snapshot_options.Last()->static_svd_preserve_snapshot = true;
-   snapshot_generators.Append(new CAROM::BasisGenerator(*(snapshot_options.Last()), incremental, filename, CAROM::Database::formats::HDF5_MPIO));
+   bool incremental_svd = incremental;
+   if (svd_options)
+      SetSVDOptions(basis_tag, *(snapshot_options.Last()), incremental_svd);
+
+   snapshot_generators.Append(new CAROM::BasisGenerator(*(snapshot_options.Last()), incremental_svd, filename, CAROM::Database::formats::HDF5_MPIO));
+   snapshot_streams.Append(NULL);
+   incremental_svds.Append(incremental_svd);
 
    basis_tag2idx[basis_tag] = basis_tags.size();
    basis_tags.push_back(basis_tag);
 
    int size = snapshot_options.Size();
    assert(snapshot_generators.Size() == size);
+   assert(snapshot_streams.Size() == size);
+   assert(basis_tag2idx.size() == size);
+   assert(basis_tags.size() == size);
+}
+
+void SampleGenerator::AddSnapshotStream(const int &fom_vdofs, const std::string &prefix, const BasisTag &basis_tag)
+{
+   // same file name as the snapshot file of BasisGenerator, with the stream suffix.
+   const std::string filename = GetBaseFilename(prefix, basis_tag) + "_snapshot";
+
+   snapshot_options.Append(NULL);
+   snapshot_generators.Append(NULL);
+   snapshot_streams.Append(new SnapshotStream(filename, proc_rank, fom_vdofs));
+   incremental_svds.Append(false);
+
+   basis_tag2idx[basis_tag] = basis_tags.size();
+   basis_tags.push_back(basis_tag);
+
+   int size = snapshot_streams.Size();
+   assert(snapshot_options.Size() == size);
+   assert(snapshot_generators.Size() == size);
    assert(basis_tag2idx.size() == size);
    assert(basis_tags.size() == size);
 }
 
+const int SampleGenerator::GetNumSnapshots(const int &index)
+{
+   assert((index >= 0) && (index < basis_tags.size()));
+   if (snapshot_streams[index])
+      return snapshot_streams[index]->GetNumSnapshots();
+
+   assert(snapshot_generators[index]);
+   return snapshot_generators[index]->getNumSamples();
+}
+
 void SampleGenerator::WriteSnapshots()
 {
-   assert(snapshot_generators.Size() > 0);
+   // with the dynamic scheduler, a process may have taken no sample.
+   assert((snapshot_generators.Size() > 0) || stream_snapshots);
    for (int s = 0; s < snapshot_generators.Size(); s++)
    {
+      if (snapshot_streams[s])
+      {
+         // snapshots are already in the file.
+         snapshot_streams[s]->Close();
+         continue;
+      }
+
       assert(snapshot_generators[s]);
       snapshot_generators[s]->writeSnapshot();
    }
+
+   if (stream_snapshots)
+      WriteStreamManifests();
+}
+
+void SampleGenerator::WriteStreamManifests()
+{
+   /* gather the stream prefixes of all processes, separated by newlines. */
+   std::string local_list;
+   for (int s = 0; s < snapshot_streams.Size(); s++)
+      if (snapshot_streams[s])
+         local_list += snapshot_streams[s]->GetPrefix() + "\n";
+
+   std::vector<std::string> rank_lists;
+   GatherStrings(local_list, rank_lists);
+
+   if (proc_rank == 0)
+   {
+      std::map<std::string, Array<int>> stream_ranks;
+      for (int r = 0; r < num_procs; r++)
+      {
+         std::istringstream rank_list(rank_lists[r]);
+         std::string prefix;
+         while (std::getline(rank_list, prefix))
+            stream_ranks[prefix].Append(r);
+      }
+
+      for (std::map<std::string, Array<int>>::iterator it = stream_ranks.begin(); it != stream_ranks.end(); it++)
+         SnapshotStream::WriteManifest(it->first, it->second);
+   }
+
+   // manifests are complete before any process reads them.
+   MPI_Barrier(sample_comm);
+}
+
+void SampleGenerator::GatherStrings(const std::string &local, std::vector<std::string> &lists)
+{
+   int local_len = local.size();
+   Array<int> lens(num_procs), displs(num_procs + 1);
+   MPI_Gather(&local_len, 1, MPI_INT, lens.GetData(), 1, MPI_INT, 0, sample_comm);
+
+   std::vector<char> all_list;
+   if (proc_rank == 0)
+   {
+      displs[0] = 0;
+      for (int r = 0; r < num_procs; r++)
+         displs[r+1] = displs[r] + lens[r];
+      all_list.resize(displs[num_procs]);
+   }
+   MPI_Gatherv(local.data(), local_len, MPI_CHAR, all_list.data(), lens.GetData(),
+               displs.GetData(), MPI_CHAR, 0, sample_comm);
+
+   lists.clear();
+   if (proc_rank != 0) return;
+
+   for (int r = 0; r < num_procs; r++)
+      lists.push_back(std::string(all_list.data() + displs[r], lens[r]));
 }
 
 void SampleGenerator::WriteSnapshotPorts()
 {
-   const std::string filename = GetSamplePrefix() + ".port.h5";
+   /*
+      Gather the snapshot ports of all processes, one tab-separated record per line:
+         - B, comp, var: basis tag.
+         - C, comp, sample indices: sample index of each column of comp.
+           Streamed columns are collected in the sample order, while the other columns keep their order.
+         - P, Mesh1, Mesh2, Attr1, Attr2, col1, col2: a column pair of a port, local to the process.
+   */
+   std::ostringstream local_list;
+   std::set<std::string> comps;
+   for (int b = 0; b < basis_tags.size(); b++)
+   {
+      local_list << "B\t" << basis_tags[b].comp << "\t" << basis_tags[b].var << "\n";
 
-   hid_t file_id;
-   herr_t errf = 0;
-   file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-   assert(file_id >= 0);
+      // all variables of a component have the same columns.
+      if (comps.count(basis_tags[b].comp)) continue;
+      comps.insert(basis_tags[b].comp);
 
-   /* this is the path to all associated snapshot matrices */
-   char sample_path[PATH_MAX];
-   realpath(GetSamplePrefix().c_str(), sample_path);
-   hdf5_utils::WriteAttribute(file_id, "sample_prefix", std::string(sample_path));
-   
-   /* write port information */
-   hdf5_utils::WriteAttribute(file_id, "number_of_ports", (int) port_tags.size());
+      local_list << "C\t" << basis_tags[b].comp;
+      for (int c = 0; c < GetNumSnapshots(b); c++)
+         local_list << "\t" << ((snapshot_streams[b]) ? snapshot_streams[b]->GetSampleIndices()[c] : -1);
+      local_list << "\n";
+   }
    for (int p = 0; p < port_tags.size(); p++)
+      for (int r = 0; r < port_colidxs[p]->NumRows(); r++)
+         local_list << "P\t" << port_tags[p].Mesh1 << "\t" << port_tags[p].Mesh2 << "\t"
+                    << port_tags[p].Attr1 << "\t" << port_tags[p].Attr2 << "\t"
+                    << (*port_colidxs[p])(r, 0) << "\t" << (*port_colidxs[p])(r, 1) << "\n";
+
+   std::vector<std::string> rank_lists;
+   GatherStrings(local_list.str(), rank_lists);
+
+   if (proc_rank == 0)
    {
-      hid_t grp_id;
-      grp_id = H5Gcreate(file_id, std::to_string(p).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-      assert(grp_id >= 0);
+      std::set<BasisTag> all_tags;
+      std::map<std::string, std::vector<Array<int>>> comp_samples;
+      // column pairs of each port tag, with the process of the pair.
+      std::map<PortTag, std::vector<std::tuple<int, int, int>>> port_cols;
 
-      hdf5_utils::WriteAttribute(grp_id, "Mesh1", port_tags[p].Mesh1);
-      hdf5_utils::WriteAttribute(grp_id, "Mesh2", port_tags[p].Mesh2);
-      hdf5_utils::WriteAttribute(grp_id, "Attr1", port_tags[p].Attr1);
-      hdf5_utils::WriteAttribute(grp_id, "Attr2", port_tags[p].Attr2);
-      hdf5_utils::WriteDataset(grp_id, "col_idxs", *(port_colidxs[p]));
+      for (int r = 0; r < num_procs; r++)
+      {
+         std::istringstream rank_list(rank_lists[r]);
+         std::string line, item;
+         while (std::getline(rank_list, line))
+         {
+            if (line.empty()) continue;
+            std::vector<std::string> items;
+            std::istringstream record(line);
+            while (std::getline(record, item, '\t'))
+               items.push_back(item);
+            // an empty variable name is the last item.
+            if (line.back() == '\t')
+               items.push_back("");
+
+            if (items[0] == "B")
+               all_tags.insert(BasisTag(items[1], items[2]));
+            else if (items[0] == "C")
+            {
+               std::vector<Array<int>> &samples = comp_samples[items[1]];
+               samples.resize(num_procs);
+               for (int c = 2; c < items.size(); c++)
+                  samples[r].Append(std::stoi(items[c]));
+            }
+            else if (items[0] == "P")
+            {
+               PortTag tag = {.Mesh1 = items[1], .Mesh2 = items[2],
+                              .Attr1 = std::stoi(items[3]), .Attr2 = std::stoi(items[4])};
+               port_cols[tag].push_back(std::make_tuple(r, std::stoi(items[5]), std::stoi(items[6])));
+            }
+            else
+               mfem_error("SampleGenerator::WriteSnapshotPorts- unknown record!\n");
+         }
+      }
 
-      errf = H5Gclose(grp_id);
+      /* global column of each local column of each process, per component. */
+      std::map<std::string, std::vector<Array<int>>> global_cols;
+      for (std::map<std::string, std::vector<Array<int>>>::iterator it = comp_samples.begin(); it != comp_samples.end(); it++)
+      {
+         Array<int> src_rank, src_col;
+         SnapshotStream::OrderBySample(it->second, src_rank, src_col);
+
+         std::vector<Array<int>> &cols = global_cols[it->first];
+         cols.resize(num_procs);
+         for (int r = 0; r < num_procs; r++)
+            cols[r].SetSize(it->second[r].Size());
+         for (int g = 0; g < src_rank.Size(); g++)
+            cols[src_rank[g]][src_col[g]] = g;
+      }
+
+      const std::string filename = GetSamplePrefix() + ".port.h5";
+
+      hid_t file_id;
+      herr_t errf = 0;
+      file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+      assert(file_id >= 0);
+
+      /* this is the path to all associated snapshot matrices */
+      char sample_path[PATH_MAX];
+      realpath(GetSamplePrefix().c_str(), sample_path);
+      hdf5_utils::WriteAttribute(file_id, "sample_prefix", std::string(sample_path));
+
+      /* write port information */
+      hdf5_utils::WriteAttribute(file_id, "number_of_ports", (int) port_cols.size());
+      int p = 0;
+      for (std::map<PortTag, std::vector<std::tuple<int, int, int>>>::iterator it = port_cols.begin(); it != port_cols.end(); it++, p++)
+      {
+         const PortTag &tag = it->first;
+         std::vector<std::pair<int, int>> pairs;
+         for (int k = 0; k < it->second.size(); k++)
+         {
+            const int r = std::get<0>(it->second[k]);
+            pairs.push_back(std::make_pair(global_cols[tag.Mesh1][r][std::get<1>(it->second[k])],
+                                           global_cols[tag.Mesh2][r][std::get<2>(it->second[k])]));
+         }
+         // pairs in the sample order, regardless of the process that solved them.
+         std::sort(pairs.begin(), pairs.end());
+
+         Array2D<int> col_idxs(pairs.size(), 2);
+         for (int k = 0; k < pairs.size(); k++)
+         {
+            col_idxs(k, 0) = pairs[k].first;
+            col_idxs(k, 1) = pairs[k].second;
+         }
+
+         hid_t grp_id;
+         grp_id = H5Gcreate(file_id, std::to_string(p).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+         assert(grp_id >= 0);
+
+         hdf5_utils::WriteAttribute(grp_id, "Mesh1", tag.Mesh1);
+         hdf5_utils::WriteAttribute(grp_id, "Mesh2", tag.Mesh2);
+         hdf5_utils::WriteAttribute(grp_id, "Attr1", tag.Attr1);
+         hdf5_utils::WriteAttribute(grp_id, "Attr2", tag.Attr2);
+         hdf5_utils::WriteDataset(grp_id, "col_idxs", col_idxs);
+
+         errf = H5Gclose(grp_id);
+         assert(errf >= 0);
+      }
+
+      /* write basis tag list */
+      hdf5_utils::WriteAttribute(file_id, "number_of_basistags", (int) all_tags.size());
+      int b = 0;
+      for (std::set<BasisTag>::iterator it = all_tags.begin(); it != all_tags.end(); it++, b++)
+         hdf5_utils::WriteAttribute(file_id, std::string("basistag" + std::to_string(b)).c_str(), *it);
+
+      errf = H5Fclose(file_id);
       assert(errf >= 0);
    }
 
-   /* write basis tag list */
-   hdf5_utils::WriteAttribute(file_id, "number_of_basistags", (int) basis_tags.size());
-   for (int b = 0; b < basis_tags.size(); b++)
-      hdf5_utils::WriteAttribute(file_id, std::string("basistag" + std::to_string(b)).c_str(), basis_tags[b]);
-
-   errf = H5Fclose(file_id);
-   assert(errf >= 0);
+   // the port file is complete before any process reads it.
+   MPI_Barrier(sample_comm);
    return;
 }
 
@@ -350,6 +788,10 @@ std::shared_ptr<const CAROM::Matrix> SampleGenerator::LookUpSnapshot(const Basis
       printf("basis tag: %s\n", basis_tag.print().c_str());
       mfem_error("SampleGenerator::LookUpSnapshot- basis tag does not exist in snapshot list!\n");
    }
+   if (snapshot_streams[idx])
+      mfem_error("SampleGenerator::LookUpSnapshot- streamed snapshots must be collected first!\n");
+   if (incremental_svds[idx])
+      mfem_error("SampleGenerator::LookUpSnapshot- incremental SVD does not keep the snapshot matrix!\n");
 
    return snapshot_generators[idx]->getSnapshotMatrix();
 }
@@ -379,7 +821,7 @@ void SampleGenerator::ReportStatus(const int &sample_idx)
    printf("Basis tags: %ld\n", basis_tags.size());
    printf("%20.20s\t# of snapshots\n", "Basis tags");
    for (int k = 0; k < basis_tags.size(); k++)
-      printf("%20.20s\t%d\n", basis_tags[k].print().c_str(), snapshot_generators[k]->getNumSamples());
+      printf("%20.20s\t%d\n", basis_tags[k].print().c_str(), GetNumSnapshots(k));
    printf("==============================================\n");
 }
 
@@ -400,12 +842,82 @@ void SampleGenerator::CollectSnapshotsByBasis(const std::string &basis_prefix,
 
    /* if the tag was never seen before, append a new snapshot generator */
    if (!basis_tag2idx.count(basis_tag))
-      AddSnapshotGenerator(local_num_vdofs, basis_prefix, basis_tag);
+      AddSnapshotGenerator(local_num_vdofs, basis_prefix, basis_tag, true);
    int index = basis_tag2idx[basis_tag];
    CAROM::BasisGenerator *basis_generator = snapshot_generators[index];
+   if (!basis_generator)
+      mfem_error("SampleGenerator::CollectSnapshotsByBasis- cannot collect into a streamed basis tag!\n");
 
    for (int s = 0; s < file_list.size(); s++)
-      basis_generator->loadSamples(file_list[s], "snapshot", 1e9, CAROM::Database::formats::HDF5_MPIO);
+   {
+      if (FileExists(SnapshotStream::GetManifestFilename(file_list[s])))
+         LoadSnapshotStreams(file_list[s], local_num_vdofs, basis_generator);
+      else
+         basis_generator->loadSamples(file_list[s], "snapshot", 1e9, CAROM::Database::formats::HDF5_MPIO);
+   }
+}
+
+void SampleGenerator::LoadSnapshotStreams(const std::string &filename, const int &local_num_vdofs,
+                                          CAROM::BasisGenerator *basis_generator)
+{
+   assert(basis_generator);
+
+   /* row offset of this process in the distributed snapshot matrix. */
+   int row_offset = 0;
+   MPI_Exscan(&local_num_vdofs, &row_offset, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+   if (proc_rank == 0) row_offset = 0;
+
+   /* streamed files are written per process of the sample generation, as listed in the manifest. */
+   Array<int> ranks;
+   SnapshotStream::ReadManifest(filename, ranks);
+
+   std::vector<hid_t> file_ids(ranks.Size());
+   std::vector<Array<int>> samples(ranks.Size());
+   for (int k = 0; k < ranks.Size(); k++)
+   {
+      file_ids[k] = H5Fopen(SnapshotStream::GetFilename(filename, ranks[k]).c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      assert(file_ids[k] >= 0);
+
+      int nrow, ncol;
+      hdf5_utils::GetMatrixDatasetSize(file_ids[k], "snapshot", nrow, ncol);
+      assert(row_offset + local_num_vdofs <= nrow);
+
+      hdf5_utils::ReadDataset(file_ids[k], "sample_index", samples[k]);
+      if (samples[k].Size() != ncol)
+         mfem_error("SampleGenerator::LoadSnapshotStreams- sample indices do not match the snapshots!\n");
+   }
+
+   /* columns are taken in the sample order, so that the snapshot matrix does not depend on the scheduling. */
+   Array<int> src_file, src_col;
+   SnapshotStream::OrderBySample(samples, src_file, src_col);
+
+   DenseMatrix block;
+   for (int g = 0; g < src_file.Size(); )
+   {
+      /* consecutive columns of the same file are read in a block. */
+      const int k = src_file[g];
+      int ncol = 1;
+      while ((ncol < collect_block_size) && (g + ncol < src_file.Size()) &&
+             (src_file[g + ncol] == k) && (src_col[g + ncol] == src_col[g] + ncol))
+         ncol++;
+
+      block.SetSize(local_num_vdofs, ncol);
+      hdf5_utils::ReadDatasetBlock(file_ids[k], "snapshot", row_offset, src_col[g], block);
+
+      for (int c = 0; c < ncol; c++)
+      {
+         bool addSample = basis_generator->takeSample(block.GetColumn(c));
+         assert(addSample);
+      }
+      g += ncol;
+   }
+
+   herr_t errf = 0;
+   for (int k = 0; k < ranks.Size(); k++)
+   {
+      errf = H5Fclose(file_ids[k]);
+      assert(errf >= 0);
+   }
 }
 
 void SampleGenerator::CollectSnapshotsByPort(
@@ -488,41 +1000,140 @@ void SampleGenerator::FormReducedBasis(const std::string &basis_prefix)
    assert(snapshot_generators.Size() > 0);
    assert(snapshot_generators.Size() == basis_tags.size());
 
-   const int num_basis_default = config.GetOption<int>("basis/number_of_basis", -1);
    int num_basis;
    std::string basis_name;
+   StopWatch svdTimer;
 
-   // tag-specific optional inputs.
-   YAML::Node basis_list = config.FindNode("basis/tags");
    for (int k = 0; k < snapshot_generators.Size(); k++)
    {
       assert(snapshot_generators[k]);
       assert(snapshot_generators[k]->getNumSamples() > 0);
+      CheckRandomizedSVD(k, basis_prefix);
+
+      svdTimer.Clear();
+      svdTimer.Start();
       snapshot_generators[k]->endSamples();
+      svdTimer.Stop();
+      if (proc_rank == 0)
+         printf("%s: SVD time %.3E seconds.\n", basis_tags[k].print().c_str(), svdTimer.RealTime());
 
-      // if optional inputs are specified, parse them first.
-      if (basis_list)
-      {
-         // Find if additional inputs are specified for basis_tags[p].
-         YAML::Node basis_tag_input = config.LookUpFromDict("name", basis_tags[k].print(), basis_list);
-         
-         // If basis_tags[p] has additional inputs, parse them.
-         // parse tag-specific number of basis.
-         if (basis_tag_input)
-            num_basis = config.GetOptionFromDict<int>("number_of_basis", num_basis_default, basis_tag_input);
-         else
-            num_basis = num_basis_default;
-      }
-      else
-         // if additional inputs are not specified, use default number of basis.
-         num_basis = num_basis_default;
+      if ((proc_rank == 0) && save_sv && (incremental_svds[k] || snapshot_options[k]->randomized))
+         printf("Truncated SVD: energy fraction is relative to the computed singular values only.\n");
 
-      assert(num_basis > 0);
+      num_basis = GetNumBasis(basis_tags[k]);
       basis_name = GetBaseFilename(basis_prefix, basis_tags[k]);
       SaveSV(snapshot_generators[k], basis_name, num_basis);
    }
 }
 
+YAML::Node SampleGenerator::GetBasisTagInput(const BasisTag &basis_tag)
+{
+   YAML::Node basis_list = config.FindNode("basis/tags");
+   if (!basis_list)
+      return YAML::Node();
+
+   // Find if additional inputs are specified for basis_tag.
+   return config.LookUpFromDict("name", basis_tag.print(), basis_list);
+}
+
+const int SampleGenerator::GetNumBasis(const BasisTag &basis_tag)
+{
+   const int num_basis_default = config.GetOption<int>("basis/number_of_basis", -1);
+   int num_basis = num_basis_default;
+
+   // If basis_tag has additional inputs, parse tag-specific number of basis.
+   YAML::Node basis_tag_input = GetBasisTagInput(basis_tag);
+   if (basis_tag_input)
+      num_basis = config.GetOptionFromDict<int>("number_of_basis", num_basis_default, basis_tag_input);
+
+   assert(num_basis > 0);
+   return num_basis;
+}
+
+void SampleGenerator::SetSVDOptions(const BasisTag &basis_tag, CAROM::Options &options, bool &incremental_svd)
+{
+   std::string svd_type = config.GetOption<std::string>("basis/svd/type", "static");
+   int oversampling = config.GetOption<int>("basis/svd/oversampling", 10);
+   int random_seed = config.GetOption<int>("basis/svd/random_seed", 1);
+   double linearity_tol = config.GetOption<double>("basis/svd/linearity_tolerance", 1.0e-7);
+
+   // tag-specific inputs override the default.
+   YAML::Node basis_tag_input = GetBasisTagInput(basis_tag);
+   if (basis_tag_input)
+   {
+      svd_type = config.GetOptionFromDict<std::string>("svd/type", svd_type, basis_tag_input);
+      oversampling = config.GetOptionFromDict<int>("svd/oversampling", oversampling, basis_tag_input);
+      random_seed = config.GetOptionFromDict<int>("svd/random_seed", random_seed, basis_tag_input);
+      linearity_tol = config.GetOptionFromDict<double>("svd/linearity_tolerance", linearity_tol, basis_tag_input);
+   }
+
+   incremental_svd = false;
+   if (svd_type == "static")
+      return;
+
+   /*
+      Both truncated SVDs compute only a part of the spectrum.
+      Keep oversampling modes beyond the number of basis, for the energy fraction diagnostics.
+   */
+   assert(oversampling >= 0);
+   const int max_dim = GetNumBasis(basis_tag) + oversampling;
+
+   if (svd_type == "randomized")
+   {
+      options.setRandomizedSVD(true, max_dim, random_seed);
+   }
+   else if (svd_type == "incremental")
+   {
+      // snapshots are not time-dependent. only the linearity tolerance matters.
+      options.setMaxBasisDimension(max_dim);
+      options.setIncrementalSVD(linearity_tol, 1.0, linearity_tol, 1.0e20, true);
+      incremental_svd = true;
+   }
+   else
+   {
+      printf("SVD type: %s\n", svd_type.c_str());
+      mfem_error("SampleGenerator::SetSVDOptions- unknown SVD type!\n");
+   }
+}
+
+void SampleGenerator::CheckRandomizedSVD(const int &index, const std::string &basis_prefix)
+{
+   CAROM::Options *options = snapshot_options[index];
+   if ((!options) || (!options->randomized))
+      return;
+
+   const int num_samples = snapshot_generators[index]->getNumSamples();
+   if (options->randomized_subspace_dim <= num_samples)
+      return;
+
+   if (proc_rank == 0)
+      printf("%s: randomized SVD dimension %d exceeds the number of snapshots %d.\n",
+             basis_tags[index].print().c_str(), options->randomized_subspace_dim, num_samples);
+   mfem_warning("SampleGenerator::CheckRandomizedSVD- falling back to static SVD!\n");
+
+   CAROM::Options *static_options = new CAROM::Options(options->dim, max_num_snapshots, 1, update_right_SV);
+   static_options->static_svd_preserve_snapshot = true;
+   CAROM::BasisGenerator *static_generator = new CAROM::BasisGenerator(*static_options, false,
+                                                                      GetBaseFilename(basis_prefix, basis_tags[index]),
+                                                                      CAROM::Database::formats::HDF5_MPIO);
+
+   std::shared_ptr<const CAROM::Matrix> snapshots = snapshot_generators[index]->getSnapshotMatrix();
+   assert(snapshots->numColumns() == num_samples);
+   CAROM::Vector snapshot(snapshots->numRows(), snapshots->distributed());
+   for (int c = 0; c < num_samples; c++)
+   {
+      snapshots->getColumn(c, snapshot);
+      bool addSample = static_generator->takeSample(snapshot.getData());
+      assert(addSample);
+   }
+   snapshots.reset();
+
+   delete snapshot_generators[index];
+   delete snapshot_options[index];
+   snapshot_generators[index] = static_generator;
+   snapshot_options[index] = static_options;
+}
+
 const int SampleGenerator::GetDimFromSnapshots(const std::string &filename)
 {
    /*
@@ -533,7 +1144,25 @@ const int SampleGenerator::GetDimFromSnapshots(const std::string &filename)
    int rank;
    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
    Array<int> nrows(1);
-   if (rank == 0)
+   if ((rank == 0) && FileExists(SnapshotStream::GetManifestFilename(filename)))
+   {
+      Array<int> ranks;
+      SnapshotStream::ReadManifest(filename, ranks);
+      const std::string stream_file = SnapshotStream::GetFilename(filename, ranks[0]);
+
+      hid_t file_id;
+      herr_t errf = 0;
+      file_id = H5Fopen(stream_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      assert(file_id >= 0);
+
+      int ncol;
+      hdf5_utils::GetMatrixDatasetSize(file_id, "snapshot", nrows[0], ncol);
+      assert(nrows[0] > 0);
+
+      errf = H5Fclose(file_id);
+      assert(errf >= 0);
+   }
+   else if (rank == 0)
    {
       hid_t file_id;
       herr_t errf = 0;
@@ -593,7 +1222,7 @@ const int SampleGenerator::GetSnapshotOffset(const std::string &comp)
    {
       if (basis_tags[b].comp != comp) continue;
 
-      offset = snapshot_generators[b]->getNumSamples();
+      offset = GetNumSnapshots(b);
 
       if (tmp < 0)
          tmp = offset;
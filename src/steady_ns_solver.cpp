@@ -11,10 +11,13 @@
 // #include "dg_bilinear.hpp"
 #include "dg_linear.hpp"
 #include "etc.hpp"
+#include <algorithm>
 
 using namespace std;
 using namespace mfem;
 
+const int SteadyNSSolver::eqp_format_version;
+
 /*
    SteadyNSOperator
 */
@@ -164,32 +167,102 @@ SteadyNSROM::SteadyNSROM(
 SteadyNSROM::~SteadyNSROM()
 {
    DeletePointers(block_idxs);
+   delete jac_mono;
+   delete jac_hypre;
+}
+
+void SteadyNSROM::ResetJacobian() const
+{
+   if (!jac_mono)
+   {
+      jac_mono = new SparseMatrix(*linearOp);
+      return;
+   }
+
+   const int nnz = linearOp->NumNonZeroElems();
+   assert(jac_mono->NumNonZeroElems() == nnz);
+   const double *d_lin = linearOp->GetData();
+   std::copy(d_lin, d_lin + nnz, jac_mono->GetData());
+}
+
+Operator& SteadyNSROM::FinalizeJacobian() const
+{
+   jac_mono->Finalize();
+
+   if (!direct_solve)
+      return *jac_mono;
+
+   // the pattern is unchanged, so the direct solver can reuse its symbolic analysis.
+   delete jac_hypre;
+   jac_hypre = new HypreParMatrix(MPI_COMM_SELF, sys_glob_size, sys_row_starts, jac_mono);
+   return *jac_hypre;
 }
 
 /*
    SteadyNSTensorROM
 */
 
+SteadyNSTensorROM::SteadyNSTensorROM(
+   ROMHandlerBase *rom_handler, Array<DenseTensor *> &hs_, const bool direct_solve_)
+   : SteadyNSROM(hs_.Size(), rom_handler, direct_solve_), hs(hs_)
+{
+   for (int m = 0; m < numSub; m++)
+   {
+      int g = group_hs.Find(hs[m]);
+      if (g < 0)
+      {
+         g = group_hs.Append(hs[m]) - 1;
+         group_subdomains.Append(new Array<int>(0));
+      }
+      group_subdomains[g]->Append(m);
+   }
+}
+
+SteadyNSTensorROM::~SteadyNSTensorROM()
+{
+   DeletePointers(group_subdomains);
+}
+
 void SteadyNSTensorROM::Mult(const Vector &x, Vector &y) const
 {
    y = 0.0;
    linearOp->Mult(x, y);
 
-   for (int m = 0; m < numSub; m++)
+   Vector x_col, y_col;
+   for (int g = 0; g < group_hs.Size(); g++)
    {
-      int midx = midxs[m];
-      x_comp.MakeRef(const_cast<Vector &>(x), block_offsets[midx], block_offsets[midx+1] - block_offsets[midx]);
-      y_comp.MakeRef(y, block_offsets[midx], block_offsets[midx+1] - block_offsets[midx]);
+      const Array<int> &subdomains = *group_subdomains[g];
+      const int nb = subdomains.Size();
+      const int dim = group_hs[g]->SizeK();
+
+      /* stack the reduced states of the group as columns. */
+      x_batch.SetSize(dim, nb);
+      y_batch.SetSize(dim, nb);
+      y_batch = 0.0;
+      for (int b = 0; b < nb; b++)
+      {
+         int midx = midxs[subdomains[b]];
+         assert(block_offsets[midx+1] - block_offsets[midx] == dim);
+         x_batch.GetColumnReference(b, x_col);
+         x_comp.MakeRef(const_cast<Vector &>(x), block_offsets[midx], dim);
+         x_col = x_comp;
+      }
 
-      TensorAddScaledContract(*hs[m], 1.0, x_comp, x_comp, y_comp);
+      TensorAddScaledContract(*group_hs[g], 1.0, x_batch, x_batch, y_batch);
+
+      for (int b = 0; b < nb; b++)
+      {
+         int midx = midxs[subdomains[b]];
+         y_batch.GetColumnReference(b, y_col);
+         y_comp.MakeRef(y, block_offsets[midx], dim);
+         y_comp += y_col;
+      }
    }
 }
 
 Operator& SteadyNSTensorROM::GetGradient(const Vector &x) const
 {
-   delete jac_mono;
-   delete jac_hypre;
-   jac_mono = new SparseMatrix(*linearOp);
+   ResetJacobian();
    DenseMatrix jac_comp;
 
    for (int m = 0; m < numSub; m++)
@@ -199,20 +272,12 @@ Operator& SteadyNSTensorROM::GetGradient(const Vector &x) const
 
       jac_comp.SetSize(block_offsets[midx+1] - block_offsets[midx]);
       jac_comp = 0.0;
-      TensorAddMultTranspose(*hs[m], x_comp, 0, jac_comp);
-      TensorAddMultTranspose(*hs[m], x_comp, 1, jac_comp);
+      TensorAddFusedMultTranspose(*hs[m], x_comp, jac_comp);
 
       jac_mono->AddSubMatrix(*block_idxs[m], *block_idxs[m], jac_comp);
    }
-   jac_mono->Finalize();
-   
-   if (direct_solve)
-   {
-      jac_hypre = new HypreParMatrix(MPI_COMM_SELF, sys_glob_size, sys_row_starts, jac_mono);
-      return *jac_hypre;
-   }
-   else
-      return *jac_mono;
+
+   return FinalizeJacobian();
 }
 
 /*
@@ -268,9 +333,7 @@ void SteadyNSEQPROM::Mult(const Vector &x, Vector &y) const
 
 Operator& SteadyNSEQPROM::GetGradient(const Vector &x) const
 {
-   delete jac_mono;
-   delete jac_hypre;
-   jac_mono = new SparseMatrix(*linearOp);
+   ResetJacobian();
 
    if (itf)
    {
@@ -310,15 +373,8 @@ Operator& SteadyNSEQPROM::GetGradient(const Vector &x) const
       jac_comp = dynamic_cast<DenseMatrix *>(&hs[m]->GetGradient(x_comp));
       jac_mono->AddSubMatrix(*block_idxs[m], *block_idxs[m], *jac_comp);
    }
-   jac_mono->Finalize();
-   
-   if (direct_solve)
-   {
-      jac_hypre = new HypreParMatrix(MPI_COMM_SELF, sys_glob_size, sys_row_starts, jac_mono);
-      return *jac_hypre;
-   }
-   else
-      return *jac_mono;
+
+   return FinalizeJacobian();
 }
 
 void SteadyNSEQPROM::GetVel(const Vector &x, Vector &x_u) const
@@ -381,6 +437,9 @@ SteadyNSSolver::SteadyNSSolver()
    minus_zeta = new ConstantCoefficient(-zeta);
    minus_half_zeta = new ConstantCoefficient(-0.5 * zeta);
 
+   // resolve the Newton options here, so that invalid options fail before any solve.
+   nlin_opts.Update(config);
+
    std::string oper_str = config.GetOption<std::string>("navier-stokes/operator-type", "base");
    if (oper_str == "base")       oper_type = OperType::BASE;
    else if (oper_str == "lf")    oper_type = OperType::LF;
@@ -588,21 +647,20 @@ void SteadyNSSolver::LoadROMOperatorFromFile(const std::string input_prefix)
 
 bool SteadyNSSolver::Solve(SampleGenerator *sample_generator)
 {
-   int maxIter = config.GetOption<int>("solver/max_iter", 100);
-   double rtol = config.GetOption<double>("solver/relative_tolerance", 1.e-10);
-   double atol = config.GetOption<double>("solver/absolute_tolerance", 1.e-10);
-   int print_level = config.GetOption<int>("solver/print_level", 0);
-
-   int jac_maxIter = config.GetOption<int>("solver/jacobian/max_iter", 10000);
-   double jac_rtol = config.GetOption<double>("solver/jacobian/relative_tolerance", 1.e-10);
-   double jac_atol = config.GetOption<double>("solver/jacobian/absolute_tolerance", 1.e-10);
-   int jac_print_level = config.GetOption<int>("solver/jacobian/print_level", -1);
-
-   bool lbfgs = config.GetOption<bool>("solver/use_lbfgs", false);
-   bool use_restart = config.GetOption<bool>("solver/use_restart", false);
-   std::string restart_file;
-   if (use_restart)
-      restart_file = config.GetRequiredOption<std::string>("solver/restart_file");
+   nlin_opts.Update(config);
+   int maxIter = nlin_opts.newton.max_iter;
+   double rtol = nlin_opts.newton.rtol;
+   double atol = nlin_opts.newton.atol;
+   int print_level = nlin_opts.newton.print_level;
+
+   int jac_maxIter = nlin_opts.jacobian.max_iter;
+   double jac_rtol = nlin_opts.jacobian.rtol;
+   double jac_atol = nlin_opts.jacobian.atol;
+   int jac_print_level = nlin_opts.jacobian.print_level;
+
+   bool lbfgs = nlin_opts.use_lbfgs;
+   bool use_restart = nlin_opts.use_restart;
+   const std::string &restart_file = nlin_opts.restart_file;
 
    // same size as var_offsets, but sorted by variables first (then by subdomain).
    Array<int> offsets_byvar(num_var * numSub + 1);
@@ -708,13 +766,9 @@ void SteadyNSSolver::SolveROM()
    else
       U_domain = new BlockVector(U->GetData(), domain_offsets);
 
-   bool use_restart = config.GetOption<bool>("solver/use_restart", false);
-   std::string restart_file;
-   if (use_restart)
-   {
-      restart_file = config.GetRequiredOption<std::string>("solver/restart_file");
-      LoadSolution(restart_file);
-   }
+   nlin_opts.Update(config);
+   if (nlin_opts.use_restart)
+      LoadSolution(nlin_opts.restart_file);
 
    // NOTE(kevin): currently assumes direct solve.
    SteadyNSROM *rom_oper = NULL;
@@ -1047,6 +1101,19 @@ void SteadyNSSolver::TrainROMEQPElems(SampleGenerator *sample_generator)
 
    double eqp_tol = config.GetOption<double>("model_reduction/eqp/relative_tolerance", 1.0e-2);
 
+   /*
+      distributed: every NNLS problem is distributed over all processes, one after another.
+      task: independent NNLS problems are scheduled over processes, each solved locally.
+   */
+   std::string scheduler = config.GetOption<std::string>("model_reduction/eqp/training_scheduler", "distributed");
+   if (scheduler == "task")
+   {
+      TrainROMEQPElemsByTask(sample_generator, eqp_tol);
+      return;
+   }
+   else if (scheduler != "distributed")
+      mfem_error("SteadyNSSolver::TrainROMEQPElems- unknown model_reduction/eqp/training_scheduler!\n");
+
    /* EQP NNLS for each reference ROM component */
    BasisTag basis_tag;
    for (int c = 0; c < num_comp; c++)
@@ -1103,6 +1170,150 @@ void SteadyNSSolver::TrainROMEQPElems(SampleGenerator *sample_generator)
    }  // for (int p = 0; p < topol_handler->GetNumRefPorts(); p++)
 }
 
+void SteadyNSSolver::TrainROMEQPElemsByTask(SampleGenerator *sample_generator, const double eqp_tol)
+{
+   int rank, nproc;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+   const int num_comp = topol_handler->GetNumComponents();
+   const int num_ref_ports = (oper_type == OperType::LF) ? topol_handler->GetNumRefPorts() : 0;
+
+   Array<int> comp_idx(num_comp), comp_nsnap(num_comp);
+   for (int c = 0; c < num_comp; c++)
+   {
+      comp_idx[c] = (separate_variable_basis) ? c * num_var : c;
+      comp_nsnap[c] = sample_generator->LookUpSnapshot(rom_handler->GetRefBasisTag(comp_idx[c]))->numColumns();
+   }
+
+   Array<int> port_comp1(num_ref_ports), port_comp2(num_ref_ports);
+   Array<Array2D<int> *> port_colidx(num_ref_ports);
+   for (int p = 0; p < num_ref_ports; p++)
+   {
+      int a1, a2;
+      topol_handler->GetRefPortInfo(p, port_comp1[p], port_comp2[p], a1, a2);
+
+      PortTag tag = {.Mesh1 = topol_handler->GetComponentName(port_comp1[p]),
+                     .Mesh2 = topol_handler->GetComponentName(port_comp2[p]),
+                     .Attr1 = a1, .Attr2 = a2};
+      port_colidx[p] = sample_generator->LookUpSnapshotPortColOffsets(tag);
+   }
+
+   /*
+      Each integrator of each component is a separate task, since its EQP system is independent.
+      task_comp[t] < 0 indicates the reference port task_idx[t].
+      Otherwise, the task trains the integrator (task_type[t], task_idx[t]) of the component task_comp[t].
+   */
+   const IntegratorType comp_types[3] = {IntegratorType::DOMAIN, IntegratorType::INTERIORFACE,
+                                         IntegratorType::BDRFACE};
+   Array<int> task_comp(0), task_idx(0);
+   Array<IntegratorType> task_type(0);
+   /* The cost of each task is estimated by the size of its Gt matrix. */
+   std::vector<double> cost;
+   for (int c = 0; c < num_comp; c++)
+      for (int d = 0; d < 3; d++)
+         for (int k = 0; k < comp_eqps[c]->GetNumIntegrators(comp_types[d]); k++)
+         {
+            task_comp.Append(c);
+            task_type.Append(comp_types[d]);
+            task_idx.Append(k);
+            cost.push_back(static_cast<double>(comp_eqps[c]->GetEQPSystemSize(comp_types[d], k))
+                           * comp_eqps[c]->Height() * comp_nsnap[c]);
+         }
+   for (int p = 0; p < num_ref_ports; p++)
+   {
+      task_comp.Append(-1);
+      task_type.Append(IntegratorType::INTERFACE);
+      task_idx.Append(p);
+      cost.push_back(static_cast<double>(itf_eqp->GetEQPSystemSizeForRefPort(p))
+                     * (comp_eqps[port_comp1[p]]->Height() + comp_eqps[port_comp2[p]]->Height())
+                     * port_colidx[p]->NumRows());
+   }
+   const int num_tasks = task_comp.Size();
+
+   /* Longest processing time first: the largest task goes to the least loaded process. */
+   std::vector<int> order(num_tasks);
+   for (int t = 0; t < num_tasks; t++) order[t] = t;
+   std::stable_sort(order.begin(), order.end(),
+                    [&cost](const int a, const int b) { return cost[a] > cost[b]; });
+
+   Array<int> owner(num_tasks);
+   std::vector<double> load(nproc, 0.0);
+   for (int k = 0; k < num_tasks; k++)
+   {
+      const int t = order[k];
+      owner[t] = std::min_element(load.begin(), load.end()) - load.begin();
+      load[owner[t]] += cost[t];
+   }
+
+   if (rank == 0)
+   {
+      printf("%d EQP training tasks scheduled over %d processes.\n", num_tasks, nproc);
+      for (int r = 0; r < nproc; r++)
+         printf("Process %d: estimated load %.3E\n", r, load[r]);
+   }
+
+   /* Snapshots of the components needed by the tasks of this process. */
+   Array<bool> comp_needed(num_comp);
+   comp_needed = false;
+   for (int t = 0; t < num_tasks; t++)
+   {
+      if (owner[t] != rank) continue;
+      if (task_comp[t] >= 0)
+         comp_needed[task_comp[t]] = true;
+      else
+         comp_needed[port_comp1[task_idx[t]]] = comp_needed[port_comp2[task_idx[t]]] = true;
+   }
+
+   /* Gathering is collective, so all processes gather every snapshot matrix in the same order. */
+   Array<CAROM::Matrix *> comp_snapshots(num_comp);
+   comp_snapshots = NULL;
+   for (int c = 0; c < num_comp; c++)
+   {
+      std::shared_ptr<const CAROM::Matrix> snapshots = sample_generator->LookUpSnapshot(rom_handler->GetRefBasisTag(comp_idx[c]));
+      CAROM::Matrix *snapshots_work = new CAROM::Matrix(*snapshots);
+      snapshots_work->gather();
+
+      if (comp_needed[c])
+         comp_snapshots[c] = snapshots_work;
+      else
+         delete snapshots_work;
+   }
+
+   /* Each process trains its own tasks, without any communication. */
+   for (int t = 0; t < num_tasks; t++)
+   {
+      if (owner[t] != rank) continue;
+
+      if (task_comp[t] >= 0)
+      {
+         const int c = task_comp[t];
+         comp_eqps[c]->SetDistributedEQP(false);
+         comp_eqps[c]->TrainEQPForIntegrator(task_type[t], task_idx[t], *comp_snapshots[c], eqp_tol);
+         comp_eqps[c]->SetDistributedEQP(true);
+      }
+      else
+      {
+         const int p = task_idx[t];
+         itf_eqp->SetDistributedEQP(false);
+         itf_eqp->TrainEQPForRefPort(p, *comp_snapshots[port_comp1[p]], *comp_snapshots[port_comp2[p]],
+                                     *port_colidx[p], eqp_tol);
+         itf_eqp->SetDistributedEQP(true);
+      }
+   }
+
+   DeletePointers(comp_snapshots);
+
+   /* All processes hold all EQP samples afterward, as in the distributed training. */
+   for (int t = 0; t < num_tasks; t++)
+   {
+      if (task_comp[t] >= 0)
+         comp_eqps[task_comp[t]]->BroadcastEQPForIntegrator(task_type[t], task_idx[t], owner[t]);
+      else
+         itf_eqp->BroadcastEQPForRefPort(task_idx[t], owner[t]);
+   }
+}
+
 void SteadyNSSolver::SaveEQPElems(const std::string &filename)
 {
    assert(topol_mode == TopologyHandlerMode::COMPONENT);
@@ -1115,8 +1326,21 @@ void SteadyNSSolver::SaveEQPElems(const std::string &filename)
    {
       hid_t file_id;
       herr_t errf = 0;
-      file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+      /*
+         Large datasets are aligned in the file,
+         so that the precomputed coefficients can be memory-mapped at loading.
+      */
+      hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+      errf = H5Pset_alignment(fapl_id, 4096, 64);
+      assert(errf >= 0);
+      file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
       assert(file_id >= 0);
+      errf = H5Pclose(fapl_id);
+      assert(errf >= 0);
+
+      // precomputed coefficients are stored only if model_reduction/eqp/precompute is set.
+      hdf5_utils::WriteAttribute(file_id, "format_version", eqp_format_version);
 
       hid_t grp_id;
 
@@ -1134,6 +1358,9 @@ void SteadyNSSolver::SaveEQPElems(const std::string &filename)
          assert(comp_eqps[c]);
          dset_name = topol_handler->GetComponentName(c);
 
+         if (comp_eqps[c]->PrecomputeMode())
+            comp_eqps[c]->PrecomputeCoefficients();
+
          comp_eqps[c]->SaveEQPForIntegrator(IntegratorType::DOMAIN, 0, grp_id, dset_name + "_integ0");
          if (oper_type == OperType::LF)
          {
@@ -1156,7 +1383,12 @@ void SteadyNSSolver::SaveEQPElems(const std::string &filename)
       assert(errf >= 0);
 
       if (oper_type == OperType::LF)
+      {
+         if (itf_eqp->PrecomputeMode())
+            itf_eqp->PrecomputeCoefficients();
+
          itf_eqp->SaveEQPForIntegrator(0, file_id, "interface_integ0");
+      }
 
       errf = H5Fclose(file_id);
       assert(errf >= 0);
@@ -1175,6 +1407,18 @@ void SteadyNSSolver::LoadEQPElems(const std::string &filename)
    file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
    assert(file_id >= 0);
 
+   int format_version = 1;
+   if (H5Aexists(file_id, "format_version") > 0)
+      hdf5_utils::ReadAttribute(file_id, "format_version", format_version);
+   if ((format_version < 1) || (format_version > eqp_format_version))
+   {
+      printf("EQP file format version: %d, supported up to: %d\n", format_version, eqp_format_version);
+      mfem_error("SteadyNSSolver::LoadEQPElems- unsupported EQP file format version!\n");
+   }
+   if (format_version < eqp_format_version)
+      mfem_warning("SteadyNSSolver::LoadEQPElems- EQP file of an older format. "
+                   "Any precomputed coefficients will be computed again.\n");
+
    hid_t grp_id;
    grp_id = H5Gopen2(file_id, "components", H5P_DEFAULT);
    assert(grp_id >= 0);
@@ -16,6 +16,10 @@ using namespace mfem;
 StokesSolver::StokesSolver()
    : MultiBlockSolver(), minus_one(-1.0)
 {
+   // the system matrix and its solvers are on MPI_COMM_SELF.
+   if (distributed_solve)
+      mfem_error("StokesSolver: solver/distributed is not supported for stokes flows, including the flow of adv-diff!\n");
+
    nu = config.GetOption<double>("stokes/nu", 1.0);
    nu_coeff = new ConstantCoefficient(nu);
 
@@ -410,12 +414,8 @@ void StokesSolver::AssembleOperatorBase()
    assert(ms.Size() == numSub);
    assert(bs.Size() == numSub);
 
-   for (int m = 0; m < numSub; m++)
-   {
-      assert(ms[m] && bs[m]);
-      ms[m]->Assemble();
-      bs[m]->Assemble();
-   }
+   AssembleSubdomainForms(ms);
+   AssembleSubdomainForms(bs);
 
    m_mats.SetSize(numSub, numSub);
    b_mats.SetSize(numSub, numSub);
@@ -709,10 +709,11 @@ bool StokesSolver::Solve(SampleGenerator *sample_generator)
    // If using direct solver, returns always true.
    bool converged = true;
 
-   int maxIter = config.GetOption<int>("solver/max_iter", 10000);
-   double rtol = config.GetOption<double>("solver/relative_tolerance", 1.e-15);
-   double atol = config.GetOption<double>("solver/absolute_tolerance", 1.e-15);
-   int print_level = config.GetOption<int>("solver/print_level", 0);
+   solver_opts.Update(config);
+   int maxIter = solver_opts.max_iter;
+   double rtol = solver_opts.rtol;
+   double atol = solver_opts.atol;
+   int print_level = solver_opts.print_level;
 
    // same size as var_offsets, but sorted by variables first (then by subdomain).
    Array<int> offsets_byvar(num_var * numSub + 1);
@@ -1084,7 +1085,12 @@ void StokesSolver::SetParameterizedProblem(ParameterizedProblem *problem)
    /* set up boundary types */
    MultiBlockSolver::SetParameterizedProblem(problem);
 
-   nu = function_factory::flow_problem::nu;
+   FlowProblem *flow_problem = dynamic_cast<FlowProblem *>(problem);
+   if (!flow_problem)
+      mfem_error("StokesSolver::SetParameterizedProblem - the problem is not a FlowProblem!\n");
+   function_factory::flow_problem::Params &flow_params = flow_problem->flow_params;
+
+   nu = flow_params.nu;
    delete nu_coeff;
    nu_coeff = new ConstantCoefficient(nu);
 
@@ -1109,7 +1115,7 @@ void StokesSolver::SetParameterizedProblem(ParameterizedProblem *problem)
          case BoundaryType::DIRICHLET:
          { 
             assert(problem->vector_bdr_ptr[b]);
-            AddBCFunction(*(problem->vector_bdr_ptr[b]), problem->battr[b]);
+            AddBCFunction(problem->vector_bdr_ptr[b], problem->battr[b]);
             break;
          }
          case BoundaryType::NEUMANN: break;
@@ -1119,14 +1125,14 @@ void StokesSolver::SetParameterizedProblem(ParameterizedProblem *problem)
       }
    }
 
-   if (problem->vector_rhs_ptr != NULL)
-      AddRHSFunction(*(problem->vector_rhs_ptr));
+   if (problem->vector_rhs_ptr)
+      AddRHSFunction(problem->vector_rhs_ptr);
    else
       AddRHSFunction(zero);
 
    // Ensure incompressibility.
-   function_factory::flow_problem::del_u = 0.0;
-   function_factory::flow_problem::x0.SetSize(dim);
+   flow_params.del_u = 0.0;
+   flow_params.x0.SetSize(dim);
    if (!pres_dbc)
    {
       Array<bool> nz_dbcs(numBdr);
@@ -1141,7 +1147,7 @@ void StokesSolver::SetParameterizedProblem(ParameterizedProblem *problem)
                nz_dbcs[b] = false;
          }
       }
-      SetComplementaryFlux(nz_dbcs);
+      SetComplementaryFlux(nz_dbcs, flow_params);
    }
 }
 
@@ -1178,7 +1184,7 @@ BlockMatrix* StokesSolver::FormBlockMatrix(
    return sys_comp;
 }
 
-void StokesSolver::SetComplementaryFlux(const Array<bool> nz_dbcs)
+void StokesSolver::SetComplementaryFlux(const Array<bool> nz_dbcs, function_factory::flow_problem::Params &flow_params)
 {
    // This routine makes sense only for all velocity dirichlet bc.
    assert(nz_dbcs.Size() == numBdr);
@@ -1191,15 +1197,16 @@ void StokesSolver::SetComplementaryFlux(const Array<bool> nz_dbcs)
    Mesh *mesh = NULL;
 
    // initializing complementary flux.
-   function_factory::flow_problem::del_u = 0.0;
+   flow_params.del_u = 0.0;
 
    // NOTE: corresponding ParameterizedProblem should use
-   // function_factory::flow_problem::flux
+   // function_factory::flow_problem::flux with its flow_params
    // to actually enforce the incompressibility.
-   Vector *x0 = &(function_factory::flow_problem::x0);
+   Vector *x0 = &(flow_params.x0);
    x0->SetSize(dim);
    (*x0) = 0.0;
-   VectorFunctionCoefficient dir_coeff(dim, function_factory::flow_problem::dir);
+   VectorFunctionCoefficient dir_coeff(dim, [&flow_params](const Vector &x, Vector &y)
+                                            { function_factory::flow_problem::dir(flow_params, x, y); });
 
    // Determine the center of domain first.
    Vector x1(dim), dx1(dim);
@@ -1255,7 +1262,7 @@ void StokesSolver::SetComplementaryFlux(const Array<bool> nz_dbcs)
    }  // for (int m = 0; m < numSub; m++)
 
    // Set the flux to ensure incompressibility.
-   function_factory::flow_problem::del_u = bflux / dirflux;
+   flow_params.del_u = bflux / dirflux;
 
    // Make sure the resulting flux is zero.
    double threshold = 1.0e-12;
@@ -1295,7 +1302,6 @@ void StokesSolver::EnrichSupremizer()
    Array<FiniteElementSpace *> comp_fes;
    FiniteElementSpace *ufes_comp, *pfes_comp;
    DenseMatrix *pbasis, *ubasis, *tmp, *supreme;
-   Vector pvec, uvec;
 
    std::string basis_prefix = rom_handler->GetBasisPrefix();
 
@@ -1325,13 +1331,11 @@ void StokesSolver::EnrichSupremizer()
 
       int num_basis = rom_handler->GetRefNumBasis(m * num_var);
       assert(num_basis == ubasis->NumCols());
-      supreme = new DenseMatrix(ubasis->NumRows(), num_ref_supreme[m]);
-      for (int k = 0; k < num_ref_supreme[m]; k++)
-      {
-         pbasis->GetColumnReference(k, pvec);
-         supreme->GetColumnReference(k, uvec);
-         b_comp.MultTranspose(pvec, uvec);
-      }
+      assert(num_ref_supreme[m] <= pbasis->NumCols());
+      /* all supremizer columns at once. the leading pressure modes are a column-major view. */
+      DenseMatrix pmodes(pbasis->Data(), pbasis->NumRows(), num_ref_supreme[m]);
+      supreme = new DenseMatrix;
+      MultTransposeDenseBlock(b_comp.SpMat(), pmodes, *supreme);
 
       // Orthonormalize supreme over ubasis and itself.
       Orthonormalize(*ubasis, *supreme);
@@ -24,6 +24,31 @@ const TopologyHandlerMode SetTopologyHandlerMode()
    return topol_mode;
 }
 
+/*
+   PortTransformations
+*/
+
+PortTransformations::PortTransformations(const int s1, const int s2, const int num_itf)
+   : sub1(s1), sub2(s2)
+{
+   tr1.SetSize(num_itf);
+   tr2.SetSize(num_itf);
+   elem1.SetSize(num_itf);
+   elem2.SetSize(num_itf);
+   tr1 = NULL;
+   tr2 = NULL;
+   elem1 = NULL;
+   elem2 = NULL;
+}
+
+PortTransformations::~PortTransformations()
+{
+   DeletePointers(tr1);
+   DeletePointers(tr2);
+   DeletePointers(elem1);
+   DeletePointers(elem2);
+}
+
 /*
    TopologyHandler Base class
 */
@@ -97,6 +122,85 @@ void TopologyHandler::GetInterfaceTransformations(Mesh *m1, Mesh *m2, const Inte
    }
 }
 
+void TopologyHandler::GetPortInterfaceTransformations(Mesh *m1, Mesh *m2, const int &p, const int &itf,
+                                                      FaceElementTransformations* &tr1,
+                                                      FaceElementTransformations* &tr2)
+{
+   assert((p >= 0) && (p < num_ports));
+   Array<InterfaceInfo> *const if_infos = interface_infos[p];
+   assert((itf >= 0) && (itf < if_infos->Size()));
+
+   if (port_trs.Size() != num_ports)
+   {
+      DeletePointers(port_trs);
+      port_trs.SetSize(num_ports);
+      port_trs = NULL;
+   }
+
+   // The cache belongs to the subdomain meshes of the port, regardless of which caller comes first.
+   const PortInfo *pInfo = &(port_infos[p]);
+   if ((m1 != GetBuiltMesh(pInfo->Mesh1)) || (m2 != GetBuiltMesh(pInfo->Mesh2)))
+   {
+      // Not the meshes of this port (e.g. copied component meshes). Do not use the cache.
+      GetInterfaceTransformations(m1, m2, &((*if_infos)[itf]), tr1, tr2);
+      return;
+   }
+
+   PortTransformations *port_tr = port_trs[p];
+
+   if (!port_tr)
+   {
+      /*
+         FaceElementTransformations returned from Mesh are reused for every face,
+         and refer to the Mesh-owned element transformation.
+         Copy both of them for each interface.
+      */
+      port_tr = new PortTransformations(pInfo->Mesh1, pInfo->Mesh2, if_infos->Size());
+      FaceElementTransformations *t1, *t2;
+      for (int i = 0; i < if_infos->Size(); i++)
+      {
+         GetInterfaceTransformations(m1, m2, &((*if_infos)[i]), t1, t2);
+         if ((t1 == NULL) || (t2 == NULL)) continue;
+
+         port_tr->elem1[i] = new IsoparametricTransformation(*static_cast<IsoparametricTransformation *>(t1->Elem1));
+         port_tr->tr1[i] = new FaceElementTransformations(*t1);
+         port_tr->tr1[i]->Elem1 = port_tr->elem1[i];
+
+         port_tr->elem2[i] = new IsoparametricTransformation(*static_cast<IsoparametricTransformation *>(t2->Elem1));
+         port_tr->tr2[i] = new FaceElementTransformations(*t2);
+         port_tr->tr2[i]->Elem1 = port_tr->elem2[i];
+      }
+      port_trs[p] = port_tr;
+   }
+
+   tr1 = port_tr->tr1[itf];
+   tr2 = port_tr->tr2[itf];
+}
+
+void TopologyHandler::ClearInterfaceTransformations(const int m)
+{
+   if (m < 0)
+   {
+      DeletePointers(port_trs);
+      port_trs.SetSize(0);
+      return;
+   }
+
+   for (int p = 0; p < port_trs.Size(); p++)
+   {
+      if (!port_trs[p]) continue;
+      if ((port_trs[p]->sub1 != m) && (port_trs[p]->sub2 != m)) continue;
+
+      delete port_trs[p];
+      port_trs[p] = NULL;
+   }
+}
+
+TopologyHandler::~TopologyHandler()
+{
+   DeletePointers(port_trs);
+}
+
 void TopologyHandler::UpdateAttributes(Mesh& m)
 {
    m.attributes.DeleteAll();
@@ -268,7 +268,7 @@ void UnsteadyNSSolver::SetParameterizedProblem(ParameterizedProblem *problem)
    if (p_ic) delete p_ic;
 
    /* set up initial condition */
-   bool ic_setup = (problem->ic_ptr.Size() >= 2);
+   bool ic_setup = (problem->ic_ptr.size() >= 2);
    if (!ic_setup)
    {
       u_ic = new VectorConstantCoefficient(zero_vel);
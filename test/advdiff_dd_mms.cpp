@@ -27,7 +27,7 @@ TEST(DDSerialTest, Test_convergence)
 TEST(DDSerialTest, Test_direct_solver)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["solver"]["direct_solve"] = true;
+   config.GetDict()["solver"]["direct_solve"] = true;
    CheckConvergence();
 
    return;
@@ -52,7 +52,7 @@ TEST(DDSerial_component_3D_hex_test, Test_convergence)
 // TEST(DDSerial_component_3D_tet_test, Test_convergence)
 // {
 //    config = InputParser("inputs/dd_mms.comp.3d.yml");
-//    config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "meshes/dd_mms.3d.tet.mesh";
+//    config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "meshes/dd_mms.3d.tet.mesh";
 //    CheckConvergence();
 
 //    return;
@@ -19,7 +19,7 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound) {
 TEST(DG_BDR_NORMAL_LF_Test, Test_Quad)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
    mms::fem::dg_bdr_normal_lf::CheckConvergence();
 
    return;
@@ -28,8 +28,8 @@ TEST(DG_BDR_NORMAL_LF_Test, Test_Quad)
 TEST(DG_BDR_NORMAL_LF_Test, Test_Tri)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["mesh"]["filename"] = "meshes/square.tri.mesh";
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["mesh"]["filename"] = "meshes/square.tri.mesh";
    mms::fem::dg_bdr_normal_lf::CheckConvergence();
 
    return;
@@ -38,8 +38,8 @@ TEST(DG_BDR_NORMAL_LF_Test, Test_Tri)
 TEST(DG_TEMAM_Test, Test_Quad)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["discretization"]["full-discrete-galerkin"] = false;
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["full-discrete-galerkin"] = false;
    mms::fem::dg_temam::CheckConvergence();
 
    return;
@@ -48,9 +48,9 @@ TEST(DG_TEMAM_Test, Test_Quad)
 TEST(DG_TEMAM_Test, Test_Tri)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["discretization"]["full-discrete-galerkin"] = false;
-   config.dict_["mesh"]["filename"] = "meshes/square.tri.mesh";
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["full-discrete-galerkin"] = false;
+   config.GetDict()["mesh"]["filename"] = "meshes/square.tri.mesh";
    mms::fem::dg_temam::CheckConvergence();
 
    return;
@@ -89,8 +89,8 @@ TEST(InterfaceDGElasticityIntegrator, Test_Quad)
    config = InputParser("inputs/dd_mms.yml");
    /* set your own parameters */
    const int order = 1;
-   config.dict_["discretization"]["order"] = order;
-   config.dict_["mesh"]["filename"] = "meshes/test.2x1.mesh";
+   config.GetDict()["discretization"]["order"] = order;
+   config.GetDict()["mesh"]["filename"] = "meshes/test.2x1.mesh";
 
    const int numBdr = 4; // hacky way to set the number of boundary attributes
 
@@ -27,7 +27,7 @@ TEST(Poisson, Test_convergence)
 TEST(AdvDiff, Test_convergence)
 {
    config = InputParser("test.component.yml");
-   config.dict_["adv-diff"]["peclet_number"] = 1.1;
+   config.GetDict()["adv-diff"]["peclet_number"] = 1.1;
    mms::advdiff::CheckConvergence();
 
    return;
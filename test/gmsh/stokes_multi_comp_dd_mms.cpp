@@ -19,13 +19,13 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound) {
 TEST(StokesFlow, Test_convergence)
 {
    config = InputParser("test.component.yml");
-   config.dict_["discretization"]["order"] = 2;
-   config.dict_["manufactured_solution"]["baseline_refinement"] = 0;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
-   config.dict_["mesh"]["component-wise"]["vertex_gap_threshold"] = 1.0e-9;
-   config.dict_["solver"]["direct_solve"] = true;
+   config.GetDict()["discretization"]["order"] = 2;
+   config.GetDict()["manufactured_solution"]["baseline_refinement"] = 0;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["mesh"]["component-wise"]["vertex_gap_threshold"] = 1.0e-9;
+   config.GetDict()["solver"]["direct_solve"] = true;
    // TODO: add ROM capability for stokes solver.
-   config.dict_["main"]["use_rom"] = false;
+   config.GetDict()["main"]["use_rom"] = false;
    CheckConvergence(1.0);
 
    return;
@@ -34,16 +34,16 @@ TEST(StokesFlow, Test_convergence)
 TEST(SteadyNS, Test_convergence)
 {
    config = InputParser("test.component.yml");
-   config.dict_["main"]["solver"] = "steady-ns";
-   config.dict_["discretization"]["order"] = 2;
-   config.dict_["manufactured_solution"]["baseline_refinement"] = 0;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
-   config.dict_["mesh"]["component-wise"]["vertex_gap_threshold"] = 1.0e-9;
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["solver"]["print_level"] = 1;
+   config.GetDict()["main"]["solver"] = "steady-ns";
+   config.GetDict()["discretization"]["order"] = 2;
+   config.GetDict()["manufactured_solution"]["baseline_refinement"] = 0;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
+   config.GetDict()["mesh"]["component-wise"]["vertex_gap_threshold"] = 1.0e-9;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["solver"]["print_level"] = 1;
    // TODO: add ROM capability for stokes solver.
-   config.dict_["main"]["use_rom"] = false;
+   config.GetDict()["main"]["use_rom"] = false;
    mms::steady_ns::CheckConvergence(1.0);
 
    return;
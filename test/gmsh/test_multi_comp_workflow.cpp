@@ -26,20 +26,20 @@ TEST(ComponentWiseTest, PoissonTest)
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   // config.dict_["sample_generation"]["poisson0"][0]["sample_size"] = 4;
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   // config.GetDict()["sample_generation"]["poisson0"][0]["sample_size"] = 4;
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -55,19 +55,19 @@ TEST(ComponentWiseTest, StokesTest)
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -81,23 +81,23 @@ TEST(ComponentWiseTest, StokesTest_SeparateVariable)
 {
    config = InputParser("stokes.component.yml");
 
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -111,28 +111,28 @@ TEST(ComponentWiseTest, SteadyNSTest)
 {
    config = InputParser("stokes.component.yml");
 
-   config.dict_["main"]["solver"] = "steady-ns";
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
-   config.dict_["solver"]["print_level"] = 1;
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["main"]["solver"] = "steady-ns";
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
+   config.GetDict()["solver"]["print_level"] = 1;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -146,29 +146,29 @@ TEST(ComponentWiseTest, SteadyNSTest_SeparateVariable)
 {
    config = InputParser("stokes.component.yml");
 
-   config.dict_["main"]["solver"] = "steady-ns";
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["solver"]["print_level"] = 1;
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["main"]["solver"] = "steady-ns";
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["solver"]["print_level"] = 1;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -181,35 +181,35 @@ TEST(ComponentWiseTest, SteadyNSTest_SeparateVariable)
 TEST(ComponentWiseTest, SteadyNSTest_SeparateVariable_EQP)
 {
    config = InputParser("stokes.component.yml");
-   config.dict_["main"]["solver"] = "steady-ns";
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
-   config.dict_["solver"]["print_level"] = 1;
+   config.GetDict()["main"]["solver"] = "steady-ns";
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
+   config.GetDict()["solver"]["print_level"] = 1;
 
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
-   config.dict_["model_reduction"]["nonlinear_handling"] = "eqp";
-   config.dict_["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-12;
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["nonlinear_handling"] = "eqp";
+   config.GetDict()["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-12;
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_eqp";
+   config.GetDict()["main"]["mode"] = "train_eqp";
    TrainEQP(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -225,21 +225,21 @@ TEST(SteadyNS_Workflow, LF)
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_eqp";
+   config.GetDict()["main"]["mode"] = "train_eqp";
    TrainEQP(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -255,28 +255,28 @@ TEST(SteadyNS_Workflow, InterfaceEQP)
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
-   config.dict_["sample_generation"]["file_path"]["prefix"] = "stokes0";
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   config.GetDict()["sample_generation"]["file_path"]["prefix"] = "stokes0";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["sample_generation"]["file_path"]["prefix"] = "stokes1";
-   config.dict_["sample_generation"]["parameters"][0]["sample_size"] = 1;
-   config.dict_["sample_generation"]["parameters"][0]["minimum"] = 1.2;
-   config.dict_["sample_generation"]["parameters"][0]["maximum"] = 1.2;
+   config.GetDict()["sample_generation"]["file_path"]["prefix"] = "stokes1";
+   config.GetDict()["sample_generation"]["parameters"][0]["sample_size"] = 1;
+   config.GetDict()["sample_generation"]["parameters"][0]["minimum"] = 1.2;
+   config.GetDict()["sample_generation"]["parameters"][0]["maximum"] = 1.2;
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_eqp";
+   config.GetDict()["main"]["mode"] = "train_eqp";
    TrainEQP(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -289,23 +289,23 @@ TEST(SteadyNS_Workflow, InterfaceEQP)
 TEST(MultiComponentGlobalROM, StokesTest)
 {
    config = InputParser("stokes.component.yml");
-   config.dict_["model_reduction"]["save_operator"]["level"] = "global";
+   config.GetDict()["model_reduction"]["save_operator"]["level"] = "global";
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -318,26 +318,26 @@ TEST(MultiComponentGlobalROM, StokesTest)
 TEST(MultiComponentGlobalROM, StokesTestDirectSolve)
 {
    config = InputParser("stokes.component.yml");
-   config.dict_["model_reduction"]["save_operator"]["level"] = "global";
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "sid";
+   config.GetDict()["model_reduction"]["save_operator"]["level"] = "global";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "sid";
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -350,30 +350,30 @@ TEST(MultiComponentGlobalROM, StokesTestDirectSolve)
 TEST(MultiComponentGlobalROM, SteadyNSTestDirectSolve)
 {
    config = InputParser("stokes.component.yml");
-   config.dict_["main"]["solver"] = "steady-ns";
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
-   config.dict_["solver"]["print_level"] = 1;
+   config.GetDict()["main"]["solver"] = "steady-ns";
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
+   config.GetDict()["solver"]["print_level"] = 1;
 
-   config.dict_["model_reduction"]["save_operator"]["level"] = "global";
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["save_operator"]["level"] = "global";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -386,31 +386,31 @@ TEST(MultiComponentGlobalROM, SteadyNSTestDirectSolve)
 TEST(MultiComponentGlobalROM, SteadyNSTest_SeparateVariable)
 {
    config = InputParser("stokes.component.yml");
-   config.dict_["main"]["solver"] = "steady-ns";
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
-   config.dict_["solver"]["print_level"] = 1;
+   config.GetDict()["main"]["solver"] = "steady-ns";
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "square.tri.mesh";
+   config.GetDict()["solver"]["print_level"] = 1;
 
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["save_operator"]["level"] = "global";
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["save_operator"]["level"] = "global";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -426,23 +426,23 @@ TEST(UnsteadyNS_Workflow, Periodic)
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_eqp";
+   config.GetDict()["main"]["mode"] = "train_eqp";
    TrainEQP(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
-   // config.dict_["solver"]["use_restart"] = true;
-   // config.dict_["solver"]["restart_file"] = "usns_restart_00000000.h5";
+   config.GetDict()["main"]["mode"] = "single_run";
+   // config.GetDict()["solver"]["use_restart"] = true;
+   // config.GetDict()["solver"]["restart_file"] = "usns_restart_00000000.h5";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
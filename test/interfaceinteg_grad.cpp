@@ -127,7 +127,7 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound) {
 TEST(DGLaxFriedrichsFlux, Test_grad_interior)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
 
    ConstantCoefficient pi(3.141592);
    auto *nlc_nlfi = new DGLaxFriedrichsFluxIntegrator(pi);
@@ -20,9 +20,9 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound)
 TEST(DDSerialTest, Test_convergence_DG)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
-   config.dict_["discretization"]["full-discrete-galerkin"] = true;
-   config.dict_["domain-decomposition"]["type"] = "none";
+   config.GetDict()["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
+   config.GetDict()["discretization"]["full-discrete-galerkin"] = true;
+   config.GetDict()["domain-decomposition"]["type"] = "none";
    CheckConvergence();
 
    return;
@@ -31,10 +31,10 @@ TEST(DDSerialTest, Test_convergence_DG)
 TEST(DDSerialTest, Test_direct_solver_DG)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["discretization"]["full-discrete-galerkin"] = true;
-   config.dict_["domain-decomposition"]["type"] = "none";
+   config.GetDict()["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["discretization"]["full-discrete-galerkin"] = true;
+   config.GetDict()["domain-decomposition"]["type"] = "none";
    CheckConvergence();
 
    return;
@@ -43,9 +43,9 @@ TEST(DDSerialTest, Test_direct_solver_DG)
 TEST(DDSerialTest, Test_convergence_DG_DD)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
-   config.dict_["discretization"]["full-discrete-galerkin"] = true;
-   config.dict_["domain-decomposition"]["type"] = "interior_penalty";
+   config.GetDict()["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
+   config.GetDict()["discretization"]["full-discrete-galerkin"] = true;
+   config.GetDict()["domain-decomposition"]["type"] = "interior_penalty";
    CheckConvergence();
 
    return;
@@ -54,10 +54,10 @@ TEST(DDSerialTest, Test_convergence_DG_DD)
 TEST(DDSerialTest, Test_direct_solver_DG_DD)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["discretization"]["full-discrete-galerkin"] = true;
-   config.dict_["domain-decomposition"]["type"] = "interior_penalty";
+   config.GetDict()["mesh"]["filename"] = "../examples/linelast/meshes/beam-tri.mesh";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["discretization"]["full-discrete-galerkin"] = true;
+   config.GetDict()["domain-decomposition"]["type"] = "interior_penalty";
    CheckConvergence();
 
    return;
@@ -36,7 +36,7 @@ double ExactRHS(const Vector &x, double t)
 
 PoissonSolver *SolveWithRefinement(const int num_refinement)
 {
-   config.dict_["mesh"]["uniform_refinement"] = num_refinement;
+   config.GetDict()["mesh"]["uniform_refinement"] = num_refinement;
    PoissonSolver *test = new PoissonSolver();
 
    test->InitVariables();
@@ -175,7 +175,7 @@ double gFun(const Vector & x, double t)
 
 StokesSolver *SolveWithRefinement(const int num_refinement)
 {
-   config.dict_["mesh"]["uniform_refinement"] = num_refinement;
+   config.GetDict()["mesh"]["uniform_refinement"] = num_refinement;
    StokesSolver *test = new StokesSolver();
 
    test->InitVariables();
@@ -355,7 +355,7 @@ double gFun(const Vector & x, double t)
 
 SteadyNSSolver *SolveWithRefinement(const int num_refinement)
 {
-   config.dict_["mesh"]["uniform_refinement"] = num_refinement;
+   config.GetDict()["mesh"]["uniform_refinement"] = num_refinement;
    SteadyNSSolver *test = new SteadyNSSolver();
 
    test->InitVariables();
@@ -493,7 +493,7 @@ namespace unsteady_ns
 
 UnsteadyNSSolver *SolveWithRefinement(const int num_refinement)
 {
-   config.dict_["mesh"]["uniform_refinement"] = num_refinement;
+   config.GetDict()["mesh"]["uniform_refinement"] = num_refinement;
    UnsteadyNSSolver *test = new UnsteadyNSSolver();
 
    test->InitVariables();
@@ -650,7 +650,7 @@ namespace linelast
 
    LinElastSolver *SolveWithRefinement(const int num_refinement)
    {
-      config.dict_["mesh"]["uniform_refinement"] = num_refinement;
+      config.GetDict()["mesh"]["uniform_refinement"] = num_refinement;
       LinElastSolver *test = new LinElastSolver();
 
       dim = test->GetDim();
@@ -782,7 +782,7 @@ double ExactRHS(const Vector &x, double t)
 
 AdvDiffSolver *SolveWithRefinement(const int num_refinement)
 {
-   config.dict_["mesh"]["uniform_refinement"] = num_refinement;
+   config.GetDict()["mesh"]["uniform_refinement"] = num_refinement;
    AdvDiffSolver *test = new AdvDiffSolver();
 
    test->InitVariables();
@@ -167,8 +167,8 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound) {
 TEST(IncompressibleInviscidFlux, Test_grad)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   // config.dict_["mesh"]["uniform_refinement"] = 2;
+   config.GetDict()["discretization"]["order"] = 1;
+   // config.GetDict()["mesh"]["uniform_refinement"] = 2;
 
    bool use_dg = config.GetOption<bool>("discretization/full-discrete-galerkin", false);
 
@@ -184,7 +184,7 @@ TEST(IncompressibleInviscidFlux, Test_grad)
 TEST(DGLaxFriedrichsFlux, Test_grad_interior)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
 
    ConstantCoefficient pi(3.141592);
    auto *nlc_nlfi = new DGLaxFriedrichsFluxIntegrator(pi);
@@ -197,7 +197,7 @@ TEST(DGLaxFriedrichsFlux, Test_grad_interior)
 TEST(DGLaxFriedrichsFlux, Test_grad_bdr)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
 
    ConstantCoefficient pi(3.141592);
    auto *nlc_nlfi = new DGLaxFriedrichsFluxIntegrator(pi);
@@ -210,7 +210,7 @@ TEST(DGLaxFriedrichsFlux, Test_grad_bdr)
 TEST(DGTemamFlux, Test_grad_interior)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
 
    ConstantCoefficient pi(3.141592);
    auto *nlc_nlfi = new DGTemamFluxIntegrator(pi);
@@ -223,7 +223,7 @@ TEST(DGTemamFlux, Test_grad_interior)
 TEST(DGTemamFlux, Test_grad_bdr)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
 
    ConstantCoefficient pi(3.141592);
    auto *nlc_nlfi = new DGTemamFluxIntegrator(pi);
@@ -236,7 +236,7 @@ TEST(DGTemamFlux, Test_grad_bdr)
 TEST(VectorConvectionTrilinearFormIntegrator, Test_grad)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
 
    ConstantCoefficient pi(3.141592);
    auto *nlc_nlfi = new VectorConvectionTrilinearFormIntegrator(pi);
@@ -249,7 +249,7 @@ TEST(VectorConvectionTrilinearFormIntegrator, Test_grad)
 TEST(TemamTrilinearFormIntegrator, Test_grad)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
+   config.GetDict()["discretization"]["order"] = 1;
 
    ConstantCoefficient pi(3.141592);
    auto *nlc_nlfi = new TemamTrilinearFormIntegrator(pi);
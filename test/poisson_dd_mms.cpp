@@ -27,7 +27,7 @@ TEST(DDSerialTest, Test_convergence)
 TEST(DDSerialTest, Test_direct_solver)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["solver"]["direct_solve"] = true;
+   config.GetDict()["solver"]["direct_solve"] = true;
    CheckConvergence();
 
    return;
@@ -52,12 +52,76 @@ TEST(DDSerial_component_3D_hex_test, Test_convergence)
 TEST(DDSerial_component_3D_tet_test, Test_convergence)
 {
    config = InputParser("inputs/dd_mms.comp.3d.yml");
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "meshes/dd_mms.3d.tet.mesh";
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "meshes/dd_mms.3d.tet.mesh";
    CheckConvergence();
 
    return;
 }
 
+TEST(DDDistributedTest, Test_convergence)
+{
+   config = InputParser("inputs/dd_mms.yml");
+   config.GetDict()["solver"]["distributed"] = true;
+   CheckConvergence();
+
+   return;
+}
+
+TEST(DDDistributedTest, Test_direct_solver)
+{
+   config = InputParser("inputs/dd_mms.yml");
+   config.GetDict()["solver"]["distributed"] = true;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   CheckConvergence();
+
+   return;
+}
+
+/*
+   The distributed solve must reproduce the serial solution on every rank,
+   and only one rank writes the solution file.
+*/
+TEST(DDDistributedTest, Test_serial_equivalence)
+{
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   config = InputParser("inputs/dd_mms.yml");
+   config.GetDict()["solver"]["direct_solve"] = true;
+   PoissonSolver *serial = SolveWithRefinement(1);
+   BlockVector *serial_U = serial->GetSolutionCopy();
+
+   config.GetDict()["solver"]["distributed"] = true;
+   config.GetDict()["save_solution"]["enabled"] = true;
+   config.GetDict()["save_solution"]["file_path"]["prefix"] = "dd_mms_distributed";
+   PoissonSolver *dist = SolveWithRefinement(1);
+   dist->SaveSolution();
+   MPI_Barrier(MPI_COMM_WORLD);
+
+   BlockVector *dist_U = dist->GetSolutionCopy();
+   *dist_U -= *serial_U;
+   const double error = dist_U->Normlinf() / serial_U->Normlinf();
+   printf("rank %d, relative difference: %.5E\n", rank, error);
+   EXPECT_TRUE(error < 1.0e-10);
+
+   // each rank assembles only the row blocks of its own subdomains.
+   int nproc;
+   MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+   if (nproc > 1)
+      EXPECT_LT(dist->GetNumAssembledBlocks(), serial->GetNumAssembledBlocks());
+
+   // every rank reads back the file written by rank 0.
+   serial->LoadSolution("./dd_mms_distributed.h5");
+   *serial_U -= *(serial->GetSolution());
+   EXPECT_TRUE(serial_U->Normlinf() < 1.0e-10);
+
+   delete dist_U;
+   delete serial_U;
+   delete dist;
+   delete serial;
+   return;
+}
+
 int main(int argc, char* argv[])
 {
    MPI_Init(&argc, &argv);
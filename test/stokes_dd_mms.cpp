@@ -19,9 +19,9 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound) {
 TEST(DDSerialTest, Test_convergence)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
-   config.dict_["solver"]["max_iter"] = 20000;
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["solver"]["max_iter"] = 20000;
    CheckConvergence();
 
    return;
@@ -30,10 +30,10 @@ TEST(DDSerialTest, Test_convergence)
 TEST(DDSerialTest, Test_direct_solve)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
-   config.dict_["solver"]["max_iter"] = 20000;
-   config.dict_["solver"]["direct_solve"] = true;
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["solver"]["max_iter"] = 20000;
+   config.GetDict()["solver"]["direct_solve"] = true;
    CheckConvergence();
 
    return;
@@ -42,8 +42,8 @@ TEST(DDSerialTest, Test_direct_solve)
 TEST(DDSerialTest, Test_componentwise)
 {
    config = InputParser("inputs/dd_mms.component.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
    CheckConvergence();
 
    return;
@@ -52,10 +52,10 @@ TEST(DDSerialTest, Test_componentwise)
 TEST(DDSerialTest, Test_triangle)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
-   config.dict_["solver"]["max_iter"] = 20000;
-   config.dict_["mesh"]["filename"] = "meshes/square.tri.mesh";
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["solver"]["max_iter"] = 20000;
+   config.GetDict()["mesh"]["filename"] = "meshes/square.tri.mesh";
    CheckConvergence();
 
    return;
@@ -64,11 +64,11 @@ TEST(DDSerialTest, Test_triangle)
 TEST(DDSerialTest, Test_full_dg)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
-   config.dict_["solver"]["max_iter"] = 20000;
-   config.dict_["mesh"]["filename"] = "meshes/square.tri.mesh";
-   config.dict_["discretization"]["full-discrete-galerkin"] = true;
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["solver"]["max_iter"] = 20000;
+   config.GetDict()["mesh"]["filename"] = "meshes/square.tri.mesh";
+   config.GetDict()["discretization"]["full-discrete-galerkin"] = true;
    CheckConvergence();
 
    return;
@@ -86,7 +86,7 @@ TEST(DDSerialTest, Test_full_dg)
 // TEST(DDSerial_component_3D_tet_test, Test_convergence)
 // {
 //    config = InputParser("inputs/dd_mms.comp.3d.yml");
-//    config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "meshes/dd_mms.3d.tet.mesh";
+//    config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "meshes/dd_mms.3d.tet.mesh";
 //    CheckConvergence();
 
 //    return;
@@ -193,6 +193,199 @@ TEST(BlockSmootherTest, BlockDSmoother)
    return;
 }
 
+TEST(BlockSmootherTest, BlockDenseLUSolver)
+{
+   const int nblocks = 5;
+   Array<int> block_offsets(nblocks+1);
+   block_offsets[0] = 0;
+   for (int b = 1; b <= nblocks; b++)
+      block_offsets[b] = UniformRandom(2, 6);
+   block_offsets.PartialSum();
+
+   /* arrow-shaped block pattern with a few zero blocks, which produces fill-in. */
+   Array2D<SparseMatrix *> mats(nblocks, nblocks);
+   mats = NULL;
+   for (int i = 0; i < nblocks; i++)
+      for (int j = 0; j < nblocks; j++)
+      {
+         if ((i != j) && (i != 0) && (j != 0) && (abs(i - j) > 1))
+            continue;
+
+         mats(i, j) = new SparseMatrix(block_offsets[i+1] - block_offsets[i],
+                                       block_offsets[j+1] - block_offsets[j]);
+
+         for (int ii = 0; ii < block_offsets[i+1] - block_offsets[i]; ii++)
+            for (int jj = 0; jj < block_offsets[j+1] - block_offsets[j]; jj++)
+            {
+               double val = UniformRandom();
+               if ((i == j) && (ii == jj)) val += 1.0e1;
+               mats(i, j)->Set(ii, jj, val);
+            }
+
+         mats(i, j)->Finalize();
+      }
+
+   BlockMatrix M(block_offsets);
+   for (int i = 0; i < nblocks; i++)
+      for (int j = 0; j < nblocks; j++)
+         if (mats(i, j)) M.SetBlock(i, j, mats(i, j));
+
+   SparseMatrix *M_mono = M.CreateMonolithic();
+   DenseMatrix *Minv = M_mono->ToDenseMatrix();
+   Minv->Invert();
+
+   Vector x(block_offsets.Last()), y(block_offsets.Last()), y_true(block_offsets.Last());
+   for (int k = 0; k < x.Size(); k++)
+      x(k) = UniformRandom();
+   Minv->Mult(x, y_true);
+
+   // BlockMatrix input
+   BlockDenseLUSolver block_lu(M);
+   block_lu.Mult(x, y);
+
+   double error = 0.0;
+   for (int k = 0; k < y.Size(); k++)
+      error = max(error, abs(y(k) - y_true(k)));
+   printf("BlockDenseLU error: %.5E\n", error);
+   EXPECT_TRUE(error < threshold * 1.0e1);
+
+   // monolithic SparseMatrix input
+   BlockDenseLUSolver mono_lu(block_offsets);
+   mono_lu.SetOperator(*M_mono);
+   y = 0.0;
+   mono_lu.Mult(x, y);
+
+   error = 0.0;
+   for (int k = 0; k < y.Size(); k++)
+      error = max(error, abs(y(k) - y_true(k)));
+   printf("BlockDenseLU (monolithic input) error: %.5E\n", error);
+   EXPECT_TRUE(error < threshold * 1.0e1);
+
+   // multiple right-hand sides
+   const int nrhs = 7;
+   DenseMatrix X(block_offsets.Last(), nrhs), Y, Y_true(block_offsets.Last(), nrhs);
+   for (int i = 0; i < X.NumRows(); i++)
+      for (int j = 0; j < nrhs; j++)
+         X(i, j) = UniformRandom();
+   Mult(*Minv, X, Y_true);
+   block_lu.Mult(X, Y);
+
+   error = 0.0;
+   for (int i = 0; i < Y.NumRows(); i++)
+      for (int j = 0; j < nrhs; j++)
+         error = max(error, abs(Y(i, j) - Y_true(i, j)));
+   printf("BlockDenseLU (multiple rhs) error: %.5E\n", error);
+   EXPECT_TRUE(error < threshold * 1.0e1);
+
+   delete Minv;
+   delete M_mono;
+   DeletePointers(mats);
+   return;
+}
+
+TEST(BlockSmootherTest, BlockDenseLUSolver_SaddlePoint)
+{
+   /*
+      Stokes-like block system ordered per subdomain as (u_0, p_0, u_1, p_1, ...),
+      as with separate_variable_basis. The pressure-pressure blocks are zero,
+      and the velocity blocks are coupled with their neighbors.
+   */
+   const int nsub = 4, nblocks = 2 * nsub;
+   Array<int> block_offsets(nblocks+1);
+   block_offsets[0] = 0;
+   for (int m = 0; m < nsub; m++)
+   {
+      block_offsets[2*m+1] = UniformRandom(5, 8);
+      block_offsets[2*m+2] = UniformRandom(2, 4);
+   }
+   block_offsets.PartialSum();
+
+   Array2D<SparseMatrix *> mats(nblocks, nblocks);
+   mats = NULL;
+   for (int i = 0; i < nblocks; i++)
+      for (int j = 0; j < nblocks; j++)
+      {
+         const bool vel_i = (i % 2 == 0), vel_j = (j % 2 == 0);
+         const int mi = i / 2, mj = j / 2;
+         // velocity-velocity coupling between neighbors
+         if (vel_i && vel_j && (abs(mi - mj) > 1)) continue;
+         // divergence blocks within a subdomain
+         if ((vel_i != vel_j) && (mi != mj)) continue;
+         // zero pressure-pressure blocks
+         if (!vel_i && !vel_j) continue;
+
+         mats(i, j) = new SparseMatrix(block_offsets[i+1] - block_offsets[i],
+                                       block_offsets[j+1] - block_offsets[j]);
+
+         for (int ii = 0; ii < block_offsets[i+1] - block_offsets[i]; ii++)
+            for (int jj = 0; jj < block_offsets[j+1] - block_offsets[j]; jj++)
+            {
+               double val = UniformRandom();
+               if ((i == j) && (ii == jj)) val += 1.0e1;
+               mats(i, j)->Set(ii, jj, val);
+            }
+
+         mats(i, j)->Finalize();
+      }
+
+   BlockMatrix M(block_offsets);
+   for (int i = 0; i < nblocks; i++)
+      for (int j = 0; j < nblocks; j++)
+         if (mats(i, j)) M.SetBlock(i, j, mats(i, j));
+
+   SparseMatrix *M_mono = M.CreateMonolithic();
+   DenseMatrix *Minv = M_mono->ToDenseMatrix();
+   Minv->Invert();
+
+   Vector x(block_offsets.Last()), y(block_offsets.Last()), y_true(block_offsets.Last());
+   for (int k = 0; k < x.Size(); k++)
+      x(k) = UniformRandom();
+   Minv->Mult(x, y_true);
+
+   // BlockMatrix input
+   BlockDenseLUSolver block_lu(M);
+   block_lu.Mult(x, y);
+
+   double error = 0.0;
+   for (int k = 0; k < y.Size(); k++)
+      error = max(error, abs(y(k) - y_true(k)));
+   printf("BlockDenseLU (saddle point) error: %.5E\n", error);
+   EXPECT_TRUE(error < threshold * 1.0e2);
+
+   // monolithic SparseMatrix input
+   BlockDenseLUSolver mono_lu(block_offsets);
+   mono_lu.SetOperator(*M_mono);
+   y = 0.0;
+   mono_lu.Mult(x, y);
+
+   error = 0.0;
+   for (int k = 0; k < y.Size(); k++)
+      error = max(error, abs(y(k) - y_true(k)));
+   printf("BlockDenseLU (saddle point, monolithic input) error: %.5E\n", error);
+   EXPECT_TRUE(error < threshold * 1.0e2);
+
+   // multiple right-hand sides
+   const int nrhs = 3;
+   DenseMatrix X(block_offsets.Last(), nrhs), Y, Y_true(block_offsets.Last(), nrhs);
+   for (int i = 0; i < X.NumRows(); i++)
+      for (int j = 0; j < nrhs; j++)
+         X(i, j) = UniformRandom();
+   Mult(*Minv, X, Y_true);
+   block_lu.Mult(X, Y);
+
+   error = 0.0;
+   for (int i = 0; i < Y.NumRows(); i++)
+      for (int j = 0; j < nrhs; j++)
+         error = max(error, abs(Y(i, j) - Y_true(i, j)));
+   printf("BlockDenseLU (saddle point, multiple rhs) error: %.5E\n", error);
+   EXPECT_TRUE(error < threshold * 1.0e2);
+
+   delete Minv;
+   delete M_mono;
+   DeletePointers(mats);
+   return;
+}
+
 // TODO: add more tests from sketches/yaml_example.cpp.
 
 int main(int argc, char* argv[])
@@ -174,6 +174,102 @@ TEST(DenseMatrix_test, Test_hdf5)
    return;
 }
 
+TEST(ExtendibleDataset_test, Test_hdf5)
+{
+   std::string filename("test.h5");
+   hid_t file_id;
+   herr_t errf = 0;
+   file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   DenseMatrix double2_ans(7,5);
+   for (int i = 0; i < double2_ans.NumRows(); i++)
+      for (int j = 0; j < double2_ans.NumCols(); j++) double2_ans(i,j) = UniformRandom();
+
+   // append column by column.
+   hid_t dset_id = hdf5_utils::CreateExtendibleDataset(file_id, "double2_ans", double2_ans.NumRows());
+   int ncol = 0;
+   for (int j = 0; j < double2_ans.NumCols(); j++)
+      hdf5_utils::AppendColumn(dset_id, double2_ans.NumRows(), ncol, double2_ans.GetColumn(j));
+   EXPECT_EQ(ncol, double2_ans.NumCols());
+
+   errf = H5Dclose(dset_id);
+   assert(errf >= 0);
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   int nrow;
+   hdf5_utils::GetMatrixDatasetSize(file_id, "double2_ans", nrow, ncol);
+   EXPECT_EQ(nrow, double2_ans.NumRows());
+   EXPECT_EQ(ncol, double2_ans.NumCols());
+
+   // the whole matrix, same as a non-extendible dataset.
+   DenseMatrix double2_result;
+   hdf5_utils::ReadDataset(file_id, "double2_ans", double2_result);
+   for (int i = 0; i < double2_ans.NumRows(); i++)
+      for (int j = 0; j < double2_ans.NumCols(); j++)
+         EXPECT_EQ(double2_result(i,j), double2_ans(i,j));
+
+   // a block of rows [2, 6) and columns [1, 4).
+   DenseMatrix block(4, 3);
+   hdf5_utils::ReadDatasetBlock(file_id, "double2_ans", 2, 1, block);
+   for (int i = 0; i < block.NumRows(); i++)
+      for (int j = 0; j < block.NumCols(); j++)
+         EXPECT_EQ(block(i,j), double2_ans(i+2,j+1));
+
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   return;
+}
+
+TEST(MapDataset_test, Test_hdf5)
+{
+   std::string filename("test.h5");
+   hid_t file_id;
+   herr_t errf = 0;
+
+   // aligned file, as written by SteadyNSSolver::SaveEQPElems.
+   hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+   errf = H5Pset_alignment(fapl_id, 4096, 64);
+   assert(errf >= 0);
+   file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+   assert(file_id >= 0);
+   errf = H5Pclose(fapl_id);
+   assert(errf >= 0);
+
+   Vector vec_ans(1500);
+   for (int i = 0; i < vec_ans.Size(); i++) vec_ans(i) = UniformRandom();
+   hdf5_utils::WriteDataset(file_id, "vec_ans", vec_ans);
+
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+   assert(file_id >= 0);
+
+   int size;
+   void *map_addr;
+   size_t map_length;
+   double *data = hdf5_utils::MapDataset(file_id, "vec_ans", size, map_addr, map_length);
+
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   // the mapping stays valid after the file is closed.
+   ASSERT_TRUE(data != NULL);
+   EXPECT_EQ(size, vec_ans.Size());
+   for (int i = 0; i < size; i++)
+      EXPECT_EQ(data[i], vec_ans(i));
+
+   hdf5_utils::UnmapDataset(map_addr, map_length);
+
+   return;
+}
+
 int main(int argc, char* argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
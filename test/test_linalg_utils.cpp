@@ -134,6 +134,406 @@ TEST(linalg_test, Orthonormalize)
    return;
 }
 
+TEST(linalg_test, BlockOrthonormalize)
+{
+   const int nrow = 200, ncol = 30;
+   DenseMatrix mat(nrow, ncol), orig(nrow, ncol), test(ncol, ncol);
+
+   /*
+      well-conditioned columns go through CholQR2,
+      while nearly dependent ones break it down and fall back to reorthogonalization.
+   */
+   for (int dependent = 0; dependent < 2; dependent++)
+   {
+      for (int i = 0; i < nrow; i++)
+         for (int j = 0; j < ncol; j++)
+            mat(i, j) = (dependent) ? sin(0.1 * i) + 1.0e-8 * UniformRandom() : UniformRandom();
+      orig = mat;
+
+      BlockOrthonormalize(mat);
+
+      MultAtB(mat, mat, test);
+      for (int i = 0; i < ncol; i++)
+         for (int j = 0; j < ncol; j++)
+            EXPECT_NEAR(test(i, j), (i == j) ? 1.0 : 0.0, 1.0e-12);
+
+      /* the leading columns span the same space: the projection of orig onto mat is upper-triangular. */
+      MultAtB(mat, orig, test);
+      for (int j = 0; j < ncol; j++)
+         for (int i = j + 1; i < ncol; i++)
+            EXPECT_NEAR(test(i, j), 0.0, 1.0e-10 * test.MaxMaxNorm());
+   }
+
+   return;
+}
+
+void ReferenceRtAP(DenseMatrix& R, const Operator& A, DenseMatrix& P, DenseMatrix& RAP)
+{
+   RAP.SetSize(R.NumCols(), P.NumCols());
+   Vector vec_i, vec_j, tmp(R.NumRows());
+   for (int i = 0; i < R.NumCols(); i++)
+      for (int j = 0; j < P.NumCols(); j++)
+      {
+         R.GetColumnReference(i, vec_i);
+         P.GetColumnReference(j, vec_j);
+         A.Mult(vec_j, tmp);
+         RAP(i, j) = vec_i * tmp;
+      }
+}
+
+SparseMatrix* RandomSparseMatrix(const int nrow, const int ncol, const int nnz_per_row, const bool symmetric)
+{
+   SparseMatrix *mat = new SparseMatrix(nrow, ncol);
+   for (int i = 0; i < nrow; i++)
+   {
+      mat->Add(i, i % ncol, 1.0);
+      for (int k = 0; k < nnz_per_row; k++)
+      {
+         const int j = UniformRandom(0, ncol-1);
+         const double val = UniformRandom();
+         mat->Add(i, j, val);
+         if (symmetric) mat->Add(j, i, val);
+      }
+   }
+   mat->Finalize();
+   return mat;
+}
+
+TEST(linalg_test, MultTransposeDenseBlock)
+{
+   const int nrow = 50, ncol = 80, nvec = 7;
+   SparseMatrix *A = RandomSparseMatrix(nrow, ncol, 4, false);
+
+   DenseMatrix P(nrow, nvec), AtP;
+   for (int i = 0; i < nrow; i++)
+      for (int j = 0; j < nvec; j++)
+         P(i, j) = UniformRandom();
+
+   MultTransposeDenseBlock(*A, P, AtP);
+   EXPECT_EQ(AtP.NumRows(), ncol);
+   EXPECT_EQ(AtP.NumCols(), nvec);
+
+   Vector P_j, AtP_j(ncol);
+   for (int j = 0; j < nvec; j++)
+   {
+      P.GetColumnReference(j, P_j);
+      A->MultTranspose(P_j, AtP_j);
+      for (int i = 0; i < ncol; i++)
+         EXPECT_NEAR(AtP(i, j), AtP_j(i), 1.0e-14);
+   }
+
+   delete A;
+   return;
+}
+
+TEST(linalg_test, RtAP)
+{
+   const double thre = 1.0e-12;
+   const int nrow = 200, ncol = 150, nbasis = 37;
+   SparseMatrix *A = RandomSparseMatrix(nrow, ncol, 5, false);
+   DenseMatrix R(nrow, nbasis), P(ncol, nbasis + 3);
+   for (int i = 0; i < nrow; i++)
+      for (int j = 0; j < nbasis; j++)
+         R(i, j) = UniformRandom();
+   for (int i = 0; i < ncol; i++)
+      for (int j = 0; j < nbasis + 3; j++)
+         P(i, j) = UniformRandom();
+
+   DenseMatrix ref, test;
+   ReferenceRtAP(R, *A, P, ref);
+
+   /* SparseMatrix path */
+   RtAP(R, *A, P, test);
+   for (int i = 0; i < ref.NumRows(); i++)
+      for (int j = 0; j < ref.NumCols(); j++)
+         EXPECT_NEAR(test(i, j), ref(i, j), thre * max(1.0, abs(ref(i, j))));
+
+   /* generic Operator path */
+   Array<int> row_offsets(2), col_offsets(2);
+   row_offsets[0] = 0; row_offsets[1] = nrow;
+   col_offsets[0] = 0; col_offsets[1] = ncol;
+   BlockMatrix bmat(row_offsets, col_offsets);
+   bmat.SetBlock(0, 0, A);
+   RtAP(R, bmat, P, test);
+   for (int i = 0; i < ref.NumRows(); i++)
+      for (int j = 0; j < ref.NumCols(); j++)
+         EXPECT_NEAR(test(i, j), ref(i, j), thre * max(1.0, abs(ref(i, j))));
+
+   /* weighted addition */
+   SparseMatrix *sp_test = SparseRtAP(R, *A, P);
+   AddwRtAP(R, *A, P, *sp_test, -0.5);
+   test = ref;
+   AddwRtAP(R, *A, P, test, -0.5);
+   for (int i = 0; i < ref.NumRows(); i++)
+      for (int j = 0; j < ref.NumCols(); j++)
+      {
+         EXPECT_NEAR(test(i, j), 0.5 * ref(i, j), thre * max(1.0, abs(ref(i, j))));
+         EXPECT_NEAR((*sp_test)(i, j), 0.5 * ref(i, j), thre * max(1.0, abs(ref(i, j))));
+      }
+
+   delete sp_test;
+   delete A;
+   return;
+}
+
+TEST(linalg_test, RtAP_symmetric)
+{
+   const double thre = 1.0e-12;
+   const int nrow = 200, nbasis = 37;
+   SparseMatrix *A = RandomSparseMatrix(nrow, nrow, 5, true);
+   DenseMatrix P(nrow, nbasis);
+   for (int i = 0; i < nrow; i++)
+      for (int j = 0; j < nbasis; j++)
+         P(i, j) = UniformRandom();
+
+   DenseMatrix ref, test;
+   ReferenceRtAP(P, *A, P, ref);
+   RtAP(P, *A, P, test);
+   for (int i = 0; i < nbasis; i++)
+      for (int j = 0; j < nbasis; j++)
+      {
+         EXPECT_NEAR(test(i, j), ref(i, j), thre * max(1.0, abs(ref(i, j))));
+         EXPECT_DOUBLE_EQ(test(i, j), test(j, i));
+      }
+
+   delete A;
+   return;
+}
+
+TEST(linalg_test, RtAP_multiple_blocks)
+{
+   /* several column blocks of the blocked kernel, with a partial last block. */
+   const int nrow = 3000, nbasis = 53;
+   SparseMatrix *A = RandomSparseMatrix(nrow, nrow, 8, true);
+   DenseMatrix P(nrow, nbasis);
+   for (int i = 0; i < nrow; i++)
+      for (int j = 0; j < nbasis; j++)
+         P(i, j) = UniformRandom();
+
+   DenseMatrix ref, test;
+   ReferenceRtAP(P, *A, P, ref);
+   RtAP(P, *A, P, test);
+
+   for (int i = 0; i < nbasis; i++)
+      for (int j = 0; j < nbasis; j++)
+         EXPECT_NEAR(test(i, j), ref(i, j), 1.0e-10 * max(1.0, abs(ref(i, j))));
+
+   delete A;
+   return;
+}
+
+TEST(linalg_test, DenseLUSolver)
+{
+   const int n = 50;
+   SparseMatrix *A = RandomSparseMatrix(n, n, 4, false);
+   for (int i = 0; i < n; i++)
+      A->Add(i, i, 10.0);
+
+   Vector x(n), b(n), Ax(n);
+   for (int i = 0; i < n; i++)
+      b(i) = UniformRandom();
+
+   DenseLUSolver solver;
+   solver.SetOperator(*A);
+   solver.Mult(b, x);
+
+   A->Mult(x, Ax);
+   for (int i = 0; i < n; i++)
+      EXPECT_NEAR(Ax(i), b(i), 1.0e-12);
+
+   delete A;
+   return;
+}
+
+TEST(linalg_test, SolveBoundedNNLS)
+{
+   /* an EQP-like system: m constraints over n positively weighted points. */
+   const int m = 20, n = 300;
+   const double tol = 1.0e-2;
+   DenseMatrix G(m, n);
+   Vector w(n), rhs(m), lb(m), ub(m);
+   for (int j = 0; j < n; j++)
+   {
+      w(j) = UniformRandom();
+      for (int i = 0; i < m; i++)
+         G(i, j) = 2.0 * UniformRandom() - 1.0;
+   }
+   G.Mult(w, rhs);
+   for (int i = 0; i < m; i++)
+   {
+      lb(i) = rhs(i) - tol * abs(rhs(i));
+      ub(i) = rhs(i) + tol * abs(rhs(i));
+   }
+
+   Vector sol;
+   EXPECT_TRUE(SolveBoundedNNLS(G, lb, ub, sol));
+   EXPECT_EQ(sol.Size(), n);
+
+   int nnz = 0;
+   for (int j = 0; j < n; j++)
+   {
+      EXPECT_TRUE(sol(j) >= 0.0);
+      if (sol(j) > 0.0) nnz++;
+   }
+   // the solution is sparse, with at most one point per constraint.
+   EXPECT_TRUE(nnz <= m);
+
+   Vector Gsol(m);
+   G.Mult(sol, Gsol);
+   for (int i = 0; i < m; i++)
+   {
+      EXPECT_TRUE(Gsol(i) >= lb(i) - 1.0e-12 * abs(rhs(i)));
+      EXPECT_TRUE(Gsol(i) <= ub(i) + 1.0e-12 * abs(rhs(i)));
+   }
+
+   /* L2 criterion: the residual from the center is bounded by the half gap in l2 norm. */
+   EXPECT_TRUE(SolveBoundedNNLS(G, lb, ub, sol, CAROM::NNLS_termination::L2));
+   for (int j = 0; j < n; j++)
+      EXPECT_TRUE(sol(j) >= 0.0);
+
+   Vector halfgap(m);
+   add(0.5, ub, -0.5, lb, halfgap);
+   G.Mult(sol, Gsol);
+   Gsol -= rhs;
+   EXPECT_TRUE(Gsol.Norml2() <= halfgap.Norml2() * (1.0 + 1.0e-12));
+
+   return;
+}
+
+void RandomTensor(DenseTensor &tensor)
+{
+   double *d = tensor.HostWrite();
+   for (int k = 0; k < tensor.TotalSize(); k++)
+      d[k] = UniformRandom();
+}
+
+TEST(linalg_test, TensorContractions)
+{
+   const double thre = 1.0e-12;
+   const int ni = 13, nj = 13, nk = 9;
+   DenseTensor T(ni, nj, nk);
+   RandomTensor(T);
+
+   Vector xi(ni), xj(nj), xk(nk);
+   for (int i = 0; i < ni; i++) xi(i) = UniformRandom();
+   for (int j = 0; j < nj; j++) xj(j) = UniformRandom();
+   for (int k = 0; k < nk; k++) xk(k) = UniformRandom();
+
+   /* y_k = T_{ijk} * x_i * x_j */
+   Vector yk, yk_ref(nk);
+   yk_ref = 0.0;
+   for (int k = 0; k < nk; k++)
+      for (int j = 0; j < nj; j++)
+         for (int i = 0; i < ni; i++)
+            yk_ref(k) += T(i, j, k) * xi(i) * xj(j);
+   TensorContract(T, xi, xj, yk);
+   for (int k = 0; k < nk; k++)
+      EXPECT_NEAR(yk(k), yk_ref(k), thre);
+   TensorAddScaledContract(T, -0.5, xi, xj, yk);
+   for (int k = 0; k < nk; k++)
+      EXPECT_NEAR(yk(k), 0.5 * yk_ref(k), thre);
+
+   /* batched contraction, Y_{kb} += w * T_{ijk} * Xi_{ib} * Xj_{jb} */
+   const int nb = 5;
+   DenseMatrix Xi(ni, nb), Xj(nj, nb), Y(nk, nb);
+   for (int b = 0; b < nb; b++)
+   {
+      for (int i = 0; i < ni; i++) Xi(i, b) = UniformRandom();
+      for (int j = 0; j < nj; j++) Xj(j, b) = UniformRandom();
+   }
+   Y = 1.0;
+   TensorAddScaledContract(T, 2.0, Xi, Xj, Y);
+   Vector xi_b, xj_b, yk_b;
+   for (int b = 0; b < nb; b++)
+   {
+      Xi.GetColumnReference(b, xi_b);
+      Xj.GetColumnReference(b, xj_b);
+      TensorContract(T, xi_b, xj_b, yk_b);
+      for (int k = 0; k < nk; k++)
+         EXPECT_NEAR(Y(k, b), 1.0 + 2.0 * yk_b(k), thre);
+   }
+
+   /* M_{ij} = T_{ijk} * x_k, M_{ik} += T_{ijk} * x_j */
+   DenseMatrix Mij(ni, nj), Mik(ni, nk);
+   Mik = 0.0;
+   TensorMult(T, xk, Mij);
+   TensorAddMultOnJ(T, xj, Mik);
+   for (int i = 0; i < ni; i++)
+   {
+      for (int j = 0; j < nj; j++)
+      {
+         double val = 0.0;
+         for (int k = 0; k < nk; k++) val += T(i, j, k) * xk(k);
+         EXPECT_NEAR(Mij(i, j), val, thre);
+      }
+      for (int k = 0; k < nk; k++)
+      {
+         double val = 0.0;
+         for (int j = 0; j < nj; j++) val += T(i, j, k) * xj(j);
+         EXPECT_NEAR(Mik(i, k), val, thre);
+      }
+   }
+
+   /* axis 0: M_{kj} += T_{ijk} * x_i, axis 1: M_{ki} += T_{ijk} * x_j */
+   DenseMatrix M0(nk, nj), M1(nk, ni), Mf(nk, ni);
+   M0 = 0.0; M1 = 0.0; Mf = 0.0;
+   TensorAddMultTranspose(T, xi, 0, M0);
+   TensorAddMultTranspose(T, xj, 1, M1);
+   TensorAddFusedMultTranspose(T, xi, Mf);
+   for (int k = 0; k < nk; k++)
+      for (int n = 0; n < ni; n++)
+      {
+         double val0 = 0.0, val1 = 0.0, valf = 0.0;
+         for (int m = 0; m < ni; m++)
+         {
+            val0 += T(m, n, k) * xi(m);
+            val1 += T(n, m, k) * xj(m);
+            valf += (T(m, n, k) + T(n, m, k)) * xi(m);
+         }
+         EXPECT_NEAR(M0(k, n), val0, thre);
+         EXPECT_NEAR(M1(k, n), val1, thre);
+         EXPECT_NEAR(Mf(k, n), valf, thre);
+      }
+
+   return;
+}
+
+TEST(linalg_test, TensorContractions_benchmark)
+{
+   const int n = 120, nrep = 10;
+   DenseTensor T(n, n, n);
+   RandomTensor(T);
+
+   Vector x(n);
+   for (int i = 0; i < n; i++) x(i) = UniformRandom();
+
+   StopWatch sep_timer, fused_timer;
+   DenseMatrix Msep(n, n), Mfused(n, n);
+   Msep = 0.0; Mfused = 0.0;
+
+   sep_timer.Start();
+   for (int r = 0; r < nrep; r++)
+   {
+      TensorAddMultTranspose(T, x, 0, Msep);
+      TensorAddMultTranspose(T, x, 1, Msep);
+   }
+   sep_timer.Stop();
+
+   fused_timer.Start();
+   for (int r = 0; r < nrep; r++)
+      TensorAddFusedMultTranspose(T, x, Mfused);
+   fused_timer.Stop();
+
+   printf("Tensor jacobian (%d^3, %d times) two contractions: %f seconds.\n", n, nrep, sep_timer.RealTime());
+   printf("Tensor jacobian (%d^3, %d times) fused contraction: %f seconds.\n", n, nrep, fused_timer.RealTime());
+
+   for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+         EXPECT_NEAR(Mfused(i, j), Msep(i, j), 1.0e-10 * max(1.0, abs(Msep(i, j))));
+
+   return;
+}
+
 // TODO: add more tests from sketches/yaml_example.cpp.
 
 int main(int argc, char* argv[])
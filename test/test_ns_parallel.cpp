@@ -24,13 +24,13 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound)
 TEST(NSTensor, Sampling)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
    return;
@@ -39,11 +39,11 @@ TEST(NSTensor, Sampling)
 TEST(NSTensor, Train)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    return;
@@ -52,16 +52,16 @@ TEST(NSTensor, Train)
 TEST(NSTensor, Build_SingleRun)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -74,16 +74,16 @@ TEST(NSTensor, Build_SingleRun)
 TEST(NSEQP, Sampling)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
-   config.dict_["model_reduction"]["nonlinear_handling"] = "eqp";
-   config.dict_["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
-   config.dict_["model_reduction"]["eqp"]["precompute"] = true;
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["nonlinear_handling"] = "eqp";
+   config.GetDict()["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
+   config.GetDict()["model_reduction"]["eqp"]["precompute"] = true;
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
    return;
@@ -92,14 +92,35 @@ TEST(NSEQP, Sampling)
 TEST(NSEQP, Train)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
-   config.dict_["model_reduction"]["nonlinear_handling"] = "eqp";
-   config.dict_["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
-   config.dict_["model_reduction"]["eqp"]["precompute"] = true;
-
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["nonlinear_handling"] = "eqp";
+   config.GetDict()["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
+   config.GetDict()["model_reduction"]["eqp"]["precompute"] = true;
+
+   config.GetDict()["main"]["mode"] = "train_rom";
+   TrainROM(MPI_COMM_WORLD);
+
+   return;
+}
+
+TEST(NSEQP, TrainByTask)
+{
+   config = InputParser("inputs/steady_ns.component.yml");
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["nonlinear_handling"] = "eqp";
+   config.GetDict()["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
+   config.GetDict()["model_reduction"]["eqp"]["precompute"] = true;
+   /*
+      each integrator and reference port is trained on one process and broadcast to all.
+      rank 0 saves the EQP file, so Build_SingleRun afterward checks the broadcast samples.
+   */
+   config.GetDict()["model_reduction"]["eqp"]["training_scheduler"] = "task";
+
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    return;
@@ -108,19 +129,19 @@ TEST(NSEQP, Train)
 TEST(NSEQP, Build_SingleRun)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
-   config.dict_["model_reduction"]["nonlinear_handling"] = "eqp";
-   config.dict_["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
-   config.dict_["model_reduction"]["eqp"]["precompute"] = true;
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["nonlinear_handling"] = "eqp";
+   config.GetDict()["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
+   config.GetDict()["model_reduction"]["eqp"]["precompute"] = true;
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
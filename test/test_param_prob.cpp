@@ -5,6 +5,7 @@
 #include<gtest/gtest.h>
 #include "mfem.hpp"
 #include "random_sample_generator.hpp"
+#include "utils/mpi_utils.h"  // this is from libROM/utils.
 #include <fstream>
 #include <iostream>
 #include <cmath>
@@ -83,6 +84,289 @@ TEST(SampleGeneratorTest, Test_Parsing)
    return;
 }
 
+TEST(SampleGeneratorTest, SampleQueue)
+{
+   config = InputParser("inputs/test_param_prob.yml");
+
+   for (const std::string scheduler : {"static", "dynamic"})
+   {
+      config.SetOption<std::string>("sample_generation/scheduler", scheduler);
+      SampleGenerator sample_gen(MPI_COMM_WORLD);
+      sample_gen.SetParamSpaceSizes();
+      const int total = sample_gen.GetTotalSampleSize();
+
+      // every sample is taken exactly once over all processes.
+      Array<int> taken(total);
+      taken = 0;
+      sample_gen.StartSampleQueue();
+      for (int s = sample_gen.GetNextSample(); s >= 0; s = sample_gen.GetNextSample())
+      {
+         EXPECT_TRUE((s >= 0) && (s < total));
+         taken[s] += 1;
+      }
+      sample_gen.FinishSampleQueue(0.0);
+
+      MPI_Allreduce(MPI_IN_PLACE, taken.GetData(), total, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+      for (int s = 0; s < total; s++)
+         EXPECT_EQ(taken[s], 1);
+   }
+
+   return;
+}
+
+TEST(SampleGeneratorTest, SnapshotStream)
+{
+   config = InputParser("inputs/test_param_prob.yml");
+   config.SetOption<bool>("sample_generation/stream_snapshots", true);
+   config.SetOption<std::string>("sample_generation/file_path/prefix", "stream_test");
+
+   int rank, nproc;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+   const int nrow = 10;
+   const BasisTag tag("comp0");
+   // snapshot entry of column c of process r.
+   auto entry = [](const int r, const int c, const int i) { return 1.0e3 * r + 1.0e2 * c + i; };
+
+   std::string filename;
+   {
+      SampleGenerator sample_gen(MPI_COMM_WORLD);
+      filename = sample_gen.GetBaseFilename(sample_gen.GetSamplePrefix(), tag) + "_snapshot";
+
+      // a stale file from a previous run with more processes must not be loaded.
+      if (rank == 0)
+      {
+         SnapshotStream stale(filename, nproc, nrow);
+         Vector tmp(nrow);
+         tmp = -1.0;
+         stale.Append(tmp);
+      }
+
+      // process 1 takes no sample, as can happen with the dynamic scheduler.
+      // column c of process r is the sample (c * nproc + r).
+      const int ncol = (rank == 1) ? 0 : rank + 1;
+      Array<int> block_offsets(2);
+      block_offsets[0] = 0;
+      block_offsets[1] = nrow;
+      BlockVector U(block_offsets);
+      std::vector<BasisTag> tags(1, tag);
+      Array<int> col_idxs;
+      for (int c = 0; c < ncol; c++)
+      {
+         for (int i = 0; i < nrow; i++)
+            U(i) = entry(rank, c, i);
+         sample_gen.SetCurrentSample(c * nproc + rank);
+         sample_gen.SaveSnapshot(&U, tags, col_idxs);
+         EXPECT_EQ(col_idxs[0], c);
+      }
+      sample_gen.WriteSnapshots();
+   }
+
+   /* load the streams back over all processes. */
+   SampleGenerator collector(MPI_COMM_WORLD);
+   collector.CollectSnapshotsByBasis("stream_test_basis", tag, std::vector<std::string>(1, filename));
+   std::shared_ptr<const CAROM::Matrix> snapshots = collector.LookUpSnapshot(tag);
+
+   int num_snap = 0;
+   for (int r = 0; r < nproc; r++)
+      num_snap += (r == 1) ? 0 : r + 1;
+   EXPECT_EQ(snapshots->numColumns(), num_snap);
+
+   int local_rows = snapshots->numRows(), row_offset = 0;
+   MPI_Exscan(&local_rows, &row_offset, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+   if (rank == 0) row_offset = 0;
+
+   /* columns are ordered by their sample, not by the process that streamed them. */
+   int col = 0;
+   for (int sample = 0; col < num_snap; sample++)
+   {
+      const int r = sample % nproc, c = sample / nproc;
+      if ((r == 1) || (c >= r + 1)) continue;
+
+      for (int i = 0; i < local_rows; i++)
+         EXPECT_EQ(snapshots->item(i, col), entry(r, c, row_offset + i));
+      col++;
+   }
+
+   return;
+}
+
+TEST(SampleGeneratorTest, SnapshotPorts)
+{
+   config = InputParser("inputs/test_param_prob.yml");
+   config.SetOption<bool>("sample_generation/stream_snapshots", true);
+   config.SetOption<std::string>("sample_generation/file_path/prefix", "port_test");
+
+   int rank, nproc;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+   Mesh *pmesh = new Mesh("meshes/test.2x1.mesh");
+   TopologyHandler *topol = new SubMeshTopologyHandler(pmesh);
+   const int numSub = topol->GetNumSubdomains();
+   assert(topol->GetNumPorts() == 1);
+
+   const int nrow = 10;
+   // every entry of a snapshot is its sample index.
+   const int num_sample = 2 * nproc + 1;
+   std::string port_file;
+   {
+      SampleGenerator sample_gen(MPI_COMM_WORLD);
+      port_file = sample_gen.GetSamplePrefix() + ".port.h5";
+
+      Array<int> block_offsets(numSub + 1);
+      block_offsets = nrow;
+      block_offsets[0] = 0;
+      block_offsets.PartialSum();
+      BlockVector U(block_offsets);
+      std::vector<BasisTag> tags;
+      for (int m = 0; m < numSub; m++)
+         tags.push_back(BasisTag(topol->GetComponentName(topol->GetMeshType(m))));
+
+      // samples are dealt in a round robin, in the reverse order on each process.
+      Array<int> col_idxs;
+      for (int sample = num_sample - 1; sample >= 0; sample--)
+      {
+         if (sample % nproc != rank) continue;
+         U = static_cast<double>(sample);
+         sample_gen.SetCurrentSample(sample);
+         sample_gen.SaveSnapshot(&U, tags, col_idxs);
+         sample_gen.SaveSnapshotPorts(topol, col_idxs);
+      }
+      sample_gen.WriteSnapshots();
+      sample_gen.WriteSnapshotPorts();
+   }
+
+   SampleGenerator collector(MPI_COMM_WORLD);
+   collector.CollectSnapshotsByPort("port_test_basis", port_file);
+
+   const PortInfo *pInfo = topol->GetPortInfo(0);
+   PortTag tag = {.Mesh1 = topol->GetComponentName(topol->GetMeshType(pInfo->Mesh1)),
+                  .Mesh2 = topol->GetComponentName(topol->GetMeshType(pInfo->Mesh2)),
+                  .Attr1 = pInfo->Attr1, .Attr2 = pInfo->Attr2};
+   Array2D<int> *col_idxs = collector.LookUpSnapshotPortColOffsets(tag);
+   std::shared_ptr<const CAROM::Matrix> snapshots1 = collector.LookUpSnapshot(BasisTag(tag.Mesh1));
+   std::shared_ptr<const CAROM::Matrix> snapshots2 = collector.LookUpSnapshot(BasisTag(tag.Mesh2));
+   EXPECT_EQ(snapshots1->numColumns(), num_sample);
+   EXPECT_EQ(snapshots2->numColumns(), num_sample);
+
+   // the pairs of each sample point to the columns of the same sample, in the sample order.
+   ASSERT_EQ(col_idxs->NumRows(), num_sample);
+   for (int k = 0; k < num_sample; k++)
+   {
+      EXPECT_EQ((*col_idxs)(k, 0), k);
+      EXPECT_EQ((*col_idxs)(k, 1), k);
+      for (int i = 0; i < snapshots1->numRows(); i++)
+         EXPECT_EQ(snapshots1->item(i, (*col_idxs)(k, 0)), static_cast<double>(k));
+      for (int i = 0; i < snapshots2->numRows(); i++)
+         EXPECT_EQ(snapshots2->item(i, (*col_idxs)(k, 1)), static_cast<double>(k));
+   }
+
+   delete topol;
+   return;
+}
+
+/*
+   Form a basis of snapshots of rank num_basis with the given SVD type,
+   and return its local rows distributed as in CollectSnapshotsByBasis.
+*/
+std::shared_ptr<const CAROM::Matrix> FormBasisBySVD(const std::string &svd_type, const int oversampling)
+{
+   config = InputParser("inputs/test_param_prob.yml");
+   config.SetOption<bool>("sample_generation/stream_snapshots", true);
+   config.SetOption<std::string>("sample_generation/file_path/prefix", "svd_test");
+   config.SetOption<int>("basis/number_of_basis", 3);
+   config.SetOption<std::string>("basis/svd/type", svd_type);
+   config.SetOption<int>("basis/svd/oversampling", oversampling);
+
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   const int nrow = 20, ncol = 8, num_basis = 3;
+   const BasisTag tag("comp0");
+
+   std::string filename;
+   {
+      SampleGenerator sample_gen(MPI_COMM_WORLD);
+      filename = sample_gen.GetBaseFilename(sample_gen.GetSamplePrefix(), tag) + "_snapshot";
+
+      /* only process 0 takes samples, combinations of num_basis cosine modes with decaying weights. */
+      Array<int> block_offsets(2);
+      block_offsets[0] = 0;
+      block_offsets[1] = nrow;
+      BlockVector U(block_offsets);
+      std::vector<BasisTag> tags(1, tag);
+      Array<int> col_idxs;
+      for (int c = 0; (rank == 0) && (c < ncol); c++)
+      {
+         U = 0.0;
+         for (int j = 0; j < num_basis; j++)
+            for (int i = 0; i < nrow; i++)
+               U(i) += pow(0.1, j) * cos(c * (j + 1.0)) * cos((j + 1) * (i + 0.5) * M_PI / nrow);
+         sample_gen.SaveSnapshot(&U, tags, col_idxs);
+      }
+      sample_gen.WriteSnapshots();
+   }
+
+   const std::string basis_prefix = "svd_test_" + svd_type + "_" + std::to_string(oversampling);
+   SampleGenerator collector(MPI_COMM_WORLD);
+   collector.CollectSnapshotsByBasis(basis_prefix, tag, std::vector<std::string>(1, filename));
+   collector.FormReducedBasis(basis_prefix);
+
+   const int local_dim = CAROM::split_dimension(nrow, MPI_COMM_WORLD);
+   CAROM::BasisReader basis_reader(collector.GetBaseFilename(basis_prefix, tag),
+                                   CAROM::Database::formats::HDF5_MPIO, local_dim);
+   return basis_reader.getSpatialBasis(num_basis);
+}
+
+// Frobenius norm of the part of test_basis outside the span of ref_basis, both orthonormal.
+double SubspaceError(const CAROM::Matrix &ref_basis, const CAROM::Matrix &test_basis)
+{
+   const int nrow = ref_basis.numRows();
+   const int nb = ref_basis.numColumns();
+   assert(test_basis.numRows() == nrow);
+   assert(test_basis.numColumns() == nb);
+
+   DenseMatrix proj(nb, nb);
+   proj = 0.0;
+   for (int i = 0; i < nrow; i++)
+      for (int a = 0; a < nb; a++)
+         for (int b = 0; b < nb; b++)
+            proj(a, b) += ref_basis.item(i, a) * test_basis.item(i, b);
+   MPI_Allreduce(MPI_IN_PLACE, proj.GetData(), nb * nb, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+   double error = 0.0;
+   for (int i = 0; i < nrow; i++)
+      for (int b = 0; b < nb; b++)
+      {
+         double res = test_basis.item(i, b);
+         for (int a = 0; a < nb; a++)
+            res -= ref_basis.item(i, a) * proj(a, b);
+         error += res * res;
+      }
+   MPI_Allreduce(MPI_IN_PLACE, &error, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+   return sqrt(error);
+}
+
+TEST(SampleGeneratorTest, SVDTypes)
+{
+   const double threshold = 1.0e-6;
+   std::shared_ptr<const CAROM::Matrix> static_basis = FormBasisBySVD("static", 10);
+
+   std::shared_ptr<const CAROM::Matrix> randomized_basis = FormBasisBySVD("randomized", 2);
+   EXPECT_TRUE(SubspaceError(*static_basis, *randomized_basis) < threshold);
+
+   // number_of_basis + oversampling exceeds the number of snapshots: falls back to static SVD.
+   std::shared_ptr<const CAROM::Matrix> fallback_basis = FormBasisBySVD("randomized", 10);
+   EXPECT_TRUE(SubspaceError(*static_basis, *fallback_basis) < threshold);
+
+   std::shared_ptr<const CAROM::Matrix> incremental_basis = FormBasisBySVD("incremental", 2);
+   EXPECT_TRUE(SubspaceError(*static_basis, *incremental_basis) < threshold);
+
+   return;
+}
+
 TEST(RandomSampleGeneratorTest, Test_Parsing)
 {
    config = InputParser("inputs/test_param_prob.yml");
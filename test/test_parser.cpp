@@ -91,7 +91,7 @@ TEST(YAML_test, LoopingOverKeys)
    vals[1] = 2.0;
    vals[2] = 3.0;
 
-   YAML::Node test = config.dict_["test"];
+   YAML::Node test = config.GetDict()["test"];
    int k = 0;
    for(YAML::const_iterator it=test.begin(); it != test.end(); ++it) {
       std::string key = it->first.as<std::string>();       // <- key
@@ -139,6 +139,74 @@ TEST(YAML_test, OverwriteOption)
    return;
 }
 
+TEST(YAML_test, OptionSnapshot)
+{
+   config = InputParser("inputs/test.parser.yml");
+
+   IterativeSolverOptions opts("solver", 10000, 1.e-15, 1.e-15, 0);
+   EXPECT_FALSE(opts.IsCurrent());
+   opts.Update();
+   EXPECT_TRUE(opts.IsCurrent());
+   EXPECT_EQ(opts.max_iter, 10000);
+   EXPECT_EQ(opts.rtol, 1.e-15);
+   EXPECT_EQ(opts.print_level, 0);
+
+   // changes through InputParser are picked up at the next Update.
+   config.SetOption<int>("solver/max_iter", 7);
+   config.SetOption<double>("solver/relative_tolerance", 1.e-3);
+   EXPECT_FALSE(opts.IsCurrent());
+   EXPECT_EQ(opts.max_iter, 10000);
+   opts.Update();
+   EXPECT_EQ(opts.max_iter, 7);
+   EXPECT_EQ(opts.rtol, 1.e-3);
+   EXPECT_EQ(opts.atol, 1.e-15);
+
+   // so are direct modifications of the options.
+   config.GetDict()["solver"]["max_iter"] = 11;
+   EXPECT_FALSE(opts.IsCurrent());
+   opts.Update();
+   EXPECT_EQ(opts.max_iter, 11);
+
+   LinearSolverOptions lin_opts("solver", 10000, 1.e-15, 1.e-15, 0);
+   lin_opts.Update();
+   EXPECT_EQ(lin_opts.max_iter, 11);
+   EXPECT_TRUE(lin_opts.block_diag_prec);
+   config.SetOption<bool>("solver/block_diagonal_preconditioner", false);
+   lin_opts.Update();
+   EXPECT_FALSE(lin_opts.block_diag_prec);
+
+   // a new input is a new revision as well.
+   config = InputParser("inputs/test.parser.yml");
+   EXPECT_FALSE(opts.IsCurrent());
+   opts.Update();
+   EXPECT_EQ(opts.max_iter, 10000);
+
+   NonlinearSolverOptions nlin_opts;
+   config.SetOption<int>("solver/jacobian/print_level", 2);
+   config.SetOption<bool>("solver/use_restart", true);
+   config.SetOption<std::string>("solver/restart_file", "restart.h5");
+   nlin_opts.Update();
+   EXPECT_EQ(nlin_opts.newton.max_iter, 100);
+   EXPECT_EQ(nlin_opts.newton.rtol, 1.e-10);
+   EXPECT_EQ(nlin_opts.jacobian.max_iter, 10000);
+   EXPECT_EQ(nlin_opts.jacobian.print_level, 2);
+   EXPECT_FALSE(nlin_opts.use_lbfgs);
+   EXPECT_TRUE(nlin_opts.use_restart);
+   EXPECT_EQ(nlin_opts.restart_file, "restart.h5");
+
+   YAML::Node dict0 = YAML::Clone(config.GetDict());
+   config.SetOption<bool>("solver/use_restart", false);
+   nlin_opts.Update();
+   EXPECT_FALSE(nlin_opts.use_restart);
+   EXPECT_EQ(nlin_opts.restart_file, "");
+
+   config.SetDict(dict0);
+   nlin_opts.Update();
+   EXPECT_TRUE(nlin_opts.use_restart);
+
+   return;
+}
+
 // TODO: add more tests from sketches/yaml_example.cpp.
 
 int main(int argc, char* argv[])
@@ -7,6 +7,8 @@
 #include "interfaceinteg.hpp"
 #include "rom_nonlinearform.hpp"
 #include "etc.hpp"
+#include "linalg_utils.hpp"
+#include "input_parser.hpp"
 
 using namespace std;
 using namespace mfem;
@@ -698,6 +700,295 @@ TEST(ROMNonlinearForm_fast, IncompressibleInviscidFluxNLFIntegrator)
    return;
 }
 
+TEST(ROMNonlinearForm_fast, ThreadedDomainIntegrator)
+{
+#if !defined(_OPENMP) || !defined(MFEM_THREAD_SAFE)
+   GTEST_SKIP() << "threaded EQP evaluation requires OpenMP and mfem built with MFEM_THREAD_SAFE.";
+#endif
+   Mesh *mesh = new Mesh("meshes/test.4x4.mesh");
+   const int dim = mesh->Dimension();
+   const int order = UniformRandom(1, 3);
+
+   FiniteElementCollection *h1_coll(new H1_FECollection(order, dim));
+   FiniteElementSpace *fes(new FiniteElementSpace(mesh, h1_coll, dim));
+   const int ndofs = fes->GetTrueVSize();
+
+   const int num_basis = 10;
+   // a fictitious basis.
+   DenseMatrix basis(ndofs, num_basis);
+   for (int i = 0; i < ndofs; i++)
+      for (int j = 0; j < num_basis; j++)
+         basis(i, j) = UniformRandom();
+
+   IntegrationRule ir = IntRules.Get(fes->GetFE(0)->GetGeomType(),
+                                    (int)(ceil(1.5 * (2 * fes->GetMaxElementOrder() - 1))));
+   ConstantCoefficient pi(3.141592);
+
+   const int nsample = UniformRandom(50, 100);
+   const int nqe = ir.GetNPoints();
+   const int ne = fes->GetNE();
+   Array<SampleInfo> samples(nsample);
+   for (int s = 0; s < nsample; s++)
+   {
+      samples[s].el = UniformRandom(0, ne-1);
+      samples[s].qp = UniformRandom(0, nqe-1);
+      samples[s].qw = UniformRandom();
+   }
+
+   /* serial and threaded forms with the same samples. */
+   ROMNonlinearForm *rforms[2];
+   for (int f = 0; f < 2; f++)
+   {
+      config.GetDict()["model_reduction"]["eqp"]["num_threads"] = (f == 0) ? 1 : 4;
+      auto *integ = new VectorConvectionTrilinearFormIntegrator(pi);
+      integ->SetIntRule(&ir);
+
+      rforms[f] = new ROMNonlinearForm(num_basis, fes);
+      rforms[f]->AddDomainIntegrator(integ);
+      rforms[f]->SetBasis(basis);
+      rforms[f]->UpdateDomainIntegratorSampling(0, samples);
+      rforms[f]->PrecomputeCoefficients();
+      rforms[f]->SetPrecomputeMode(true);
+   }
+   config.GetDict()["model_reduction"]["eqp"]["num_threads"] = 1;
+
+   Vector rom_u(num_basis);
+   for (int k = 0; k < rom_u.Size(); k++)
+      rom_u(k) = UniformRandom();
+
+   Vector rom_y(num_basis), rom_yt(num_basis), rom_yt2(num_basis);
+   rforms[0]->Mult(rom_u, rom_y);
+   rforms[1]->Mult(rom_u, rom_yt);
+   rforms[1]->Mult(rom_u, rom_yt2);
+   for (int k = 0; k < rom_y.Size(); k++)
+   {
+      EXPECT_NEAR(rom_y(k), rom_yt(k), threshold);
+      // deterministic mode is bitwise reproducible.
+      EXPECT_EQ(rom_yt(k), rom_yt2(k));
+   }
+
+   DenseMatrix jac(*dynamic_cast<DenseMatrix *>(&(rforms[0]->GetGradient(rom_u))));
+   DenseMatrix *jac_t = dynamic_cast<DenseMatrix *>(&(rforms[1]->GetGradient(rom_u)));
+   for (int i = 0; i < num_basis; i++)
+      for (int j = 0; j < num_basis; j++)
+         EXPECT_NEAR(jac(i, j), (*jac_t)(i, j), threshold);
+
+   delete mesh;
+   delete h1_coll;
+   delete fes;
+   delete rforms[0];
+   delete rforms[1];
+   return;
+}
+
+TEST(ROMNonlinearForm_fast, PackedEQPCoefficients)
+{
+   const int dim = 2, nbasis1 = 4, nbasis2 = 3, nsample = 5;
+   Array<SampleInfo> samples(nsample);
+   for (int s = 0; s < nsample; s++)
+      samples[s] = SampleInfo({.el=s, .qp=0, .qw=1.0});
+
+   EQPElement eqp_elem(samples);
+   eqp_elem.AllocateCoefficients(dim, nbasis1, nbasis2, true);
+
+   /* all samples are views into one contiguous buffer, in the sample order. */
+   const int stride = 1 + (dim + dim * dim) * (nbasis1 + nbasis2);
+   EXPECT_EQ(eqp_elem.GetCoefficientSize(), stride);
+   EXPECT_EQ(eqp_elem.coeffs.Size(), stride * nsample);
+
+   double *d_coeffs = eqp_elem.coeffs.GetData();
+   for (int s = 0; s < nsample; s++, d_coeffs += stride)
+   {
+      EQPSample *sample = eqp_elem.GetSample(s);
+      EXPECT_EQ(sample->weight, d_coeffs);
+      EXPECT_EQ(sample->shape1.GetData(), d_coeffs + 1);
+      EXPECT_EQ(sample->shape1.NumRows(), dim);
+      EXPECT_EQ(sample->shape1.NumCols(), nbasis1);
+      EXPECT_EQ(sample->dshape1, sample->shape1.GetData() + dim * nbasis1);
+      EXPECT_EQ(sample->shape2.GetData(), sample->dshape1 + dim * dim * nbasis1);
+      EXPECT_EQ(sample->shape2.NumCols(), nbasis2);
+      EXPECT_EQ(sample->dshape2, sample->shape2.GetData() + dim * nbasis2);
+   }
+
+   /* samples without the second element and gradients. */
+   eqp_elem.AllocateCoefficients(dim, nbasis1, 0, false);
+   EXPECT_EQ(eqp_elem.coeffs.Size(), (1 + dim * nbasis1) * nsample);
+   EXPECT_TRUE(eqp_elem.GetSample(nsample-1)->dshape1 == NULL);
+   EXPECT_EQ(eqp_elem.GetSample(nsample-1)->shape2.NumCols(), 0);
+
+   /* the fast kernels on the packed coefficients match the assembly with the basis. */
+   Mesh *mesh = new Mesh("meshes/test.4x4.mesh");
+   const int order = UniformRandom(1, 3);
+
+   FiniteElementCollection *h1_coll(new H1_FECollection(order, dim));
+   FiniteElementSpace *fes(new FiniteElementSpace(mesh, h1_coll, dim));
+   const int ndofs = fes->GetTrueVSize();
+
+   const int num_basis = 10;
+   // a fictitious basis.
+   DenseMatrix basis(ndofs, num_basis);
+   for (int i = 0; i < ndofs; i++)
+      for (int j = 0; j < num_basis; j++)
+         basis(i, j) = UniformRandom();
+
+   IntegrationRule ir = IntRules.Get(fes->GetFE(0)->GetGeomType(),
+                                    (int)(ceil(1.5 * (2 * fes->GetMaxElementOrder() - 1))));
+   ConstantCoefficient pi(3.141592);
+
+   const int nqe = ir.GetNPoints();
+   const int ne = fes->GetNE();
+   Array<SampleInfo> el_samples(UniformRandom(15, 20));
+   for (int s = 0; s < el_samples.Size(); s++)
+   {
+      el_samples[s].el = UniformRandom(0, ne-1);
+      el_samples[s].qp = UniformRandom(0, nqe-1);
+      el_samples[s].qw = UniformRandom();
+   }
+
+   Vector rom_u(num_basis);
+   for (int k = 0; k < rom_u.Size(); k++)
+      rom_u(k) = UniformRandom();
+
+   for (int f = 0; f < 2; f++)
+   {
+      HyperReductionIntegrator *integ;
+      if (f == 0)
+         integ = new VectorConvectionTrilinearFormIntegrator(pi);
+      else
+         integ = new IncompressibleInviscidFluxNLFIntegrator(pi);
+      integ->SetIntRule(&ir);
+
+      ROMNonlinearForm *rform(new ROMNonlinearForm(num_basis, fes));
+      rform->AddDomainIntegrator(integ);
+      rform->SetBasis(basis);
+      rform->UpdateDomainIntegratorSampling(0, el_samples);
+      rform->PrecomputeCoefficients();
+
+      Vector rom_y(num_basis), rom_yfast(num_basis);
+      rform->Mult(rom_u, rom_y);
+      DenseMatrix jac(*dynamic_cast<DenseMatrix *>(&(rform->GetGradient(rom_u))));
+
+      rform->SetPrecomputeMode(true);
+      rform->Mult(rom_u, rom_yfast);
+      for (int k = 0; k < rom_y.Size(); k++)
+         EXPECT_NEAR(rom_y(k), rom_yfast(k), threshold);
+
+      DenseMatrix *jac_fast = dynamic_cast<DenseMatrix *>(&(rform->GetGradient(rom_u)));
+      for (int i = 0; i < num_basis; i++)
+         for (int j = 0; j < num_basis; j++)
+            EXPECT_NEAR(jac(i, j), (*jac_fast)(i, j), threshold);
+
+      delete rform;
+   }
+
+   delete mesh;
+   delete h1_coll;
+   delete fes;
+}
+
+TEST(ROMNonlinearForm_fast, EQPCoefficientsRoundTrip)
+{
+   Mesh *mesh = new Mesh("meshes/test.4x4.mesh");
+   const int dim = mesh->Dimension();
+   const int order = UniformRandom(1, 3);
+
+   FiniteElementCollection *h1_coll(new H1_FECollection(order, dim));
+   FiniteElementSpace *fes(new FiniteElementSpace(mesh, h1_coll, dim));
+   const int ndofs = fes->GetTrueVSize();
+
+   const int num_basis = 10;
+   // a fictitious basis, and a retrained one.
+   DenseMatrix basis(ndofs, num_basis), basis1(ndofs, num_basis);
+   for (int i = 0; i < ndofs; i++)
+      for (int j = 0; j < num_basis; j++)
+      {
+         basis(i, j) = UniformRandom();
+         basis1(i, j) = UniformRandom();
+      }
+
+   IntegrationRule ir = IntRules.Get(fes->GetFE(0)->GetGeomType(),
+                                    (int)(ceil(1.5 * (2 * fes->GetMaxElementOrder() - 1))));
+   ConstantCoefficient pi(3.141592);
+   auto *integ = new VectorConvectionTrilinearFormIntegrator(pi);
+   integ->SetIntRule(&ir);
+   auto *integ1 = new VectorConvectionTrilinearFormIntegrator(pi);
+   integ1->SetIntRule(&ir);
+
+   ROMNonlinearForm *rform(new ROMNonlinearForm(num_basis, fes));
+   rform->AddDomainIntegrator(integ);
+   rform->SetBasis(basis);
+
+   const int nsample = UniformRandom(15, 20);
+   const int nqe = ir.GetNPoints();
+   const int ne = fes->GetNE();
+   Array<SampleInfo> samples(nsample);
+   for (int s = 0; s < nsample; s++)
+   {
+      samples[s].el = UniformRandom(0, ne-1);
+      samples[s].qp = UniformRandom(0, nqe-1);
+      samples[s].qw = UniformRandom();
+   }
+   rform->UpdateDomainIntegratorSampling(0, samples);
+   rform->PrecomputeCoefficients();
+   rform->SetPrecomputeMode(true);
+
+   Vector rom_u(num_basis);
+   for (int k = 0; k < rom_u.Size(); k++)
+      rom_u(k) = UniformRandom();
+
+   Vector rom_y(num_basis), rom_y1(num_basis);
+   rform->Mult(rom_u, rom_y);
+
+   /* save and reload. */
+   const std::string filename = "eqp_roundtrip.h5";
+   hid_t file_id = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+   assert(file_id >= 0);
+   rform->SaveEQPForIntegrator(IntegratorType::DOMAIN, 0, file_id, "integ0");
+   herr_t errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   ROMNonlinearForm *rform1(new ROMNonlinearForm(num_basis, fes));
+   rform1->AddDomainIntegrator(integ1);
+   rform1->SetBasis(basis);
+   file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+   assert(file_id >= 0);
+   rform1->LoadEQPForIntegrator(IntegratorType::DOMAIN, 0, file_id, "integ0");
+   errf = H5Fclose(file_id);
+   assert(errf >= 0);
+
+   /* the loaded coefficients are reused with the same basis. */
+   EQPElement *eqp_elem = rform1->GetEQPForIntegrator(IntegratorType::DOMAIN, 0);
+   EXPECT_TRUE(eqp_elem->HasLoadedCoefficients(dim, num_basis, 0, true, BasisFingerprint(basis)));
+   const double *loaded = eqp_elem->coeffs.GetData();
+   rform1->PrecomputeCoefficients();
+   EXPECT_EQ(eqp_elem->coeffs.GetData(), loaded);
+
+   rform1->SetPrecomputeMode(true);
+   rform1->Mult(rom_u, rom_y1);
+   for (int k = 0; k < rom_y.Size(); k++)
+      EXPECT_NEAR(rom_y(k), rom_y1(k), threshold);
+
+   /* the loaded coefficients are stale for a retrained basis, and computed again. */
+   EXPECT_FALSE(eqp_elem->HasLoadedCoefficients(dim, num_basis, 0, true, BasisFingerprint(basis1)));
+   rform1->SetBasis(basis1);
+   rform1->PrecomputeCoefficients();
+   EXPECT_FALSE(eqp_elem->HasLoadedCoefficients(dim, num_basis, 0, true, BasisFingerprint(basis1)));
+   rform1->Mult(rom_u, rom_y1);
+
+   rform->SetPrecomputeMode(false);
+   rform->SetBasis(basis1);
+   rform->Mult(rom_u, rom_y);
+   for (int k = 0; k < rom_y.Size(); k++)
+      EXPECT_NEAR(rom_y(k), rom_y1(k), threshold);
+
+   delete mesh;
+   delete h1_coll;
+   delete fes;
+   delete rform;
+   delete rform1;
+   return;
+}
+
 TEST(ROMNonlinearForm_fast, DGLaxFriedrichsFluxIntegrator)
 {
    Mesh *mesh = new Mesh("meshes/test.4x4.mesh");
@@ -952,6 +1243,78 @@ TEST(ROMNonlinearForm, SetupEQPSystemForDomainIntegrator)
    delete rform;
 }
 
+TEST(ROMNonlinearForm, ThreadedSetupEQPSystemForDomainIntegrator)
+{
+#if !defined(_OPENMP) || !defined(MFEM_THREAD_SAFE)
+   GTEST_SKIP() << "threaded EQP setup requires OpenMP and mfem built with MFEM_THREAD_SAFE.";
+#endif
+   Mesh *mesh = new Mesh("meshes/test.4x4.mesh");
+   const int dim = mesh->Dimension();
+   const int order = UniformRandom(1, 3);
+
+   FiniteElementCollection *h1_coll(new H1_FECollection(order, dim));
+   FiniteElementSpace *fes(new FiniteElementSpace(mesh, h1_coll, dim));
+   const int ndofs = fes->GetTrueVSize();
+   const int num_snap = UniformRandom(3, 5);
+   const int num_basis = 10;
+
+   // fictitious snapshots and basis.
+   CAROM::Matrix snapshots(ndofs, num_snap, false);
+   for (int i = 0; i < ndofs; i++)
+      for (int j = 0; j < num_snap; j++)
+         snapshots(i, j) = 2.0 * UniformRandom() - 1.0;
+   DenseMatrix basis(ndofs, num_basis);
+   for (int i = 0; i < ndofs; i++)
+      for (int j = 0; j < num_basis; j++)
+         basis(i, j) = UniformRandom();
+
+   IntegrationRule ir = IntRules.Get(fes->GetFE(0)->GetGeomType(),
+                                    (int)(ceil(1.5 * (2 * fes->GetMaxElementOrder() - 1))));
+   ConstantCoefficient pi(3.141592);
+
+   /* serial and threaded forms, both building local EQP systems. */
+   ROMNonlinearForm *rforms[2];
+   HyperReductionIntegrator *integs[2];
+   CAROM::Matrix *Gts[2];
+   CAROM::Vector *rhs[2];
+   for (int f = 0; f < 2; f++)
+   {
+      config.GetDict()["model_reduction"]["eqp"]["num_threads"] = (f == 0) ? 1 : 4;
+      integs[f] = new VectorConvectionTrilinearFormIntegrator(pi);
+      integs[f]->SetIntRule(&ir);
+
+      rforms[f] = new ROMNonlinearForm(num_basis, fes);
+      rforms[f]->AddDomainIntegrator(integs[f]);
+      rforms[f]->SetBasis(basis);
+
+      Gts[f] = new CAROM::Matrix(1, 1, false);
+      rhs[f] = new CAROM::Vector(1, false);
+      rforms[f]->SetupEQPSystemForDomainIntegrator(snapshots, integs[f], *Gts[f], *rhs[f]);
+   }
+   config.GetDict()["model_reduction"]["eqp"]["num_threads"] = 1;
+
+   EXPECT_EQ(Gts[0]->numRows(), fes->GetNE() * ir.GetNPoints());
+   EXPECT_EQ(Gts[0]->numColumns(), num_basis * num_snap);
+   EXPECT_EQ(Gts[1]->numRows(), Gts[0]->numRows());
+   EXPECT_EQ(Gts[1]->numColumns(), Gts[0]->numColumns());
+   for (int i = 0; i < Gts[0]->numRows(); i++)
+      for (int j = 0; j < Gts[0]->numColumns(); j++)
+         EXPECT_NEAR((*Gts[0])(i, j), (*Gts[1])(i, j), threshold);
+   for (int k = 0; k < rhs[0]->dim(); k++)
+      EXPECT_NEAR((*rhs[0])(k), (*rhs[1])(k), threshold);
+
+   delete mesh;
+   delete h1_coll;
+   delete fes;
+   for (int f = 0; f < 2; f++)
+   {
+      delete rforms[f];
+      delete Gts[f];
+      delete rhs[f];
+   }
+   return;
+}
+
 TEST(ROMNonlinearForm, SetupEQPSystemForInteriorFaceIntegrator)
 {
    Mesh *mesh = new Mesh("meshes/test.4x4.mesh");
@@ -1181,6 +1544,76 @@ TEST(ROMNonlinearForm, SetupEQPSystemForBdrFaceIntegrator)
    delete rform;
 }
 
+TEST(DGLaxFriedrichsFluxIntegrator, QuadratureVectors)
+{
+   Mesh *mesh = new Mesh("meshes/test.4x4.mesh");
+   const int dim = mesh->Dimension();
+   const int order = UniformRandom(1, 3);
+
+   FiniteElementCollection *dg_coll(new DG_FECollection(order, dim));
+   FiniteElementSpace *fes(new FiniteElementSpace(mesh, dg_coll, dim));
+   const int ncol = UniformRandom(3, 5);
+
+   IntegrationRule ir = IntRules.Get(fes->GetFE(0)->GetGeomType(),
+                                    (int)(ceil(1.5 * (2 * fes->GetMaxElementOrder() - 1))));
+   ConstantCoefficient pi(3.141592);
+   Vector ud(dim);
+   for (int d = 0; d < dim; d++) ud(d) = UniformRandom();
+   VectorConstantCoefficient ud_coeff(ud);
+   DGLaxFriedrichsFluxIntegrator integ(pi, &ud_coeff);
+   integ.SetIntRule(&ir);
+   const IntegrationRule *face_ir = integ.GetIntegrationRule();
+
+   /* batched evaluation must match the column-by-column evaluation on interior and boundary faces. */
+   Array<int> vdofs, vdofs2;
+   DenseMatrix el_x, el_quads;
+   Vector el_quad;
+   for (int bdr = 0; bdr < 2; bdr++)
+   {
+      const int nface = (bdr) ? fes->GetNBE() : mesh->GetNumFaces();
+      for (int f = 0; f < nface; f++)
+      {
+         FaceElementTransformations *tr = (bdr) ? mesh->GetBdrFaceTransformations(f)
+                                                : mesh->GetInteriorFaceTransformations(f);
+         if (tr == NULL) continue;
+
+         const FiniteElement *fe1 = fes->GetFE(tr->Elem1No);
+         const FiniteElement *fe2 = (bdr) ? fe1 : fes->GetFE(tr->Elem2No);
+         fes->GetElementVDofs(tr->Elem1No, vdofs);
+         if (!bdr)
+         {
+            fes->GetElementVDofs(tr->Elem2No, vdofs2);
+            vdofs.Append(vdofs2);
+         }
+
+         el_x.SetSize(vdofs.Size(), ncol);
+         for (int i = 0; i < el_x.NumRows(); i++)
+            for (int j = 0; j < ncol; j++)
+               el_x(i, j) = 2.0 * UniformRandom() - 1.0;
+
+         for (int m = 0; m < face_ir->GetNPoints(); m++)
+         {
+            const IntegrationPoint &ip = face_ir->IntPoint(m);
+            integ.AssembleQuadratureVectors(*fe1, *fe2, *tr, ip, 1.0, el_x, el_quads);
+            EXPECT_EQ(el_quads.NumCols(), ncol);
+
+            for (int j = 0; j < ncol; j++)
+            {
+               const Vector el_xj(el_x.GetColumn(j), el_x.NumRows());
+               integ.AssembleQuadratureVector(*fe1, *fe2, *tr, ip, 1.0, el_xj, el_quad);
+               for (int i = 0; i < el_quad.Size(); i++)
+                  EXPECT_NEAR(el_quads(i, j), el_quad(i), threshold);
+            }
+         }
+      }
+   }
+
+   delete fes;
+   delete dg_coll;
+   delete mesh;
+   return;
+}
+
 int main(int argc, char* argv[])
 {
    MPI_Init(&argc, &argv);
@@ -5,8 +5,13 @@
 #include<gtest/gtest.h>
 #include "topology_handler.hpp"
 #include "component_topology_handler.hpp"
+#include "interface_form.hpp"
+#include "interfaceinteg.hpp"
+#include "etc.hpp"
 #include <fstream>
 #include <iostream>
+#include <random>
+#include <algorithm>
 
 using namespace std;
 
@@ -38,8 +43,8 @@ TEST(Consistency3D_hex_test, Test_topol)
 TEST(Consistency3D_tet_test, Test_topol)
 {
    config = InputParser("inputs/test_topol.3d.yml");
-   config.dict_["mesh"]["filename"] = "meshes/test.2x2x2.tet.mesh";
-   config.dict_["mesh"]["component-wise"]["components"][0]["file"] = "meshes/test.1x1x1.tet.mesh";
+   config.GetDict()["mesh"]["filename"] = "meshes/test.2x2x2.tet.mesh";
+   config.GetDict()["mesh"]["component-wise"]["components"][0]["file"] = "meshes/test.1x1x1.tet.mesh";
 
    // For tetrahedra, indexing order becomes different, and it's difficult to match it.
    // Simply print out the result for now.
@@ -61,10 +66,10 @@ TEST(Consistency3D_tet_test, Test_topol)
 TEST(PortReadWrite_test, Test_topol)
 {
    config = InputParser("inputs/test_topol.3d.yml");
-   config.dict_["mesh"]["component-wise"]["write_ports"] = true;
-   config.dict_["mesh"]["component-wise"]["ports"][0]["file"] = "port1.3d.h5";
-   config.dict_["mesh"]["component-wise"]["ports"][1]["file"] = "port2.3d.h5";
-   config.dict_["mesh"]["component-wise"]["ports"][2]["file"] = "port3.3d.h5";
+   config.GetDict()["mesh"]["component-wise"]["write_ports"] = true;
+   config.GetDict()["mesh"]["component-wise"]["ports"][0]["file"] = "port1.3d.h5";
+   config.GetDict()["mesh"]["component-wise"]["ports"][1]["file"] = "port2.3d.h5";
+   config.GetDict()["mesh"]["component-wise"]["ports"][2]["file"] = "port3.3d.h5";
 
    printf("Generate\n");
    ComponentTopologyHandler *old = new ComponentTopologyHandler();
@@ -107,6 +112,319 @@ TEST(PortReadWrite_test, Test_topol)
    return;
 }
 
+TEST(LazyMeshes_test, Test_topol)
+{
+   config = InputParser("inputs/test_topol.2d.yml");
+   ComponentTopologyHandler *topol = new ComponentTopologyHandler();
+
+   // no subdomain mesh is copied at the setup.
+   EXPECT_EQ(topol->GetNumMaterializedMeshes(), 0);
+
+   const int numSub = topol->GetNumSubdomains();
+   Mesh *mesh = topol->GetMesh(numSub - 1);
+   EXPECT_EQ(topol->GetNumMaterializedMeshes(), 1);
+   EXPECT_EQ(topol->GetMesh(numSub - 1), mesh);
+
+   Array<Mesh*> meshes;
+   TopologyData topol_data;
+   topol->ExportInfo(meshes, topol_data);
+   EXPECT_EQ(topol->GetNumMaterializedMeshes(), numSub);
+   EXPECT_EQ(meshes[numSub - 1], mesh);
+
+   // materialized meshes are the rigid transformations of the reference components.
+   const int dim = topol_data.dim;
+   Vector x_c(dim), x_trns(dim), x(dim);
+   for (int m = 0; m < numSub; m++)
+   {
+      Mesh *comp = topol->GetComponentMesh(topol->GetMeshType(m));
+      EXPECT_EQ(meshes[m]->GetNE(), comp->GetNE());
+      EXPECT_EQ(meshes[m]->GetNBE(), comp->GetNBE());
+
+      for (int e = 0; e < comp->GetNE(); e++)
+      {
+         const IntegrationPoint &ip = Geometries.GetCenter(comp->GetElementBaseGeometry(e));
+         comp->GetElementTransformation(e)->Transform(ip, x_c);
+         meshes[m]->GetElementTransformation(e)->Transform(ip, x);
+         topol->TransformToSubdomain(m, x_c, x_trns);
+         for (int d = 0; d < dim; d++)
+            EXPECT_NEAR(x(d), x_trns(d), 1.0e-14);
+      }
+   }
+
+   delete topol;
+   return;
+}
+
+TEST(LazyMeshes_test, Test_rom_only)
+{
+   config = InputParser("inputs/test_topol.2d.yml");
+   ComponentTopologyHandler *topol = new ComponentTopologyHandler();
+
+   const int numSub = topol->GetNumSubdomains();
+   const int num_comp = topol->GetNumComponents();
+   const int dim = topol->GetComponentMesh(0)->Dimension();
+
+   // component-level ROM operators are assembled on the reference components and ports only.
+   FiniteElementCollection *fec = new DG_FECollection(1, dim);
+   Array<FiniteElementSpace *> comp_fes(num_comp);
+   for (int c = 0; c < num_comp; c++)
+      comp_fes[c] = new FiniteElementSpace(topol->GetComponentMesh(c), fec);
+
+   Array<Mesh *> meshes(0);
+   Array<FiniteElementSpace *> fes(0);
+   InterfaceForm *a_itf = new InterfaceForm(meshes, fes, topol);
+   a_itf->AddInterfaceIntegrator(new InterfaceDGDiffusionIntegrator(-1.0, 4.0));
+
+   Array2D<SparseMatrix *> spmats(2, 2);
+   spmats = NULL;
+   for (int p = 0; p < topol->GetNumRefPorts(); p++)
+   {
+      a_itf->AssembleInterfaceMatrixAtPort(p, comp_fes, spmats);
+      EXPECT_TRUE(spmats(0, 1)->NumNonZeroElems() > 0);
+   }
+   DeletePointers(spmats);
+
+   // global ROM system, as in MultiBlockSolver::AssembleROMMat.
+   for (int m = 0; m < numSub; m++)
+   {
+      const int c = topol->GetMeshType(m);
+      EXPECT_TRUE((c >= 0) && (c < num_comp));
+
+      Array<int> *bdr_c2g = topol->GetBdrAttrComponentToGlobalMap(m);
+      EXPECT_EQ(bdr_c2g->Size(), topol->GetComponentMesh(c)->bdr_attributes.Size());
+   }
+   for (int p = 0; p < topol->GetNumPorts(); p++)
+   {
+      const PortInfo *pInfo = topol->GetPortInfo(p);
+      EXPECT_TRUE((pInfo->Mesh1 >= 0) && (pInfo->Mesh1 < numSub));
+      EXPECT_TRUE((pInfo->Mesh2 >= 0) && (pInfo->Mesh2 < numSub));
+      EXPECT_TRUE((topol->GetPortType(p) >= 0) && (topol->GetPortType(p) < topol->GetNumRefPorts()));
+   }
+
+   // subdomain geometry is available through the rigid transformations.
+   Vector x_c(dim), x(dim);
+   x_c = 0.0;
+   for (int m = 0; m < numSub; m++)
+      topol->TransformToSubdomain(m, x_c, x);
+
+   // none of these builds a subdomain mesh.
+   EXPECT_EQ(topol->GetNumMaterializedMeshes(), 0);
+
+   delete a_itf;
+   DeletePointers(comp_fes);
+   delete fec;
+   delete topol;
+   return;
+}
+
+TEST(PortTransformations_test, Test_topol)
+{
+   config = InputParser("inputs/test_topol.2d.yml");
+   ComponentTopologyHandler *topol = new ComponentTopologyHandler();
+
+   const int dim = topol->GetMesh(0)->Dimension();
+   const IntegrationRule &ir = IntRules.Get(Geometry::SEGMENT, 3);
+   Vector nor_c(dim), nor(dim), x_c(dim), x(dim);
+
+   FaceElementTransformations *tr1, *tr2, *ctr1, *ctr2;
+   for (int p = 0; p < topol->GetNumPorts(); p++)
+   {
+      const PortInfo *pInfo = topol->GetPortInfo(p);
+      Mesh *mesh1 = topol->GetMesh(pInfo->Mesh1);
+      Mesh *mesh2 = topol->GetMesh(pInfo->Mesh2);
+      Array<InterfaceInfo> *if_infos = topol->GetInterfaceInfos(p);
+
+      for (int itf = 0; itf < if_infos->Size(); itf++)
+      {
+         topol->GetPortInterfaceTransformations(mesh1, mesh2, p, itf, ctr1, ctr2);
+         // rebuild the mesh-owned transformation, which must not alter the cached one.
+         topol->GetInterfaceTransformations(mesh1, mesh2, &((*if_infos)[itf]), tr1, tr2);
+         if ((tr1 == NULL) || (tr2 == NULL))
+         {
+            EXPECT_TRUE((ctr1 == NULL) || (ctr2 == NULL));
+            continue;
+         }
+
+         EXPECT_EQ(ctr1->Elem1No, tr1->Elem1No);
+         EXPECT_EQ(ctr2->Elem1No, tr2->Elem1No);
+         for (int q = 0; q < ir.GetNPoints(); q++)
+         {
+            const IntegrationPoint &ip = ir.IntPoint(q);
+            tr1->SetAllIntPoints(&ip);
+            ctr1->SetAllIntPoints(&ip);
+            CalcOrtho(tr1->Jacobian(), nor);
+            CalcOrtho(ctr1->Jacobian(), nor_c);
+            tr1->Elem1->Transform(tr1->GetElement1IntPoint(), x);
+            ctr1->Elem1->Transform(ctr1->GetElement1IntPoint(), x_c);
+            for (int d = 0; d < dim; d++)
+            {
+               EXPECT_NEAR(nor_c(d), nor(d), 1.0e-14);
+               EXPECT_NEAR(x_c(d), x(d), 1.0e-14);
+            }
+
+            tr2->SetAllIntPoints(&ip);
+            ctr2->SetAllIntPoints(&ip);
+            tr2->Elem1->Transform(tr2->GetElement1IntPoint(), x);
+            ctr2->Elem1->Transform(ctr2->GetElement1IntPoint(), x_c);
+            for (int d = 0; d < dim; d++)
+               EXPECT_NEAR(x_c(d), x(d), 1.0e-14);
+         }
+      }
+   }
+
+   delete topol;
+   return;
+}
+
+TEST(PortTransformations_test, Test_cache_owner)
+{
+   config = InputParser("inputs/test_topol.2d.yml");
+   ComponentTopologyHandler *topol = new ComponentTopologyHandler();
+
+   FaceElementTransformations *tr1, *tr2, *ctr1, *ctr2;
+   for (int p = 0; p < topol->GetNumPorts(); p++)
+   {
+      const PortInfo *pInfo = topol->GetPortInfo(p);
+      Mesh *mesh1 = topol->GetMesh(pInfo->Mesh1);
+      Mesh *mesh2 = topol->GetMesh(pInfo->Mesh2);
+      Mesh copy1(*mesh1), copy2(*mesh2);
+
+      // the first caller with other meshes must not define the cache of the port.
+      topol->GetPortInterfaceTransformations(&copy1, &copy2, p, 0, tr1, tr2);
+      topol->GetPortInterfaceTransformations(mesh1, mesh2, p, 0, ctr1, ctr2);
+      if ((ctr1 == NULL) || (ctr2 == NULL)) continue;
+      EXPECT_TRUE(ctr1 != tr1);
+      EXPECT_TRUE(ctr1 != mesh1->GetBdrFaceTransformations((*topol->GetInterfaceInfos(p))[0].BE1));
+
+      // cached transformations are reused.
+      topol->GetPortInterfaceTransformations(mesh1, mesh2, p, 0, tr1, tr2);
+      EXPECT_EQ(tr1, ctr1);
+      EXPECT_EQ(tr2, ctr2);
+
+      // clearing the other subdomains keeps the cache of this port.
+      for (int m = 0; m < topol->GetNumSubdomains(); m++)
+         if ((m != pInfo->Mesh1) && (m != pInfo->Mesh2))
+            topol->ClearInterfaceTransformations(m);
+      topol->GetPortInterfaceTransformations(mesh1, mesh2, p, 0, tr1, tr2);
+      EXPECT_EQ(tr1, ctr1);
+
+      // cleared with its subdomain, it is rebuilt from the subdomain meshes.
+      const int elem1 = ctr1->Elem1No, elem2 = ctr2->Elem1No;
+      topol->ClearInterfaceTransformations(pInfo->Mesh2);
+      topol->GetPortInterfaceTransformations(mesh1, mesh2, p, 0, tr1, tr2);
+      ASSERT_TRUE((tr1 != NULL) && (tr2 != NULL));
+      EXPECT_EQ(tr1->Elem1No, elem1);
+      EXPECT_EQ(tr2->Elem1No, elem2);
+   }
+
+   delete topol;
+   return;
+}
+
+/* exhaustive search over x2 in order, which BuildPortDataFromInput used to do. */
+void ReferenceMatchPortVertices(const DenseMatrix &x1, const DenseMatrix &x2, const double threshold, Array<int> &match1to2)
+{
+   const int dim = x1.NumRows();
+   std::vector<bool> matched(x2.NumCols(), false);
+   match1to2.SetSize(x1.NumCols());
+   match1to2 = -1;
+   for (int v1 = 0; v1 < x1.NumCols(); v1++)
+      for (int v2 = 0; v2 < x2.NumCols(); v2++)
+      {
+         if (matched[v2]) continue;
+
+         bool match = true;
+         for (int d = 0; d < dim; d++)
+            match = match && (abs(x1(d, v1) - x2(d, v2)) < threshold);
+
+         if (match)
+         {
+            match1to2[v1] = v2;
+            matched[v2] = true;
+            break;
+         }
+      }
+}
+
+/* scattered copy of a structured port grid, perturbed within the threshold. */
+void RandomPortVertices(const int dim, const int n, const double noise, DenseMatrix &x1, DenseMatrix &x2, Array<int> &perm)
+{
+   std::mt19937 gen(1234);
+   std::uniform_real_distribution<double> perturb(-noise, noise);
+
+   const int npts = (dim == 2) ? n : n * n;
+   perm.SetSize(npts);
+   for (int k = 0; k < npts; k++) perm[k] = k;
+   std::shuffle(perm.begin(), perm.end(), gen);
+
+   x1.SetSize(dim, npts);
+   x2.SetSize(dim, npts);
+   for (int k = 0; k < npts; k++)
+   {
+      // the port lies on the plane x = 1.
+      x1(0, k) = 1.0;
+      x1(1, k) = static_cast<double>(k % n) / static_cast<double>(n - 1);
+      if (dim == 3)
+         x1(2, k) = static_cast<double>(k / n) / static_cast<double>(n - 1);
+
+      for (int d = 0; d < dim; d++)
+         x2(d, perm[k]) = x1(d, k) + perturb(gen);
+   }
+}
+
+TEST(MatchPortVertices_test, Test_topol)
+{
+   const double threshold = 1.0e-10;
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      const int n = (dim == 2) ? 2000 : 45;
+      DenseMatrix x1, x2;
+      Array<int> perm, ref, test;
+      RandomPortVertices(dim, n, 0.1 * threshold, x1, x2, perm);
+
+      // duplicated points must be paired in the same order as the exhaustive search.
+      x2.SetCol(perm[1], x2.GetColumn(perm[0]));
+      x1.SetCol(1, x1.GetColumn(0));
+
+      ReferenceMatchPortVertices(x1, x2, threshold, ref);
+      MatchPortVertices(x1, x2, threshold, test);
+
+      EXPECT_EQ(test.Size(), ref.Size());
+      for (int k = 0; k < ref.Size(); k++)
+         EXPECT_EQ(test[k], ref[k]);
+      for (int k = 2; k < ref.Size(); k++)
+         EXPECT_EQ(test[k], perm[k]);
+
+      // a point beyond the threshold is not matched.
+      x2(0, perm[2]) += 10.0 * threshold;
+      MatchPortVertices(x1, x2, threshold, test);
+      EXPECT_EQ(test[2], -1);
+   }
+
+   return;
+}
+
+TEST(MatchPortVertices_benchmark, Test_topol)
+{
+   const int n = 317;
+   const double threshold = 1.0e-10;
+   DenseMatrix x1, x2;
+   Array<int> perm, test;
+   RandomPortVertices(3, n, 1.0e-2 * threshold, x1, x2, perm);
+
+   StopWatch timer;
+   timer.Start();
+   MatchPortVertices(x1, x2, threshold, test);
+   timer.Stop();
+
+   printf("MatchPortVertices (%d vertices): %f seconds.\n", x1.NumCols(), timer.RealTime());
+
+   for (int k = 0; k < perm.Size(); k++)
+      EXPECT_EQ(test[k], perm[k]);
+
+   return;
+}
+
 int main(int argc, char* argv[])
 {
    ::testing::InitGoogleTest(&argc, argv);
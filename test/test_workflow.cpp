@@ -4,7 +4,13 @@
 
 #include <gtest/gtest.h>
 #include "main_workflow.hpp"
+#include "advdiff_solver.hpp"
+#include "etc.hpp"
 #include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace mfem;
@@ -25,28 +31,28 @@ TEST(Poisson_Workflow, SubmeshTest)
 {
    config = InputParser("inputs/test.base.yml");
 
-   config.dict_["visualization"]["enabled"] = true;
+   config.GetDict()["visualization"]["enabled"] = true;
 
-   config.dict_["model_reduction"]["rom_handler_type"] = "mfem";
-   config.dict_["model_reduction"]["visualization"]["enabled"] = true;
-   config.dict_["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
+   config.GetDict()["model_reduction"]["visualization"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
 
    // Test save/loadSolution as well.
-   config.dict_["save_solution"]["enabled"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["load_solution"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
+   config.GetDict()["save_solution"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["load_solution"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["save_solution"]["enabled"] = false;
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["save_solution"]["enabled"] = false;
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -56,25 +62,51 @@ TEST(Poisson_Workflow, SubmeshTest)
    return;
 }
 
+TEST(Poisson_Workflow, ReuseSolverTest)
+{
+   config = InputParser("inputs/test.base.yml");
+
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
+
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   config.GetDict()["sample_generation"]["reuse_solver"] = true;
+   GenerateSamples(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "train_rom";
+   TrainROM(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "build_rom";
+   BuildROM(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "single_run";
+   double error = SingleRun(MPI_COMM_WORLD);
+
+   // Reusing the solver over samples must reproduce the same snapshots.
+   printf("Error: %.15E\n", error);
+   EXPECT_TRUE(error < threshold);
+
+   return;
+}
+
 TEST(Poisson_Workflow, ComponentWiseTest)
 {
    config = InputParser("inputs/test.component.yml");
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -87,25 +119,25 @@ TEST(Poisson_Workflow, ComponentWiseTest)
 TEST(Poisson_Workflow, ComponentWiseWithDirectSolve)
 {
    config = InputParser("inputs/test.component.yml");
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "spd";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "spd";
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -115,34 +147,313 @@ TEST(Poisson_Workflow, ComponentWiseWithDirectSolve)
    return;
 }
 
+/*
+   Run ServeROM on the query lines, and return the response lines.
+   Responses are of the form "response <index> <status> ...".
+*/
+static std::vector<std::string> ServeQueries(const std::string &queries)
+{
+   std::istringstream query_stream(queries);
+   std::streambuf *cin_buf = std::cin.rdbuf(query_stream.rdbuf());
+
+   testing::internal::CaptureStdout();
+   ServeROM(MPI_COMM_WORLD);
+   fflush(stdout);
+   std::string output = testing::internal::GetCapturedStdout();
+   std::cin.rdbuf(cin_buf);
+
+   std::vector<std::string> responses;
+   std::istringstream output_stream(output);
+   std::string line;
+   while (std::getline(output_stream, line))
+      if (line.compare(0, 9, "response ") == 0)
+         responses.push_back(line);
+   return responses;
+}
+
+// The word following key in a response line.
+static std::string ResponseField(const std::string &response, const std::string &key)
+{
+   std::istringstream ss(response);
+   std::string word;
+   while (ss >> word)
+      if ((word == key) && (ss >> word))
+         return word;
+   return "";
+}
+
+TEST(Poisson_Workflow, ServeROMTest)
+{
+   config = InputParser("inputs/test.base.yml");
+
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
+
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   GenerateSamples(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "train_rom";
+   TrainROM(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "build_rom";
+   BuildROM(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "serve";
+   config.GetDict()["serve"]["parameters"].push_back("single_run/poisson0/k");
+   // a repeated query must give the same response after a different one, and an invalid query an error.
+   const std::string queries = "2.5\nsingle_run/poisson0/k=2.2\n\n2.5\n2.5 3.0\nquit\n";
+   const int num_queries = 4;
+
+   std::vector<std::vector<std::string>> responses;
+   // the saved global operator, then the operator assembled from the FOM.
+   responses.push_back(ServeQueries(queries));
+   config.GetDict()["model_reduction"]["save_operator"]["level"] = "none";
+   responses.push_back(ServeQueries(queries));
+
+   for (int r = 0; r < responses.size(); r++)
+   {
+      ASSERT_EQ(responses[r].size(), num_queries);
+      for (int q = 0; q < num_queries; q++)
+      {
+         std::string status = (q == 3) ? "error" : "ok";
+         EXPECT_EQ(ResponseField(responses[r][q], "response"), std::to_string(q));
+         EXPECT_EQ(ResponseField(responses[r][q], std::to_string(q)), status);
+      }
+
+      const double norm0 = std::stod(ResponseField(responses[r][0], "norm_l2"));
+      const double norm1 = std::stod(ResponseField(responses[r][1], "norm_l2"));
+      const double norm2 = std::stod(ResponseField(responses[r][2], "norm_l2"));
+      const double norm_global = std::stod(ResponseField(responses[0][0], "norm_l2"));
+      EXPECT_TRUE(fabs(norm2 - norm0) < threshold * norm0);
+      EXPECT_TRUE(fabs(norm1 - norm0) > 1.0e-3 * norm0);
+      EXPECT_TRUE(fabs(norm0 - norm_global) < 1.0e-12 * norm_global);
+   }
+
+   return;
+}
+
+TEST(Poisson_Workflow, MultipleRHSSolveROM)
+{
+   config = InputParser("inputs/test.base.yml");
+
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
+
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   GenerateSamples(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "train_rom";
+   TrainROM(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "single_run";
+   config.GetDict()["model_reduction"]["save_operator"]["level"] = "none";
+
+   // the iterative solve of each column, and one MUMPS solve phase for all columns.
+   const std::vector<std::string> solver_types = {"cg", "direct"};
+   for (int t = 0; t < solver_types.size(); t++)
+   {
+      config.GetDict()["model_reduction"]["linear_solver_type"] = solver_types[t];
+
+      ParameterizedProblem *problem = InitParameterizedProblem();
+      MultiBlockSolver *test = InitSolver();
+      test->InitVariables();
+      test->InitROMHandler();
+
+      problem->SetSingleRun();
+      test->SetParameterizedProblem(problem);
+      test->BuildRHSOperators();
+      test->SetupRHSBCOperators();
+
+      test->LoadReducedBasis();
+      test->BuildDomainOperators();
+      test->SetupDomainBCOperators();
+      test->AssembleOperator();
+      test->ProjectOperatorOnReducedBasis();
+
+      BlockVector *RHS = test->GetRHS();
+      BlockVector *U = test->GetSolution();
+      const int ncol = 3;
+      DenseMatrix RHS_cols(RHS->Size(), ncol), U_cols;
+      for (int i = 0; i < RHS->Size(); i++)
+         for (int k = 0; k < ncol; k++)
+            RHS_cols(i, k) = UniformRandom();
+
+      test->SolveROM(RHS_cols, U_cols);
+      ASSERT_EQ(U_cols.NumRows(), U->Size());
+      ASSERT_EQ(U_cols.NumCols(), ncol);
+
+      // each column must be the single-vector ROM solution of the same RHS.
+      for (int k = 0; k < ncol; k++)
+      {
+         RHS_cols.GetColumn(k, *RHS);
+         test->ProjectRHSOnReducedBasis();
+         test->SolveROM();
+
+         const double norm = U->Normlinf();
+         for (int i = 0; i < U->Size(); i++)
+            EXPECT_NEAR(U_cols(i, k), (*U)[i], 1.0e-12 * norm);
+      }
+
+      delete test;
+      delete problem;
+   }
+
+   return;
+}
+
+static void SolvePoissonSample(MultiBlockSolver *test, ParameterizedProblem *problem)
+{
+   test->SetParameterizedProblem(problem);
+   test->BuildOperators();
+   test->SetupBCOperators();
+   test->Assemble();
+   test->Solve();
+}
+
+TEST(Poisson_Workflow, ConcurrentAssembly)
+{
+   config = InputParser("inputs/test.base.yml");
+   config.GetDict()["main"]["use_rom"] = false;
+
+   ParameterizedProblem *problem = InitParameterizedProblem();
+   problem->SetSingleRun();
+
+   // reference solution with the serial assembly.
+   config.GetDict()["solver"]["num_threads"] = 1;
+   MultiBlockSolver *test = InitSolver();
+   test->InitVariables();
+   SolvePoissonSample(test, problem);
+   BlockVector *ref_sol = test->GetSolutionCopy();
+   delete test;
+
+   config.GetDict()["solver"]["num_threads"] = 4;
+   test = InitSolver();
+   if (test->GetNumThreads() == 1)
+   {
+      delete test;
+      delete ref_sol;
+      delete problem;
+      GTEST_SKIP() << "concurrent assembly requires OpenMP and mfem built with MFEM_THREAD_SAFE.";
+   }
+   test->InitVariables();
+   SolvePoissonSample(test, problem);
+
+   // each subdomain form is assembled in the same order, so it must be bitwise identical.
+   BlockVector *sol = test->GetSolution();
+   ASSERT_EQ(sol->Size(), ref_sol->Size());
+   for (int i = 0; i < sol->Size(); i++)
+      EXPECT_EQ((*sol)[i], (*ref_sol)[i]);
+
+   delete test;
+   delete ref_sol;
+   delete problem;
+   return;
+}
+
+TEST(Poisson_Workflow, ConcurrentSamples)
+{
+   config = InputParser("inputs/test.base.yml");
+   config.GetDict()["main"]["use_rom"] = false;
+   // serial iterative solver, so that each thread solves its own system without MPI communication.
+   config.GetDict()["solver"]["use_amg"] = false;
+   config.GetDict()["solver"]["direct_solve"] = false;
+
+   const int nsample = 2;
+   SampleGenerator *generator = InitSampleGenerator(MPI_COMM_WORLD);
+   generator->SetParamSpaceSizes();
+
+   /*
+      each sample reads its parameters from its own copy of config,
+      and the problems hold their parameters separately.
+   */
+   std::vector<InputParser> sample_configs(nsample);
+   ParameterizedProblem *problems[nsample];
+   for (int s = 0; s < nsample; s++)
+   {
+      sample_configs[s].SetDict(YAML::Clone(config.GetDict()));
+      generator->SetSampleParams(2 * s, sample_configs[s]);
+
+      problems[s] = InitParameterizedProblem();
+      problems[s]->SetSingleRun(sample_configs[s]);
+   }
+   delete generator;
+   EXPECT_NE(problems[0]->GetParam(0), problems[1]->GetParam(0));
+
+   // reference solutions solved one after another.
+   BlockVector *ref_sol[nsample];
+   for (int s = 0; s < nsample; s++)
+   {
+      MultiBlockSolver *test = InitSolver();
+      test->InitVariables();
+      SolvePoissonSample(test, problems[s]);
+      ref_sol[s] = test->GetSolutionCopy();
+      delete test;
+   }
+
+   // the same samples solved concurrently on threads.
+   MultiBlockSolver *tests[nsample];
+   for (int s = 0; s < nsample; s++)
+   {
+      tests[s] = InitSolver();
+      tests[s]->InitVariables();
+   }
+
+   std::vector<std::thread> threads;
+   for (int s = 0; s < nsample; s++)
+      threads.push_back(std::thread(SolvePoissonSample, tests[s], problems[s]));
+   for (int s = 0; s < nsample; s++)
+      threads[s].join();
+
+   for (int s = 0; s < nsample; s++)
+   {
+      BlockVector *sol = tests[s]->GetSolution();
+      ASSERT_EQ(sol->Size(), ref_sol[s]->Size());
+      // must be bitwise identical.
+      for (int i = 0; i < sol->Size(); i++)
+         EXPECT_EQ((*sol)[i], (*ref_sol[s])[i]);
+   }
+
+   // the two samples must not share their parameters.
+   Vector diff(*ref_sol[0]);
+   diff -= *ref_sol[1];
+   EXPECT_TRUE(diff.Normlinf() > 0.0);
+
+   for (int s = 0; s < nsample; s++)
+   {
+      delete tests[s];
+      delete ref_sol[s];
+      delete problems[s];
+   }
+
+   return;
+}
+
 TEST(Stokes_Workflow, SubmeshTest)
 {
    config = InputParser("inputs/stokes.base.yml");
 
-   config.dict_["visualization"]["enabled"] = true;
+   config.GetDict()["visualization"]["enabled"] = true;
 
-   config.dict_["model_reduction"]["rom_handler_type"] = "mfem";
-   config.dict_["model_reduction"]["visualization"]["enabled"] = true;
-   config.dict_["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
+   config.GetDict()["model_reduction"]["visualization"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
 
    // Test save/loadSolution as well.
-   config.dict_["save_solution"]["enabled"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["load_solution"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
+   config.GetDict()["save_solution"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["load_solution"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
 
-   config.dict_["main"]["mode"] = "sample_generation";
-   config.dict_["main"]["use_rom"] = false;
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["use_rom"] = false;
    GenerateSamples(MPI_COMM_WORLD);
-   config.dict_["main"]["use_rom"] = true;
+   config.GetDict()["main"]["use_rom"] = true;
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["save_solution"]["enabled"] = false;
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["save_solution"]["enabled"] = false;
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -156,31 +467,31 @@ TEST(Stokes_Workflow, MFEMGlobalSeparateTest)
 {
    config = InputParser("inputs/stokes.base.yml");
 
-   config.dict_["visualization"]["enabled"] = true;
+   config.GetDict()["visualization"]["enabled"] = true;
 
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["visualization"]["enabled"] = true;
-   config.dict_["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
-   config.dict_["model_reduction"]["linear_solver_type"] = "minres";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["visualization"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "minres";
 
    // Test save/loadSolution as well.
-   config.dict_["save_solution"]["enabled"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["load_solution"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
+   config.GetDict()["save_solution"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["load_solution"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
 
-   config.dict_["main"]["mode"] = "sample_generation";
-   config.dict_["main"]["use_rom"] = false;
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["use_rom"] = false;
    GenerateSamples(MPI_COMM_WORLD);
-   config.dict_["main"]["use_rom"] = true;
+   config.GetDict()["main"]["use_rom"] = true;
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["save_solution"]["enabled"] = false;
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["save_solution"]["enabled"] = false;
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -196,20 +507,20 @@ TEST(Stokes_Workflow, ComponentWiseTest)
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
-   config.dict_["main"]["use_rom"] = false;
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["use_rom"] = false;
    GenerateSamples(MPI_COMM_WORLD);
-   config.dict_["main"]["use_rom"] = true;
+   config.GetDict()["main"]["use_rom"] = true;
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -222,24 +533,24 @@ TEST(Stokes_Workflow, ComponentWiseTest)
 TEST(Stokes_Workflow, ComponentWiseWithDirectSolve)
 {
    config = InputParser("inputs/stokes.component.yml");
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "sid";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "sid";
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -252,25 +563,56 @@ TEST(Stokes_Workflow, ComponentWiseWithDirectSolve)
 TEST(Stokes_Workflow, ComponentSeparateVariable)
 {
    config = InputParser("inputs/stokes.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
+   double error = SingleRun(MPI_COMM_WORLD);
+
+   // This reproductive case must have a very small error at the level of finite-precision.
+   printf("Error: %.15E\n", error);
+   EXPECT_TRUE(error < stokes_threshold);
+
+   return;
+}
+
+TEST(Stokes_Workflow, ComponentSeparateVariableBlockDirect)
+{
+   config = InputParser("inputs/stokes.component.yml");
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   // the pressure-pressure ROM blocks are zero.
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "block_direct";
+
+   printf("\nSample Generation \n\n");
+
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   GenerateSamples(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "train_rom";
+   TrainROM(MPI_COMM_WORLD);
+
+   printf("\nBuild ROM \n\n");
+
+   config.GetDict()["main"]["mode"] = "build_rom";
+   BuildROM(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -284,27 +626,27 @@ TEST(Stokes_Workflow, ROM_OrderingByVariable)
 {
    config = InputParser("inputs/stokes.component.yml");
 
-   config.dict_["model_reduction"]["ordering"] = "variable";
+   config.GetDict()["model_reduction"]["ordering"] = "variable";
 
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -318,30 +660,30 @@ TEST(SteadyNS_Workflow, SubmeshTest)
 {
    config = InputParser("inputs/steady_ns.base.yml");
 
-   config.dict_["mesh"]["uniform_refinement"] = 2;
-   config.dict_["discretization"]["order"] = 2;
-   config.dict_["visualization"]["enabled"] = true;
+   config.GetDict()["mesh"]["uniform_refinement"] = 2;
+   config.GetDict()["discretization"]["order"] = 2;
+   config.GetDict()["visualization"]["enabled"] = true;
 
-   config.dict_["model_reduction"]["rom_handler_type"] = "mfem";
-   config.dict_["model_reduction"]["visualization"]["enabled"] = true;
-   config.dict_["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
+   config.GetDict()["model_reduction"]["visualization"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
 
    // Test save/loadSolution as well.
-   config.dict_["save_solution"]["enabled"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["load_solution"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
+   config.GetDict()["save_solution"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["load_solution"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["save_solution"]["enabled"] = false;
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["save_solution"]["enabled"] = false;
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -355,31 +697,31 @@ TEST(SteadyNS_Workflow, MFEMGlobalUniversalTest)
 {
    config = InputParser("inputs/steady_ns.base.yml");
 
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["mesh"]["uniform_refinement"] = 2;
-   config.dict_["discretization"]["order"] = 2;
-   config.dict_["visualization"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["mesh"]["uniform_refinement"] = 2;
+   config.GetDict()["discretization"]["order"] = 2;
+   config.GetDict()["visualization"]["enabled"] = true;
 
-   config.dict_["model_reduction"]["rom_handler_type"] = "mfem";
-   config.dict_["model_reduction"]["visualization"]["enabled"] = true;
-   config.dict_["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
+   config.GetDict()["model_reduction"]["visualization"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
 
    // Test save/loadSolution as well.
-   config.dict_["save_solution"]["enabled"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["load_solution"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
+   config.GetDict()["save_solution"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["load_solution"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["save_solution"]["enabled"] = false;
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["save_solution"]["enabled"] = false;
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -395,18 +737,18 @@ TEST(SteadyNS_Workflow, ComponentWiseTest)
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -419,23 +761,23 @@ TEST(SteadyNS_Workflow, ComponentWiseTest)
 TEST(SteadyNS_Workflow, ComponentWiseWithDirectSolve)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -448,24 +790,24 @@ TEST(SteadyNS_Workflow, ComponentWiseWithDirectSolve)
 TEST(SteadyNS_Workflow, ComponentSeparateVariable)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -475,33 +817,63 @@ TEST(SteadyNS_Workflow, ComponentSeparateVariable)
    return;
 }
 
+TEST(SteadyNS_Workflow, ComponentSeparateVariableBlockDirect)
+{
+   config = InputParser("inputs/steady_ns.component.yml");
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   // the Newton jacobians have zero pressure-pressure ROM blocks.
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "block_direct";
+
+   printf("\nSample Generation \n\n");
+
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   GenerateSamples(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "train_rom";
+   TrainROM(MPI_COMM_WORLD);
+
+   printf("\nBuild ROM \n\n");
+
+   config.GetDict()["main"]["mode"] = "build_rom";
+   BuildROM(MPI_COMM_WORLD);
+
+   config.GetDict()["main"]["mode"] = "single_run";
+   double error = SingleRun(MPI_COMM_WORLD);
+
+   // This reproductive case must have a very small error at the level of finite-precision.
+   printf("Error: %.15E\n", error);
+   EXPECT_TRUE(error < stokes_threshold);
+
+   return;
+}
+
 TEST(SteadyNS_Workflow, ComponentSeparateVariable_EQP)
 {
    config = InputParser("inputs/steady_ns.component.yml");
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
-   config.dict_["model_reduction"]["nonlinear_handling"] = "eqp";
-   config.dict_["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
-   config.dict_["model_reduction"]["eqp"]["precompute"] = true;
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["nonlinear_handling"] = "eqp";
+   config.GetDict()["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
+   config.GetDict()["model_reduction"]["eqp"]["precompute"] = true;
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_eqp";
+   config.GetDict()["main"]["mode"] = "train_eqp";
    TrainEQP(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -515,32 +887,32 @@ TEST(SteadyNS_Workflow, ROM_OrderingByVariable)
 {
    config = InputParser("inputs/steady_ns.component.yml");
 
-   config.dict_["model_reduction"]["ordering"] = "variable";
+   config.GetDict()["model_reduction"]["ordering"] = "variable";
 
-   config.dict_["model_reduction"]["separate_variable_basis"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "us";
-   config.dict_["model_reduction"]["nonlinear_handling"] = "eqp";
-   config.dict_["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
-   config.dict_["model_reduction"]["eqp"]["precompute"] = true;
+   config.GetDict()["model_reduction"]["separate_variable_basis"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "us";
+   config.GetDict()["model_reduction"]["nonlinear_handling"] = "eqp";
+   config.GetDict()["model_reduction"]["eqp"]["relative_tolerance"] = 1.0e-11;
+   config.GetDict()["model_reduction"]["eqp"]["precompute"] = true;
 
    printf("\nSample Generation \n\n");
    
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_eqp";
+   config.GetDict()["main"]["mode"] = "train_eqp";
    TrainEQP(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD, "test_output.h5");
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -554,23 +926,23 @@ TEST(LinElast_Workflow, SubmeshTest)
 {
    config = InputParser("inputs/linelast.base.yml");
 
-   config.dict_["model_reduction"]["rom_handler_type"] = "mfem";
+   config.GetDict()["model_reduction"]["rom_handler_type"] = "mfem";
 
    // Test save/loadSolution as well.
-   config.dict_["save_solution"]["enabled"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["load_solution"] = true;
-   config.dict_["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
+   config.GetDict()["save_solution"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["load_solution"] = true;
+   config.GetDict()["model_reduction"]["compare_solution"]["fom_solution_file"] = "./sample1_solution.h5";
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["save_solution"]["enabled"] = false;
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["save_solution"]["enabled"] = false;
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -583,25 +955,25 @@ TEST(LinElast_Workflow, SubmeshTest)
 TEST(LinElast_Workflow, ComponentWiseWithDirectSolve)
 {
    config = InputParser("inputs/linelast.component.yml");
-   config.dict_["solver"]["direct_solve"] = true;
-   config.dict_["model_reduction"]["linear_solver_type"] = "direct";
-   config.dict_["model_reduction"]["linear_system_type"] = "spd";
+   config.GetDict()["solver"]["direct_solve"] = true;
+   config.GetDict()["model_reduction"]["linear_solver_type"] = "direct";
+   config.GetDict()["model_reduction"]["linear_system_type"] = "spd";
 
    printf("\nSample Generation \n\n");
 
-    config.dict_["main"]["mode"] = "sample_generation";
+    config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -617,19 +989,19 @@ TEST(LinElast_Workflow, ComponentWiseTest)
 
    printf("\nSample Generation \n\n");
 
-   config.dict_["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["mode"] = "sample_generation";
    GenerateSamples(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
    printf("\nBuild ROM \n\n");
 
-   config.dict_["mesh"]["type"] = "component-wise";
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["mesh"]["type"] = "component-wise";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -643,21 +1015,21 @@ TEST(AdvDiff_Workflow, SubmeshTest)
 {
    config = InputParser("inputs/advdiff.base.yml");
 
-   config.dict_["model_reduction"]["visualization"]["enabled"] = true;
-   config.dict_["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
+   config.GetDict()["model_reduction"]["visualization"]["enabled"] = true;
+   config.GetDict()["model_reduction"]["visualization"]["prefix"] = "basis_paraview";
 
-   config.dict_["main"]["mode"] = "sample_generation";
-   config.dict_["main"]["use_rom"] = false;
+   config.GetDict()["main"]["mode"] = "sample_generation";
+   config.GetDict()["main"]["use_rom"] = false;
    GenerateSamples(MPI_COMM_WORLD);
-   config.dict_["main"]["use_rom"] = true;
+   config.GetDict()["main"]["use_rom"] = true;
 
-   config.dict_["main"]["mode"] = "train_rom";
+   config.GetDict()["main"]["mode"] = "train_rom";
    TrainROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "build_rom";
+   config.GetDict()["main"]["mode"] = "build_rom";
    BuildROM(MPI_COMM_WORLD);
 
-   config.dict_["main"]["mode"] = "single_run";
+   config.GetDict()["main"]["mode"] = "single_run";
    double error = SingleRun(MPI_COMM_WORLD);
 
    // This reproductive case must have a very small error at the level of finite-precision.
@@ -667,6 +1039,80 @@ TEST(AdvDiff_Workflow, SubmeshTest)
    return;
 }
 
+static BlockVector* SolveAdvDiff(ParameterizedProblem *problem, bool &flow_from_library)
+{
+   AdvDiffSolver *test = new AdvDiffSolver;
+   test->InitVariables();
+   test->SetParameterizedProblem(problem);
+   flow_from_library = test->IsFlowFromLibrary();
+
+   test->BuildOperators();
+   test->SetupBCOperators();
+   test->Assemble();
+   test->Solve();
+
+   BlockVector *sol = test->GetSolutionCopy();
+   delete test;
+   return sol;
+}
+
+TEST(AdvDiff_Workflow, FlowLibrary)
+{
+   config = InputParser("inputs/advdiff.base.yml");
+   config.GetDict()["main"]["use_rom"] = false;
+   config.GetDict()["adv-diff"]["save_flow"] = false;
+   config.GetDict()["adv-diff"]["flow_library"]["enabled"] = true;
+   config.GetDict()["adv-diff"]["flow_library"]["prefix"] = "advdiff.flow_library";
+   config.GetDict()["adv-diff"]["flow_library"]["max_size"] = 1;
+   std::remove("advdiff.flow_library.h5");
+   AdvDiffSolver::ClearFlowLibrary();
+
+   ParameterizedProblem *problem = InitParameterizedProblem();
+   problem->SetSingleRun();
+
+   bool from_library;
+   BlockVector *sol0 = SolveAdvDiff(problem, from_library);
+   EXPECT_FALSE(from_library);
+   EXPECT_EQ(AdvDiffSolver::GetFlowLibrarySize(), 1);
+   EXPECT_TRUE(FileExists("advdiff.flow_library.h5"));
+
+   // cache hit: the source term does not change the flow field.
+   problem->SetParams("qk_x", 1.2);
+   BlockVector *sol1 = SolveAdvDiff(problem, from_library);
+   EXPECT_TRUE(from_library);
+
+   // a new flow field evicts the old one from the in-memory library.
+   problem->SetParams("qk_x", 1.5);
+   problem->SetParams("nu", 3.0);
+   BlockVector *sol2 = SolveAdvDiff(problem, from_library);
+   EXPECT_FALSE(from_library);
+   EXPECT_EQ(AdvDiffSolver::GetFlowLibrarySize(), 1);
+
+   // the evicted flow field is loaded from the library file, and reproduces the solution.
+   problem->SetParams("nu", 2.5);
+   BlockVector *sol3 = SolveAdvDiff(problem, from_library);
+   EXPECT_TRUE(from_library);
+   *sol3 -= *sol0;
+   EXPECT_TRUE(sol3->Normlinf() < threshold * sol0->Normlinf());
+
+   // the same after clearing the in-memory library.
+   AdvDiffSolver::ClearFlowLibrary();
+   EXPECT_EQ(AdvDiffSolver::GetFlowLibrarySize(), 0);
+   problem->SetParams("nu", 3.0);
+   BlockVector *sol4 = SolveAdvDiff(problem, from_library);
+   EXPECT_TRUE(from_library);
+   *sol4 -= *sol2;
+   EXPECT_TRUE(sol4->Normlinf() < threshold * sol2->Normlinf());
+
+   delete sol0;
+   delete sol1;
+   delete sol2;
+   delete sol3;
+   delete sol4;
+   delete problem;
+   return;
+}
+
 int main(int argc, char *argv[])
 {
    ::testing::InitGoogleTest(&argc, argv);
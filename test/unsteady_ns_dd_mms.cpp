@@ -19,12 +19,12 @@ TEST(GoogleTestFramework, GoogleTestFrameworkFound) {
 TEST(DDSerialTest, Test_convergence)
 {
    config = InputParser("inputs/dd_mms.yml");
-   config.dict_["navier-stokes"]["operator-type"] = "lf";
-   config.dict_["discretization"]["order"] = 1;
-   config.dict_["manufactured_solution"]["number_of_refinement"] = 3;
-   config.dict_["time-integration"]["timestep_size"] = 0.01;
-   config.dict_["time-integration"]["number_of_timesteps"] = 100;
-   config.dict_["time-integration"]["report_interval"] = 10;
+   config.GetDict()["navier-stokes"]["operator-type"] = "lf";
+   config.GetDict()["discretization"]["order"] = 1;
+   config.GetDict()["manufactured_solution"]["number_of_refinement"] = 3;
+   config.GetDict()["time-integration"]["timestep_size"] = 0.01;
+   config.GetDict()["time-integration"]["number_of_timesteps"] = 100;
+   config.GetDict()["time-integration"]["report_interval"] = 10;
    CheckConvergence();
 
    return;
@@ -22,7 +22,7 @@ int main(int argc, char *argv[])
    args.ParseCheck();
    config = InputParser(input_file);
    // Do not need ROMHandler.
-   config.dict_["main"]["use_rom"] = false;
+   config.GetDict()["main"]["use_rom"] = false;
 
    MultiBlockSolver *test = InitSolver();
    test->InitVariables();